@@ -0,0 +1,168 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of qti_adc on the virtual time port. The sim ADC converts a
+  sawtooth per channel, the scope Qti subscribes and checks every sample
+  of every block against it, decimated or not. Every rate and decimation
+  runs in a process of its own.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/sim -I$R/qties -o sample_adc [a-z]*.c \
+       $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/sim/tq_port.c $R/hw/sim/hw_adc.c $R/qties/qti_adc.c
+    sample_adc [-n channels] [-c scope us per block] [-t seconds]
+
+  A line per run gives samples converted a second, blocks and interrupts
+  a second, the drops, the share of the virtual CPU the scope takes with
+  -c and the host time per sample.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_sim.h"
+#include "hw_adc.h"
+#include "qti_adc.h"
+#include "qties.h"
+
+#define DEFAULT_CHANNELS                    (4)
+#define DEFAULT_RUN_TIME                    (1)             /* seconds */
+
+static void run(void);
+static uint16 sawtooth(uint8 channel, uint32 sequence);
+static void report(double host_seconds);
+
+static const uint32 _rates[] = {1000, 8000, 32000, 100000, 250000};
+static const uint8 _decimations[] = {1, 16};
+
+static struct QTI_ADC_CONFIG _config;
+static uint8  _channel_count = DEFAULT_CHANNELS;
+static uint32 _block_time;
+static TQ_SIM_TIME _run_time = DEFAULT_RUN_TIME;
+
+static unsigned long long _samples;
+static unsigned long long _errors;
+static unsigned long long _busy;
+
+
+int main(int argc, char *argv[])
+{
+  uint8 r, d;
+  int i, status;
+  pid_t child;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-n") && i + 1 < argc)
+      _channel_count = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-c") && i + 1 < argc)
+      _block_time = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      _run_time = strtoull(argv[++i], 0, 10);
+  }
+  if(!_channel_count || _channel_count > 16 || !_run_time)
+  {
+    fprintf(stderr, "channels 1 to 16\n");
+    return 1;
+  }
+
+  printf("%u channels, blocks of %u samples, %u us per block\n", _channel_count,
+         QTI_ADC_BLOCK_SAMPLES / _channel_count * _channel_count, _block_time);
+  printf("%8s %4s %12s %10s %10s %10s %8s %10s\n", "rate", "dec", "samples/s", "blocks/s", "irqs/s", "dropped", "load %",
+         "ns/sample");
+  fflush(stdout);
+
+  _config.channels = (1UL << _channel_count) - 1;
+  for(r = 0; r < sizeof(_rates) / sizeof(_rates[0]); r++)
+  {
+    for(d = 0; d < sizeof(_decimations); d++)
+    {
+      _config.rate = _rates[r];
+      _config.decimation = _decimations[d];
+
+      /* tq_sim_run() once per process */
+      child = fork();
+      if(!child)
+      {
+        run();
+        exit(_errors ? 1 : 0);
+      }
+      waitpid(child, &status, 0);
+      if(!WIFEXITED(status) || WEXITSTATUS(status))
+        return 1;
+    }
+  }
+  return 0;
+}
+
+static void run(void)
+{
+  clock_t started;
+
+  hw_adc_sim_set_generator(sawtooth);
+  started = clock();
+  tq_sim_run(_run_time * 1000 * 1000);
+  report((double)(clock() - started) / CLOCKS_PER_SEC);
+}
+
+/* channel in the top bits, a window of decimation never wraps */
+static uint16 sawtooth(uint8 channel, uint32 sequence)
+{
+  return (uint16)(channel * 256 + (sequence & 0xff));
+}
+
+void qti_scope_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  const struct QTI_ADC_BLOCK *block;
+  uint32 sequence;
+  uint16 count, i;
+  uint8 c;
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    qti_adc_subscribe(QTI_SCOPE);
+    if(!qti_adc_start(&_config))
+      exit(1);
+  }
+  else if(from == QTI_ADC && sig == ADC_NTF_BLOCK)
+  {
+    block = (const struct QTI_ADC_BLOCK*)p;
+    count = (size - sizeof(block->index)) / sizeof(uint16) / _channel_count;
+    sequence = (uint32)block->index * count * _config.decimation;
+    for(i = 0; i < count; i++, sequence += _config.decimation)
+    {
+      for(c = 0; c < _channel_count; c++)
+      {
+        if(block->samples[i * _channel_count + c] != sawtooth(c, sequence) + (_config.decimation - 1) / 2)
+          _errors++;
+      }
+    }
+    _samples += count * _channel_count;
+
+    if(_block_time)
+    {
+      tq_sim_consume(_block_time);
+      _busy += _block_time;
+    }
+  }
+}
+
+static void report(double host_seconds)
+{
+  struct QTI_ADC_STATS stats;
+  double seconds = tq_sim_now() / 1e6;
+
+  qti_adc_get_stats(&stats);
+  printf("%8u %4u %12.0f %10.0f %10.0f %10u %8.1f %10.1f\n", _config.rate, _config.decimation,
+         stats.sequences * (double)_channel_count / seconds, stats.blocks / seconds, stats.irqs / seconds, stats.dropped,
+         _busy / 1e4 / seconds, stats.sequences ? host_seconds * 1e9 / stats.sequences / _channel_count : 0.0);
+  if(_errors)
+    printf("%llu samples of %llu wrong\n", _errors, _samples);
+  fflush(stdout);
+}
@@ -0,0 +1,226 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Load test of qti_bridge between two tinyq processes, a main side and a
+  coprocessor side over a Unix socket or a pair of pipes. The ping Qti of
+  the main side keeps echo requests in flight to the pong Qti of the other
+  side and probes it with a high priority signal every few milliseconds.
+  Every count of requests in flight runs in a pair of processes of its own.
+
+    R=../../tinyq
+    cc -O2 -DTQ_LOGIC_BUFFER_SIZE=16384 -DBRIDGE_FRAME_SIZE=2048 -DBRIDGE_TX_FRAMES=8 -DBRIDGE_WINDOW=4 \
+       -I. -I$R/core -I$R/misc -I$R/hw/posix -I$R/qties -o sample_bridge [a-z]*.c $R/core/[a-z]*.c $R/misc/[a-z]*.c \
+       $R/hw/posix/tq_port.c $R/hw/posix/hw_link.c $R/qties/qti_bridge.c
+    sample_bridge [-k in flight] [-s param bytes] [-t ms] [-p]
+
+  The requests in flight sit in the logic queue at start, so it has to be
+  bigger than on target. Without the BRIDGE_xxx flags the frames and the
+  window are those of a target.
+
+  A line per count gives round trips per second, signals per frame each
+  way, the worst probe round trip and the CRC errors, drops, stalls and
+  failed opens of the link.
+****************************************************************************/
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "ring_buffer.h"
+#include "tq_context.h"
+#include "hw_link.h"
+#include "qti_bridge.h"
+#include "qties.h"
+
+#define WARM_UP_TIME                        (200)           /* ms */
+#define DEFAULT_RUN_TIME                    (1000)          /* ms */
+#define PROBE_PERIOD                        (5)             /* ms */
+
+#define DEFAULT_IN_FLIGHT                   (64)
+#define DEFAULT_PARAM_SIZE                  (8)
+
+#define TIMER_WARM_UP                       (1)
+#define TIMER_RUN                           (2)
+#define TIMER_PROBE                         (3)
+
+static void run_pair(boolean pipes);
+static void report(void);
+
+static boolean _main_side;
+static uint16 _in_flight;
+static uint8  _param_size = DEFAULT_PARAM_SIZE;
+static uint32 _run_time = DEFAULT_RUN_TIME;
+
+static unsigned long long _round_trips;
+static unsigned long long _start_round_trips;
+static struct QTI_BRIDGE_STATS _start_stats;
+static uint32 _start_time;
+static uint32 _probe_max;
+
+
+int main(int argc, char *argv[])
+{
+  uint16 max_in_flight = DEFAULT_IN_FLIGHT;
+  boolean pipes = FALSE;
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      max_in_flight = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+      _param_size = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      _run_time = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-p"))
+      pipes = TRUE;
+  }
+  if(!max_in_flight || max_in_flight > 1024 || !_run_time || _run_time > 2000)
+  {
+    fprintf(stderr, "in flight 1 to 1024, run time 1 to 2000 ms\n");
+    return 1;
+  }
+  if(max_in_flight * (TQ_SIGNAL_HEADER_SIZE + _param_size) > TQ_LOGIC_BUFFER_SIZE / 2)
+  {
+    fprintf(stderr, "the logic queue of %u bytes holds too few requests\n", TQ_LOGIC_BUFFER_SIZE);
+    return 1;
+  }
+
+  printf("%s, %u bytes of param, frames of %u bytes, window %u, %u ms per run\n", pipes ? "pipes" : "socket",
+         _param_size, BRIDGE_FRAME_SIZE, BRIDGE_WINDOW, _run_time);
+  printf("%9s %12s %10s %10s %10s %8s\n", "in flight", "round/s", "sig/frame", "back", "probe us", "errors");
+  fflush(stdout);
+
+  for(_in_flight = 1; _in_flight <= max_in_flight; _in_flight *= 4)
+    run_pair(pipes);
+  return 0;
+}
+
+/* tinyq never returns, a process per side */
+static void run_pair(boolean pipes)
+{
+  int to_co[2], to_main[2];
+  pid_t co, main_side;
+  int status;
+
+  if(pipes)
+  {
+    if(pipe2(to_co, O_NONBLOCK | O_CLOEXEC) || pipe2(to_main, O_NONBLOCK | O_CLOEXEC))
+      exit(1);
+  }
+  else
+  {
+    if(socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, to_co))
+      exit(1);
+    to_main[0] = to_co[1];
+    to_main[1] = to_co[0];
+  }
+
+  co = fork();
+  if(!co)
+  {
+    _main_side = FALSE;
+    hw_link_set_fds(to_co[0], to_main[1]);
+    tinyq_run();
+  }
+  main_side = fork();
+  if(!main_side)
+  {
+    _main_side = TRUE;
+    hw_link_set_fds(to_main[0], to_co[1]);
+    tinyq_run();
+  }
+
+  waitpid(main_side, &status, 0);
+  kill(co, SIGKILL);
+  waitpid(co, 0, 0);
+  close(to_co[0]);
+  close(to_co[1]);
+  if(pipes)
+  {
+    close(to_main[0]);
+    close(to_main[1]);
+  }
+  if(!WIFEXITED(status) || WEXITSTATUS(status))
+    exit(1);
+}
+
+void qti_ping_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint8 param[255];
+  uint32 sent;
+  uint16 i, id;
+
+  if(!_main_side)
+    return;
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    memset(param, 0x5a, sizeof(param));
+    for(i = 0; i < _in_flight; i++)
+      tinyq_send_signal(QTI_PING, QTI_REMOTE_PONG, PONG_CMD_ECHO, param, _param_size);
+    qti_system_start_timer(QTI_PING, TIMER_WARM_UP, WARM_UP_TIME);
+  }
+  else if(from == QTI_SYSTEM && sig == SYSTEM_RSP_TIMER)
+  {
+    id = *((uint16*)(p));
+    if(id == TIMER_WARM_UP)
+    {
+      _start_round_trips = _round_trips;
+      qti_bridge_get_stats(&_start_stats);
+      _start_time = tq_port_timestamp();
+      qti_system_start_timer(QTI_PING, TIMER_RUN, _run_time);
+      qti_system_start_timer(QTI_PING, TIMER_PROBE, PROBE_PERIOD);
+    }
+    else if(id == TIMER_RUN)
+    {
+      report();
+      exit(0);
+    }
+    else if(id == TIMER_PROBE)
+    {
+      sent = tq_port_timestamp();
+      tinyq_send_signal(QTI_PING, QTI_REMOTE_PONG, PONG_CMD_PROBE, &sent, sizeof(sent));
+      qti_system_start_timer(QTI_PING, TIMER_PROBE, PROBE_PERIOD);
+    }
+  }
+  else if(from == QTI_REMOTE_PONG && sig == PONG_RSP_ECHO)
+  {
+    _round_trips++;
+    tinyq_send_signal(QTI_PING, QTI_REMOTE_PONG, PONG_CMD_ECHO, p, size);
+  }
+  else if(from == QTI_REMOTE_PONG && sig == PONG_RSP_PROBE)
+  {
+    memcpy(&sent, p, sizeof(sent));
+    sent = tq_port_timestamp() - sent;
+    _probe_max = (sent > _probe_max) ? sent : _probe_max;
+  }
+}
+
+/* signals per frame back are those the coprocessor packed, seen from here */
+static void report(void)
+{
+  struct QTI_BRIDGE_STATS stats;
+  double seconds = (tq_port_timestamp() - _start_time) / (double)_PT_TIMESTAMP_FREQ;
+  uint32 tx_frames, rx_frames;
+
+  qti_bridge_get_stats(&stats);
+  tx_frames = stats.tx_frames - _start_stats.tx_frames;
+  rx_frames = stats.rx_frames - _start_stats.rx_frames;
+
+  printf("%9u %12.0f %10.2f %10.2f %10u %8u\n", _in_flight, (_round_trips - _start_round_trips) / seconds,
+         tx_frames ? (double)(stats.tx_signals - _start_stats.tx_signals) / tx_frames : 0.0,
+         rx_frames ? (double)(stats.rx_signals - _start_stats.rx_signals) / rx_frames : 0.0,
+         _probe_max, stats.crc_errors + stats.dropped + stats.stalls + stats.link_errors);
+  fflush(stdout);
+}
@@ -0,0 +1,21 @@
+/****************************************************************************
+  qti_pong.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Echoes what it gets back to the sender, a proxy when it came over the
+  bridge.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "qties.h"
+
+
+void qti_pong_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  if(sig == PONG_CMD_ECHO)
+    tinyq_send_signal(self->self, from, PONG_RSP_ECHO, p, size);
+  else if(sig == PONG_CMD_PROBE)
+    tinyq_send_signal(self->self, from, PONG_RSP_PROBE, p, size);
+}
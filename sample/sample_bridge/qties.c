@@ -0,0 +1,32 @@
+/****************************************************************************
+  qties.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "qti_system.h"
+#include "qti_bridge.h"
+
+const uint8 tq_qti_count = _QTI_COUNT_;
+
+
+/* table of Qties */
+const struct TQ_QTI tq_qti_table[_QTI_COUNT_] =
+{
+  {QTI_SYSTEM,        qti_system_signal_entry},
+  {QTI_BRIDGE,        qti_bridge_signal_entry},
+  {QTI_PING,          qti_ping_signal_entry},
+  {QTI_PONG,          qti_pong_signal_entry},
+  {QTI_REMOTE_PING,   qti_bridge_signal_entry},
+  {QTI_REMOTE_PONG,   qti_bridge_signal_entry},
+};
+
+/* proxies and the Qties they stand for */
+const struct QTI_BRIDGE_ROUTE qti_bridge_routes[] =
+{
+  {QTI_REMOTE_PING,   QTI_PING},
+  {QTI_REMOTE_PONG,   QTI_PONG},
+};
+
+const uint8 qti_bridge_route_count = sizeof(qti_bridge_routes) / sizeof(qti_bridge_routes[0]);
@@ -0,0 +1,28 @@
+/****************************************************************************
+  qties.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTIES_H
+#define QTIES_H
+
+/* both sides run the same table, a proxy stands for the Qti on the other side */
+enum e_QTIES
+{
+  QTI_SYSTEM = 0,
+  QTI_BRIDGE,
+  QTI_PING,
+  QTI_PONG,
+  QTI_REMOTE_PING,
+  QTI_REMOTE_PONG,
+  _QTI_COUNT_,
+};
+
+#define PONG_CMD_ECHO                       TQ_SIG_MAKE_CMD(TQ_DSP_NORMAL, 0)   /* p: echoed */
+#define PONG_RSP_ECHO                       TQ_SIG_MAKE_RSP(TQ_DSP_NORMAL, 0)
+#define PONG_CMD_PROBE                      TQ_SIG_MAKE_CMD(TQ_DSP_HIGH, 1)     /* p: timestamp, echoed */
+#define PONG_RSP_PROBE                      TQ_SIG_MAKE_RSP(TQ_DSP_HIGH, 1)
+
+extern void qti_ping_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+extern void qti_pong_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+#endif
@@ -0,0 +1,222 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of qti_bridge over hw_link on the simulated UART, the Qties of
+  sample_bridge on the virtual time port. The tx sink puts what the link
+  sends back on the rx line, so the bridge talks to itself: the ping Qti
+  keeps echo requests in flight to the pong Qti through the proxies and
+  probes it with a high priority signal every few milliseconds. Both ways
+  share the one line. Every count of requests in flight runs in a process
+  of its own.
+
+    R=../../tinyq
+    cc -O2 -I. -I../sample_bridge -I$R/core -I$R/misc -I$R/hw/sim -I$R/qties -o sample_bridge_uart [a-z]*.c \
+       ../sample_bridge/qties.c ../sample_bridge/qti_pong.c $R/core/[a-z]*.c $R/misc/[a-z]*.c \
+       $R/hw/sim/tq_port.c $R/hw/sim/hw_uart.c $R/hw/sim/hw_link.c $R/qties/qti_bridge.c
+    sample_bridge_uart [-b baud] [-k in flight] [-s param bytes] [-t ms] [-e bytes per error]
+
+  The frames, the window and the logic queue are those of a target. The
+  sink gets a buffer once its last byte is out, so every frame lands a
+  frame time late and the line idles about half the time with the window
+  of one frame. With -e a byte of every that many on the line is flipped,
+  a frame it hits is lost with the echoes in it and fewer stay in flight.
+
+  A line per count gives round trips per second, signals per frame, the
+  share of the line in use, the worst probe round trip and the CRC errors,
+  drops, stalls and failed opens of the link with the bytes the line lost.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "ring_buffer.h"
+#include "tq_context.h"
+#include "tq_sim.h"
+#include "hw_uart.h"
+#include "hw_link.h"
+#include "qti_bridge.h"
+#include "qties.h"
+
+#define WARM_UP_TIME                        (200)           /* ms */
+#define DEFAULT_RUN_TIME                    (2000)          /* ms */
+#define PROBE_PERIOD                        (5)             /* ms */
+
+#define DEFAULT_IN_FLIGHT                   (16)
+#define DEFAULT_PARAM_SIZE                  (8)
+
+#define TIMER_WARM_UP                       (1)
+#define TIMER_RUN                           (2)
+#define TIMER_PROBE                         (3)
+
+static void run(void);
+static void tx_sink(const uint8 *data, uint16 size);
+static void report(void);
+
+static uint32 _baud = HW_LINK_BAUD;
+static uint16 _in_flight;
+static uint8  _param_size = DEFAULT_PARAM_SIZE;
+static uint32 _run_time = DEFAULT_RUN_TIME;
+static uint32 _error_every;
+
+static unsigned long long _round_trips;
+static unsigned long long _start_round_trips;
+static struct QTI_BRIDGE_STATS _start_stats;
+static TQ_SIM_TIME _start_time;
+static uint32 _probe_max;
+
+static unsigned long long _line_bytes;
+static unsigned long long _start_line_bytes;
+static uint32 _line_lost;
+
+
+int main(int argc, char *argv[])
+{
+  uint16 max_in_flight = DEFAULT_IN_FLIGHT;
+  pid_t child;
+  int status;
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-b") && i + 1 < argc)
+      _baud = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      max_in_flight = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+      _param_size = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      _run_time = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-e") && i + 1 < argc)
+      _error_every = atoi(argv[++i]);
+  }
+  if(_baud < 1200 || !max_in_flight || max_in_flight > 1024 || !_run_time || _run_time > 60000)
+  {
+    fprintf(stderr, "baud from 1200, in flight 1 to 1024, run time 1 to 60000 ms\n");
+    return 1;
+  }
+  if(max_in_flight * (TQ_SIGNAL_HEADER_SIZE + _param_size) > TQ_LOGIC_BUFFER_SIZE / 2)
+  {
+    fprintf(stderr, "the logic queue of %u bytes holds too few requests\n", TQ_LOGIC_BUFFER_SIZE);
+    return 1;
+  }
+
+  printf("%u baud, %u bytes of param, frames of %u bytes, window %u, %u ms per run\n", _baud, _param_size,
+         BRIDGE_FRAME_SIZE, BRIDGE_WINDOW, _run_time);
+  printf("%9s %12s %10s %10s %10s %8s\n", "in flight", "round/s", "sig/frame", "line %", "probe us", "errors");
+  fflush(stdout);
+
+  for(_in_flight = 1; _in_flight <= max_in_flight; _in_flight *= 4)
+  {
+    /* tq_sim_run() once per process */
+    child = fork();
+    if(!child)
+    {
+      run();
+      exit(1);
+    }
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      return 1;
+  }
+  return 0;
+}
+
+/* the ping Qti exits once it has reported */
+static void run(void)
+{
+  hw_link_set_baud(_baud);
+  hw_uart_sim_set_tx_sink(tx_sink);
+  tq_sim_run((TQ_SIM_TIME)(WARM_UP_TIME + _run_time) * 2 * 1000);
+  fprintf(stderr, "the run did not end\n");
+}
+
+/* the line back to the link, the flipped byte lands as it would */
+static void tx_sink(const uint8 *data, uint16 size)
+{
+  uint8 line[HW_LINK_TX_SIZE];
+  uint16 i;
+
+  memcpy(line, data, size);
+  for(i = 0; i < size; i++)
+  {
+    if(_error_every && !(++_line_bytes % _error_every))
+      line[i] ^= 0x10;
+  }
+  if(!_error_every)
+    _line_bytes += size;
+  _line_lost += size - hw_uart_sim_receive(line, size);
+}
+
+void qti_ping_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint8 param[255];
+  uint32 sent;
+  uint16 i, id;
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    memset(param, 0x5a, sizeof(param));
+    for(i = 0; i < _in_flight; i++)
+      tinyq_send_signal(QTI_PING, QTI_REMOTE_PONG, PONG_CMD_ECHO, param, _param_size);
+    qti_system_start_timer(QTI_PING, TIMER_WARM_UP, WARM_UP_TIME);
+  }
+  else if(from == QTI_SYSTEM && sig == SYSTEM_RSP_TIMER)
+  {
+    id = *((uint16*)(p));
+    if(id == TIMER_WARM_UP)
+    {
+      _start_round_trips = _round_trips;
+      _start_line_bytes = _line_bytes;
+      qti_bridge_get_stats(&_start_stats);
+      _start_time = tq_sim_now();
+      qti_system_start_timer(QTI_PING, TIMER_RUN, _run_time);
+      qti_system_start_timer(QTI_PING, TIMER_PROBE, PROBE_PERIOD);
+    }
+    else if(id == TIMER_RUN)
+    {
+      report();
+      exit(0);
+    }
+    else if(id == TIMER_PROBE)
+    {
+      sent = tq_port_timestamp();
+      tinyq_send_signal(QTI_PING, QTI_REMOTE_PONG, PONG_CMD_PROBE, &sent, sizeof(sent));
+      qti_system_start_timer(QTI_PING, TIMER_PROBE, PROBE_PERIOD);
+    }
+  }
+  else if(from == QTI_REMOTE_PONG && sig == PONG_RSP_ECHO)
+  {
+    _round_trips++;
+    tinyq_send_signal(QTI_PING, QTI_REMOTE_PONG, PONG_CMD_ECHO, p, size);
+  }
+  else if(from == QTI_REMOTE_PONG && sig == PONG_RSP_PROBE)
+  {
+    memcpy(&sent, p, sizeof(sent));
+    sent = tq_port_timestamp() - sent;
+    _probe_max = (sent > _probe_max) ? sent : _probe_max;
+  }
+}
+
+/* a byte keeps the line ten bit times */
+static void report(void)
+{
+  struct QTI_BRIDGE_STATS stats;
+  double seconds = (tq_sim_now() - _start_time) / 1e6;
+  uint32 tx_frames;
+
+  qti_bridge_get_stats(&stats);
+  tx_frames = stats.tx_frames - _start_stats.tx_frames;
+
+  printf("%9u %12.0f %10.2f %10.1f %10u %8u\n", _in_flight, (_round_trips - _start_round_trips) / seconds,
+         tx_frames ? (double)(stats.tx_signals - _start_stats.tx_signals) / tx_frames : 0.0,
+         (_line_bytes - _start_line_bytes) * 10 * 100 / (_baud * seconds), _probe_max,
+         stats.crc_errors + stats.dropped + stats.stalls + stats.link_errors + _line_lost);
+  fflush(stdout);
+}
@@ -0,0 +1,302 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of curve_value() and curve_map() on the host, the temperature
+  of an NTC thermistor from a 12 bit ADC code as a BMS reads its cells.
+  Against them the usual ways: a binary search in a table of a code a
+  degree and a division between two entries, the same with the bit at a
+  time division of the runtime library of a Cortex-M0, and the Beta
+  equation in float. A second part seeks interpolator_set_pos() to random
+  positions, against the division it did before.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/posix -o sample_curve main.c \
+       $R/misc/curve.c $R/misc/interpolator.c -lm
+    sample_curve [-k rounds]
+
+  ntc_curve.h comes from tools/curve_compile.c:
+    curve_compile -ntc 3950 10000 10000 -e 10 -n _ntc_curve > ntc_curve.h
+
+  Errors are of the exact Beta equation in 0.01C over every code of the
+  curve. Cycles are of the time stamp counter on x86, elsewhere they read
+  0.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES()                            __rdtsc()
+#else
+#define CYCLES()                            (0ULL)
+#endif
+#include "tq_types.h"
+#include "curve.h"
+#include "interpolator.h"
+#include "ntc_curve.h"
+
+#define DEFAULT_ROUNDS                      (2000)
+#define CODES                               (4096)          /* a round, in a random order */
+#define BLOCK                               (64)            /* codes a curve_map() */
+
+/* of ntc_curve.h */
+#define NTC_BETA                            (3950.0)
+#define NTC_R25                             (10000.0)
+#define NTC_PULL_UP                         (10000.0)
+#define ADC_FULL                            (4095.0)
+#define T_MIN                               (-40)
+#define T_MAX                               (125)
+#define KELVIN                              (273.15)
+
+#define SEEK_TABLE_SIZE                     (64)
+
+typedef void (*CONVERT)(const uint16 *codes, int16 *t, uint16 n);
+
+static double exact(uint16 code);
+static uint16 code_of(double t);
+static uint32 soft_divide(uint32 n, uint32 d);
+static int16 search(uint16 code, boolean soft);
+static void convert_curve(const uint16 *codes, int16 *t, uint16 n);
+static void convert_map(const uint16 *codes, int16 *t, uint16 n);
+static void convert_search(const uint16 *codes, int16 *t, uint16 n);
+static void convert_soft_search(const uint16 *codes, int16 *t, uint16 n);
+static void convert_beta(const uint16 *codes, int16 *t, uint16 n);
+static void bench(const char *name, CONVERT convert, uint32 bytes);
+static void seek(void);
+
+static uint32 _rounds = DEFAULT_ROUNDS;
+static uint16 _codes[CODES];
+static int16  _t[CODES];
+static uint16 _degree_codes[T_MAX - T_MIN + 1];   /* falling, a degree apart */
+static volatile int32 _sink;
+
+/* the whole seek, then the division alone that it no longer does */
+static const char *_seek_names[] = {"  set_pos", "  divide", "  soft divide"};
+
+
+int main(int argc, char *argv[])
+{
+  uint32 seed = 1, c;
+  int i, t;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      _rounds = atoi(argv[++i]);
+  }
+  if(!_rounds)
+  {
+    fprintf(stderr, "at least a round\n");
+    return 1;
+  }
+
+  for(t = T_MIN; t <= T_MAX; t++)
+    _degree_codes[t - T_MIN] = code_of(t);
+  for(c = 0; c < CODES; c++)
+  {
+    seed = seed * 1103515245 + 12345;
+    _codes[c] = _ntc_curve.x_min + (seed >> 8) % (_ntc_curve.x_max - _ntc_curve.x_min + 1);
+  }
+
+  printf("%u rounds of %u codes, %u to %u, %d to %dC\n", _rounds, CODES, _ntc_curve.x_min, _ntc_curve.x_max, T_MIN, T_MAX);
+  printf("%-12s %8s %10s %10s %12s %8s\n", "method", "bytes", "cyc", "ns", "max err .01C", "at code");
+  bench("curve", convert_curve, _ntc_curve.slot_count * sizeof(struct S_CURVE_SLOT));
+  bench("curve map", convert_map, _ntc_curve.slot_count * sizeof(struct S_CURVE_SLOT));
+  bench("search", convert_search, sizeof(_degree_codes));
+  bench("soft search", convert_soft_search, sizeof(_degree_codes));
+  bench("beta float", convert_beta, 0);
+  seek();
+  return 0;
+}
+
+/* 0.01C */
+static double exact(uint16 code)
+{
+  double r = NTC_PULL_UP * code / (ADC_FULL - code);
+
+  return (1.0 / (1.0 / (25.0 + KELVIN) + log(r / NTC_R25) / NTC_BETA) - KELVIN) * 100.0;
+}
+
+static uint16 code_of(double t)
+{
+  double r = NTC_R25 * exp(NTC_BETA * (1.0 / (t + KELVIN) - 1.0 / (25.0 + KELVIN)));
+
+  return (uint16)floor(ADC_FULL * r / (r + NTC_PULL_UP) + 0.5);
+}
+
+/* shift and subtract, a bit of quotient a round */
+static uint32 soft_divide(uint32 n, uint32 d)
+{
+  uint32 q = 0, r = 0;
+  int8 bit;
+
+  for(bit = 31; bit >= 0; bit--)
+  {
+    r = (r << 1) | ((n >> bit) & 1);
+    if(r >= d)
+    {
+      r -= d;
+      q |= 1UL << bit;
+    }
+  }
+  return q;
+}
+
+/* the degree below, 0.01C between two codes of the table */
+static int16 search(uint16 code, boolean soft)
+{
+  uint16 lo = 0, hi = T_MAX - T_MIN, mid;
+  uint32 d, n;
+
+  if(code >= _degree_codes[lo])
+    return T_MIN * 100;
+  if(code <= _degree_codes[hi])
+    return T_MAX * 100;
+  while(hi - lo > 1)
+  {
+    mid = (lo + hi) >> 1;
+    if(_degree_codes[mid] > code)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  d = _degree_codes[lo] - _degree_codes[hi];
+  n = (_degree_codes[lo] - code) * 100 + d / 2;
+  return (int16)((T_MIN + lo) * 100 + (soft ? soft_divide(n, d) : n / d));
+}
+
+static void convert_curve(const uint16 *codes, int16 *t, uint16 n)
+{
+  uint16 i;
+
+  for(i = 0; i < n; i++)
+    t[i] = curve_value(&_ntc_curve, codes[i]);
+}
+
+static void convert_map(const uint16 *codes, int16 *t, uint16 n)
+{
+  uint16 i;
+
+  for(i = 0; i < n; i += BLOCK)
+    curve_map(&_ntc_curve, &codes[i], &t[i], (n - i < BLOCK) ? n - i : BLOCK);
+}
+
+static void convert_search(const uint16 *codes, int16 *t, uint16 n)
+{
+  uint16 i;
+
+  for(i = 0; i < n; i++)
+    t[i] = search(codes[i], FALSE);
+}
+
+static void convert_soft_search(const uint16 *codes, int16 *t, uint16 n)
+{
+  uint16 i;
+
+  for(i = 0; i < n; i++)
+    t[i] = search(codes[i], TRUE);
+}
+
+static void convert_beta(const uint16 *codes, int16 *t, uint16 n)
+{
+  float r;
+  uint16 i;
+
+  for(i = 0; i < n; i++)
+  {
+    r = (float)NTC_PULL_UP * codes[i] / ((float)ADC_FULL - codes[i]);
+    t[i] = (int16)lrintf((1.0f / (1.0f / (25.0f + (float)KELVIN) + logf(r / (float)NTC_R25) / (float)NTC_BETA)
+                          - (float)KELVIN) * 100.0f);
+  }
+}
+
+static void bench(const char *name, CONVERT convert, uint32 bytes)
+{
+  struct timespec t0, t1;
+  unsigned long long start, cycles;
+  double ns, error, worst = 0;
+  uint32 round, code, worst_code = 0;
+  uint16 c;
+  int16 t;
+
+  /* every code of the curve once for the error */
+  for(code = _ntc_curve.x_min; code <= _ntc_curve.x_max; code++)
+  {
+    c = code;
+    convert(&c, &t, 1);
+    error = fabs(t - exact(c));
+    if(error > worst)
+    {
+      worst = error;
+      worst_code = code;
+    }
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  start = CYCLES();
+  for(round = 0; round < _rounds; round++)
+  {
+    convert(_codes, _t, CODES);
+    _sink += _t[round % CODES];
+  }
+  cycles = CYCLES() - start;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+  printf("%-12s %8u %10.2f %10.2f %12.2f %8u\n", name, bytes, (double)cycles / ((double)_rounds * CODES),
+         ns / ((double)_rounds * CODES), worst, worst_code);
+}
+
+/* interpolator_set_pos() to random positions, slots as the division put them */
+static void seek(void)
+{
+  static const uint8 table[SEEK_TABLE_SIZE];
+  struct S_INTERPOLATOR itp;
+  struct timespec t0, t1;
+  unsigned long long start, cycles, seeks = 0;
+  uint32 round, i, wrong = 0;
+  uint32 f_x;
+  uint16 range_x;
+  uint8  how;
+  double ns;
+
+  for(range_x = SEEK_TABLE_SIZE; range_x < 65000; range_x += 997)
+  {
+    interpolator_init(&itp, range_x, 1000, table, SEEK_TABLE_SIZE);
+    for(i = 0; i < CODES; i++)
+    {
+      interpolator_set_pos(&itp, _codes[i] % (range_x + 1));
+      wrong += (itp.slot_index != ((uint32)(_codes[i] % (range_x + 1)) << 16) / itp.f_slot_width);
+    }
+  }
+
+  printf("%-12s %8s %10s %10s, %u seeks off the division\n", "seek", "", "cyc", "ns", wrong);
+  interpolator_init(&itp, 60000, 1000, table, SEEK_TABLE_SIZE);
+  for(how = 0; how < 3; how++)
+  {
+    seeks = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    start = CYCLES();
+    for(round = 0; round < _rounds; round++)
+    {
+      for(i = 0; i < CODES; i++)
+      {
+        f_x = (uint32)(_codes[i] * 14) << 16;
+        if(how == 0)
+          interpolator_set_pos(&itp, _codes[i] * 14);
+        else
+          itp.slot_index = (how == 1) ? f_x / itp.f_slot_width : soft_divide(f_x, itp.f_slot_width);
+        _sink += itp.slot_index;
+      }
+      seeks += CODES;
+    }
+    cycles = CYCLES() - start;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+    printf("%-21s %10.2f %10.2f\n", _seek_names[how], (double)cycles / seeks, ns / seeks);
+  }
+}
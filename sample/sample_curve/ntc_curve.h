@@ -0,0 +1,60 @@
+/****************************************************************************
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  _ntc_curve, generated by tools/curve_compile.c, do not edit.
+  NTC beta 3950, 10000 ohm at 25C, 10000 ohm pull up, 12 bit ADC, y in 1/100 C.
+****************************************************************************/
+#ifndef NTC_CURVE_H
+#define NTC_CURVE_H
+
+static const struct S_CURVE_SLOT _ntc_curve_slots[] =
+{
+  { 12496,   -440}, { 12056,   -391}, { 11665,   -351}, { 11314,   -318}, { 10996,   -291}, { 10705,   -268},
+  { 10437,   -248}, { 10189,   -231}, {  9958,   -216}, {  9742,   -203}, {  9539,   -191}, {  9348,   -180},
+  {  9168,   -172}, {  8996,   -162}, {  8834,   -155}, {  8679,   -149}, {  8530,   -141}, {  8389,   -136},
+  {  8253,   -131}, {  8122,   -125}, {  7997,   -121}, {  7876,   -117}, {  7759,   -113}, {  7646,   -109},
+  {  7537,   -106}, {  7431,   -102}, {  7329,    -99}, {  7230,    -97}, {  7133,    -94}, {  7039,    -91},
+  {  6948,    -89}, {  6859,    -87}, {  6772,    -84}, {  6688,    -83}, {  6605,    -81}, {  6524,    -79},
+  {  6445,    -77}, {  6368,    -75}, {  6293,    -74}, {  6219,    -72}, {  6147,    -71}, {  6076,    -70},
+  {  6006,    -68}, {  5938,    -67}, {  5871,    -66}, {  5805,    -65}, {  5740,    -64}, {  5676,    -62},
+  {  5614,    -62}, {  5552,    -60}, {  5492,    -60}, {  5432,    -59}, {  5373,    -58}, {  5315,    -57},
+  {  5258,    -56}, {  5202,    -55}, {  5147,    -55}, {  5092,    -54}, {  5038,    -53}, {  4985,    -53},
+  {  4932,    -52}, {  4880,    -51}, {  4829,    -51}, {  4778,    -50}, {  4728,    -50}, {  4678,    -49},
+  {  4629,    -48}, {  4581,    -48}, {  4533,    -48}, {  4485,    -47}, {  4438,    -46}, {  4392,    -47},
+  {  4345,    -45}, {  4300,    -45}, {  4255,    -45}, {  4210,    -45}, {  4165,    -44}, {  4121,    -43},
+  {  4078,    -44}, {  4034,    -43}, {  3991,    -42}, {  3949,    -42}, {  3907,    -42}, {  3865,    -42},
+  {  3823,    -41}, {  3782,    -41}, {  3741,    -41}, {  3700,    -41}, {  3659,    -40}, {  3619,    -40},
+  {  3579,    -40}, {  3539,    -39}, {  3500,    -39}, {  3461,    -39}, {  3422,    -39}, {  3383,    -38},
+  {  3345,    -39}, {  3306,    -38}, {  3268,    -38}, {  3230,    -38}, {  3192,    -37}, {  3155,    -38},
+  {  3117,    -37}, {  3080,    -37}, {  3043,    -37}, {  3006,    -37}, {  2969,    -36}, {  2933,    -37},
+  {  2896,    -36}, {  2860,    -36}, {  2824,    -36}, {  2788,    -36}, {  2752,    -36}, {  2716,    -36},
+  {  2680,    -35}, {  2645,    -36}, {  2609,    -35}, {  2574,    -35}, {  2539,    -36}, {  2503,    -35},
+  {  2468,    -35}, {  2433,    -35}, {  2398,    -35}, {  2363,    -35}, {  2328,    -34}, {  2294,    -35},
+  {  2259,    -35}, {  2224,    -34}, {  2190,    -35}, {  2155,    -35}, {  2120,    -34}, {  2086,    -35},
+  {  2051,    -34}, {  2017,    -35}, {  1982,    -34}, {  1948,    -34}, {  1914,    -35}, {  1879,    -34},
+  {  1845,    -35}, {  1810,    -34}, {  1776,    -34}, {  1742,    -35}, {  1707,    -34}, {  1673,    -35},
+  {  1638,    -34}, {  1604,    -35}, {  1569,    -34}, {  1535,    -35}, {  1500,    -34}, {  1466,    -35},
+  {  1431,    -35}, {  1396,    -35}, {  1361,    -35}, {  1326,    -35}, {  1291,    -35}, {  1256,    -35},
+  {  1221,    -35}, {  1186,    -35}, {  1151,    -36}, {  1115,    -35}, {  1080,    -36}, {  1044,    -35},
+  {  1009,    -36}, {   973,    -36}, {   937,    -36}, {   901,    -36}, {   865,    -37}, {   828,    -36},
+  {   792,    -37}, {   755,    -37}, {   718,    -37}, {   681,    -37}, {   644,    -37}, {   607,    -38},
+  {   569,    -38}, {   531,    -38}, {   493,    -38}, {   455,    -39}, {   416,    -38}, {   378,    -39},
+  {   339,    -40}, {   299,    -39}, {   260,    -40}, {   220,    -40}, {   180,    -40}, {   140,    -41},
+  {    99,    -41}, {    58,    -42}, {    16,    -42}, {   -26,    -42}, {   -68,    -42}, {  -110,    -43},
+  {  -153,    -44}, {  -197,    -44}, {  -241,    -44}, {  -285,    -45}, {  -330,    -45}, {  -375,    -46},
+  {  -421,    -47}, {  -468,    -47}, {  -515,    -47}, {  -562,    -49}, {  -611,    -49}, {  -660,    -49},
+  {  -709,    -51}, {  -760,    -51}, {  -811,    -52}, {  -863,    -53}, {  -916,    -53}, {  -969,    -55},
+  { -1024,    -56}, { -1080,    -57}, { -1137,    -58}, { -1195,    -59}, { -1254,    -60}, { -1314,    -62},
+  { -1376,    -63}, { -1439,    -65}, { -1504,    -66}, { -1570,    -68}, { -1638,    -70}, { -1708,    -72},
+  { -1780,    -74}, { -1854,    -76}, { -1930,    -80}, { -2010,    -81}, { -2091,    -85}, { -2176,    -89},
+  { -2265,    -92}, { -2357,    -96}, { -2453,   -100}, { -2553,   -106}, { -2659,   -112}, { -2771,   -118},
+  { -2889,   -126}, { -3015,   -134}, { -3149,   -146}, { -3295,   -157}, { -3452,   -174}, { -3626,   -192},
+  { -3818,   -217},
+};
+
+static const struct S_CURVE _ntc_curve =
+{
+  _ntc_curve_slots, 241, 142, 3995, 4,
+};
+
+#endif
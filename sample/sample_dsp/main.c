@@ -0,0 +1,261 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of the tinyq/dsp stages on the host, q15 and q31, a stage at a
+  time and all of them as one pipeline, the way a Qti runs a block. A
+  sanity line per filter checks gains against the design.
+
+    R=../../tinyq
+    cc -O3 -march=native -I$R/core -I$R/dsp -I$R/hw/posix -o sample_dsp main.c $R/dsp/[a-z]*.c -lm
+    sample_dsp [-n block samples] [-k blocks]
+
+  Build it again with -fno-tree-vectorize to see what SIMD brings. Cycles
+  are of the time stamp counter on x86, elsewhere they read 0.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES()                            __rdtsc()
+#else
+#define CYCLES()                            (0ULL)
+#endif
+#include "tq_types.h"
+#include "dsp.h"
+#include "dsp_filter.h"
+#include "dsp_measure.h"
+
+#define DEFAULT_BLOCK                       (128)
+#define DEFAULT_BLOCKS                      (20000)
+
+#define FIR_TAPS                            (32)
+#define FIR_CUTOFF                          (0.1)           /* of the sample rate */
+#define BIQUAD_SECTIONS                     (2)
+#define BIQUAD_CUTOFF                       (0.05)
+#define BIQUAD_POST_SHIFT                   (1)
+#define AVERAGE_SHIFT                       (4)
+#define SIGNAL_PERIOD                       (100)           /* samples */
+
+static void design(void);
+static void fill(uint16 count);
+static void bench(const char *name, struct DSP_STAGE *const stages[], uint8 stage_count, boolean q31);
+static void sanity(void);
+
+static q15 _fir_q15_coeffs[FIR_TAPS];
+static q31 _fir_q31_coeffs[FIR_TAPS];
+static q15 _biquad_q15_coeffs[BIQUAD_SECTIONS * 5];
+static q31 _biquad_q31_coeffs[BIQUAD_SECTIONS * 5];
+
+static q15 _fir_q15_state[DSP_FIR_STATE_SIZE(FIR_TAPS)];
+static q31 _fir_q31_state[DSP_FIR_STATE_SIZE(FIR_TAPS)];
+static q15 _biquad_q15_state[DSP_BIQUAD_STATE_SIZE(BIQUAD_SECTIONS)];
+static q31 _biquad_q31_state[DSP_BIQUAD_STATE_SIZE(BIQUAD_SECTIONS)];
+static q15 _average_q15_history[1 << AVERAGE_SHIFT];
+static q31 _average_q31_history[1 << AVERAGE_SHIFT];
+
+static struct DSP_FIR_Q15 _fir_q15;
+static struct DSP_FIR_Q31 _fir_q31;
+static struct DSP_BIQUAD_Q15 _biquad_q15;
+static struct DSP_BIQUAD_Q31 _biquad_q31;
+static struct DSP_AVERAGE_Q15 _average_q15;
+static struct DSP_AVERAGE_Q31 _average_q31;
+static struct DSP_RMS_Q15 _rms_q15;
+static struct DSP_RMS_Q31 _rms_q31;
+static struct DSP_MINMAX_Q15 _minmax_q15;
+static struct DSP_MINMAX_Q31 _minmax_q31;
+static struct DSP_THRESHOLD_Q15 _threshold_q15;
+static struct DSP_THRESHOLD_Q31 _threshold_q31;
+
+static uint16 _block = DEFAULT_BLOCK;
+static uint32 _blocks = DEFAULT_BLOCKS;
+static q15 *_input_q15, *_block_q15;
+static q31 *_input_q31, *_block_q31;
+
+
+int main(int argc, char *argv[])
+{
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-n") && i + 1 < argc)
+      _block = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      _blocks = atoi(argv[++i]);
+  }
+  if(!_block || _block > 4096 || !_blocks)
+  {
+    fprintf(stderr, "block 1 to 4096 samples\n");
+    return 1;
+  }
+
+  _input_q15 = malloc(_block * sizeof(q15));
+  _block_q15 = malloc(_block * sizeof(q15));
+  _input_q31 = malloc(_block * sizeof(q31));
+  _block_q31 = malloc(_block * sizeof(q31));
+  design();
+  fill(_block);
+
+  printf("blocks of %u samples, %u blocks a run\n", _block, _blocks);
+  printf("%-12s %10s %10s %10s %10s\n", "stage", "q15 cyc", "q15 ns", "q31 cyc", "q31 ns");
+  {
+    struct DSP_STAGE *fir[] = {&_fir_q15.stage, &_fir_q31.stage};
+    struct DSP_STAGE *biquad[] = {&_biquad_q15.stage, &_biquad_q31.stage};
+    struct DSP_STAGE *average[] = {&_average_q15.stage, &_average_q31.stage};
+    struct DSP_STAGE *rms[] = {&_rms_q15.stage, &_rms_q31.stage};
+    struct DSP_STAGE *minmax[] = {&_minmax_q15.stage, &_minmax_q31.stage};
+    struct DSP_STAGE *threshold[] = {&_threshold_q15.stage, &_threshold_q31.stage};
+    struct DSP_STAGE *pipeline_q15[] = {&_fir_q15.stage, &_biquad_q15.stage, &_average_q15.stage, &_rms_q15.stage,
+                                        &_minmax_q15.stage, &_threshold_q15.stage};
+    struct DSP_STAGE *pipeline_q31[] = {&_fir_q31.stage, &_biquad_q31.stage, &_average_q31.stage, &_rms_q31.stage,
+                                        &_minmax_q31.stage, &_threshold_q31.stage};
+
+    bench("fir", fir, 1, FALSE);
+    bench(0, fir + 1, 1, TRUE);
+    bench("biquad", biquad, 1, FALSE);
+    bench(0, biquad + 1, 1, TRUE);
+    bench("average", average, 1, FALSE);
+    bench(0, average + 1, 1, TRUE);
+    bench("rms", rms, 1, FALSE);
+    bench(0, rms + 1, 1, TRUE);
+    bench("minmax", minmax, 1, FALSE);
+    bench(0, minmax + 1, 1, TRUE);
+    bench("threshold", threshold, 1, FALSE);
+    bench(0, threshold + 1, 1, TRUE);
+    bench("pipeline", pipeline_q15, 6, FALSE);
+    bench(0, pipeline_q31, 6, TRUE);
+  }
+
+  sanity();
+  return 0;
+}
+
+/* windowed sinc FIR and Butterworth-ish RBJ low pass sections, a and b in the signs of dsp_filter.h */
+static void design(void)
+{
+  double h[FIR_TAPS], sum = 0, w, alpha, a0, b[3], a[2];
+  uint8 i, s;
+
+  for(i = 0; i < FIR_TAPS; i++)
+  {
+    w = i - (FIR_TAPS - 1) / 2.0;
+    h[i] = (w == 0 ? 2 * FIR_CUTOFF : sin(2 * M_PI * FIR_CUTOFF * w) / (M_PI * w)) *
+           (0.54 - 0.46 * cos(2 * M_PI * i / (FIR_TAPS - 1)));
+    sum += h[i];
+  }
+  for(i = 0; i < FIR_TAPS; i++)
+  {
+    _fir_q15_coeffs[FIR_TAPS - 1 - i] = (q15)lrint(h[i] / sum * 32767);
+    _fir_q31_coeffs[FIR_TAPS - 1 - i] = (q31)lrint(h[i] / sum * 2147483647.0);
+  }
+
+  w = 2 * M_PI * BIQUAD_CUTOFF;
+  alpha = sin(w) / (2 * 0.7071);
+  a0 = 1 + alpha;
+  b[0] = (1 - cos(w)) / 2 / a0;
+  b[1] = (1 - cos(w)) / a0;
+  b[2] = b[0];
+  a[0] = 2 * cos(w) / a0;
+  a[1] = -(1 - alpha) / a0;
+  for(s = 0; s < BIQUAD_SECTIONS; s++)
+  {
+    for(i = 0; i < 5; i++)
+    {
+      w = (i < 3 ? b[i] : a[i - 3]) / (1 << BIQUAD_POST_SHIFT);
+      _biquad_q15_coeffs[s * 5 + i] = (q15)lrint(w * 32767);
+      _biquad_q31_coeffs[s * 5 + i] = (q31)lrint(w * 2147483647.0);
+    }
+  }
+
+  dsp_fir_q15_init(&_fir_q15, _fir_q15_coeffs, FIR_TAPS, _fir_q15_state);
+  dsp_fir_q31_init(&_fir_q31, _fir_q31_coeffs, FIR_TAPS, _fir_q31_state);
+  dsp_biquad_q15_init(&_biquad_q15, _biquad_q15_coeffs, BIQUAD_SECTIONS, BIQUAD_POST_SHIFT, _biquad_q15_state);
+  dsp_biquad_q31_init(&_biquad_q31, _biquad_q31_coeffs, BIQUAD_SECTIONS, BIQUAD_POST_SHIFT, _biquad_q31_state);
+  dsp_average_q15_init(&_average_q15, AVERAGE_SHIFT, _average_q15_history);
+  dsp_average_q31_init(&_average_q31, AVERAGE_SHIFT, _average_q31_history);
+  dsp_rms_q15_init(&_rms_q15);
+  dsp_rms_q31_init(&_rms_q31);
+  dsp_minmax_q15_init(&_minmax_q15);
+  dsp_minmax_q31_init(&_minmax_q31);
+  dsp_threshold_q15_init(&_threshold_q15, 8192, -8192);
+  dsp_threshold_q31_init(&_threshold_q31, 8192L << 16, -(8192L << 16));
+}
+
+/* a slow sine at half scale with some noise on it */
+static void fill(uint16 count)
+{
+  double v;
+  uint16 i;
+
+  srand(1);
+  for(i = 0; i < count; i++)
+  {
+    v = 0.5 * sin(2 * M_PI * i / SIGNAL_PERIOD) + 0.1 * (rand() / (double)RAND_MAX - 0.5);
+    _input_q15[i] = (q15)lrint(v * 32767);
+    _input_q31[i] = (q31)lrint(v * 2147483647.0);
+  }
+}
+
+/* a copy of the input per block, timed apart */
+static void bench(const char *name, struct DSP_STAGE *const stages[], uint8 stage_count, boolean q31)
+{
+  unsigned long long cycles = 0, start;
+  struct timespec t0, t1;
+  double ns = 0;
+  uint32 i;
+
+  for(i = 0; i < _blocks; i++)
+  {
+    if(q31)
+      memcpy(_block_q31, _input_q31, _block * sizeof(q31));
+    else
+      memcpy(_block_q15, _input_q15, _block * sizeof(q15));
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    start = CYCLES();
+    dsp_run(stages, stage_count, q31 ? (void*)_block_q31 : (void*)_block_q15, _block);
+    cycles += CYCLES() - start;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    ns += (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+  }
+
+  if(name)
+    printf("%-12s %10.2f %10.2f", name, (double)cycles / _blocks / _block, ns / _blocks / _block);
+  else
+    printf(" %10.2f %10.2f\n", (double)cycles / _blocks / _block, ns / _blocks / _block);
+}
+
+/* DC through both filters, a period of a sine for the measures */
+static void sanity(void)
+{
+  struct DSP_STAGE *filters_q15[] = {&_fir_q15.stage, &_biquad_q15.stage};
+  struct DSP_STAGE *filters_q31[] = {&_fir_q31.stage, &_biquad_q31.stage};
+  struct DSP_STAGE *measures_q15[] = {&_rms_q15.stage, &_minmax_q15.stage, &_threshold_q15.stage};
+  uint16 i;
+
+  design();
+  for(i = 0; i < 20; i++)
+  {
+    uint16 k;
+
+    for(k = 0; k < _block; k++)
+    {
+      _block_q15[k] = 16384;
+      _block_q31[k] = 1L << 30;
+    }
+    dsp_run(filters_q15, 2, _block_q15, _block);
+    dsp_run(filters_q31, 2, _block_q31, _block);
+  }
+  printf("DC gain q15 %.4f q31 %.6f\n", _block_q15[_block - 1] / 16384.0, _block_q31[_block - 1] / (double)(1L << 30));
+
+  for(i = 0; i < _block; i++)
+    _block_q15[i] = (q15)lrint(16384 * sin(2 * M_PI * (i + 0.5) / _block));
+  dsp_run(measures_q15, 3, _block_q15, _block);
+  printf("sine of 0.5: rms %.4f (%.4f), min %d at %u, max %d at %u, %u up %u down\n", _rms_q15.rms / 32768.0,
+         0.5 / sqrt(2), _minmax_q15.min, _minmax_q15.min_index, _minmax_q15.max, _minmax_q15.max_index,
+         _threshold_q15.rising, _threshold_q15.falling);
+}
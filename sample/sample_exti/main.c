@@ -0,0 +1,344 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of the EXTI dispatch of tinyq/hw/stm32f030/hw_exti.c on the
+  virtual time port, over the register model of stm32f0xx.h. A contact on
+  PC13 is pressed and released with a bounce of random edges behind every
+  edge, the line takes them three ways:
+
+    callback  hw_exti_set(), a handler every interrupt, the one qti_button.c
+              had, which starts a debounce timer unless one runs
+    post      hw_exti_post() without a holdoff, a signal every interrupt
+    holdoff   hw_exti_post() with a holdoff, masked after the edge posted
+              and posted again settled if the level moved meanwhile
+
+  The interrupts, signals and timers each way are counted, and whether the
+  level last reported after a press is the one the contact rests at. Every
+  way runs in a process of its own. The scan of the pending bits is timed
+  the way invoke_irqs() did it, a bit at a time up to the highest, and
+  with a find-first-set as now.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/sim -I$R/hw/stm32f030 -o sample_exti [a-z]*.c \
+       $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/sim/tq_port.c $R/hw/stm32f030/hw_exti.c
+    sample_exti [-k presses] [-b max bounces] [-h holdoff ms]
+
+  The sim directory goes before stm32f030, its tq_port.h and hw_debug.h
+  are the ones taken. Cycles are of the time stamp counter on x86,
+  elsewhere they read 0.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES()                            __rdtsc()
+#else
+#define CYCLES()                            (0ULL)
+#endif
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_sim.h"
+#include "hw_exti.h"
+#include "stm32f0xx.h"
+#include "qties.h"
+
+#define DEFAULT_PRESSES                     (10000)
+#define DEFAULT_BOUNCES                     (30)
+#define DEFAULT_HOLDOFF                     (100)           /* ms */
+#define BUTTON_PORT                         EXTI_PortSourceGPIOC
+#define BUTTON_PIN                          EXTI_PinSource13
+#define PRESS_PERIOD                        (1000 * 1000)   /* us */
+#define PRESS_LENGTH                        (200 * 1000)    /* us */
+#define BOUNCE_GAP_MAX                      (300)           /* us between two bounces */
+#define LINES                               (16)
+#define SCAN_ROUNDS                         (1000000)
+
+#define SIG_EXTI_EDGE                       TQ_SIG_MAKE_NTF(TQ_DSP_HIGH, 1)     /* from hw_exti.c */
+#define TIMER_DEBOUNCE                      (1)
+#define SIM_IRQ_EDGE                        (0)
+
+#define MODE_CALLBACK                       (0)
+#define MODE_POST                           (1)
+#define MODE_HOLDOFF                        (2)
+#define MODES                               (3)
+
+struct EDGE
+{
+  unsigned long long time;                  /* us */
+  uint8  level;
+  boolean bounce;
+};
+
+struct COUNTS
+{
+  uint32 interrupts;
+  uint32 signals;
+  uint32 timers;
+  uint32 wrong;                             /* presses and releases left on a level not reported */
+};
+
+typedef uint32 (*SCAN)(uint32 flags);
+
+static uint32 random_next(void);
+static void bounce(void);
+static void run(void);
+static void edge_irq(uint8 irq, uint32 e);
+static void button_irq(void);
+static uint32 scan_bits(uint32 flags);
+static uint32 scan_ffs(uint32 flags);
+static double timed(SCAN scan, const uint32 *flags, unsigned long long *cycles);
+
+static const char *_mode_names[MODES] = {"callback", "post", "holdoff"};
+
+static const uint8 _debruijn_position[32] =
+{
+  0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+  31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9,
+};
+
+static uint32 _presses = DEFAULT_PRESSES;
+static uint32 _bounces = DEFAULT_BOUNCES;
+static uint32 _holdoff = DEFAULT_HOLDOFF;          /* ms */
+static uint32 _seed = 1;
+static struct EDGE *_edges;
+static uint32 _edge_count;
+static uint32 _handled[LINES];
+static uint8  _mode;
+
+/* the button */
+static uint8  _self;
+static uint8  _reported;
+static boolean _debouncing;
+static struct COUNTS _counts;
+
+
+int main(int argc, char *argv[])
+{
+  static uint32 single[SCAN_ROUNDS], multiple[SCAN_ROUNDS];
+  unsigned long long bits_cycles, ffs_cycles;
+  double bits_ns, ffs_ns;
+  uint32 r;
+  int i, status;
+  pid_t child;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      _presses = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-b") && i + 1 < argc)
+      _bounces = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-h") && i + 1 < argc)
+      _holdoff = atoi(argv[++i]);
+  }
+  if(!_presses || _holdoff * 1000 * 2 > PRESS_LENGTH)
+  {
+    fprintf(stderr, "a press at least, a holdoff within half a press\n");
+    return 1;
+  }
+
+  bounce();
+  printf("%u presses, up to %u bounces an edge, %u edges, holdoff %ums\n", _presses, _bounces, _edge_count,
+         _holdoff);
+  printf("%-10s %12s %12s %12s %8s\n", "mode", "interrupts", "signals", "timers", "wrong");
+  fflush(stdout);
+  for(_mode = 0; _mode < MODES; _mode++)
+  {
+    /* tq_sim_run() once per process */
+    child = fork();
+    if(!child)
+    {
+      run();
+      exit(0);
+    }
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      return 1;
+  }
+
+  /* the button line alone, then up to four of the lines pending at once */
+  for(r = 0; r < SCAN_ROUNDS; r++)
+  {
+    single[r] = 1UL << 13;
+    multiple[r] = (1UL << (random_next() % LINES)) | (1UL << (random_next() % LINES)) |
+                  (1UL << (random_next() % LINES)) | (1UL << (random_next() % LINES));
+  }
+  printf("%-10s %12s %12s %12s %12s\n", "pending", "scan cyc", "scan ns", "ffs cyc", "ffs ns");
+  bits_ns = timed(scan_bits, single, &bits_cycles);
+  ffs_ns = timed(scan_ffs, single, &ffs_cycles);
+  printf("%-10s %12.2f %12.2f %12.2f %12.2f\n", "line 13", (double)bits_cycles / SCAN_ROUNDS, bits_ns / SCAN_ROUNDS,
+         (double)ffs_cycles / SCAN_ROUNDS, ffs_ns / SCAN_ROUNDS);
+  bits_ns = timed(scan_bits, multiple, &bits_cycles);
+  ffs_ns = timed(scan_ffs, multiple, &ffs_cycles);
+  printf("%-10s %12.2f %12.2f %12.2f %12.2f\n", "random 4", (double)bits_cycles / SCAN_ROUNDS, bits_ns / SCAN_ROUNDS,
+         (double)ffs_cycles / SCAN_ROUNDS, ffs_ns / SCAN_ROUNDS);
+  return 0;
+}
+
+static uint32 random_next(void)
+{
+  _seed = _seed * 1103515245 + 12345;
+  return _seed >> 8;
+}
+
+/* a press and a release a period, each edge followed by its bounces, from a period in */
+static void bounce(void)
+{
+  unsigned long long time;
+  uint32 p, b, n;
+  uint8 level;
+
+  _edges = malloc((size_t)_presses * 2 * (_bounces + 1) * sizeof(struct EDGE));
+  for(p = 0; p < _presses; p++)
+  {
+    for(level = 0; level < 2; level++)
+    {
+      time = (unsigned long long)(p + 1) * PRESS_PERIOD + level * PRESS_LENGTH;
+      _edges[_edge_count].time = time;
+      _edges[_edge_count].bounce = FALSE;
+      _edges[_edge_count++].level = !level;
+      n = _bounces ? random_next() % (_bounces + 1) : 0;
+      n &= ~1UL;                            /* comes to rest where it went */
+      for(b = 0; b < n; b++)
+      {
+        time += 1 + random_next() % BOUNCE_GAP_MAX;
+        _edges[_edge_count].time = time;
+        _edges[_edge_count].bounce = TRUE;
+        _edges[_edge_count++].level = (b & 1) ? !level : level;
+      }
+    }
+  }
+}
+
+static void run(void)
+{
+  tq_sim_set_irq_handler(SIM_IRQ_EDGE, edge_irq);
+  tq_sim_raise_irq(_edges[0].time, SIM_IRQ_EDGE, 0);
+  tq_sim_run((unsigned long long)(_presses + 2) * PRESS_PERIOD);
+
+  /* the level of the last release */
+  if(_reported != ((sim_gpio[BUTTON_PORT].regs.IDR >> BUTTON_PIN) & 1))
+    _counts.wrong++;
+  printf("%-10s %12u %12u %12u %8u\n", _mode_names[_mode], _counts.interrupts, _counts.signals, _counts.timers,
+         _counts.wrong);
+  fflush(stdout);
+}
+
+/* the board, an edge at a time, the next scheduled from this one */
+static void edge_irq(uint8 irq, uint32 e)
+{
+  /* the level a press or a release rests at, before the next one */
+  if(e && !_edges[e].bounce && _reported != ((sim_gpio[BUTTON_PORT].regs.IDR >> BUTTON_PIN) & 1))
+    _counts.wrong++;
+
+  if(sim_exti_edge(BUTTON_PORT, BUTTON_PIN, _edges[e].level))
+    _counts.interrupts++;
+  if(e + 1 < _edge_count)
+    tq_sim_raise_irq(_edges[e + 1].time, SIM_IRQ_EDGE, e + 1);
+}
+
+/* the callback reports the level when its timer expires, a post the level of every signal */
+void qti_button_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  struct S_STM32_EXTI_EDGE edge;
+  uint16 timer_id;
+
+  if(from != QTI_SYSTEM)
+    return;
+
+  if(sig == SYSTEM_NTF_START)
+  {
+    _self = self->self;
+    if(_mode == MODE_CALLBACK)
+      hw_exti_set(BUTTON_PORT, BUTTON_PIN, EXTI_Trigger_Rising_Falling, button_irq);
+    else
+      hw_exti_post(BUTTON_PORT, BUTTON_PIN, EXTI_Trigger_Rising_Falling, _self, SIG_EXTI_EDGE,
+                   (_mode == MODE_HOLDOFF) ? _holdoff : 0);
+  }
+  else if(sig == SYSTEM_RSP_TIMER)
+  {
+    memcpy(&timer_id, p, sizeof(timer_id));
+    _counts.timers++;
+    if(timer_id == TIMER_DEBOUNCE)
+    {
+      _debouncing = FALSE;
+      _reported = (sim_gpio[BUTTON_PORT].regs.IDR >> BUTTON_PIN) & 1;
+    }
+    else
+      hw_exti_timer_expired(timer_id);
+  }
+  else if(sig == SIG_EXTI_EDGE)
+  {
+    memcpy(&edge, p, sizeof(edge));
+    _counts.signals++;
+    hw_exti_holdoff(&edge);
+    _reported = edge.level;
+  }
+}
+
+/* in the interrupt */
+static void button_irq(void)
+{
+  if(_debouncing)
+    return;
+  _debouncing = TRUE;
+  qti_system_start_timer(_self, TIMER_DEBOUNCE, _holdoff);
+}
+
+/* invoke_irqs() as it was */
+static uint32 scan_bits(uint32 flags)
+{
+  uint32 mask = 1, handled = 0;
+  uint8 i;
+
+  for(i = 0; i < LINES; i++)
+  {
+    if(!flags)
+      break;
+    if(flags & 1)
+    {
+      _handled[i]++;
+      handled |= mask;
+    }
+    flags >>= 1;
+    mask <<= 1;
+  }
+  return handled;
+}
+
+/* invoke_irqs() now */
+static uint32 scan_ffs(uint32 flags)
+{
+  uint32 bit, handled = 0;
+
+  while(flags)
+  {
+    bit = flags & (0 - flags);
+    flags ^= bit;
+    _handled[_debruijn_position[(uint32)(bit * 0x077CB531UL) >> 27]]++;
+    handled |= bit;
+  }
+  return handled;
+}
+
+static double timed(SCAN scan, const uint32 *flags, unsigned long long *cycles)
+{
+  struct timespec t0, t1;
+  unsigned long long start;
+  volatile uint32 sink = 0;
+  uint32 r;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  start = CYCLES();
+  for(r = 0; r < SCAN_ROUNDS; r++)
+    sink += scan(flags[r]);
+  *cycles = CYCLES() - start;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
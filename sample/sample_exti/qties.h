@@ -0,0 +1,17 @@
+/****************************************************************************
+  qties.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTIES_H
+#define QTIES_H
+
+enum e_QTIES
+{
+  QTI_SYSTEM = 0,
+  QTI_BUTTON,
+  _QTI_COUNT_
+};
+
+extern void qti_button_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+#endif
@@ -0,0 +1,91 @@
+/****************************************************************************
+  stm32f0xx.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "stm32f0xx.h"
+
+#define PR_READ                             (0x80000000UL)  /* no line, set in PR till it is written */
+
+static EXTI_TypeDef _exti;
+static uint32 _pending;
+static uint8  _line_port[16];
+static uint32 _nvic_enabled;                /* bit per IRQn */
+
+union SIM_GPIO_PORT sim_gpio[SIM_GPIO_PORTS];
+
+
+EXTI_TypeDef *sim_exti(void)
+{
+  if(!(_exti.PR & PR_READ))
+    _pending &= ~_exti.PR;
+  _exti.PR = _pending | PR_READ;
+  return &_exti;
+}
+
+void EXTI_Init(EXTI_InitTypeDef *EXTI_InitStruct)
+{
+  EXTI_TypeDef *exti = sim_exti();
+  uint32 line = EXTI_InitStruct->EXTI_Line;
+
+  if(EXTI_InitStruct->EXTI_LineCmd == DISABLE)
+  {
+    exti->IMR &= ~line;
+    return;
+  }
+
+  exti->IMR &= ~line;
+  exti->EMR &= ~line;
+  if(EXTI_InitStruct->EXTI_Mode == EXTI_Mode_Interrupt)
+    exti->IMR |= line;
+  else
+    exti->EMR |= line;
+
+  exti->RTSR &= ~line;
+  exti->FTSR &= ~line;
+  if(EXTI_InitStruct->EXTI_Trigger != EXTI_Trigger_Falling)
+    exti->RTSR |= line;
+  if(EXTI_InitStruct->EXTI_Trigger != EXTI_Trigger_Rising)
+    exti->FTSR |= line;
+}
+
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct)
+{
+  if(NVIC_InitStruct->NVIC_IRQChannelCmd == ENABLE)
+    _nvic_enabled |= 1UL << NVIC_InitStruct->NVIC_IRQChannel;
+  else
+    _nvic_enabled &= ~(1UL << NVIC_InitStruct->NVIC_IRQChannel);
+}
+
+void SYSCFG_EXTILineConfig(uint8_t EXTI_PortSourceGPIOx, uint8_t EXTI_PinSourcex)
+{
+  _line_port[EXTI_PinSourcex & 0x0f] = EXTI_PortSourceGPIOx;
+}
+
+/* an edge sets the pending bit whether the line is masked or not, as on the chip, TRUE when it interrupted */
+boolean sim_exti_edge(uint8 port, uint8 pin, uint8 level)
+{
+  EXTI_TypeDef *exti = sim_exti();
+  uint32 bit = 1UL << pin;
+  uint8 irqn = (pin < 2) ? EXTI0_1_IRQn : (pin < 4) ? EXTI2_3_IRQn : EXTI4_15_IRQn;
+
+  if(level)
+    sim_gpio[port].regs.IDR |= (uint16)bit;
+  else
+    sim_gpio[port].regs.IDR &= (uint16)~bit;
+
+  if(_line_port[pin] != port || !((level ? exti->RTSR : exti->FTSR) & bit))
+    return FALSE;
+  _pending |= bit;
+  sim_exti();
+
+  if(!(_pending & exti->IMR & bit) || !(_nvic_enabled & (1UL << irqn)))
+    return FALSE;
+  if(irqn == EXTI0_1_IRQn)
+    EXTI0_1_IRQHandler();
+  else if(irqn == EXTI2_3_IRQn)
+    EXTI2_3_IRQHandler();
+  else
+    EXTI4_15_IRQHandler();
+  return TRUE;
+}
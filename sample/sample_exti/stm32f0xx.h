@@ -0,0 +1,113 @@
+/****************************************************************************
+  stm32f0xx.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef STM32F0XX_H
+#define STM32F0XX_H
+
+/*
+  Host model of what tinyq/hw/stm32f030/hw_exti.c takes of the device and
+  the StdPeriph drivers: the EXTI lines, IDR of the GPIO ports and the
+  NVIC enables. The stm32f0xx_*.h next to this one stand in for the
+  driver headers. EXTI goes through sim_exti(), which applies what was
+  written to PR since the last access as a write one to clear; PR reads
+  with bit 31 set to tell a write, no line of the F030 has it.
+
+  sim_exti_edge() is the board, it moves a pin and takes the interrupt of
+  its line if that is pending, unmasked and enabled, TRUE then.
+*/
+#include <stdint.h>
+#include "tq_types.h"
+
+#define SIM_GPIO_PORTS                      (6)             /* A to F */
+
+typedef enum {DISABLE = 0, ENABLE = !DISABLE} FunctionalState;
+
+typedef enum
+{
+  EXTI0_1_IRQn = 5,
+  EXTI2_3_IRQn = 6,
+  EXTI4_15_IRQn = 7,
+} IRQn_Type;
+
+typedef struct
+{
+  volatile uint32_t IMR;
+  volatile uint32_t EMR;
+  volatile uint32_t RTSR;
+  volatile uint32_t FTSR;
+  volatile uint32_t SWIER;
+  volatile uint32_t PR;
+} EXTI_TypeDef;
+
+typedef struct
+{
+  volatile uint32_t MODER;
+  volatile uint16_t OTYPER;
+  uint16_t RESERVED0;
+  volatile uint32_t OSPEEDR;
+  volatile uint32_t PUPDR;
+  volatile uint16_t IDR;
+  uint16_t RESERVED1;
+  volatile uint16_t ODR;
+  uint16_t RESERVED2;
+} GPIO_TypeDef;
+
+/* a port in 0x400 bytes, as they are laid out */
+union SIM_GPIO_PORT
+{
+  GPIO_TypeDef regs;
+  uint8_t space[0x400];
+};
+
+typedef struct
+{
+  uint8_t NVIC_IRQChannel;
+  uint8_t NVIC_IRQChannelPriority;
+  FunctionalState NVIC_IRQChannelCmd;
+} NVIC_InitTypeDef;
+
+typedef enum
+{
+  EXTI_Mode_Interrupt = 0x00,
+  EXTI_Mode_Event = 0x04
+} EXTIMode_TypeDef;
+
+typedef enum
+{
+  EXTI_Trigger_Rising = 0x08,
+  EXTI_Trigger_Falling = 0x0C,
+  EXTI_Trigger_Rising_Falling = 0x10
+} EXTITrigger_TypeDef;
+
+typedef struct
+{
+  uint32_t EXTI_Line;
+  EXTIMode_TypeDef EXTI_Mode;
+  EXTITrigger_TypeDef EXTI_Trigger;
+  FunctionalState EXTI_LineCmd;
+} EXTI_InitTypeDef;
+
+#define EXTI_PortSourceGPIOA                ((uint8_t)0x00)
+#define EXTI_PortSourceGPIOB                ((uint8_t)0x01)
+#define EXTI_PortSourceGPIOC                ((uint8_t)0x02)
+#define EXTI_PinSource13                    ((uint8_t)0x0D)
+
+extern union SIM_GPIO_PORT sim_gpio[SIM_GPIO_PORTS];
+
+#define GPIOA_BASE                          ((uintptr_t)sim_gpio)
+#define EXTI                                (sim_exti())
+
+extern EXTI_TypeDef *sim_exti(void);
+extern void EXTI_Init(EXTI_InitTypeDef *EXTI_InitStruct);
+extern void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct);
+extern void SYSCFG_EXTILineConfig(uint8_t EXTI_PortSourceGPIOx, uint8_t EXTI_PinSourcex);
+
+extern boolean sim_exti_edge(uint8 port, uint8 pin, uint8 level);
+
+/* of hw_exti.c */
+extern void EXTI0_1_IRQHandler(void);
+extern void EXTI2_3_IRQHandler(void);
+extern void EXTI4_15_IRQHandler(void);
+
+#endif
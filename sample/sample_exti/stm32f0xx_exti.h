@@ -0,0 +1,11 @@
+/****************************************************************************
+  stm32f0xx_exti.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef STM32F0XX_EXTI_H
+#define STM32F0XX_EXTI_H
+
+/* in the model of stm32f0xx.h */
+#include "stm32f0xx.h"
+
+#endif
@@ -0,0 +1,171 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of fd signal sources on the POSIX port (tq_fd.h). Thousands of
+  eventfds are registered with the loop, relay Qties pass a number of
+  tokens between them at random, every hop is a readiness signal through
+  epoll. Every fd count runs in a process of its own.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/posix \
+       -o sample_fd [a-z]*.c $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/posix/tq_port.c
+    sample_fd [-n fds] [-k tokens] [-t ms]
+
+  A line per fd count gives fd events per second, the time per event,
+  tokens per event, more than one when tokens meet on a fd, and the tokens
+  a failed write lost, a run losing any fails.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "tq_fd.h"
+#include "qties.h"
+
+#define FDS_MAX                             (16 * 1024)
+#define DEFAULT_FDS                         (4096)
+#define DEFAULT_TOKENS                      (64)
+#define WARM_UP_TIME                        (200)           /* ms */
+#define DEFAULT_RUN_TIME                    (1000)          /* ms */
+
+#define TIMER_WARM_UP                       (1)
+#define TIMER_RUN                           (2)
+
+static boolean report(void);
+
+int32  relay_fds[FDS_MAX];
+uint32 relay_fd_count;
+
+static uint32 _tokens = DEFAULT_TOKENS;
+static uint32 _run_time = DEFAULT_RUN_TIME;
+
+static unsigned long long _start_events;
+static unsigned long long _start_tokens;
+static uint32 _start_time;
+
+
+int main(int argc, char *argv[])
+{
+  uint32 max_fds = DEFAULT_FDS, i;
+  struct rlimit limit;
+  int status;
+  pid_t child;
+
+  for(i = 1; i < (uint32)argc; i++)
+  {
+    if(!strcmp(argv[i], "-n") && i + 1 < (uint32)argc)
+      max_fds = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-k") && i + 1 < (uint32)argc)
+      _tokens = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < (uint32)argc)
+      _run_time = atoi(argv[++i]);
+  }
+  if(max_fds < 16 || max_fds > FDS_MAX || !_tokens || !_run_time || _run_time > 2000)
+  {
+    fprintf(stderr, "fds 16 to %u, run time 1 to 2000 ms\n", FDS_MAX);
+    return 1;
+  }
+
+  /* room for the eventfds */
+  if(!getrlimit(RLIMIT_NOFILE, &limit) && limit.rlim_cur < max_fds + 64)
+  {
+    limit.rlim_cur = (limit.rlim_max < max_fds + 64) ? limit.rlim_max : max_fds + 64;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    if(limit.rlim_cur < max_fds + 64)
+      max_fds = limit.rlim_cur - 64;
+  }
+
+  printf("%u tokens, %u ms per run\n", _tokens, _run_time);
+  printf("%7s %14s %10s %12s %8s\n", "fds", "events/s", "ns/event", "tokens/event", "lost");
+  fflush(stdout);
+
+  /* tinyq never returns, a run per process */
+  for(relay_fd_count = 16; relay_fd_count <= max_fds; relay_fd_count *= 4)
+  {
+    child = fork();
+    if(!child)
+    {
+      for(i = 0; i < relay_fd_count; i++)
+      {
+        relay_fds[i] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if(relay_fds[i] < 0)
+        {
+          perror("eventfd");
+          exit(1);
+        }
+      }
+      tinyq_run();
+    }
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      return 1;
+  }
+  return 0;
+}
+
+void qti_bench_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  unsigned long long one = 1;
+  uint32 i;
+  uint16 id;
+
+  if(from != QTI_SYSTEM)
+    return;
+
+  if(sig == SYSTEM_NTF_START)
+  {
+    for(i = 0; i < relay_fd_count; i++)
+    {
+      if(!tq_fd_add(relay_fds[i], TQ_FD_IN, QTI_RELAY + i % RELAY_COUNT, RELAY_NTF_FD))
+      {
+        perror("tq_fd_add");
+        exit(1);
+      }
+    }
+    for(i = 0; i < _tokens; i++)
+    {
+      if(write(relay_fds[(i * 7919) % relay_fd_count], &one, sizeof(one)) != sizeof(one))
+      {
+        perror("write");
+        exit(1);
+      }
+    }
+    qti_system_start_timer(QTI_BENCH, TIMER_WARM_UP, WARM_UP_TIME);
+  }
+  else if(sig == SYSTEM_RSP_TIMER)
+  {
+    id = *((uint16*)(p));
+    if(id == TIMER_WARM_UP)
+    {
+      _start_events = relay_events;
+      _start_tokens = relay_tokens;
+      _start_time = tq_port_timestamp();
+      qti_system_start_timer(QTI_BENCH, TIMER_RUN, _run_time);
+    }
+    else if(id == TIMER_RUN)
+    {
+      exit(report() ? 0 : 1);
+    }
+  }
+}
+
+/* FALSE when a token was lost, the relays ran with fewer than set */
+static boolean report(void)
+{
+  unsigned long long events = relay_events - _start_events;
+  double seconds = (tq_port_timestamp() - _start_time) / (double)_PT_TIMESTAMP_FREQ;
+
+  printf("%7u %14.0f %10.0f %12.2f %8llu\n", relay_fd_count, events / seconds, events ? seconds * 1e9 / events : 0.0,
+         events ? (double)(relay_tokens - _start_tokens) / events : 0.0, relay_lost);
+  fflush(stdout);
+  return relay_lost ? FALSE : TRUE;
+}
@@ -0,0 +1,51 @@
+/****************************************************************************
+  qti_relay.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Takes the tokens written to its eventfds and writes each on to an
+  eventfd picked at random, every token is an event of some fd.
+****************************************************************************/
+#include <unistd.h>
+#include <errno.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_fd.h"
+#include "qties.h"
+
+static uint32 _seeds[RELAY_COUNT] = {1, 2, 3, 4, 5, 6, 7, 8};
+
+unsigned long long relay_events;
+unsigned long long relay_tokens;
+unsigned long long relay_lost;
+
+
+void qti_relay_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint32 *seed = &_seeds[self->self - QTI_RELAY];
+  const struct TQ_FD_EVENT *event;
+  unsigned long long tokens, one = 1;
+
+  if(from != QTI_SYSTEM || sig != RELAY_NTF_FD)
+    return;
+
+  /* a read takes the whole count of an eventfd, the next would be EAGAIN */
+  event = (const struct TQ_FD_EVENT *)p;
+  if(read(event->fd, &tokens, sizeof(tokens)) != sizeof(tokens))
+  {
+    TQ_ASSERT(errno == EAGAIN);
+    return;
+  }
+
+  relay_events++;
+  relay_tokens += tokens;
+  while(tokens--)
+  {
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 17;
+    *seed ^= *seed << 5;
+    if(write(relay_fds[*seed % relay_fd_count], &one, sizeof(one)) != sizeof(one))
+      relay_lost++;
+  }
+}
@@ -0,0 +1,26 @@
+/****************************************************************************
+  qties.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "qti_system.h"
+
+const uint8 tq_qti_count = _QTI_COUNT_;
+
+
+/* table of Qties */
+const struct TQ_QTI tq_qti_table[_QTI_COUNT_] =
+{
+  {QTI_SYSTEM,        qti_system_signal_entry},
+  {QTI_BENCH,         qti_bench_signal_entry},
+  {QTI_RELAY + 0,     qti_relay_signal_entry},
+  {QTI_RELAY + 1,     qti_relay_signal_entry},
+  {QTI_RELAY + 2,     qti_relay_signal_entry},
+  {QTI_RELAY + 3,     qti_relay_signal_entry},
+  {QTI_RELAY + 4,     qti_relay_signal_entry},
+  {QTI_RELAY + 5,     qti_relay_signal_entry},
+  {QTI_RELAY + 6,     qti_relay_signal_entry},
+  {QTI_RELAY + 7,     qti_relay_signal_entry},
+};
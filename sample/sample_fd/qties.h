@@ -0,0 +1,30 @@
+/****************************************************************************
+  qties.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTIES_H
+#define QTIES_H
+
+#define RELAY_COUNT                         (8)
+
+enum e_QTIES
+{
+  QTI_SYSTEM = 0,
+  QTI_BENCH,
+  QTI_RELAY,                                /* RELAY_COUNT of them */
+  _QTI_COUNT_ = QTI_RELAY + RELAY_COUNT,
+};
+
+#define RELAY_NTF_FD                        TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 0)   /* p: struct TQ_FD_EVENT */
+
+extern void qti_bench_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+extern void qti_relay_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+/* eventfds of the run, the relays pass tokens between them */
+extern int32  relay_fds[];
+extern uint32 relay_fd_count;
+extern unsigned long long relay_events;
+extern unsigned long long relay_tokens;
+extern unsigned long long relay_lost;          /* tokens a write failed to pass on */
+
+#endif
@@ -0,0 +1,440 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of qti_input on the virtual time port, a panel of 1, 4 and 12
+  keys pressed at random with a bounce of random edges behind every edge.
+  Now and then more keys go down while one is held, up to four at once.
+  Two ways take the same presses:
+
+    per key   a debounce timer and a hold timer a key, an interrupt every
+              edge starting the timer of its key unless it runs, the way
+              qti_button.c took its one button
+    scan      qti_input, one timer for all keys, armed on the edges only
+              while every key is still
+
+  The first REPEAT_KEYS keys repeat when held, the others report a long
+  press. A key debounces for as long as the scans take. Every key count
+  and way runs in a process of its own.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/sim -I$R/qties -o sample_input [a-z]*.c \
+       $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/sim/tq_port.c $R/hw/sim/hw_input.c $R/qties/qti_input.c
+    sample_input [-k presses] [-b max bounces] [-s scan period ms] [-d debounce scans]
+
+  A line per run gives the interrupts, timer expiries and the wakeups of
+  both a key press, the most timer slots taken at once and the events
+  reported. The presses, releases, long presses and repeats the script
+  holds come first, a repeat or a long press right at its threshold may
+  go either way.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "ring_buffer.h"
+#include "qti_system.h"
+#include "tq_context.h"
+#include "tq_sim.h"
+#include "hw_input.h"
+#include "qti_input.h"
+#include "qties.h"
+
+#define DEFAULT_PRESSES                     (1000)
+#define DEFAULT_BOUNCES                     (10)
+#define BOUNCE_GAP_MAX                      (1000)          /* us between two bounces */
+#define PRESS_MIN                           (40)            /* ms */
+#define PRESS_SPREAD                        (1500)          /* ms */
+#define PAUSE_MIN                           (200)           /* ms between two presses */
+#define PAUSE_SPREAD                        (800)
+#define CHORD_MAX                           (3)             /* keys more down at once */
+
+#define KEYS_MAX                            (12)
+#define KEYS_PORT_A                         (6)             /* PA0..PA5, then PB6..PB11 */
+#define REPEAT_KEYS                         (4)
+#define DEFAULT_SCAN_PERIOD                 (10)            /* ms */
+#define DEFAULT_DEBOUNCE_SCANS              (2)
+#define LONG_PRESS                          (800)
+#define REPEAT_PERIOD                       (150)
+
+#define MODE_PER_KEY                        (0)
+#define MODE_SCAN                           (1)
+#define MODES                               (2)
+
+#define TIMER_DEBOUNCE(KEY)                 (0x10 + (KEY))
+#define TIMER_HOLD(KEY)                     (0x30 + (KEY))
+
+/* of the events, INPUT_NTF_PRESS and on */
+#define EVENT_PRESS                         (0)
+#define EVENT_RELEASE                       (1)
+#define EVENT_LONG                          (2)
+#define EVENT_REPEAT                        (3)
+#define EVENTS                              (4)
+
+struct EDGE
+{
+  TQ_SIM_TIME time;
+  uint32 order;                             /* the times of two keys may meet */
+  uint8  key;
+  uint8  level;                             /* 1 pressed */
+};
+
+static uint32 random_next(void);
+static void script_build(void);
+static void script_press(TQ_SIM_TIME time, uint8 key, uint32 length);
+static void script_edge(TQ_SIM_TIME time, uint8 key, uint8 level);
+static int compare_edges(const void *a, const void *b);
+static boolean script_next(struct HW_INPUT_SIM_CHANGE *change);
+static void run(void);
+static void count_slots(void);
+static void key_irq(void);
+static uint32 key_read(void);
+static void key_timer(uint16 timer_id);
+static void key_event(uint8 event, uint8 key);
+
+static const char *_mode_names[MODES] = {"per key", "scan"};
+static const uint8 _key_counts[] = {1, 4, KEYS_MAX};
+
+static uint32 _presses = DEFAULT_PRESSES;
+static uint32 _bounces = DEFAULT_BOUNCES;
+static uint32 _seed = 1;
+static uint16 _scan_period = DEFAULT_SCAN_PERIOD;
+static uint8  _debounce_scans = DEFAULT_DEBOUNCE_SCANS;
+static uint16 _debounce_period;             /* of a key, the scans take as long */
+static uint8  _keys;
+static uint8  _mode;
+
+static struct EDGE *_edges;
+static uint32 _edge_count;
+static uint32 _edge_next;
+static uint16 _port_levels[2];
+static uint32 _expected[EVENTS];
+static TQ_SIM_TIME _end;
+
+static struct QTI_INPUT_LINE _lines[KEYS_MAX];
+static struct QTI_INPUT_CONFIG _config;
+
+/* per key */
+static uint32 _seen;
+static uint32 _reported;
+static uint32 _debouncing;
+
+static uint32 _events[EVENTS];
+static uint8  _peak_slots;
+
+
+int main(int argc, char *argv[])
+{
+  uint8 k;
+  int i, status;
+  pid_t child;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      _presses = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-b") && i + 1 < argc)
+      _bounces = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+      _scan_period = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-d") && i + 1 < argc)
+      _debounce_scans = atoi(argv[++i]);
+  }
+  if(!_presses || !_scan_period || !_debounce_scans)
+  {
+    fprintf(stderr, "at least a press, a scan period and a debounce scan\n");
+    return 1;
+  }
+  _debounce_period = _scan_period * _debounce_scans;
+
+  printf("%u presses, up to %u bounces an edge, scans %ums apart, debounce %ums\n", _presses, _bounces, _scan_period,
+         _debounce_period);
+  printf("%4s %-8s %8s %10s %10s %10s %6s %8s %8s %6s %7s\n", "keys", "way", "presses", "irq/press", "tmr/press",
+         "wake/press", "slots", "press", "release", "long", "repeat");
+  fflush(stdout);
+
+  for(k = 0; k < sizeof(_key_counts); k++)
+  {
+    _keys = _key_counts[k];
+    _seed = 1;
+    _edge_count = 0;
+    memset(_expected, 0, sizeof(_expected));
+    script_build();
+    printf("%4u %-8s %8u %10s %10s %10s %6s %8u %8u %6u %7u\n", _keys, "script", _expected[EVENT_PRESS], "", "", "", "",
+           _expected[EVENT_PRESS], _expected[EVENT_RELEASE], _expected[EVENT_LONG], _expected[EVENT_REPEAT]);
+    fflush(stdout);
+
+    for(_mode = 0; _mode < MODES; _mode++)
+    {
+      /* tq_sim_run() once per process */
+      child = fork();
+      if(!child)
+      {
+        run();
+        exit(0);
+      }
+      waitpid(child, &status, 0);
+      if(!WIFEXITED(status) || WEXITSTATUS(status))
+        return 1;
+    }
+    free(_edges);
+  }
+  return 0;
+}
+
+static uint32 random_next(void)
+{
+  _seed = _seed * 1103515245 + 12345;
+  return _seed >> 8;
+}
+
+/* presses a pause apart, a chord now and then inside a press */
+static void script_build(void)
+{
+  TQ_SIM_TIME time = 100 * 1000;
+  uint32 p, length, chord, c;
+  uint8 key, other;
+
+  _edges = malloc((size_t)_presses * (CHORD_MAX + 1) * 2 * (_bounces + 1) * sizeof(struct EDGE));
+  for(p = 0; p < _presses; p++)
+  {
+    key = random_next() % _keys;
+    length = PRESS_MIN + random_next() % PRESS_SPREAD;
+    script_press(time, key, length);
+
+    chord = (_keys > 1 && !(random_next() % 4)) ? 1 + random_next() % CHORD_MAX : 0;
+    chord = (chord < (uint32)_keys) ? chord : (uint32)_keys - 1;
+    chord = (length / (chord + 1) >= PRESS_MIN) ? chord : 0;
+    for(c = 1; c <= chord; c++)
+    {
+      /* the others in turn, down after the first, up before it */
+      other = (key + c) % _keys;
+      script_press(time + (TQ_SIM_TIME)c * length * 1000 / (2 * chord + 2), other, length / (chord + 1));
+    }
+    time += (TQ_SIM_TIME)(length + PAUSE_MIN + random_next() % PAUSE_SPREAD) * 1000;
+  }
+  _end = time;
+
+  qsort(_edges, _edge_count, sizeof(struct EDGE), compare_edges);
+}
+
+static void script_press(TQ_SIM_TIME time, uint8 key, uint32 length)
+{
+  _expected[EVENT_PRESS]++;
+  _expected[EVENT_RELEASE]++;
+  if(length >= LONG_PRESS)
+  {
+    if(key < REPEAT_KEYS)
+      _expected[EVENT_REPEAT] += 1 + (length - LONG_PRESS) / REPEAT_PERIOD;
+    else
+      _expected[EVENT_LONG]++;
+  }
+  script_edge(time, key, 1);
+  script_edge(time + (TQ_SIM_TIME)length * 1000, key, 0);
+}
+
+/* the edge, then its bounces coming to rest at its level */
+static void script_edge(TQ_SIM_TIME time, uint8 key, uint8 level)
+{
+  uint32 n, b;
+
+  n = _bounces ? random_next() % (_bounces + 1) : 0;
+  n &= ~1UL;
+  for(b = 0; b <= n; b++)
+  {
+    _edges[_edge_count].time = time;
+    _edges[_edge_count].order = _edge_count;
+    _edges[_edge_count].key = key;
+    _edges[_edge_count++].level = (b & 1) ? !level : level;
+    time += 1 + random_next() % BOUNCE_GAP_MAX;
+  }
+}
+
+static int compare_edges(const void *a, const void *b)
+{
+  const struct EDGE *ea = (const struct EDGE *)a, *eb = (const struct EDGE *)b;
+
+  if(ea->time != eb->time)
+    return (ea->time < eb->time) ? -1 : 1;
+  return (ea->order < eb->order) ? -1 : 1;
+}
+
+/* a key pulls its pin low, the keys rest at the pull ups */
+static boolean script_next(struct HW_INPUT_SIM_CHANGE *change)
+{
+  const struct EDGE *edge;
+  uint8 port;
+
+  count_slots();
+  if(_edge_next == _edge_count)
+    return FALSE;
+
+  edge = &_edges[_edge_next++];
+  port = (edge->key < KEYS_PORT_A) ? 0 : 1;
+  if(edge->level)
+    _port_levels[port] &= ~(1 << edge->key);
+  else
+    _port_levels[port] |= (1 << edge->key);
+
+  change->time = edge->time;
+  change->port = port;
+  change->levels = _port_levels[port];
+  return TRUE;
+}
+
+static void run(void)
+{
+  struct TQ_CONTEXT *context = TQ_CTX;
+  uint32 irqs, expiries;
+  uint8 k;
+
+  for(k = 0; k < _keys; k++)
+  {
+    _lines[k].port = (k < KEYS_PORT_A) ? 0 : 1;
+    _lines[k].pin = k;
+    _lines[k].flags = QTI_INPUT_ACTIVE_LOW | ((k < REPEAT_KEYS) ? QTI_INPUT_REPEAT : QTI_INPUT_LONG);
+  }
+  _config.lines = _lines;
+  _config.line_count = _keys;
+  _config.debounce = _debounce_scans;
+  _config.scan_period = _scan_period;
+  _config.long_press = LONG_PRESS;
+  _config.repeat_period = REPEAT_PERIOD;
+
+  _port_levels[0] = _port_levels[1] = 0xffff;
+  hw_input_sim_set_script(script_next);
+  tq_sim_run(_end + 1000 * 1000);
+
+  irqs = hw_input_sim_interrupts();
+  expiries = tq_sim_timer_expiries();
+  printf("%4u %-8s %8u %10.2f %10.2f %10.2f %6u %8u %8u %6u %7u%s\n", _keys, _mode_names[_mode], _expected[EVENT_PRESS],
+         (double)irqs / _expected[EVENT_PRESS], (double)expiries / _expected[EVENT_PRESS],
+         (double)(irqs + expiries) / _expected[EVENT_PRESS], _peak_slots, _events[EVENT_PRESS], _events[EVENT_RELEASE],
+         _events[EVENT_LONG], _events[EVENT_REPEAT], context->timer_map ? ", timers left" : "");
+  fflush(stdout);
+}
+
+static void count_slots(void)
+{
+  uint32 map = TQ_CTX->timer_map;
+  uint8 n = 0;
+
+  for(; map; map &= map - 1)
+    n++;
+  _peak_slots = (n > _peak_slots) ? n : _peak_slots;
+}
+
+void qti_panel_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint16 timer_id;
+  uint8 k;
+
+  count_slots();
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    if(_mode == MODE_SCAN)
+    {
+      qti_input_set_listener(QTI_PANEL);
+      if(!qti_input_open(&_config))
+        exit(1);
+    }
+    else
+    {
+      hw_input_open(0, (1 << ((_keys < KEYS_PORT_A) ? _keys : KEYS_PORT_A)) - 1, 0xffff, key_irq);
+      if(_keys > KEYS_PORT_A)
+        hw_input_open(1, ((1 << _keys) - 1) & ~((1 << KEYS_PORT_A) - 1), 0xffff, key_irq);
+      hw_input_arm(TRUE);
+    }
+  }
+  else if(from == QTI_SYSTEM && sig == SYSTEM_RSP_TIMER)
+  {
+    memcpy(&timer_id, p, sizeof(timer_id));
+    key_timer(timer_id);
+  }
+  else if(from == QTI_INPUT)
+  {
+    for(k = 0; k < EVENTS && sig != INPUT_NTF_PRESS + k; k++);
+    if(k < EVENTS)
+      _events[k]++;
+  }
+}
+
+/* an interrupt every edge, a timer started for each key that moved */
+static void key_irq(void)
+{
+  uint32 pressed = key_read();
+  uint32 moved = (pressed ^ _seen) & ~_debouncing;
+  uint8 k;
+
+  _seen = pressed;
+  hw_input_arm(TRUE);
+  for(k = 0; moved; k++, moved >>= 1)
+  {
+    if(moved & 1)
+    {
+      _debouncing |= 1UL << k;
+      qti_system_start_timer(QTI_PANEL, TIMER_DEBOUNCE(k), _debounce_period);
+    }
+  }
+  count_slots();
+}
+
+static uint32 key_read(void)
+{
+  uint32 levels = hw_input_read(0) | ((uint32)hw_input_read(1) << 16);
+  uint32 pressed = 0;
+  uint8 k;
+
+  for(k = 0; k < _keys; k++)
+  {
+    if(!(levels & (1UL << (k < KEYS_PORT_A ? k : 16 + k))))
+      pressed |= 1UL << k;
+  }
+  return pressed;
+}
+
+static void key_timer(uint16 timer_id)
+{
+  uint32 bit;
+  uint8 k;
+
+  if(timer_id >= TIMER_HOLD(0))
+  {
+    k = timer_id - TIMER_HOLD(0);
+    if(k < REPEAT_KEYS)
+    {
+      key_event(EVENT_REPEAT, k);
+      qti_system_start_timer(QTI_PANEL, TIMER_HOLD(k), REPEAT_PERIOD);
+    }
+    else
+      key_event(EVENT_LONG, k);
+    return;
+  }
+
+  k = timer_id - TIMER_DEBOUNCE(0);
+  bit = 1UL << k;
+  _debouncing &= ~bit;
+  if((key_read() ^ _reported) & bit)
+  {
+    _reported ^= bit;
+    if(_reported & bit)
+    {
+      key_event(EVENT_PRESS, k);
+      qti_system_start_timer(QTI_PANEL, TIMER_HOLD(k), LONG_PRESS);
+    }
+    else
+    {
+      key_event(EVENT_RELEASE, k);
+      qti_system_stop_timer(QTI_PANEL, TIMER_HOLD(k));
+    }
+  }
+}
+
+static void key_event(uint8 event, uint8 key)
+{
+  _events[event]++;
+}
@@ -0,0 +1,173 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of interpolator_fill() against interpolator_step() and
+  interpolator_get_value() a sample at a time, on the wave tables of the
+  melodies, LED ramps of 10ms steps and actuator ramps of 1ms steps. Every
+  block filled is checked first against the values a sample at a time gives.
+
+    R=../../tinyq
+    cc -O2 -I. -I../sample_stm32f030/qties -I$R/core -I$R/misc -I$R/hw/posix \
+       -o sample_interpolator main.c $R/misc/interpolator.c
+    sample_interpolator [-n block samples] [-k rounds]
+
+  With -I$R/hw/sim in place of -I$R/hw/posix the fill takes the path of
+  a target without a divider. Cycles are of the time stamp counter on
+  x86, elsewhere they read 0.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES()                            __rdtsc()
+#else
+#define CYCLES()                            (0ULL)
+#endif
+#include "tq_types.h"
+#include "tq_port.h"
+#include "interpolator.h"
+#include "melodies.h"
+
+#define DEFAULT_BLOCK                       (64)
+#define DEFAULT_ROUNDS                      (2000)
+#define WAVES                               (sizeof(_wave_table) / sizeof(_wave_table[0]))
+
+struct RAMP
+{
+  const char *name;
+  uint16 range_x;
+  uint16 range_y;
+  uint16 step;
+};
+
+typedef uint32 (*GENERATE)(struct S_INTERPOLATOR *itp, uint16 step, uint16 *out);
+
+static void bench(const struct RAMP *ramp);
+static double timed(const struct RAMP *ramp, GENERATE generate, unsigned long long *cycles);
+static uint32 per_sample(struct S_INTERPOLATOR *itp, uint16 step, uint16 *out);
+static uint32 filled(struct S_INTERPOLATOR *itp, uint16 step, uint16 *out);
+
+/* a 2s LED note, a 100ms actuator ramp, a 10s dimming */
+static const struct RAMP _ramps[] =
+{
+  {"led 2s",       2000, 100,   10},
+  {"actuator",     100,  4095,  1},
+  {"dim 10s",      10000, 1000, 1},
+};
+
+static uint16 _block = DEFAULT_BLOCK;
+static uint32 _rounds = DEFAULT_ROUNDS;
+static uint16 *_out;
+static uint16 *_reference;
+static uint32 _mismatches;
+static volatile uint16 _sink;
+
+
+int main(int argc, char *argv[])
+{
+  uint8 r;
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-n") && i + 1 < argc)
+      _block = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      _rounds = atoi(argv[++i]);
+  }
+  if(!_block || !_rounds)
+  {
+    fprintf(stderr, "block 1 to 65535 samples\n");
+    return 1;
+  }
+
+  _out = malloc(_block * sizeof(uint16));
+  _reference = malloc(_block * sizeof(uint16));
+
+#ifdef _PT_HW_DIVIDE
+  printf("blocks of %u samples, %u rounds of the %u wave tables, runs of a slot\n", _block, _rounds, (uint32)WAVES);
+#else
+  printf("blocks of %u samples, %u rounds of the %u wave tables, a compare a sample\n", _block, _rounds, (uint32)WAVES);
+#endif
+  printf("%-10s %8s %12s %10s %12s %10s %8s\n", "ramp", "samples", "step cyc", "step ns", "fill cyc", "fill ns", "speedup");
+  for(r = 0; r < sizeof(_ramps) / sizeof(_ramps[0]); r++)
+    bench(&_ramps[r]);
+
+  if(_mismatches)
+  {
+    printf("%u values of the fill differ\n", _mismatches);
+    return 1;
+  }
+  return 0;
+}
+
+static void bench(const struct RAMP *ramp)
+{
+  struct S_INTERPOLATOR step_itp, fill_itp;
+  unsigned long long step_cycles, fill_cycles, samples = 0;
+  double step_ns, fill_ns;
+  uint32 count;
+  uint8 w;
+
+  for(w = 0; w < WAVES; w++)
+  {
+    interpolator_init(&step_itp, ramp->range_x, ramp->range_y, _wave_table[w], WAVE_TABLE_SIZE);
+    interpolator_init(&fill_itp, ramp->range_x, ramp->range_y, _wave_table[w], WAVE_TABLE_SIZE);
+    do
+    {
+      count = per_sample(&step_itp, ramp->step, _reference);
+      if(filled(&fill_itp, ramp->step, _out) != count || memcmp(_out, _reference, count * sizeof(uint16)))
+        _mismatches++;
+      samples += count;
+    } while(count == _block);
+  }
+
+  step_ns = timed(ramp, per_sample, &step_cycles);
+  fill_ns = timed(ramp, filled, &fill_cycles);
+  samples *= _rounds;
+  printf("%-10s %8llu %12.2f %10.2f %12.2f %10.2f %8.2f\n", ramp->name, samples / _rounds, (double)step_cycles / samples,
+         step_ns / samples, (double)fill_cycles / samples, fill_ns / samples, fill_ns ? step_ns / fill_ns : 0.0);
+}
+
+/* every wave table _rounds times, ns of all */
+static double timed(const struct RAMP *ramp, GENERATE generate, unsigned long long *cycles)
+{
+  struct S_INTERPOLATOR itp;
+  struct timespec t0, t1;
+  unsigned long long start;
+  uint32 round;
+  uint8 w;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  start = CYCLES();
+  for(round = 0; round < _rounds; round++)
+  {
+    for(w = 0; w < WAVES; w++)
+    {
+      interpolator_init(&itp, ramp->range_x, ramp->range_y, _wave_table[w], WAVE_TABLE_SIZE);
+      while(generate(&itp, ramp->step, _out) == _block)
+        _sink += _out[0];
+    }
+  }
+  *cycles = CYCLES() - start;
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+}
+
+/* as the LED interrupt does it */
+static uint32 per_sample(struct S_INTERPOLATOR *itp, uint16 step, uint16 *out)
+{
+  uint32 count;
+
+  for(count = 0; count < _block && interpolator_step(itp, step); count++)
+    out[count] = interpolator_get_value(itp);
+  return count;
+}
+
+static uint32 filled(struct S_INTERPOLATOR *itp, uint16 step, uint16 *out)
+{
+  return interpolator_fill(itp, step, out, _block);
+}
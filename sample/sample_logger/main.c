@@ -0,0 +1,195 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of qti_logger on the virtual time port and the sim flash. The
+  sensor Qti appends records with a running counter every 10ms, the tick
+  Qti runs a 1ms timer and keeps the worst lateness of it. The power is
+  cut at the end of the run, or earlier with -x, then the log is recovered
+  as at a boot and read back. Every rate runs in a process of its own.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/sim -I$R/qties -o sample_logger [a-z]*.c \
+       $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/sim/tq_port.c $R/hw/sim/hw_flash.c $R/qties/qti_logger.c
+    sample_logger [-s record bytes] [-t seconds] [-x cut ms]
+
+  A line per rate gives records programmed a second, the drops, the erases
+  of the most and the least worn page, the worst tick lateness, the page
+  headers read at boot, the records read back and those lost at the cut.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_sim.h"
+#include "hw_flash.h"
+#include "qti_logger.h"
+#include "qties.h"
+
+#define DEFAULT_RECORD_SIZE                 (16)
+#define DEFAULT_RUN_TIME                    (20)            /* seconds */
+#define SENSOR_PERIOD                       (10)            /* ms */
+#define TICK_PERIOD                         (1)             /* ms */
+#define IRQ_CUT                             (0)
+
+#define TIMER_SENSOR                        (1)
+#define TIMER_TICK                          (2)
+
+static void run(void);
+static void cut_power(uint8 irq, uint32 arg);
+static void report(void);
+
+static const uint32 _rates[] = {100, 400, 1000, 2000};    /* records a second */
+
+static uint32 _rate;
+static uint8  _record_size = DEFAULT_RECORD_SIZE;
+static TQ_SIM_TIME _run_time = DEFAULT_RUN_TIME;
+static TQ_SIM_TIME _cut_time;
+
+static uint32 _next;                        /* counter of the next record */
+static TQ_SIM_TIME _tick_due;
+static TQ_SIM_TIME _tick_late;
+static uint32 _cut_at;
+
+
+int main(int argc, char *argv[])
+{
+  uint8 r;
+  int i, status;
+  pid_t child;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-s") && i + 1 < argc)
+      _record_size = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      _run_time = strtoull(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-x") && i + 1 < argc)
+      _cut_time = strtoull(argv[++i], 0, 10);
+  }
+  if(_record_size < sizeof(_next) || _record_size > QTI_LOGGER_RECORD_MAX || !_run_time)
+  {
+    fprintf(stderr, "records of %u to %u bytes\n", (uint32)sizeof(_next), QTI_LOGGER_RECORD_MAX);
+    return 1;
+  }
+
+  printf("records of %u bytes, %u pages, batches of %u bytes, cut at %llu ms\n", _record_size, QTI_LOGGER_PAGES,
+         QTI_LOGGER_BATCH, _cut_time ? _cut_time : _run_time * 1000);
+  printf("%6s %10s %8s %7s %7s %9s %6s %8s %6s\n", "rate", "records/s", "dropped", "wear", "least", "late us",
+         "boot", "read", "lost");
+  fflush(stdout);
+
+  for(r = 0; r < sizeof(_rates) / sizeof(_rates[0]); r++)
+  {
+    _rate = _rates[r];
+
+    /* tq_sim_run() once per process */
+    child = fork();
+    if(!child)
+    {
+      run();
+      exit(0);
+    }
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      return 1;
+  }
+  return 0;
+}
+
+static void run(void)
+{
+  tq_sim_set_irq_handler(IRQ_CUT, cut_power);
+  if(_cut_time && _cut_time < _run_time * 1000)
+    tq_sim_raise_irq(_cut_time * 1000, IRQ_CUT, 0);
+  tq_sim_run(_run_time * 1000 * 1000);
+  report();
+}
+
+/* whatever is left in RAM or not committed is lost */
+static void cut_power(uint8 irq, uint32 arg)
+{
+  hw_flash_sim_cut_power(TRUE);
+  _cut_at = _next;
+}
+
+void qti_sensor_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint8 record[QTI_LOGGER_RECORD_MAX];
+  uint32 i;
+
+  if(from != QTI_SYSTEM)
+    return;
+
+  if(sig == SYSTEM_NTF_START || sig == SYSTEM_RSP_TIMER)
+  {
+    memset(record, 0x5a, sizeof(record));
+    for(i = 0; i < _rate * SENSOR_PERIOD / 1000; i++)
+    {
+      memcpy(record, &_next, sizeof(_next));
+      if(qti_logger_append(record, _record_size))
+        _next++;
+    }
+    qti_system_start_timer(QTI_SENSOR, TIMER_SENSOR, SENSOR_PERIOD);
+  }
+}
+
+void qti_tick_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  TQ_SIM_TIME now = tq_sim_now();
+
+  if(from != QTI_SYSTEM)
+    return;
+
+  if(sig == SYSTEM_RSP_TIMER && now > _tick_due && now - _tick_due > _tick_late)
+    _tick_late = now - _tick_due;
+  if(sig == SYSTEM_NTF_START || sig == SYSTEM_RSP_TIMER)
+  {
+    _tick_due = now + TICK_PERIOD * 1000;
+    qti_system_start_timer(QTI_TICK, TIMER_TICK, TICK_PERIOD);
+  }
+}
+
+/* the log as a boot after the cut finds it */
+static void report(void)
+{
+  struct QTI_LOGGER_STATS stats, recovered;
+  struct QTI_LOGGER_CURSOR cursor;
+  const uint8 *data;
+  uint32 most = 0, least = 0xffffffffUL, erases, counter, expected = 0, read = 0, gaps = 0;
+  double seconds = tq_sim_now() / 1e6;
+  uint8 page, length;
+
+  qti_logger_get_stats(&stats);
+  for(page = 0; page < QTI_LOGGER_PAGES; page++)
+  {
+    erases = hw_flash_sim_erases(QTI_LOGGER_BASE + (uint32)page * HW_FLASH_PAGE_SIZE);
+    most = (erases > most) ? erases : most;
+    least = (erases < least) ? erases : least;
+  }
+  if(!_cut_at)
+    _cut_at = _next;
+
+  qti_logger_recover();
+  qti_logger_get_stats(&recovered);
+  qti_logger_rewind(&cursor);
+  while((length = qti_logger_read(&cursor, &data)) != 0)
+  {
+    memcpy(&counter, data, sizeof(counter));
+    if(length != _record_size || (read && counter != expected))
+      gaps++;
+    expected = counter + 1;
+    read++;
+  }
+
+  printf("%6u %10.0f %8u %7u %7u %9llu %6u %8u %6u\n", _rate, stats.records / seconds, stats.dropped, most, least,
+         _tick_late, recovered.boot_reads, read, read ? _cut_at - expected : _cut_at);
+  if(gaps || stats.errors)
+    printf("%u records out of order, %u flash errors\n", gaps, stats.errors);
+  fflush(stdout);
+}
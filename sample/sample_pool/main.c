@@ -0,0 +1,211 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of the worker pool of the POSIX port (tq_pool.h). Virtual
+  devices running the sample state machine, CPU bound crunch Qties or both
+  are kept busy with signals in flight, every worker count from 1 up runs
+  in a process of its own.
+
+    R=../../tinyq
+    cc -O2 -pthread -DTQ_POOL -DTQ_POOL_MAILBOX_SIZE=8192 -I. -I$R/core -I$R/misc -I$R/hw/posix \
+       -o sample_pool [a-z]*.c $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/posix/tq_*.c
+    sample_pool [-w workers] [-t ms] [-m devices|crunch|mixed] [-r rounds]
+
+  A line per worker count gives signals per second, the speed up over one
+  worker, the steals and parks of the pool and the worst latency of a high
+  priority poll sent to a device every few milliseconds. The presses of
+  all devices may gather on one, its mailbox is sized to take them, a run
+  that drops a signal all the same fails.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "ring_buffer.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "tq_context.h"
+#include "tq_pool.h"
+#include "qties.h"
+
+#define WARM_UP_TIME                        (200)           /* ms */
+#define DEFAULT_RUN_TIME                    (1000)          /* ms */
+#define POLL_PERIOD                         (5)             /* ms */
+
+#define DEVICE_TOKENS                       (4)             /* presses in flight per device */
+#define CRUNCH_TOKENS                       (2)
+#define DEFAULT_ROUNDS                      (4)
+
+/* every press in flight queued at one device, a uint32 of hops each */
+#define DEVICE_PRESS_BYTES                  (DEVICE_COUNT * DEVICE_TOKENS * (TQ_SIGNAL_HEADER_SIZE + 4))
+
+#if DEVICE_PRESS_BYTES >= TQ_POOL_MAILBOX_SIZE
+#error "TQ_POOL_MAILBOX_SIZE takes fewer than the presses of all devices"
+#endif
+
+#define TIMER_WARM_UP                       (1)
+#define TIMER_RUN                           (2)
+#define TIMER_POLL                          (3)
+
+#define MODE_DEVICES                        (1)
+#define MODE_CRUNCH                         (2)
+
+static unsigned long long count_signals(void);
+static boolean report(void);
+
+static uint8  _workers;
+static uint32 _run_time = DEFAULT_RUN_TIME;
+static uint8  _mode = MODE_DEVICES | MODE_CRUNCH;
+static uint16 _rounds = DEFAULT_ROUNDS;
+
+static unsigned long long _start_signals;
+static uint32 _start_time;
+static uint32 _poll_max;
+static uint8  _poll_device;
+static double *_single_rate;                        /* shared with the runs */
+
+
+int main(int argc, char *argv[])
+{
+  uint8 max_workers = 4, i;
+  int status;
+  pid_t child;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-w") && i + 1 < argc)
+      max_workers = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      _run_time = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-r") && i + 1 < argc)
+      _rounds = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-m") && i + 1 < argc)
+    {
+      i++;
+      _mode = !strcmp(argv[i], "devices") ? MODE_DEVICES : !strcmp(argv[i], "crunch") ? MODE_CRUNCH : MODE_DEVICES | MODE_CRUNCH;
+    }
+  }
+  if(!max_workers || max_workers > TQ_POOL_WORKERS_MAX || !_run_time || _run_time > 2000)
+  {
+    fprintf(stderr, "workers 1 to %u, run time 1 to 2000 ms\n", TQ_POOL_WORKERS_MAX);
+    return 1;
+  }
+
+  _single_rate = mmap(0, sizeof(*_single_rate), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if(_single_rate == MAP_FAILED)
+    return 1;
+
+  printf("%u devices, %u crunch Qties of %u rounds, %u ms per run\n", (_mode & MODE_DEVICES) ? DEVICE_COUNT : 0,
+         (_mode & MODE_CRUNCH) ? CRUNCH_COUNT : 0, _rounds, _run_time);
+  printf("%7s %14s %8s %10s %10s %10s %8s\n", "workers", "signals/s", "speedup", "steals", "parks", "poll us", "dropped");
+  fflush(stdout);
+
+  /* tinyq never returns, a run per process */
+  for(_workers = 1; _workers <= max_workers; _workers++)
+  {
+    child = fork();
+    if(!child)
+      tinyq_run_pool(_workers);
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      return 1;
+  }
+  return 0;
+}
+
+void qti_bench_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint32 sent, latency;
+  uint16 id;
+
+  QTI_COUNT_SIGNAL(QTI_BENCH);
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    if(_mode & MODE_DEVICES)
+      qti_device_start(DEVICE_TOKENS);
+    if(_mode & MODE_CRUNCH)
+      qti_crunch_start(CRUNCH_TOKENS, _rounds);
+    qti_system_start_timer(QTI_BENCH, TIMER_WARM_UP, WARM_UP_TIME);
+    return;
+  }
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_RSP_TIMER)
+  {
+    id = *((uint16*)(p));
+    if(id == TIMER_WARM_UP)
+    {
+      _start_signals = count_signals();
+      _start_time = tq_port_timestamp();
+      _poll_max = 0;
+      qti_system_start_timer(QTI_BENCH, TIMER_RUN, _run_time);
+      qti_system_start_timer(QTI_BENCH, TIMER_POLL, POLL_PERIOD);
+    }
+    else if(id == TIMER_RUN)
+    {
+      exit(report() ? 0 : 1);
+    }
+    else if(id == TIMER_POLL && (_mode & MODE_DEVICES))
+    {
+      sent = tq_port_timestamp();
+      tinyq_send_signal(QTI_BENCH, QTI_DEVICE + _poll_device, DEVICE_CMD_POLL, &sent, sizeof(sent));
+      _poll_device = (_poll_device + 1) % DEVICE_COUNT;
+      qti_system_start_timer(QTI_BENCH, TIMER_POLL, POLL_PERIOD);
+    }
+    return;
+  }
+
+  if(sig == DEVICE_RSP_POLL)
+  {
+    memcpy(&sent, p, sizeof(sent));
+    latency = tq_port_timestamp() - sent;
+    _poll_max = (latency > _poll_max) ? latency : _poll_max;
+  }
+}
+
+static unsigned long long count_signals(void)
+{
+  unsigned long long total = 0;
+  uint16 i;
+
+  for(i = 0; i < _QTI_COUNT_; i++)
+    total += __atomic_load_n(&qti_counters[i].signals, __ATOMIC_RELAXED);
+  return total;
+}
+
+/* FALSE when a signal was dropped, the rate is not of the workload set up then */
+static boolean report(void)
+{
+  struct TQ_POOL_STATS stats;
+  uint32 steals = 0, parks = 0, dropped = 0;
+  double seconds, rate;
+  uint8 i;
+
+  seconds = (tq_port_timestamp() - _start_time) / (double)_PT_TIMESTAMP_FREQ;
+  rate = (count_signals() - _start_signals) / seconds;
+  for(i = 0; i < tq_pool_worker_count(); i++)
+  {
+    tq_pool_get_stats(i, &stats);
+    steals += stats.steals;
+    parks += stats.parks;
+  }
+  for(i = 0; i < _QTI_COUNT_; i++)
+    dropped += tq_pool_dropped(i);
+  if(_workers == 1)
+    *_single_rate = rate;
+
+  printf("%7u %14.0f %8.2f %10u %10u %10u %8u\n", _workers, rate, rate / *_single_rate,
+         steals, parks, (_mode & MODE_DEVICES) ? _poll_max : 0, dropped);
+  fflush(stdout);
+  if(dropped)
+  {
+    fprintf(stderr, "%u signals dropped\n", dropped);
+    return FALSE;
+  }
+  return TRUE;
+}
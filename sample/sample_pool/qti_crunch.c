@@ -0,0 +1,80 @@
+/****************************************************************************
+  qti_crunch.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  A CPU bound Qti, every work command runs a CRC over a block of its own
+  and hands the command on to a crunch Qti picked from the result.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "qties.h"
+
+#define CRUNCH_BLOCK_SIZE                   (256)
+
+struct S_WORK
+{
+  uint32 crc;
+  uint16 rounds;
+};
+
+static uint32 crc32_block(uint32 crc, const uint8 *data, uint16 size);
+
+static uint8 _blocks[CRUNCH_COUNT][CRUNCH_BLOCK_SIZE];
+
+
+void qti_crunch_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint8 *block = _blocks[self->self - QTI_CRUNCH];
+  struct S_WORK work;
+  uint16 i;
+
+  QTI_COUNT_SIGNAL(self->self);
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    for(i = 0; i < CRUNCH_BLOCK_SIZE; i++)
+      block[i] = (uint8)(i * self->self);
+    return;
+  }
+
+  if(sig == CRUNCH_CMD_WORK)
+  {
+    memcpy(&work, p, sizeof(work));
+    for(i = 0; i < work.rounds; i++)
+      work.crc = crc32_block(work.crc, block, CRUNCH_BLOCK_SIZE);
+    tinyq_send_signal(self->self, QTI_CRUNCH + work.crc % CRUNCH_COUNT, CRUNCH_CMD_WORK, &work, sizeof(work));
+  }
+}
+
+/* rounds of CRC per command set the cost, a round is a few microseconds */
+void qti_crunch_start(uint8 tokens, uint16 rounds)
+{
+  struct S_WORK work;
+  uint8 i, t;
+
+  work.rounds = rounds;
+  for(t = 0; t < tokens; t++)
+  {
+    for(i = 0; i < CRUNCH_COUNT; i++)
+    {
+      work.crc = (uint32)t << 8 | i;
+      tinyq_send_signal(QTI_BENCH, QTI_CRUNCH + i, CRUNCH_CMD_WORK, &work, sizeof(work));
+    }
+  }
+}
+
+static uint32 crc32_block(uint32 crc, const uint8 *data, uint16 size)
+{
+  uint8 bit;
+
+  crc = ~crc;
+  while(size--)
+  {
+    crc ^= *data++;
+    for(bit = 0; bit < 8; bit++)
+      crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+  }
+  return ~crc;
+}
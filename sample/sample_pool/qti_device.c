@@ -0,0 +1,123 @@
+/****************************************************************************
+  qti_device.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  A virtual device, the state machine of sample_stm32f030/qties/qti_sample.c
+  driven by button notifications instead of a button. Every press is passed
+  on to a neighbour, the presses in flight keep the devices busy.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "state_machine.h"
+#include "qti_system.h"
+#include "qties.h"
+
+#define MELODY_STEPS                        (5)
+#define NEIGHBOUR_STRIDE                    (7)
+
+static void state_entry_stopped(struct STATE_MACHINE *sm, uint32 msg, const uint8 *p, uint8 size);
+static void state_entry_playing(struct STATE_MACHINE *sm, uint32 msg, const uint8 *p, uint8 size);
+static void pass_press(struct STATE_MACHINE *sm, const uint8 *p);
+
+enum STATES
+{
+  STATE_STOPPED = 0,
+  STATE_PLAYING,
+  TOTAL_STATE_COUNT
+};
+
+static const STATE_MACHINE_ENTRY _state_table[] =
+{
+  state_entry_stopped,
+  state_entry_playing,
+};
+
+/* the state machine first, handlers get back to their device from it */
+struct S_DEVICE
+{
+  struct STATE_MACHINE sm;
+  uint8  self;
+  uint8  melody;
+  uint8  step;
+};
+
+static struct S_DEVICE _devices[DEVICE_COUNT];
+
+
+void qti_device_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  struct S_DEVICE *device = &_devices[self->self - QTI_DEVICE];
+
+  QTI_COUNT_SIGNAL(self->self);
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    device->self = self->self;
+    device->melody = 1;
+    state_machine_init(&device->sm, _state_table, TOTAL_STATE_COUNT);
+    return;
+  }
+
+  if(sig == DEVICE_CMD_POLL)
+  {
+    tinyq_send_signal(device->self, from, DEVICE_RSP_POLL, p, size);
+    return;
+  }
+
+  state_machine_signal_entry(&device->sm, ((uint32)from << 8) | sig, p, size);
+}
+
+/* every device gets its share of presses */
+void qti_device_start(uint8 tokens)
+{
+  uint32 hops = 0;
+  uint8 i, t;
+
+  for(t = 0; t < tokens; t++)
+  {
+    for(i = 0; i < DEVICE_COUNT; i++)
+      tinyq_send_signal(QTI_BENCH, QTI_DEVICE + i, DEVICE_NTF_BUTTON, &hops, sizeof(hops));
+  }
+}
+
+static void state_entry_stopped(struct STATE_MACHINE *sm, uint32 msg, const uint8 *p, uint8 size)
+{
+  struct S_DEVICE *device = (struct S_DEVICE *)sm;
+
+  if(msg == STATE_MACHINE_MSG_ENTER || msg == STATE_MACHINE_MSG_LEAVE)
+    return;
+
+  if((msg & 0xff) == DEVICE_NTF_BUTTON)
+  {
+    device->step = 0;
+    device->melody = (device->melody >= 5) ? 1 : device->melody + 1;
+    state_machine_goto_state(sm, STATE_PLAYING, 0);
+    pass_press(sm, p);
+  }
+}
+
+static void state_entry_playing(struct STATE_MACHINE *sm, uint32 msg, const uint8 *p, uint8 size)
+{
+  struct S_DEVICE *device = (struct S_DEVICE *)sm;
+
+  if(msg == STATE_MACHINE_MSG_ENTER || msg == STATE_MACHINE_MSG_LEAVE)
+    return;
+
+  if((msg & 0xff) == DEVICE_NTF_BUTTON)
+  {
+    if(++device->step >= MELODY_STEPS * device->melody)
+      state_machine_goto_state(sm, STATE_STOPPED, 0);
+    pass_press(sm, p);
+  }
+}
+
+static void pass_press(struct STATE_MACHINE *sm, const uint8 *p)
+{
+  struct S_DEVICE *device = (struct S_DEVICE *)sm;
+  uint32 hops;
+  uint8 next;
+
+  hops = ((const uint32 *)p)[0] + 1;
+  next = (device->self - QTI_DEVICE + NEIGHBOUR_STRIDE) % DEVICE_COUNT;
+  tinyq_send_signal(device->self, QTI_DEVICE + next, DEVICE_NTF_BUTTON, &hops, sizeof(hops));
+}
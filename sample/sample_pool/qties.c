@@ -0,0 +1,38 @@
+/****************************************************************************
+  qties.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "qti_system.h"
+
+#define QTI_ENTRIES_8(BASE, ENTRY)                                             \
+  {(BASE) + 0, ENTRY}, {(BASE) + 1, ENTRY}, {(BASE) + 2, ENTRY}, {(BASE) + 3, ENTRY}, \
+  {(BASE) + 4, ENTRY}, {(BASE) + 5, ENTRY}, {(BASE) + 6, ENTRY}, {(BASE) + 7, ENTRY}
+#define QTI_ENTRIES_32(BASE, ENTRY)                                            \
+  QTI_ENTRIES_8((BASE), ENTRY), QTI_ENTRIES_8((BASE) + 8, ENTRY),              \
+  QTI_ENTRIES_8((BASE) + 16, ENTRY), QTI_ENTRIES_8((BASE) + 24, ENTRY)
+
+#if DEVICE_COUNT != 160 || CRUNCH_COUNT != 64
+#error "the table below lists 160 devices and 64 crunch Qties"
+#endif
+
+const uint8 tq_qti_count = _QTI_COUNT_;
+
+struct QTI_COUNTER qti_counters[_QTI_COUNT_];
+
+
+/* table of Qties */
+const struct TQ_QTI tq_qti_table[_QTI_COUNT_] =
+{
+  {QTI_SYSTEM,        qti_system_signal_entry},
+  {QTI_BENCH,         qti_bench_signal_entry},
+  QTI_ENTRIES_32(QTI_DEVICE,        qti_device_signal_entry),
+  QTI_ENTRIES_32(QTI_DEVICE + 32,   qti_device_signal_entry),
+  QTI_ENTRIES_32(QTI_DEVICE + 64,   qti_device_signal_entry),
+  QTI_ENTRIES_32(QTI_DEVICE + 96,   qti_device_signal_entry),
+  QTI_ENTRIES_32(QTI_DEVICE + 128,  qti_device_signal_entry),
+  QTI_ENTRIES_32(QTI_CRUNCH,        qti_crunch_signal_entry),
+  QTI_ENTRIES_32(QTI_CRUNCH + 32,   qti_crunch_signal_entry),
+};
@@ -0,0 +1,44 @@
+/****************************************************************************
+  qties.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTIES_H
+#define QTIES_H
+
+#define DEVICE_COUNT                        (160)
+#define CRUNCH_COUNT                        (64)
+
+enum e_QTIES
+{
+  QTI_SYSTEM = 0,
+  QTI_BENCH,
+  QTI_DEVICE,                               /* DEVICE_COUNT of them */
+  QTI_CRUNCH = QTI_DEVICE + DEVICE_COUNT,   /* CRUNCH_COUNT of them */
+  _QTI_COUNT_ = QTI_CRUNCH + CRUNCH_COUNT,
+};
+
+#define DEVICE_NTF_BUTTON                   TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 0)
+#define DEVICE_CMD_POLL                     TQ_SIG_MAKE_CMD(TQ_DSP_HIGH, 1)     /* p: timestamp, echoed */
+#define DEVICE_RSP_POLL                     TQ_SIG_MAKE_RSP(TQ_DSP_HIGH, 1)
+#define CRUNCH_CMD_WORK                     TQ_SIG_MAKE_CMD(TQ_DSP_NORMAL, 0)
+
+/* signals handled, one cache line per Qti, written by the Qti only */
+struct QTI_COUNTER
+{
+  uint32 signals;
+  uint8  pad[60];
+};
+
+extern struct QTI_COUNTER qti_counters[_QTI_COUNT_];
+
+#define QTI_COUNT_SIGNAL(QTI)               __atomic_store_n(&qti_counters[QTI].signals, qti_counters[QTI].signals + 1, __ATOMIC_RELAXED)
+
+extern void qti_bench_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+extern void qti_device_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+extern void qti_device_start(uint8 tokens);
+
+extern void qti_crunch_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+extern void qti_crunch_start(uint8 tokens, uint16 work);
+
+#endif
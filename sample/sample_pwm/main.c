@@ -0,0 +1,199 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of pwm_engine on the host, 1 to PWM_ENGINE_CHANNELS_MAX LED
+  channels of a timer each looping a melody of melodies.h at 100 updates a
+  second. Three ways to drive them are timed over the same updates:
+
+    update    an interrupt an update a channel, one value each, as the
+              TIM3 update interrupt of qti_indication.c used to do
+    separate  a one channel engine and a DMA of its own a channel, half
+              buffers of LED_DMA_UPDATES / 2 updates
+    shared    one engine for all channels, one DMA burst an update and
+              the same half buffers
+
+    R=../../tinyq; Q=../sample_stm32f030/qties
+    cc -O2 -I. -I$Q -I$R/core -I$R/misc -I$R/hw/posix -o sample_pwm main.c \
+       $Q/pwm_engine.c $R/misc/interpolator.c
+    sample_pwm [-t seconds]
+
+  The shared fill is checked first against the separate ones, value for
+  value. A line per channel count gives the interrupts a second and the
+  ns of the fills per channel and update each way. An interrupt costs the
+  Cortex-M0 about 32 cycles of entry and exit on top, not counted here.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tq_types.h"
+#include "interpolator.h"
+#include "melodies.h"
+#include "pwm_engine.h"
+
+#define DEFAULT_RUN_TIME                    (600)           /* seconds */
+#define LED_PWM_FREQ                        (100)
+#define LED_PWM_PERIOD_MS                   (1000 / LED_PWM_FREQ)
+#define LED_DMA_UPDATES                     (32)
+#define HALF                                (LED_DMA_UPDATES / 2)
+#define MELODIES                            (sizeof(_led_melody_table) / sizeof(_led_melody_table[0]))
+
+static uint32 verify(void);
+static double run_update(uint8 channels);
+static double run_separate(uint8 channels);
+static double run_shared(uint8 channels);
+static void start(struct S_PWM_ENGINE *engine, uint8 channel_count, uint8 first);
+static double elapsed(const struct timespec *t0);
+
+static uint32 _updates;
+static uint16 _buffer[HALF * PWM_ENGINE_CHANNELS_MAX];
+static volatile uint16 _sink;
+
+
+int main(int argc, char *argv[])
+{
+  double update, separate, shared, shared_one = 0;
+  uint32 seconds = DEFAULT_RUN_TIME;
+  uint8 n;
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      seconds = atoi(argv[++i]);
+  }
+  if(!seconds)
+  {
+    fprintf(stderr, "at least a second\n");
+    return 1;
+  }
+  _updates = seconds * LED_PWM_FREQ / HALF * HALF;
+
+  if(verify())
+  {
+    printf("the shared fill differs from the separate ones\n");
+    return 1;
+  }
+
+  printf("%u s of %u Hz updates, half buffers of %u updates\n", seconds, LED_PWM_FREQ, HALF);
+  printf("%8s %9s %9s %9s %10s %10s %10s %8s\n", "channels", "irq/s", "irq/s", "irq/s", "ns/ch-upd", "ns/ch-upd",
+         "ns/ch-upd", "vs 1");
+  printf("%8s %9s %9s %9s %10s %10s %10s %8s\n", "", "update", "separate", "shared", "update", "separate", "shared", "shared");
+  for(n = 1; n <= PWM_ENGINE_CHANNELS_MAX; n++)
+  {
+    update = run_update(n);
+    separate = run_separate(n);
+    shared = run_shared(n);
+    if(n == 1)
+      shared_one = shared;
+    printf("%8u %9u %9.2f %9.2f %10.2f %10.2f %10.2f %8.2f\n", n, n * LED_PWM_FREQ, (double)n * LED_PWM_FREQ / HALF,
+           (double)LED_PWM_FREQ / HALF, update, separate, shared, shared / shared_one);
+  }
+  return 0;
+}
+
+/* values that differ */
+static uint32 verify(void)
+{
+  struct S_PWM_ENGINE engines[PWM_ENGINE_CHANNELS_MAX], engine;
+  uint16 separate[HALF];
+  uint32 u, i, mismatches = 0;
+  uint8 c;
+
+  start(&engine, PWM_ENGINE_CHANNELS_MAX, 0);
+  for(c = 0; c < PWM_ENGINE_CHANNELS_MAX; c++)
+    start(&engines[c], 1, c);
+
+  for(u = 0; u < _updates; u += HALF)
+  {
+    pwm_engine_fill(&engine, _buffer, HALF);
+    for(c = 0; c < PWM_ENGINE_CHANNELS_MAX; c++)
+    {
+      pwm_engine_fill(&engines[c], separate, HALF);
+      for(i = 0; i < HALF; i++)
+        mismatches += (_buffer[i * PWM_ENGINE_CHANNELS_MAX + c] != separate[i]);
+    }
+  }
+  return mismatches;
+}
+
+/* a value a call, a call an update a channel */
+static double run_update(uint8 channels)
+{
+  struct S_PWM_ENGINE engines[PWM_ENGINE_CHANNELS_MAX];
+  struct timespec t0;
+  uint32 u;
+  uint8 c;
+
+  for(c = 0; c < channels; c++)
+    start(&engines[c], 1, c);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(u = 0; u < _updates; u++)
+  {
+    for(c = 0; c < channels; c++)
+    {
+      pwm_engine_fill(&engines[c], _buffer, 1);
+      _sink += _buffer[0];
+    }
+  }
+  return elapsed(&t0) / ((double)_updates * channels);
+}
+
+static double run_separate(uint8 channels)
+{
+  struct S_PWM_ENGINE engines[PWM_ENGINE_CHANNELS_MAX];
+  struct timespec t0;
+  uint32 u;
+  uint8 c;
+
+  for(c = 0; c < channels; c++)
+    start(&engines[c], 1, c);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(u = 0; u < _updates; u += HALF)
+  {
+    for(c = 0; c < channels; c++)
+    {
+      pwm_engine_fill(&engines[c], _buffer, HALF);
+      _sink += _buffer[0];
+    }
+  }
+  return elapsed(&t0) / ((double)_updates * channels);
+}
+
+static double run_shared(uint8 channels)
+{
+  struct S_PWM_ENGINE engine;
+  struct timespec t0;
+  uint32 u;
+
+  start(&engine, channels, 0);
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(u = 0; u < _updates; u += HALF)
+  {
+    pwm_engine_fill(&engine, _buffer, HALF);
+    _sink += _buffer[0];
+  }
+  return elapsed(&t0) / ((double)_updates * channels);
+}
+
+/* channel c of all plays the looping melody c + 1, power up left out */
+static void start(struct S_PWM_ENGINE *engine, uint8 channel_count, uint8 first)
+{
+  uint8 c;
+
+  pwm_engine_init(engine, channel_count, LED_PWM_PERIOD_MS, 1, 0);
+  for(c = 0; c < channel_count; c++)
+    pwm_engine_play(engine, c, _led_melody_table[1 + (first + c) % (MELODIES - 1)]);
+}
+
+static double elapsed(const struct timespec *t0)
+{
+  struct timespec t1;
+
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+  return (t1.tv_sec - t0->tv_sec) * 1e9 + (t1.tv_nsec - t0->tv_nsec);
+}
@@ -0,0 +1,237 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  The sample application on the virtual time port, with stand-ins of the
+  STM32 button and indication Qties and the rest of sample_stm32f030/qties.
+
+    R=../../tinyq; Q=../sample_stm32f030/qties
+    cc -DTQ_DEBUG -DTQ_PROFILE -DTQ_POWER_STATS -I. -I$Q -I$R/core -I$R/misc -I$R/hw/sim \
+       -o sample_sim [a-z]*.c $Q/qties.c $Q/qti_sample.c $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/sim/tq_*.c
+    sample_sim [-t seconds] [-r record] [script]
+
+  A script line is "<ms> <irq> <arg>" and raises interrupt line <irq> of
+  sim_irqs.h at virtual time <ms>, '#' starts a comment. -r replays a dump
+  of tq_record_buffer taken on target instead. Without either the button is
+  clicked every 7 seconds. Built with TQ_RECORD the run writes its own
+  tq_record.bin.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qti_system.h"
+#include "tq_profile.h"
+#include "tq_trace.h"
+#include "tq_record.h"
+#include "tq_sim.h"
+#include "tq_replay.h"
+#include "sim_irqs.h"
+
+#define DEFAULT_RUN_TIME                    (3600)          /* seconds */
+#define DEFAULT_CLICK_PERIOD                (7000)          /* ms */
+#define DEFAULT_CLICK_LENGTH                (150)           /* ms */
+
+static boolean replay_load(const char *name);
+static boolean script_next(void);
+static void script_irq(uint8 irq, uint32 arg);
+static void print_results(void);
+
+static FILE *_script;
+static unsigned long _clicks;
+static boolean _replay;
+
+
+int main(int argc, char *argv[])
+{
+  TQ_SIM_TIME run_time = DEFAULT_RUN_TIME;
+  clock_t started;
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      run_time = strtoull(argv[++i], 0, 10);
+    else if(!strcmp(argv[i], "-r") && i + 1 < argc)
+    {
+      if(!replay_load(argv[++i]))
+        return 1;
+    }
+    else if(!_script)
+    {
+      _script = fopen(argv[i], "r");
+      if(!_script)
+      {
+        perror(argv[i]);
+        return 1;
+      }
+    }
+  }
+
+  if(_replay)
+  {
+    tq_replay_map_exti(13, SIM_IRQ_BUTTON);
+    tq_replay_start(SIM_IRQ_REPLAY);
+  }
+  else
+  {
+    tq_sim_set_irq_handler(SIM_IRQ_SCRIPT, script_irq);
+    script_next();
+  }
+
+  started = clock();
+  tq_sim_run(run_time * 1000 * 1000);
+  fprintf(stderr, "%.3fs virtual in %.3fs\n", tq_sim_now() / 1e6, (double)(clock() - started) / CLOCKS_PER_SEC);
+
+  print_results();
+  return 0;
+}
+
+static boolean replay_load(const char *name)
+{
+  static uint8 dump[sizeof(struct TQ_RECORD_BUFFER) + 64 * 1024];
+  FILE *file = fopen(name, "rb");
+  size_t size;
+
+  if(!file)
+  {
+    perror(name);
+    return FALSE;
+  }
+  size = fread(dump, 1, sizeof(dump), file);
+  fclose(file);
+
+  if(!tq_replay_load(dump, size))
+  {
+    fprintf(stderr, "%s: not a tinyq record dump\n", name);
+    return FALSE;
+  }
+  _replay = TRUE;
+  return TRUE;
+}
+
+/* one script line is pending at a time, the event queue stays short */
+static boolean script_next(void)
+{
+  char line[128];
+  unsigned long long ms;
+  unsigned irq;
+  unsigned long arg;
+
+  if(!_script)
+  {
+    ms = (_clicks / 2) * DEFAULT_CLICK_PERIOD + ((_clicks & 1) ? DEFAULT_CLICK_LENGTH : 0);
+    ms += DEFAULT_CLICK_PERIOD;
+    tq_sim_raise_irq(ms * 1000, SIM_IRQ_SCRIPT, (SIM_IRQ_BUTTON << 24) | ((_clicks & 1) ? 1 : 0));
+    _clicks++;
+    return TRUE;
+  }
+
+  while(fgets(line, sizeof(line), _script))
+  {
+    if(line[0] == '#' || sscanf(line, "%llu %u %lu", &ms, &irq, &arg) != 3)
+      continue;
+    if(irq == SIM_IRQ_SCRIPT || irq >= _SIM_IRQ_COUNT_ || arg > 0xffffff)
+    {
+      fprintf(stderr, "bad script line: %s", line);
+      continue;
+    }
+    tq_sim_raise_irq(ms * 1000, SIM_IRQ_SCRIPT, (irq << 24) | arg);
+    return TRUE;
+  }
+  return FALSE;
+}
+
+/* line is the target interrupt in the top byte and its arg */
+static void script_irq(uint8 irq, uint32 line)
+{
+  tq_sim_raise_irq(tq_sim_now(), (uint8)(line >> 24), line & 0xffffff);
+  script_next();
+}
+
+static void print_results(void)
+{
+#ifdef TQ_PROFILE
+  const struct TQ_PROFILE_TABLE *profile = tq_profile_get_data();
+  const struct TQ_PROFILE_ENTRY *entry;
+#endif
+#ifdef TQ_POWER_STATS
+  struct QTI_SYSTEM_POWER_STATS power;
+  const char *mode_names[QTI_SYSTEM_SLEEP_MODES] = {"wfi", "stop", "standby"};
+#endif
+#ifdef TQ_DEBUG
+  int16 interface_bytes, logic_bytes;
+#endif
+  struct TQ_REPLAY_STATS replay;
+  int i;
+
+  printf("virtual time %.3fs\n", tq_sim_now() / 1e6);
+
+#ifdef TQ_PROFILE
+  printf("%5s %5s %8s %10s %10s %10s\n", "qti", "sig", "count", "avg us", "max us", "latency");
+  for(i = 0; i < profile->slot_count; i++)
+  {
+    entry = &profile->entries[i];
+    if(!entry->count)
+      continue;
+    printf("%5u  0x%02x %8u %10.1f %10u %10u\n", entry->qti, entry->sig, entry->count,
+           (double)entry->time_total / entry->count, entry->time_max, entry->residency_max);
+  }
+  {
+    FILE *file = fopen("tq_profile.bin", "wb");
+    if(file)
+    {
+      fwrite(profile, sizeof(*profile), 1, file);
+      fclose(file);
+    }
+  }
+#endif
+
+#ifdef TQ_RECORD
+  {
+    FILE *file = fopen("tq_record.bin", "wb");
+    if(file)
+    {
+      fwrite(tq_record_get_data(), sizeof(struct TQ_RECORD_BUFFER), 1, file);
+      fclose(file);
+    }
+  }
+#endif
+
+#ifdef TQ_TRACE
+  {
+    FILE *file = fopen("tq_trace.bin", "wb");
+    if(file)
+    {
+      fwrite(tq_trace_get_data(), sizeof(struct TQ_TRACE_BUFFER), 1, file);
+      fclose(file);
+    }
+  }
+#endif
+
+#ifdef TQ_DEBUG
+  tinyq_get_queue_high_water(&interface_bytes, &logic_bytes);
+  printf("queue high water: interface %d bytes, logic %d bytes\n", interface_bytes, logic_bytes);
+#endif
+
+#ifdef TQ_POWER_STATS
+  qti_system_get_power_stats(&power);
+  printf("active %u.%06us\n", power.active.seconds, power.active.ticks);
+  for(i = 0; i < QTI_SYSTEM_SLEEP_MODES; i++)
+    printf("%-8s %u.%06us in %u sleeps\n", mode_names[i], power.asleep[i].seconds, power.asleep[i].ticks, power.sleeps[i]);
+  printf("wakeups: rtc %u exti %u other %u\n", power.wakeups[QTI_SYSTEM_WAKEUP_RTC],
+         power.wakeups[QTI_SYSTEM_WAKEUP_EXTI], power.wakeups[QTI_SYSTEM_WAKEUP_OTHER]);
+  printf("waits of untracked Qties: %u\n", power.untracked_waits);
+#endif
+
+  if(_replay)
+  {
+    tq_replay_get_stats(&replay);
+    printf("replay%s: exti %u (%u unmapped) signals %u timer alarms %u missed %u extra %u, %u not recorded\n",
+           replay.finished ? "" : " cut short", replay.extis, replay.unmapped, replay.signals, replay.timers,
+           replay.timers_missed, replay.timers_extra, replay.dropped);
+  }
+  (void)i;
+}
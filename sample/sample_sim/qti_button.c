@@ -0,0 +1,103 @@
+/****************************************************************************
+  qti_button.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Stand-in of sample_stm32f030/qties/qti_button.c, the button pin PC13 is
+  the SIM_IRQ_BUTTON line. The line posts its edges and holds off as
+  hw_exti_post() does, an edge carries its level only. Edges on the line
+  while it is masked count as no interrupt.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "qti_button.h"
+#include "tq_record.h"
+#include "tq_sim.h"
+#include "sim_irqs.h"
+
+#define SIG_EXTI_EDGE                       TQ_SIG_MAKE_NTF(TQ_DSP_HIGH, 1)     /* as from hw_exti.c */
+#define DEBOUNCE_PERIOD                     (100)
+#define TIMER_HOLDOFF                       (0xff00 + GPIO_PIN_BUTTON)          /* HW_EXTI_TIMER_ID() */
+
+#define GPIO_PIN_BUTTON                     (13)
+
+static void button_state_exti_irq(uint8 irq, uint32 level);
+static void button_holdoff_timeout(void);
+static void post_edge(void);
+static void button_edge(uint8 level);
+
+static uint8 _self;
+static uint8 _listener = 0;
+static uint8 _reported = 0;
+static boolean _masked = FALSE;
+static uint8 _level = 0;                    /* of the pin */
+static uint8 _posted = 0;
+
+
+void qti_button_set_listener(uint8 qti)
+{
+  _listener = qti;
+}
+
+void qti_button_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint16 timer_id;
+  
+  if(from == QTI_SYSTEM)
+  {
+    if(sig == SYSTEM_NTF_START)
+    {
+      _self = self->self;
+      tq_sim_set_irq_handler(SIM_IRQ_BUTTON, button_state_exti_irq);
+    }
+    else if(sig == SYSTEM_RSP_TIMER)
+    {
+      timer_id = *((uint16*)(p));
+      if(timer_id == TIMER_HOLDOFF)
+        button_holdoff_timeout();
+    }
+    else if(sig == SIG_EXTI_EDGE)
+      button_edge(p[0]);
+  }
+}
+
+static void button_state_exti_irq(uint8 irq, uint32 level)
+{
+  _level = (level != 0);
+  if(_masked)
+    return;
+
+  /* hw_exti.c records the edge on target */
+  TQ_RECORD_STIMULUS(TQ_RECORD_EXTI, GPIO_PIN_BUTTON, level, 0, 0, 0);
+  post_edge();
+}
+
+static void button_holdoff_timeout(void)
+{
+  qti_system_lock();
+  _masked = FALSE;
+  if(_level != _posted)
+    post_edge();
+  qti_system_unlock();
+}
+
+static void post_edge(void)
+{
+  _posted = _level;
+  tinyq_send_signal(0, _self, SIG_EXTI_EDGE, &_posted, 1);
+  _masked = TRUE;
+  qti_system_start_timer(_self, TIMER_HOLDOFF, DEBOUNCE_PERIOD);
+}
+
+static void button_edge(uint8 level)
+{
+  uint8 evt = (level == 0) ? BUTTON_NTF_DOWN : BUTTON_NTF_UP;
+
+  if(evt != _reported)
+  {
+    _reported = evt;
+    tinyq_send_signal(_self, _listener, evt, 0, 0);
+  }
+}
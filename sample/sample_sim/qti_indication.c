@@ -0,0 +1,355 @@
+/****************************************************************************
+  qti_indication.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Stand-in of sample_stm32f030/qties/qti_indication.c. Melodies are walked
+  note by note with the same timers and waits, the buzzer DMA half / full
+  transfer interrupts are raised on SIM_IRQ_BUZZER_DMA while it plays. A
+  buzzer melody of melody_streams.h takes no timer, a transfer complete
+  interrupt a pass instead. INDICATION_NO_STREAMS interprets them all.
+  The LED DMA half / full transfer interrupts come on SIM_IRQ_LED_DMA,
+  INDICATION_LED_IRQ has one every update as the TIM3 interrupt they
+  replaced. Of the LED channels only the status one is there, of the
+  buzzer voices only the UI one.
+****************************************************************************/
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "qti_system.h"
+#include "qti_indication.h"
+#include "melodies.h"
+#ifndef INDICATION_NO_STREAMS
+#include "melody_streams.h"
+#endif
+#include "tq_sim.h"
+#include "sim_irqs.h"
+
+
+#define MELODY_TIMER_RANGE        (256)
+#define BUZZER_TIMER_BASE         (16)
+#define LED_TIMER_BASE            (BUZZER_TIMER_BASE + MELODY_TIMER_RANGE)
+
+/* 20 bursts of 64us per half buffer, refilling one costs about 40us */
+#define BUZZER_DMA_HALF_PERIOD    (20 * 64)
+#define BUZZER_DMA_FILL_TIME      (40)
+
+/* 16 updates of 10ms per LED half buffer, filling one costs about 50us, an update interrupt 8us */
+#ifdef INDICATION_LED_IRQ
+#define LED_DMA_PERIOD            (10 * 1000)
+#define LED_DMA_FILL_TIME         (8)
+#else
+#define LED_DMA_PERIOD            (16 * 10 * 1000)
+#define LED_DMA_FILL_TIME         (50)
+#endif
+
+/* a stream pass ends in a DMA restart, a few us */
+#define BUZZER_STREAM_PASS_TIME   (5)
+
+typedef void (*HW_RUN)(boolean run);
+typedef void (*PLAY_FINISHED)(boolean finished);
+
+struct S_MELODY_PLAY
+{
+  HW_RUN hw_run;
+  PLAY_FINISHED play_finished;
+
+  const struct S_NOTE *melody;
+  uint16 note_index;
+  uint16 timer_id;
+  uint16 timer_base;
+  uint8  repeat;
+  boolean running;
+};
+
+static void play_melody(struct S_MELODY_PLAY *play, const struct S_NOTE *melody);
+static void stop_melody(struct S_MELODY_PLAY *play);
+static void melody_play_note(struct S_MELODY_PLAY *play);
+static void melody_timer_expired(struct S_MELODY_PLAY *play, uint16 id);
+static void hw_led_run(boolean run);
+static void hw_buzzer_run(boolean run);
+static void buzzer_dma_irq(uint8 irq, uint32 arg);
+static void led_dma_irq(uint8 irq, uint32 arg);
+static void play_led_finished(boolean finished);
+static void play_buzzer_finished(boolean finished);
+#ifndef INDICATION_NO_STREAMS
+static void play_buzzer_stream(const struct S_MELODY_STREAM *stream);
+#endif
+static void stop_buzzer_stream(void);
+static void buzzer_stream_pass_end(void);
+
+static uint8 _self;
+static uint8 _led_listener;
+static uint8 _buzzer_listener;
+static uint8 _led_melody_id;
+static uint8 _buzzer_melody_id;
+
+static struct S_MELODY_PLAY _led_play = {hw_led_run, play_led_finished, 0, 0, LED_TIMER_BASE, LED_TIMER_BASE, 0, FALSE};
+static struct S_MELODY_PLAY _buzzer_play = {hw_buzzer_run, play_buzzer_finished, 0, 0, BUZZER_TIMER_BASE, BUZZER_TIMER_BASE, 0, FALSE};
+
+static const struct S_MELODY_STREAM *_buzzer_stream;
+static uint8  _buzzer_stream_passes;
+static uint32 _buzzer_stream_time;          /* us a pass */
+
+
+void qti_indication_play_led(uint8 from, uint8 melody)
+{
+  stop_melody(&_led_play);
+  _led_listener = from;
+  if(melody < sizeof(_led_melody_table) / sizeof(_led_melody_table[0]))
+  {
+    _led_melody_id = melody + 1;
+    play_melody(&_led_play, _led_melody_table[melody]);
+  }
+}
+
+void qti_indication_stop_led(uint8 from)
+{
+  stop_melody(&_led_play);
+}
+
+void qti_indication_play_buzzer(uint8 from, uint8 melody)
+{
+  stop_melody(&_buzzer_play);
+  stop_buzzer_stream();
+  _buzzer_listener = from;
+  if(melody < sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0]))
+  {
+    _buzzer_melody_id = melody + 1;
+#ifndef INDICATION_NO_STREAMS
+    if(_buzzer_stream_table[melody].bursts)
+    {
+      play_buzzer_stream(&_buzzer_stream_table[melody]);
+      return;
+    }
+#endif
+    play_melody(&_buzzer_play, _buzzer_melody_table[melody]);
+  }
+}
+
+void qti_indication_stop_buzzer(uint8 from)
+{
+  stop_melody(&_buzzer_play);
+  stop_buzzer_stream();
+}
+
+void qti_indication_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint16 id;
+
+  if(from == QTI_SYSTEM)
+  {
+    if(sig == SYSTEM_NTF_START)
+    {
+      _self = self->self;
+      tq_sim_set_irq_handler(SIM_IRQ_BUZZER_DMA, buzzer_dma_irq);
+      tq_sim_set_irq_handler(SIM_IRQ_LED_DMA, led_dma_irq);
+    }
+    else if(sig == SYSTEM_RSP_TIMER)
+    {
+      id = *((uint16*)(p));
+      if(id >= LED_TIMER_BASE)
+        melody_timer_expired(&_led_play, id);
+      else
+        melody_timer_expired(&_buzzer_play, id);
+    }
+  }
+}
+
+/* MELODY_PLAY, every note lasts its period on a timer */
+static void play_melody(struct S_MELODY_PLAY *play, const struct S_NOTE *melody)
+{
+  play->melody = melody;
+  play->note_index = 0;
+  play->repeat = 255;
+  melody_play_note(play);
+}
+
+static void stop_melody(struct S_MELODY_PLAY *play)
+{
+  if(play->melody)
+  {
+    play->hw_run(FALSE);
+    qti_system_stop_timer(_self, play->timer_id);
+    play->melody = 0;
+    play->play_finished(FALSE);
+  }
+}
+
+static void melody_finish(struct S_MELODY_PLAY *play)
+{
+  play->melody = 0;
+  play->hw_run(FALSE);
+  play->play_finished(TRUE);
+}
+
+static void melody_play_note(struct S_MELODY_PLAY *play)
+{
+  const struct S_NOTE *note;
+  uint8  func;
+  uint16 period;
+
+  note = &(play->melody[play->note_index]);
+  func = TEMPO_GET_FUNC(note->tempo);
+  period = TEMPO_GET_PERIOD(note->tempo);
+  if(func == CTRL_STOP)
+  {
+    melody_finish(play);
+    return;
+  }
+
+  if(func == CTRL_REPT)
+  {
+    if(period && play->repeat > period)
+      play->repeat = period;
+
+    if(period && play->repeat)
+      play->repeat--;
+
+    if(!play->repeat)
+    {
+      melody_finish(play);
+      return;
+    }
+    play->note_index = 0;
+    note = play->melody;
+    period = TEMPO_GET_PERIOD(note->tempo);
+  }
+
+  play->hw_run(TEMPO_GET_FUNC(note->tempo) != WAVE_SLNT);
+  play->timer_id++;
+  if(play->timer_id >= play->timer_base + MELODY_TIMER_RANGE)
+    play->timer_id = play->timer_base;
+  qti_system_start_timer(_self, play->timer_id, period * 10);
+}
+
+static void melody_timer_expired(struct S_MELODY_PLAY *play, uint16 id)
+{
+  if(play->melody && id == play->timer_id)
+  {
+    play->note_index++;
+    melody_play_note(play);
+  }
+}
+
+/* the timers keep clocks running, hold a wait like the hardware */
+static void hw_run(struct S_MELODY_PLAY *play, boolean run)
+{
+  if(run == play->running)
+    return;
+
+  play->running = run;
+  if(run)
+    qti_system_request_wait(_self);
+  else
+    qti_system_release_wait(_self);
+}
+
+static void hw_led_run(boolean run)
+{
+  boolean running = _led_play.running;
+
+  hw_run(&_led_play, run);
+  if(run && !running)
+    tq_sim_raise_irq(tq_sim_now() + LED_DMA_PERIOD, SIM_IRQ_LED_DMA, TQ_SIM_DMA_FULL);
+  else if(!run)
+    tq_sim_cancel_irq(SIM_IRQ_LED_DMA);
+}
+
+static void led_dma_irq(uint8 irq, uint32 arg)
+{
+  tq_sim_consume(LED_DMA_FILL_TIME);
+  if(_led_play.running)
+    tq_sim_raise_irq(tq_sim_now() + LED_DMA_PERIOD - LED_DMA_FILL_TIME, SIM_IRQ_LED_DMA, TQ_SIM_DMA_FULL);
+}
+
+static void hw_buzzer_run(boolean run)
+{
+  boolean running = _buzzer_play.running;
+
+  hw_run(&_buzzer_play, run);
+  if(run && !running)
+    tq_sim_raise_irq(tq_sim_now() + BUZZER_DMA_HALF_PERIOD, SIM_IRQ_BUZZER_DMA, TQ_SIM_DMA_HALF);
+  else if(!run)
+    tq_sim_cancel_irq(SIM_IRQ_BUZZER_DMA);
+}
+
+static void buzzer_dma_irq(uint8 irq, uint32 arg)
+{
+  if(_buzzer_stream)
+  {
+    buzzer_stream_pass_end();
+    return;
+  }
+  tq_sim_consume(BUZZER_DMA_FILL_TIME);
+  if(_buzzer_play.running)
+    tq_sim_raise_irq(tq_sim_now() + BUZZER_DMA_HALF_PERIOD - BUZZER_DMA_FILL_TIME, SIM_IRQ_BUZZER_DMA,
+                     arg == TQ_SIM_DMA_HALF ? TQ_SIM_DMA_FULL : TQ_SIM_DMA_HALF);
+}
+
+#ifndef INDICATION_NO_STREAMS
+/* the length of a pass from the bursts, transfer complete as the last one is loaded */
+static void play_buzzer_stream(const struct S_MELODY_STREAM *stream)
+{
+  const uint16 *burst;
+
+  _buzzer_stream_time = 0;
+  for(burst = stream->bursts; burst < stream->bursts + 3 * (stream->burst_count - 1); burst += 3)
+    _buzzer_stream_time += ((uint32)burst[0] + 1) * (burst[1] + 1) / 4;
+
+  _buzzer_stream = stream;
+  _buzzer_stream_passes = stream->repeat;
+  qti_system_request_wait(_self);
+  tq_sim_raise_irq(tq_sim_now() + _buzzer_stream_time, SIM_IRQ_BUZZER_DMA, TQ_SIM_DMA_FULL);
+}
+#endif
+
+static void stop_buzzer_stream(void)
+{
+  if(_buzzer_stream)
+  {
+    tq_sim_cancel_irq(SIM_IRQ_BUZZER_DMA);
+    _buzzer_stream = 0;
+    qti_system_release_wait(_self);
+    play_buzzer_finished(FALSE);
+  }
+}
+
+static void buzzer_stream_pass_end(void)
+{
+  tq_sim_consume(BUZZER_STREAM_PASS_TIME);
+  if(_buzzer_stream_passes != 1)
+  {
+    if(_buzzer_stream_passes)
+      _buzzer_stream_passes--;
+    tq_sim_raise_irq(tq_sim_now() + _buzzer_stream_time - BUZZER_STREAM_PASS_TIME, SIM_IRQ_BUZZER_DMA, TQ_SIM_DMA_FULL);
+  }
+  else
+  {
+    _buzzer_stream = 0;
+    qti_system_release_wait(_self);
+    play_buzzer_finished(TRUE);
+  }
+}
+
+static void play_led_finished(boolean finished)
+{
+  uint8 p[2];
+
+  TQ_ASSERT(_led_melody_id);
+  p[0] = _led_melody_id - 1;
+  p[1] = INDICATION_LED_STATUS;
+  _led_melody_id = 0;
+  tinyq_send_signal(_self, _led_listener, INDICATION_NTF_LED_STOPPED, p, 2);
+}
+
+static void play_buzzer_finished(boolean finished)
+{
+  uint8 p[2];
+
+  TQ_ASSERT(_buzzer_melody_id);
+  p[0] = _buzzer_melody_id - 1;
+  p[1] = INDICATION_BUZZER_VOICE_UI;
+  tinyq_send_signal(_self, _buzzer_listener, INDICATION_NTF_BUZZER_STOPPED, p, 2);
+  _buzzer_melody_id = 0;
+}
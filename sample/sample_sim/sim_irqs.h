@@ -0,0 +1,19 @@
+/****************************************************************************
+  sim_irqs.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef SIM_IRQS_H
+#define SIM_IRQS_H
+
+/* interrupt lines of the simulated board, arg of the button line is the pin level */
+enum e_SIM_IRQS
+{
+  SIM_IRQ_SCRIPT = 0,
+  SIM_IRQ_REPLAY,
+  SIM_IRQ_BUTTON,
+  SIM_IRQ_BUZZER_DMA,
+  SIM_IRQ_LED_DMA,
+  _SIM_IRQ_COUNT_
+};
+
+#endif
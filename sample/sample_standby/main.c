@@ -0,0 +1,208 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of STANDBY on the virtual time port, a tracker taking a GPS
+  fix every period and counting them. A fix holds a wait for FIX_TIME,
+  the receiver streams over the UART, then the tracker sleeps until the
+  next one. Three ways sleep between fixes:
+
+    stop      STOP, RAM and the timers kept, woken by the RTC every second
+    cold      STANDBY, the reset boots cold: the RTC domain starts over,
+              SYSTEM_NTF_START sets the receiver up again and a fix goes
+              first since the timer is gone, the count is lost
+    warm      STANDBY, the reset boots warm: the fix timer and the count
+              come back from the retained words, SYSTEM_NTF_RESUME only
+              puts the pins and clocks back
+
+  The tracker retains its count, with the fix timer it fits the 16 bytes
+  the STM32F030 keeps in its backup registers. Every way runs in a
+  process of its own.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/sim -o sample_standby [a-z]*.c \
+       $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/sim/tq_port.c
+    sample_standby [-p fix period s] [-t hours]
+
+  A line per way gives the fixes taken and counted, the boots, the time
+  from a wakeup to the tracker ready, the share of the time in each mode
+  and the average current from the typical STM32F030 figures below.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "tq_sim.h"
+#include "qties.h"
+
+#define DEFAULT_PERIOD                      (60)            /* s */
+#define DEFAULT_HOURS                       (4)
+#define FIX_TIME                            (100)           /* ms holding a wait */
+#define COLD_INIT_US                        (20 * 1000)     /* receiver set up over the UART, pins and clocks */
+#define WARM_INIT_US                        (200)           /* pins and clocks */
+
+/* uA, 3.3V, 8MHz HSI, RTC on LSI */
+#define CURRENT_RUN                         (2000.0)
+#define CURRENT_WFI                         (800.0)
+#define CURRENT_STOP                        (5.0)
+#define CURRENT_STANDBY                     (2.0)
+
+#define TIMER_FIX                           (1)
+#define TIMER_FIX_DONE                      (2)
+
+#define WAY_STOP                            (0)
+#define WAY_COLD                            (1)
+#define WAY_WARM                            (2)
+#define WAYS                                (3)
+
+/* what the tracker keeps over STANDBY */
+struct TRACKER_RETAINED
+{
+  uint16 fixes;
+};
+
+static void run(void);
+static void tracker_boot(boolean warm);
+static void tracker_fix(void);
+
+static const char *_way_names[WAYS] = {"stop", "cold", "warm"};
+static const double _currents[TQ_SIM_SLEEP_MODES] = {CURRENT_WFI, CURRENT_STOP, CURRENT_STANDBY};
+
+static uint32 _period = DEFAULT_PERIOD;
+static uint32 _hours = DEFAULT_HOURS;
+static uint8  _way;
+
+/* the tracker, lost in STANDBY */
+static uint8  _self;
+static struct TRACKER_RETAINED _retained;
+
+/* measurement, on the host */
+static uint32 _taken;
+static uint32 _boots;
+static TQ_SIM_TIME _ready;                  /* wakeup to the tracker ready, summed */
+
+
+int main(int argc, char *argv[])
+{
+  int i, status;
+  pid_t child;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-p") && i + 1 < argc)
+      _period = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      _hours = atoi(argv[++i]);
+  }
+  if(!_period || !_hours)
+  {
+    fprintf(stderr, "a fix period and an hour at least\n");
+    return 1;
+  }
+
+  printf("a fix every %us for %uh, %u bytes retained\n", _period, _hours, _PT_RETAINED_WORDS * 4);
+  printf("%-5s %6s %7s %6s %9s %7s %7s %9s %9s %8s\n", "way", "fixes", "counted", "boots", "ready us", "wfi %",
+         "stop %", "standby %", "active %", "avg uA");
+  fflush(stdout);
+
+  for(_way = 0; _way < WAYS; _way++)
+  {
+    /* tq_sim_run() once per process */
+    child = fork();
+    if(!child)
+    {
+      run();
+      exit(0);
+    }
+    waitpid(child, &status, 0);
+    if(!WIFEXITED(status) || WEXITSTATUS(status))
+      return 1;
+  }
+  return 0;
+}
+
+static void run(void)
+{
+  struct TQ_SIM_SLEEP_STATS stats;
+  TQ_SIM_TIME end = (TQ_SIM_TIME)_hours * 3600 * 1000 * 1000;
+  TQ_SIM_TIME asleep = 0;
+  double charge = 0;
+  uint8 mode;
+
+  tq_sim_set_warm_boot((_way == WAY_WARM) ? TRUE : FALSE);
+  tq_sim_run(end);
+
+  tq_sim_get_sleep_stats(&stats);
+  for(mode = 0; mode < TQ_SIM_SLEEP_MODES; mode++)
+  {
+    asleep += stats.asleep[mode];
+    charge += _currents[mode] * stats.asleep[mode];
+  }
+  charge += CURRENT_RUN * (end - asleep);
+
+  printf("%-5s %6u %7u %6u %9.0f %7.3f %7.3f %9.3f %9.3f %8.2f\n", _way_names[_way], _taken, _retained.fixes,
+         _boots, _boots ? (double)_ready / _boots : 0.0, 100.0 * stats.asleep[QTI_SYSTEM_SLEEP_WFI] / end,
+         100.0 * stats.asleep[QTI_SYSTEM_SLEEP_STOP] / end, 100.0 * stats.asleep[QTI_SYSTEM_SLEEP_STANDBY] / end,
+         100.0 * (end - asleep) / end, charge / end);
+  fflush(stdout);
+}
+
+void qti_tracker_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint16 timer_id;
+
+  if(from != QTI_SYSTEM)
+    return;
+
+  if(sig == SYSTEM_NTF_START)
+  {
+    _self = self->self;
+    tracker_boot(FALSE);
+    tracker_fix();
+  }
+  else if(sig == SYSTEM_NTF_RESUME)
+  {
+    _self = self->self;
+    tracker_boot(TRUE);
+  }
+  else if(sig == SYSTEM_RSP_TIMER)
+  {
+    memcpy(&timer_id, p, sizeof(timer_id));
+    if(timer_id == TIMER_FIX)
+      tracker_fix();
+    else if(timer_id == TIMER_FIX_DONE)
+    {
+      qti_system_release_wait(_self);
+      _retained.fixes++;
+      _taken++;
+      qti_system_start_timer(_self, TIMER_FIX, _period * 1000);
+    }
+  }
+}
+
+/* RAM comes out of a reset cleared, as the startup code leaves it */
+static void tracker_boot(boolean warm)
+{
+  memset(&_retained, 0, sizeof(_retained));
+  qti_system_retain(_self, &_retained, sizeof(_retained));
+  tq_sim_consume(warm ? WARM_INIT_US : COLD_INIT_US);
+
+  if(tq_sim_wake_time())
+  {
+    _boots++;
+    _ready += tq_sim_now() - tq_sim_wake_time();
+  }
+  qti_system_allow_standby((_way != WAY_STOP) ? TRUE : FALSE);
+}
+
+static void tracker_fix(void)
+{
+  qti_system_request_wait(_self);
+  qti_system_start_timer(_self, TIMER_FIX_DONE, FIX_TIME);
+}
@@ -29,6 +29,14 @@ struct S_NOTE
   uint16 tempo;
 };
 
+/* a buzzer melody compiled by tools/melody_compile.c, DMA bursts of TIM17 ARR, RCR, CCR1 */
+struct S_MELODY_STREAM
+{
+  const uint16 *bursts;
+  uint16 burst_count;
+  uint8  repeat;                /* passes, 0 : infinite loop */
+};
+
 /*Wave forms*/
 static const uint8 _wave_table_zero[WAVE_TABLE_SIZE] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 static const uint8 _wave_table_linear[WAVE_TABLE_SIZE] = {0, 16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240};
@@ -36,7 +44,7 @@ static const uint8 _wave_table_sqr[WAVE_TABLE_SIZE] = {0, 1, 4, 9, 16, 25, 36, 4
 static const uint8 _wave_table_sin[WAVE_TABLE_SIZE] = {0, 25, 50, 74, 98, 121, 142, 162, 181, 198, 213, 226, 237, 245, 251, 255};
 static const uint8 _wave_table_cos[WAVE_TABLE_SIZE] = {0, 1, 5, 11, 19, 30, 43, 58, 75, 94, 114, 135, 158, 182, 206, 231};
 
-static const uint8* _wave_table[] =
+static const uint8 * const _wave_table[] =
 {
   _wave_table_zero,
   _wave_table_linear,
@@ -0,0 +1,294 @@
+/****************************************************************************
+  melody_streams.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Generated by tools/melody_compile.c from melodies.h, do not edit.
+  Bursts of TIM17 ARR, RCR, CCR1, periods held within 5.0 cents.
+****************************************************************************/
+#ifndef MELODY_STREAMS_H
+#define MELODY_STREAMS_H
+
+static const uint16 _buzzer_stream_0[] =
+{
+  0x0f9f, 0x0000, 0x07d0,  0x0f51, 0x0000, 0x07a9,  0x0f05, 0x0000, 0x0783,  0x0eb9, 0x0000, 0x075d,
+  0x0e7e, 0x0000, 0x073f,  0x0e3d, 0x0000, 0x071f,  0x0dff, 0x0000, 0x0700,  0x0dc6, 0x0000, 0x06e3,
+  0x0d8f, 0x0000, 0x06c8,  0x0d5d, 0x0000, 0x06af,  0x0d29, 0x0000, 0x0695,  0x0cfc, 0x0000, 0x067e,
+  0x0cce, 0x0000, 0x0667,  0x0ca3, 0x0000, 0x0652,  0x0c7c, 0x0000, 0x063e,  0x0c54, 0x0000, 0x062a,
+  0x0c2d, 0x0000, 0x0617,  0x0c04, 0x0000, 0x0602,  0x0be1, 0x0000, 0x05f1,  0x0bbf, 0x0000, 0x05e0,
+  0x0b9d, 0x0000, 0x05cf,  0x0b7c, 0x0000, 0x05be,  0x0b5e, 0x0000, 0x05af,  0x0b41, 0x0000, 0x05a1,
+  0x0b22, 0x0000, 0x0591,  0x0b04, 0x0000, 0x0582,  0x0ae6, 0x0000, 0x0573,  0x0acf, 0x0000, 0x0568,
+  0x0ab5, 0x0000, 0x055b,  0x0a9c, 0x0000, 0x054e,  0x0a83, 0x0000, 0x0542,  0x0a6a, 0x0000, 0x0535,
+  0x0a53, 0x0000, 0x052a,  0x0a3b, 0x0000, 0x051e,  0x0a24, 0x0000, 0x0512,  0x0a0d, 0x0000, 0x0507,
+  0x09f9, 0x0000, 0x04fd,  0x09e6, 0x0000, 0x04f3,  0x09d1, 0x0000, 0x04e9,  0x09be, 0x0000, 0x04df,
+  0x09ac, 0x0000, 0x04d6,  0x099b, 0x0000, 0x04ce,  0x0989, 0x0000, 0x04c5,  0x0977, 0x0000, 0x04bc,
+  0x0964, 0x0000, 0x04b2,  0x0953, 0x0000, 0x04aa,  0x0942, 0x0000, 0x04a1,  0x0933, 0x0000, 0x049a,
+  0x0922, 0x0000, 0x0491,  0x0912, 0x0000, 0x0489,  0x0900, 0x0000, 0x0480,  0x08f1, 0x0000, 0x0479,
+  0x08e5, 0x0000, 0x0473,  0x08d7, 0x0000, 0x046c,  0x08c9, 0x0000, 0x0465,  0x08bb, 0x0000, 0x045e,
+  0x08ad, 0x0000, 0x0457,  0x08a0, 0x0000, 0x0450,  0x0895, 0x0000, 0x044b,  0x0888, 0x0000, 0x0444,
+  0x087b, 0x0000, 0x043e,  0x086e, 0x0000, 0x0437,  0x0861, 0x0000, 0x0431,  0x0855, 0x0000, 0x042b,
+  0x084a, 0x0000, 0x0425,  0x083e, 0x0000, 0x041f,  0x0832, 0x0000, 0x0419,  0x0826, 0x0000, 0x0413,
+  0x081b, 0x0000, 0x040e,  0x0810, 0x0005, 0x0408,  0x07cf, 0x0000, 0x03e8,  0x07e7, 0x0000, 0x03f4,
+  0x0800, 0x0000, 0x0400,  0x081a, 0x0000, 0x040d,  0x0838, 0x0000, 0x041c,  0x0854, 0x0000, 0x042a,
+  0x0874, 0x0000, 0x043a,  0x0895, 0x0000, 0x044b,  0x08b2, 0x0000, 0x0459,  0x08d5, 0x0000, 0x046b,
+  0x08fa, 0x0000, 0x047d,  0x091f, 0x0000, 0x0490,  0x0945, 0x0000, 0x04a3,  0x0973, 0x0000, 0x04ba,
+  0x099d, 0x0000, 0x04cf,  0x09cc, 0x0000, 0x04e6,  0x09fe, 0x0000, 0x04ff,  0x0a2d, 0x0000, 0x0517,
+  0x0a6a, 0x0000, 0x0535,  0x0aa8, 0x0000, 0x0554,  0x0ae2, 0x0000, 0x0571,  0x0b28, 0x0000, 0x0594,
+  0x0b71, 0x0000, 0x05b9,  0x0bc5, 0x0000, 0x05e3,  0x0c17, 0x0000, 0x060c,  0x0c7f, 0x0000, 0x0640,
+  0x0cec, 0x0000, 0x0676,  0x0d57, 0x0000, 0x06ac,  0x0ddf, 0x0000, 0x06f0,  0x0e69, 0x0000, 0x0735,
+  0x0eb2, 0x0000, 0x0759,  0x0f9f, 0x0000, 0x07d0,  0x0ed9, 0x0000, 0x076d,  0x0e3d, 0x0000, 0x071f,
+  0x0dae, 0x0000, 0x06d7,  0x0d29, 0x0000, 0x0695,  0x0cb6, 0x0000, 0x065b,  0x0c4d, 0x0000, 0x0627,
+  0x0be8, 0x0000, 0x05f4,  0x0b99, 0x0000, 0x05cd,  0x0b4f, 0x0000, 0x05a8,  0x0b00, 0x0000, 0x0580,
+  0x0abe, 0x0000, 0x055f,  0x0a7d, 0x0000, 0x053f,  0x0a40, 0x0000, 0x0520,  0x0a05, 0x0000, 0x0503,
+  0x09d3, 0x0000, 0x04ea,  0x09a3, 0x0000, 0x04d2,  0x0979, 0x0000, 0x04bd,  0x094c, 0x0000, 0x04a6,
+  0x0925, 0x0000, 0x0493,  0x08fb, 0x0000, 0x047e,  0x08d7, 0x0000, 0x046c,  0x08b3, 0x0000, 0x045a,
+  0x0896, 0x0000, 0x044b,  0x0875, 0x0000, 0x043b,  0x0855, 0x0000, 0x042b,  0x0839, 0x0000, 0x041d,
+  0x081b, 0x0000, 0x040e,  0x0810, 0x0001, 0x0408,  0x018f, 0x0000, 0x0000,  0x018f, 0x0000, 0x0000,
+};
+
+static const uint16 _buzzer_stream_1[] =
+{
+  0x0930, 0x0000, 0x0498,  0x0924, 0x0000, 0x0492,  0x0916, 0x0000, 0x048b,  0x0908, 0x0000, 0x0484,
+  0x08fb, 0x0000, 0x047e,  0x08f1, 0x0000, 0x0479,  0x08e5, 0x0000, 0x0473,  0x08d9, 0x0000, 0x046d,
+  0x08cf, 0x0000, 0x0468,  0x08c4, 0x0000, 0x0462,  0x08b8, 0x0000, 0x045c,  0x08ae, 0x0000, 0x0457,
+  0x08a3, 0x0000, 0x0452,  0x0898, 0x0000, 0x044c,  0x088f, 0x0000, 0x0448,  0x0885, 0x0000, 0x0443,
+  0x087b, 0x0000, 0x043e,  0x0871, 0x0000, 0x0439,  0x0867, 0x0000, 0x0434,  0x085c, 0x0000, 0x042e,
+  0x0853, 0x0000, 0x042a,  0x0849, 0x0000, 0x0425,  0x083f, 0x0000, 0x0420,  0x0836, 0x0000, 0x041b,
+  0x082c, 0x0000, 0x0416,  0x0822, 0x0000, 0x0411,  0x081a, 0x0000, 0x040d,  0x0810, 0x0000, 0x0408,
+  0x0806, 0x0000, 0x0403,  0x07fe, 0x0000, 0x03ff,  0x07f6, 0x0000, 0x03fb,  0x07ee, 0x0000, 0x03f7,
+  0x07e7, 0x0000, 0x03f4,  0x07df, 0x0000, 0x03f0,  0x07d8, 0x0000, 0x03ec,  0x07d0, 0x0000, 0x03e8,
+  0x07c9, 0x0000, 0x03e5,  0x07c1, 0x0000, 0x03e1,  0x07b9, 0x0000, 0x03dd,  0x07b2, 0x0000, 0x03d9,
+  0x07ab, 0x0000, 0x03d6,  0x07a4, 0x0000, 0x03d2,  0x079c, 0x0000, 0x03ce,  0x0795, 0x0000, 0x03cb,
+  0x078e, 0x0000, 0x03c7,  0x0787, 0x0000, 0x03c4,  0x0780, 0x0000, 0x03c0,  0x0779, 0x0000, 0x03bd,
+  0x0772, 0x0000, 0x03b9,  0x076c, 0x0000, 0x03b6,  0x0765, 0x0000, 0x03b3,  0x075f, 0x0000, 0x03b0,
+  0x0758, 0x0000, 0x03ac,  0x0751, 0x0000, 0x03a9,  0x074a, 0x0000, 0x03a5,  0x0743, 0x0000, 0x03a2,
+  0x073d, 0x0000, 0x039f,  0x0737, 0x0000, 0x039c,  0x0731, 0x0000, 0x0399,  0x072a, 0x0000, 0x0395,
+  0x0723, 0x0000, 0x0392,  0x071d, 0x0000, 0x038f,  0x0717, 0x0000, 0x038c,  0x0711, 0x0000, 0x0389,
+  0x070a, 0x0000, 0x0385,  0x0705, 0x0000, 0x0383,  0x06ff, 0x0000, 0x0380,  0x06f6, 0x0001, 0x037b,
+  0x06ec, 0x0001, 0x0376,  0x06e2, 0x0001, 0x0371,  0x06d8, 0x0001, 0x036c,  0x06ce, 0x0001, 0x0367,
+  0x06c4, 0x0001, 0x0362,  0x06ba, 0x0001, 0x035d,  0x06b1, 0x0001, 0x0359,  0x06a7, 0x0001, 0x0354,
+  0x069f, 0x0001, 0x0350,  0x0695, 0x0001, 0x034b,  0x068c, 0x0001, 0x0346,  0x0683, 0x0001, 0x0342,
+  0x067a, 0x0001, 0x033d,  0x0671, 0x0001, 0x0339,  0x0668, 0x0001, 0x0334,  0x0660, 0x0001, 0x0330,
+  0x0657, 0x0001, 0x032c,  0x064f, 0x0001, 0x0328,  0x0646, 0x0001, 0x0323,  0x063e, 0x0001, 0x031f,
+  0x0636, 0x0001, 0x031b,  0x062e, 0x0001, 0x0317,  0x0626, 0x0001, 0x0313,  0x061e, 0x0001, 0x030f,
+  0x0616, 0x0001, 0x030b,  0x060e, 0x0001, 0x0307,  0x0606, 0x0001, 0x0303,  0x05ff, 0x0001, 0x0300,
+  0x05f8, 0x0001, 0x02fc,  0x05f2, 0x0001, 0x02f9,  0x05ec, 0x0001, 0x02f6,  0x05e6, 0x0001, 0x02f3,
+  0x05df, 0x0001, 0x02f0,  0x05d9, 0x0001, 0x02ed,  0x05d3, 0x0001, 0x02ea,  0x05cd, 0x0001, 0x02e7,
+  0x05c7, 0x0001, 0x02e4,  0x05c1, 0x0001, 0x02e1,  0x05bb, 0x0001, 0x02de,  0x05b6, 0x0001, 0x02db,
+  0x05b0, 0x0001, 0x02d8,  0x05aa, 0x0001, 0x02d5,  0x05a4, 0x0001, 0x02d2,  0x059f, 0x0001, 0x02d0,
+  0x0599, 0x0001, 0x02cd,  0x0594, 0x0001, 0x02ca,  0x058e, 0x0001, 0x02c7,  0x0589, 0x0001, 0x02c5,
+  0x0583, 0x0001, 0x02c2,  0x057e, 0x0001, 0x02bf,  0x0579, 0x0001, 0x02bd,  0x0573, 0x0001, 0x02ba,
+  0x056e, 0x0001, 0x02b7,  0x0569, 0x0001, 0x02b5,  0x0564, 0x0001, 0x02b2,  0x055f, 0x0001, 0x02b0,
+  0x055a, 0x0001, 0x02ad,  0x0555, 0x0001, 0x02ab,  0x0550, 0x0001, 0x02a8,  0x054b, 0x0001, 0x02a6,
+  0x0546, 0x0001, 0x02a3,  0x0541, 0x0001, 0x02a1,  0x053c, 0x0001, 0x029e,  0x0537, 0x0001, 0x029c,
+  0x0532, 0x0001, 0x0299,  0x052e, 0x0001, 0x0297,  0x0529, 0x0001, 0x0295,  0x0524, 0x0001, 0x0292,
+  0x0520, 0x0001, 0x0290,  0x051b, 0x0001, 0x028e,  0x0516, 0x0001, 0x028b,  0x0512, 0x0001, 0x0289,
+  0x050d, 0x0001, 0x0287,  0x0509, 0x0001, 0x0285,  0x0504, 0x0001, 0x0282,  0x0500, 0x0001, 0x0280,
+  0x04fb, 0x0002, 0x027e,  0x04f6, 0x0002, 0x027b,  0x04f1, 0x0002, 0x0279,  0x04eb, 0x0002, 0x0276,
+  0x04e6, 0x0002, 0x0273,  0x04e1, 0x0002, 0x0271,  0x04dc, 0x0002, 0x026e,  0x04d7, 0x0002, 0x026c,
+  0x04d2, 0x0002, 0x0269,  0x04cd, 0x0002, 0x0267,  0x04c8, 0x0002, 0x0264,  0x04c4, 0x0002, 0x0262,
+  0x04bf, 0x0002, 0x0260,  0x04ba, 0x0002, 0x025d,  0x04b5, 0x0002, 0x025b,  0x04b1, 0x0002, 0x0259,
+  0x04ac, 0x0002, 0x0256,  0x04a7, 0x0002, 0x0254,  0x04a3, 0x0002, 0x0252,  0x049e, 0x0002, 0x024f,
+  0x049a, 0x0002, 0x024d,  0x0495, 0x0002, 0x024b,  0x0491, 0x0002, 0x0249,  0x048d, 0x0002, 0x0247,
+  0x0488, 0x0002, 0x0244,  0x0484, 0x0002, 0x0242,  0x0480, 0x0002, 0x0240,  0x047b, 0x0002, 0x023e,
+  0x0477, 0x0002, 0x023c,  0x0473, 0x0002, 0x023a,  0x046e, 0x0002, 0x0237,  0x046a, 0x0002, 0x0235,
+  0x0466, 0x0002, 0x0233,  0x0462, 0x0002, 0x0231,  0x045e, 0x0002, 0x022f,  0x045a, 0x0002, 0x022d,
+  0x0456, 0x0002, 0x022b,  0x0452, 0x0002, 0x0229,  0x044e, 0x0002, 0x0227,  0x044a, 0x0002, 0x0225,
+  0x0446, 0x0002, 0x0223,  0x0442, 0x0020, 0x0221,  0x041d, 0x0002, 0x020f,  0x0421, 0x0002, 0x0211,
+  0x0425, 0x0002, 0x0213,  0x0429, 0x0002, 0x0215,  0x042d, 0x0002, 0x0217,  0x0431, 0x0002, 0x0219,
+  0x0435, 0x0002, 0x021b,  0x0439, 0x0002, 0x021d,  0x043d, 0x0002, 0x021f,  0x0441, 0x0002, 0x0221,
+  0x0445, 0x0002, 0x0223,  0x0449, 0x0002, 0x0225,  0x044d, 0x0002, 0x0227,  0x0452, 0x0002, 0x0229,
+  0x0456, 0x0002, 0x022b,  0x045a, 0x0002, 0x022d,  0x045f, 0x0002, 0x0230,  0x0463, 0x0002, 0x0232,
+  0x0468, 0x0002, 0x0234,  0x046c, 0x0002, 0x0236,  0x0471, 0x0002, 0x0239,  0x0475, 0x0002, 0x023b,
+  0x047a, 0x0002, 0x023d,  0x047f, 0x0002, 0x0240,  0x0483, 0x0002, 0x0242,  0x0488, 0x0002, 0x0244,
+  0x048d, 0x0002, 0x0247,  0x0492, 0x0002, 0x0249,  0x0496, 0x0002, 0x024b,  0x049b, 0x0002, 0x024e,
+  0x04a0, 0x0002, 0x0250,  0x04a5, 0x0002, 0x0253,  0x04a9, 0x0001, 0x0255,  0x04ad, 0x0002, 0x0257,
+  0x04b2, 0x0002, 0x0259,  0x04b7, 0x0002, 0x025c,  0x04bc, 0x0002, 0x025e,  0x04c2, 0x0002, 0x0261,
+  0x04c7, 0x0002, 0x0264,  0x04cc, 0x0002, 0x0266,  0x04d1, 0x0002, 0x0269,  0x04d7, 0x0002, 0x026c,
+  0x04dc, 0x0002, 0x026e,  0x04e1, 0x0001, 0x0271,  0x04e5, 0x0002, 0x0273,  0x04eb, 0x0002, 0x0276,
+  0x04f1, 0x0002, 0x0279,  0x04f6, 0x0002, 0x027b,  0x04fb, 0x0002, 0x027e,  0x0501, 0x0001, 0x0281,
+  0x0505, 0x0001, 0x0283,  0x050a, 0x0001, 0x0285,  0x050f, 0x0001, 0x0288,  0x0514, 0x0001, 0x028a,
+  0x0519, 0x0001, 0x028d,  0x051e, 0x0001, 0x028f,  0x0523, 0x0001, 0x0292,  0x0528, 0x0001, 0x0294,
+  0x052d, 0x0001, 0x0297,  0x0533, 0x0001, 0x029a,  0x0538, 0x0001, 0x029c,  0x053d, 0x0001, 0x029f,
+  0x0542, 0x0001, 0x02a1,  0x0548, 0x0001, 0x02a4,  0x054d, 0x0001, 0x02a7,  0x0552, 0x0001, 0x02a9,
+  0x0558, 0x0001, 0x02ac,  0x055d, 0x0001, 0x02af,  0x0563, 0x0001, 0x02b2,  0x0569, 0x0001, 0x02b5,
+  0x056e, 0x0001, 0x02b7,  0x0573, 0x0001, 0x02ba,  0x0579, 0x0001, 0x02bd,  0x057f, 0x0001, 0x02c0,
+  0x0584, 0x0001, 0x02c2,  0x058a, 0x0001, 0x02c5,  0x0591, 0x0001, 0x02c9,  0x0596, 0x0001, 0x02cb,
+  0x059c, 0x0001, 0x02ce,  0x05a3, 0x0001, 0x02d2,  0x05a9, 0x0001, 0x02d5,  0x05af, 0x0001, 0x02d8,
+  0x05b5, 0x0001, 0x02db,  0x05bb, 0x0001, 0x02de,  0x05c2, 0x0001, 0x02e1,  0x05c8, 0x0001, 0x02e4,
+  0x05cf, 0x0001, 0x02e8,  0x05d5, 0x0001, 0x02eb,  0x05dc, 0x0001, 0x02ee,  0x05e2, 0x0001, 0x02f1,
+  0x05e9, 0x0001, 0x02f5,  0x05f0, 0x0001, 0x02f8,  0x05f6, 0x0001, 0x02fb,  0x05fd, 0x0001, 0x02ff,
+  0x0605, 0x0001, 0x0303,  0x060d, 0x0001, 0x0307,  0x0616, 0x0001, 0x030b,  0x061e, 0x0001, 0x030f,
+  0x0627, 0x0001, 0x0314,  0x062f, 0x0001, 0x0318,  0x0638, 0x0001, 0x031c,  0x0641, 0x0001, 0x0321,
+  0x064a, 0x0001, 0x0325,  0x0653, 0x0001, 0x032a,  0x065a, 0x0000, 0x032d,  0x0662, 0x0001, 0x0331,
+  0x066b, 0x0001, 0x0336,  0x0673, 0x0000, 0x033a,  0x0677, 0x0000, 0x033c,  0x067c, 0x0000, 0x033e,
+  0x0681, 0x0000, 0x0341,  0x0686, 0x0000, 0x0343,  0x068b, 0x0000, 0x0346,  0x0690, 0x0000, 0x0348,
+  0x0695, 0x0000, 0x034b,  0x069a, 0x0000, 0x034d,  0x06a1, 0x0001, 0x0351,  0x06a8, 0x0000, 0x0354,
+  0x06ad, 0x0000, 0x0357,  0x06b2, 0x0000, 0x0359,  0x06b7, 0x0000, 0x035c,  0x06bd, 0x0000, 0x035f,
+  0x06c2, 0x0000, 0x0361,  0x06c7, 0x0000, 0x0364,  0x06cc, 0x0000, 0x0366,  0x06d2, 0x0000, 0x0369,
+  0x06d7, 0x0000, 0x036c,  0x06dc, 0x0000, 0x036e,  0x06e2, 0x0000, 0x0371,  0x06e7, 0x0000, 0x0374,
+  0x06ed, 0x0000, 0x0377,  0x06f2, 0x0000, 0x0379,  0x06f8, 0x0000, 0x037c,  0x06fe, 0x0000, 0x037f,
+  0x0703, 0x0000, 0x0382,  0x070a, 0x0000, 0x0385,  0x0711, 0x0000, 0x0389,  0x0718, 0x0000, 0x038c,
+  0x071e, 0x0000, 0x038f,  0x0725, 0x0000, 0x0393,  0x072c, 0x0000, 0x0396,  0x0733, 0x0000, 0x039a,
+  0x073a, 0x0000, 0x039d,  0x0741, 0x0000, 0x03a1,  0x0748, 0x0000, 0x03a4,  0x0750, 0x0000, 0x03a8,
+  0x0757, 0x0000, 0x03ac,  0x075e, 0x0000, 0x03af,  0x0765, 0x0000, 0x03b3,  0x076c, 0x0000, 0x03b6,
+  0x0774, 0x0000, 0x03ba,  0x077b, 0x0000, 0x03be,  0x0782, 0x0000, 0x03c1,  0x078a, 0x0000, 0x03c5,
+  0x0791, 0x0000, 0x03c9,  0x0799, 0x0000, 0x03cd,  0x07a1, 0x0000, 0x03d1,  0x07a9, 0x0000, 0x03d5,
+  0x07b0, 0x0000, 0x03d8,  0x07b8, 0x0000, 0x03dc,  0x07c0, 0x0000, 0x03e0,  0x07c9, 0x0000, 0x03e5,
+  0x07d1, 0x0000, 0x03e9,  0x07d9, 0x0000, 0x03ed,  0x07e1, 0x0000, 0x03f1,  0x07e9, 0x0000, 0x03f5,
+  0x07f3, 0x0000, 0x03fa,  0x07fb, 0x0000, 0x03fe,  0x0803, 0x0000, 0x0402,  0x080d, 0x0000, 0x0407,
+  0x0818, 0x0000, 0x040c,  0x0821, 0x0000, 0x0411,  0x082c, 0x0000, 0x0416,  0x0836, 0x0000, 0x041b,
+  0x0840, 0x0000, 0x0420,  0x084b, 0x0000, 0x0426,  0x0855, 0x0000, 0x042b,  0x0860, 0x0000, 0x0430,
+  0x086b, 0x0000, 0x0436,  0x0876, 0x0000, 0x043b,  0x0886, 0x000e, 0x0443,  0x018f, 0x0000, 0x0000,
+  0x018f, 0x0000, 0x0000,
+};
+
+static const uint16 _buzzer_stream_2[] =
+{
+  0x06f3, 0x0003, 0x037a,  0x06fa, 0x0003, 0x037d,  0x06ff, 0x0002, 0x0380,  0x0705, 0x0002, 0x0383,
+  0x070b, 0x0002, 0x0386,  0x0710, 0x0002, 0x0388,  0x0716, 0x0002, 0x038b,  0x071c, 0x0002, 0x038e,
+  0x0722, 0x0002, 0x0391,  0x0728, 0x0002, 0x0394,  0x072e, 0x0002, 0x0397,  0x0734, 0x0002, 0x039a,
+  0x073a, 0x0002, 0x039d,  0x0740, 0x0002, 0x03a0,  0x0747, 0x0002, 0x03a4,  0x074d, 0x0002, 0x03a7,
+  0x0753, 0x0002, 0x03aa,  0x0759, 0x0002, 0x03ad,  0x0760, 0x0002, 0x03b0,  0x0766, 0x0002, 0x03b3,
+  0x076c, 0x0002, 0x03b6,  0x0773, 0x0002, 0x03ba,  0x0779, 0x0002, 0x03bd,  0x0780, 0x0002, 0x03c0,
+  0x0787, 0x0002, 0x03c4,  0x078e, 0x0002, 0x03c7,  0x0794, 0x0002, 0x03ca,  0x079b, 0x0002, 0x03ce,
+  0x07a2, 0x0002, 0x03d1,  0x07a8, 0x0002, 0x03d4,  0x07b0, 0x0002, 0x03d8,  0x07b6, 0x0002, 0x03db,
+  0x07bd, 0x0002, 0x03df,  0x07c4, 0x0002, 0x03e2,  0x07cc, 0x0002, 0x03e6,  0x07d3, 0x0002, 0x03ea,
+  0x07da, 0x0002, 0x03ed,  0x07e1, 0x0002, 0x03f1,  0x07e9, 0x0002, 0x03f5,  0x07f0, 0x0002, 0x03f8,
+  0x07f7, 0x0002, 0x03fc,  0x07ff, 0x0002, 0x0400,  0x0807, 0x0002, 0x0404,  0x080e, 0x0001, 0x0407,
+  0x0816, 0x0002, 0x040b,  0x081f, 0x0002, 0x0410,  0x0827, 0x0002, 0x0414,  0x082f, 0x0001, 0x0418,
+  0x0836, 0x0002, 0x041b,  0x083f, 0x0002, 0x0420,  0x0849, 0x0002, 0x0425,  0x0850, 0x0001, 0x0428,
+  0x0858, 0x0002, 0x042c,  0x0861, 0x0002, 0x0431,  0x086b, 0x0002, 0x0436,  0x0874, 0x0002, 0x043a,
+  0x087c, 0x0001, 0x043e,  0x0884, 0x0002, 0x0442,  0x088e, 0x0002, 0x0447,  0x0898, 0x0002, 0x044c,
+  0x08a0, 0x0001, 0x0450,  0x08a9, 0x0002, 0x0455,  0x08b3, 0x0002, 0x045a,  0x08bd, 0x0002, 0x045f,
+  0x08c6, 0x0001, 0x0463,  0x08ce, 0x0002, 0x0467,  0x08d8, 0x0002, 0x046c,  0x08e3, 0x0002, 0x0472,
+  0x08ee, 0x0002, 0x0477,  0x08f7, 0x0001, 0x047c,  0x0900, 0x0002, 0x0480,  0x090a, 0x0001, 0x0485,
+  0x0913, 0x0001, 0x048a,  0x091b, 0x0001, 0x048e,  0x0923, 0x0001, 0x0492,  0x092b, 0x0001, 0x0496,
+  0x0933, 0x0001, 0x049a,  0x093c, 0x0001, 0x049e,  0x0944, 0x0001, 0x04a2,  0x094d, 0x0001, 0x04a7,
+  0x0957, 0x0001, 0x04ac,  0x095f, 0x0001, 0x04b0,  0x0968, 0x0001, 0x04b4,  0x0971, 0x0001, 0x04b9,
+  0x0979, 0x0001, 0x04bd,  0x0982, 0x0001, 0x04c1,  0x098b, 0x0001, 0x04c6,  0x0995, 0x0001, 0x04cb,
+  0x099f, 0x0001, 0x04d0,  0x09a8, 0x0001, 0x04d4,  0x09b1, 0x0001, 0x04d9,  0x09ba, 0x0001, 0x04dd,
+  0x09c4, 0x0001, 0x04e2,  0x09cd, 0x0001, 0x04e7,  0x09d7, 0x0001, 0x04ec,  0x09e1, 0x0001, 0x04f1,
+  0x09eb, 0x0001, 0x04f6,  0x09f5, 0x0001, 0x04fb,  0x09ff, 0x0001, 0x0500,  0x0a0a, 0x0001, 0x0505,
+  0x0a15, 0x0001, 0x050b,  0x0a20, 0x0001, 0x0510,  0x0a2c, 0x0001, 0x0516,  0x0a38, 0x0001, 0x051c,
+  0x0a43, 0x0001, 0x0522,  0x0a4f, 0x0001, 0x0528,  0x0a5b, 0x0001, 0x052e,  0x0a67, 0x0001, 0x0534,
+  0x0a73, 0x0001, 0x053a,  0x0a7f, 0x0001, 0x0540,  0x0a8c, 0x0001, 0x0546,  0x0a98, 0x0001, 0x054c,
+  0x0aa5, 0x0001, 0x0553,  0x0ab2, 0x0001, 0x0559,  0x0abe, 0x0001, 0x055f,  0x0acb, 0x0001, 0x0566,
+  0x0ad8, 0x0001, 0x056c,  0x0ae5, 0x0001, 0x0573,  0x0af3, 0x0001, 0x057a,  0x0b00, 0x0001, 0x0580,
+  0x0b0f, 0x0001, 0x0588,  0x0b1e, 0x0001, 0x058f,  0x0b2d, 0x0001, 0x0597,  0x0b3d, 0x0001, 0x059f,
+  0x0b4c, 0x0001, 0x05a6,  0x0b58, 0x0000, 0x05ac,  0x0b64, 0x0001, 0x05b2,  0x0b6f, 0x0000, 0x05b8,
+  0x0b78, 0x0000, 0x05bc,  0x0b84, 0x0001, 0x05c2,  0x0b90, 0x0000, 0x05c8,  0x0b99, 0x0000, 0x05cd,
+  0x0ba5, 0x0001, 0x05d3,  0x0bb1, 0x0000, 0x05d9,  0x0bba, 0x0000, 0x05dd,  0x0bc6, 0x0001, 0x05e3,
+  0x0bd3, 0x0000, 0x05ea,  0x0bdc, 0x0000, 0x05ee,  0x0be9, 0x0001, 0x05f5,  0x0bf6, 0x0000, 0x05fb,
+  0x0bff, 0x0000, 0x0600,  0x0c09, 0x0000, 0x0605,  0x0c12, 0x0000, 0x0609,  0x0c1c, 0x0000, 0x060e,
+  0x0c25, 0x0000, 0x0613,  0x0c2f, 0x0000, 0x0618,  0x0c39, 0x0000, 0x061d,  0x0c43, 0x0000, 0x0622,
+  0x0c4f, 0x0000, 0x0628,  0x0c59, 0x0000, 0x062d,  0x0c63, 0x0000, 0x0632,  0x0c6d, 0x0000, 0x0637,
+  0x0c77, 0x0000, 0x063c,  0x0c82, 0x0000, 0x0641,  0x0c8c, 0x0000, 0x0646,  0x0c96, 0x0000, 0x064b,
+  0x0ca1, 0x0000, 0x0651,  0x0cab, 0x0000, 0x0656,  0x0cb6, 0x0000, 0x065b,  0x0cc0, 0x0000, 0x0660,
+  0x0cce, 0x0000, 0x0667,  0x0cd8, 0x0000, 0x066c,  0x0ce3, 0x0000, 0x0672,  0x0cee, 0x0000, 0x0677,
+  0x0cf9, 0x0000, 0x067d,  0x0d04, 0x0000, 0x0682,  0x0d0f, 0x0000, 0x0688,  0x0d1e, 0x0000, 0x068f,
+  0x0d29, 0x0000, 0x0695,  0x0d37, 0x0000, 0x069c,  0x0d43, 0x0000, 0x06a2,  0x0d4e, 0x0000, 0x06a7,
+  0x0d5d, 0x0000, 0x06af,  0x0d68, 0x0000, 0x06b4,  0x0d77, 0x0000, 0x06bc,  0x0d83, 0x0000, 0x06c2,
+  0x0d92, 0x0000, 0x06c9,  0x0d9e, 0x0000, 0x06cf,  0x0dab, 0x0000, 0x06d6,  0x0dba, 0x0000, 0x06dd,
+  0x0dc6, 0x0000, 0x06e3,  0x0dd6, 0x0000, 0x06eb,  0x0de3, 0x0000, 0x06f2,  0x0df2, 0x0000, 0x06f9,
+  0x0dff, 0x0000, 0x0700,  0x0e0f, 0x0000, 0x0708,  0x0e20, 0x0000, 0x0710,  0x0e2d, 0x000f, 0x0717,
+  0x0f3d, 0x0000, 0x079f,  0x0da8, 0x0000, 0x06d4,  0x0c75, 0x0000, 0x063b,  0x0b96, 0x0000, 0x05cb,
+  0x0ad7, 0x0000, 0x056c,  0x0a4a, 0x0000, 0x0525,  0x09be, 0x0000, 0x04df,  0x094c, 0x0000, 0x04a6,
+  0x08ef, 0x0000, 0x0478,  0x089a, 0x0000, 0x044d,  0x0854, 0x0000, 0x042a,  0x080a, 0x0000, 0x0405,
+  0x07c4, 0x0000, 0x03e2,  0x078a, 0x0000, 0x03c5,  0x075c, 0x0000, 0x03ae,  0x0730, 0x0001, 0x0398,
+  0x018f, 0x0000, 0x0000,  0x018f, 0x0000, 0x0000,
+};
+
+static const uint16 _buzzer_stream_3[] =
+{
+  0x08ba, 0x00ff, 0x045d,  0x08ba, 0x00ff, 0x045d,  0x08ba, 0x00ff, 0x045d,  0x08ba, 0x00ff, 0x045d,
+  0x08ba, 0x009d, 0x045d,  0x0c7f, 0x00ff, 0x0640,  0x0c7f, 0x00ff, 0x0640,  0x0c7f, 0x00c8, 0x0640,
+  0x018f, 0x0000, 0x0000,  0x018f, 0x0000, 0x0000,
+};
+
+static const uint16 _buzzer_stream_4[] =
+{
+  0x18f0, 0x0001, 0x0c78,  0x18d1, 0x0001, 0x0c69,  0x18b8, 0x0000, 0x0c5c,  0x189f, 0x0001, 0x0c50,
+  0x1886, 0x0000, 0x0c43,  0x186e, 0x0001, 0x0c37,  0x1856, 0x0000, 0x0c2b,  0x183d, 0x0001, 0x0c1f,
+  0x1821, 0x0001, 0x0c11,  0x1809, 0x0000, 0x0c05,  0x17f1, 0x0001, 0x0bf9,  0x17d5, 0x0001, 0x0beb,
+  0x17be, 0x0000, 0x0bdf,  0x17a7, 0x0001, 0x0bd4,  0x178c, 0x0001, 0x0bc6,  0x1771, 0x0001, 0x0bb9,
+  0x175a, 0x0000, 0x0bad,  0x1744, 0x0001, 0x0ba2,  0x1729, 0x0001, 0x0b95,  0x170f, 0x0001, 0x0b88,
+  0x16f5, 0x0001, 0x0b7b,  0x16db, 0x0001, 0x0b6e,  0x16c6, 0x0000, 0x0b63,  0x16b1, 0x0001, 0x0b59,
+  0x16a4, 0x0000, 0x0b52,  0x168f, 0x0001, 0x0b48,  0x1676, 0x0001, 0x0b3b,  0x165e, 0x0001, 0x0b2f,
+  0x1645, 0x0001, 0x0b23,  0x162d, 0x0001, 0x0b17,  0x1615, 0x0001, 0x0b0b,  0x15fd, 0x0001, 0x0aff,
+  0x15e5, 0x0001, 0x0af3,  0x15ce, 0x0001, 0x0ae7,  0x15b6, 0x0001, 0x0adb,  0x159c, 0x0002, 0x0ace,
+  0x1581, 0x0001, 0x0ac1,  0x156a, 0x0001, 0x0ab5,  0x1550, 0x0002, 0x0aa8,  0x1536, 0x0001, 0x0a9b,
+  0x1520, 0x0001, 0x0a90,  0x1507, 0x0002, 0x0a84,  0x14ed, 0x0001, 0x0a77,  0x14d4, 0x0002, 0x0a6a,
+  0x14b8, 0x0002, 0x0a5c,  0x14a0, 0x0001, 0x0a50,  0x1487, 0x0002, 0x0a44,  0x146c, 0x0002, 0x0a36,
+  0x1451, 0x0002, 0x0a29,  0x1439, 0x0001, 0x0a1d,  0x1422, 0x0002, 0x0a11,  0x1407, 0x0002, 0x0a04,
+  0x13ed, 0x0002, 0x09f7,  0x13d3, 0x0002, 0x09ea,  0x13ba, 0x0002, 0x09dd,  0x13a6, 0x0001, 0x09d3,
+  0x1397, 0x0001, 0x09cc,  0x1381, 0x0002, 0x09c1,  0x1368, 0x0002, 0x09b4,  0x1356, 0x0001, 0x09ab,
+  0x1346, 0x0001, 0x09a3,  0x1331, 0x0002, 0x0999,  0x1319, 0x0002, 0x098d,  0x1307, 0x0001, 0x0984,
+  0x12f5, 0x0002, 0x097b,  0x12de, 0x0002, 0x096f,  0x12cc, 0x0001, 0x0966,  0x12bb, 0x0002, 0x095e,
+  0x12a4, 0x0002, 0x0952,  0x1296, 0x0001, 0x094b,  0x1282, 0x0002, 0x0941,  0x1272, 0x0001, 0x0939,
+  0x1261, 0x0002, 0x0931,  0x1250, 0x0001, 0x0928,  0x1240, 0x0002, 0x0920,  0x122a, 0x0002, 0x0915,
+  0x121a, 0x0001, 0x090d,  0x120a, 0x0002, 0x0905,  0x11fa, 0x0001, 0x08fd,  0x11ea, 0x0002, 0x08f5,
+  0x11da, 0x0001, 0x08ed,  0x11cb, 0x0002, 0x08e6,  0x11bb, 0x0002, 0x08de,  0x11a7, 0x0002, 0x08d4,
+  0x1198, 0x0002, 0x08cc,  0x1183, 0x0002, 0x08c2,  0x1174, 0x0002, 0x08ba,  0x1160, 0x0002, 0x08b0,
+  0x1152, 0x0002, 0x08a9,  0x113e, 0x0002, 0x089f,  0x112f, 0x0002, 0x0898,  0x111c, 0x0002, 0x088e,
+  0x110e, 0x0002, 0x0887,  0x1100, 0x0001, 0x0880,  0x10f1, 0x0002, 0x0879,  0x10e3, 0x0002, 0x0872,
+  0x10d5, 0x0002, 0x086b,  0x10c3, 0x0002, 0x0862,  0x10b5, 0x0002, 0x085b,  0x10a7, 0x0002, 0x0854,
+  0x109c, 0x0001, 0x084e,  0x108c, 0x0002, 0x0846,  0x107f, 0x0002, 0x0840,  0x1072, 0x0002, 0x0839,
+  0x1064, 0x0001, 0x0832,  0x1057, 0x0002, 0x082c,  0x104a, 0x0002, 0x0825,  0x103d, 0x0002, 0x081f,
+  0x1030, 0x0001, 0x0818,  0x1023, 0x0002, 0x0812,  0x1016, 0x0002, 0x080b,  0x100a, 0x0002, 0x0805,
+  0x0ffd, 0x0001, 0x07ff,  0x0ff1, 0x0002, 0x07f9,  0x0fe4, 0x0002, 0x07f2,  0x0fd8, 0x0002, 0x07ec,
+  0x0fcb, 0x0002, 0x07e6,  0x0fbf, 0x0002, 0x07e0,  0x0fb3, 0x0002, 0x07da,  0x0fa7, 0x0002, 0x07d4,
+  0x0f9b, 0x0002, 0x07ce,  0x0f8f, 0x0002, 0x07c8,  0x0f83, 0x0002, 0x07c2,  0x0f77, 0x0002, 0x07bc,
+  0x0f6c, 0x0002, 0x07b6,  0x0f60, 0x0002, 0x07b0,  0x0f51, 0x0002, 0x07a9,  0x0f45, 0x0002, 0x07a3,
+  0x0f3a, 0x0002, 0x079d,  0x0f2e, 0x0002, 0x0797,  0x0f23, 0x0002, 0x0792,  0x0f18, 0x0002, 0x078c,
+  0x0f0d, 0x0002, 0x0787,  0x0f00, 0x0003, 0x0780,  0x0ef1, 0x0003, 0x0779,  0x0ee2, 0x0003, 0x0771,
+  0x0ed3, 0x0004, 0x076a,  0x0ec6, 0x0003, 0x0763,  0x0eb7, 0x0003, 0x075c,  0x0ea9, 0x0003, 0x0755,
+  0x0e9b, 0x0003, 0x074e,  0x0e8d, 0x0003, 0x0747,  0x0e80, 0x0004, 0x0740,  0x0e72, 0x0003, 0x0739,
+  0x0e64, 0x0003, 0x0732,  0x0e56, 0x0003, 0x072b,  0x0e49, 0x0003, 0x0725,  0x0e3b, 0x0004, 0x071e,
+  0x0e2e, 0x0003, 0x0717,  0x0e21, 0x0003, 0x0711,  0x0e14, 0x0003, 0x070a,  0x0e07, 0x0003, 0x0704,
+  0x0dfa, 0x0004, 0x06fd,  0x0dee, 0x0003, 0x06f7,  0x0de1, 0x0004, 0x06f1,  0x0dd4, 0x0003, 0x06ea,
+  0x0dc8, 0x0004, 0x06e4,  0x0dbb, 0x0003, 0x06de,  0x0daf, 0x0004, 0x06d8,  0x0da3, 0x0003, 0x06d2,
+  0x0d96, 0x0004, 0x06cb,  0x0d8b, 0x0003, 0x06c6,  0x0d7f, 0x0004, 0x06c0,  0x0d73, 0x0003, 0x06ba,
+  0x0d67, 0x0004, 0x06b4,  0x0d5b, 0x0003, 0x06ae,  0x0d50, 0x0004, 0x06a8,  0x0d44, 0x0003, 0x06a2,
+  0x0d39, 0x0004, 0x069d,  0x0d2d, 0x0003, 0x0697,  0x0d22, 0x0004, 0x0691,  0x0d16, 0x0003, 0x068b,
+  0x0d0c, 0x0004, 0x0686,  0x0d00, 0x0003, 0x0680,  0x0cf6, 0x0004, 0x067b,  0x0ceb, 0x0004, 0x0676,
+  0x0ce0, 0x0004, 0x0670,  0x0cd5, 0x0004, 0x066b,  0x0cc9, 0x0004, 0x0665,  0x0cbf, 0x0004, 0x0660,
+  0x0cb4, 0x0004, 0x065a,  0x0ca9, 0x0004, 0x0655,  0x0c9f, 0x0003, 0x0650,  0x0c96, 0x0004, 0x064b,
+  0x0c8b, 0x0004, 0x0646,  0x0c81, 0x0004, 0x0641,  0x0c76, 0x0004, 0x063b,  0x0c6c, 0x0004, 0x0636,
+  0x0c61, 0x0004, 0x0631,  0x0c57, 0x0004, 0x062c,  0x0c4e, 0x0003, 0x0627,  0x0c45, 0x0004, 0x0623,
+  0x0c3b, 0x0004, 0x061e,  0x0c31, 0x0004, 0x0619,  0x0c27, 0x0004, 0x0614,  0x0c1d, 0x0004, 0x060f,
+  0x0c13, 0x0004, 0x060a,  0x0c09, 0x0004, 0x0605,  0x0c00, 0x0004, 0x0600,  0x0bf7, 0x0004, 0x05fc,
+  0x0bee, 0x0004, 0x05f7,  0x0be4, 0x0005, 0x05f2,  0x0bdb, 0x0004, 0x05ee,  0x0bd2, 0x0004, 0x05e9,
+  0x0bc9, 0x0005, 0x05e5,  0x0bbf, 0x0004, 0x05e0,  0x0bb7, 0x0004, 0x05dc,  0x0bae, 0x0005, 0x05d7,
+  0x0ba5, 0x0004, 0x05d3,  0x0b9c, 0x0004, 0x05ce,  0x0b93, 0x0004, 0x05ca,  0x0b8a, 0x0005, 0x05c5,
+  0x0b81, 0x0004, 0x05c1,  0x0b79, 0x0004, 0x05bd,  0x0b70, 0x0005, 0x05b8,  0x0b68, 0x0004, 0x05b4,
+  0x0b5f, 0x0004, 0x05b0,  0x0b57, 0x0005, 0x05ac,  0x0b4e, 0x0004, 0x05a7,  0x0b45, 0x0006, 0x05a3,
+  0x0b3b, 0x0005, 0x059e,  0x0b31, 0x0006, 0x0599,  0x0b26, 0x0006, 0x0593,  0x0b1c, 0x0005, 0x058e,
+  0x0b12, 0x0006, 0x0589,  0x0b08, 0x0006, 0x0584,  0x0afd, 0x0006, 0x057f,  0x0af4, 0x0006, 0x057a,
+  0x0aeb, 0x0006, 0x0576,  0x0ae1, 0x0007, 0x0571,  0x0ad7, 0x0006, 0x056c,  0x0acd, 0x0006, 0x0567,
+  0x0ac4, 0x0007, 0x0562,  0x0aba, 0x0006, 0x055d,  0x0ab1, 0x0006, 0x0559,  0x0aa8, 0x0007, 0x0554,
+  0x0a9e, 0x0006, 0x054f,  0x0a95, 0x0006, 0x054b,  0x0a8c, 0x0007, 0x0546,  0x0a83, 0x0006, 0x0542,
+  0x0a7a, 0x0006, 0x053d,  0x0a71, 0x0007, 0x0539,  0x0a67, 0x0006, 0x0534,  0x0a5f, 0x0006, 0x0530,
+  0x0a57, 0x0006, 0x052c,  0x0a4e, 0x0007, 0x0527,  0x0a45, 0x0006, 0x0523,  0x0a3d, 0x0006, 0x051f,
+  0x0a34, 0x0007, 0x051a,  0x0a2b, 0x0006, 0x0516,  0x0a23, 0x0006, 0x0512,  0x0a1a, 0x0007, 0x050d,
+  0x0a12, 0x0006, 0x0509,  0x0a0a, 0x0006, 0x0505,  0x0a01, 0x0007, 0x0501,  0x09f9, 0x0007, 0x04fd,
+  0x09f1, 0x0007, 0x04f9,  0x09e9, 0x006a, 0x04f5,  0xdf35, 0x0006, 0x0000,  0x0005, 0x0000, 0x0000,
+  0x018f, 0x0000, 0x0000,  0x018f, 0x0000, 0x0000,
+};
+
+static const uint16 _buzzer_stream_5[] =
+{
+  0x06e1, 0x00ff, 0x0371,  0x06e1, 0x00ff, 0x0371,  0x06e1, 0x0070, 0x0371,  0xf423, 0x000f, 0x0000,
+  0x018f, 0x0000, 0x0000,  0x018f, 0x0000, 0x0000,
+};
+
+static const struct S_MELODY_STREAM _buzzer_stream_table[] =
+{
+  {_buzzer_stream_0, sizeof(_buzzer_stream_0) / sizeof(_buzzer_stream_0[0]) / 3, 1},
+  {_buzzer_stream_1, sizeof(_buzzer_stream_1) / sizeof(_buzzer_stream_1[0]) / 3, 0},
+  {_buzzer_stream_2, sizeof(_buzzer_stream_2) / sizeof(_buzzer_stream_2[0]) / 3, 0},
+  {_buzzer_stream_3, sizeof(_buzzer_stream_3) / sizeof(_buzzer_stream_3[0]) / 3, 0},
+  {_buzzer_stream_4, sizeof(_buzzer_stream_4) / sizeof(_buzzer_stream_4[0]) / 3, 0},
+  {_buzzer_stream_5, sizeof(_buzzer_stream_5) / sizeof(_buzzer_stream_5[0]) / 3, 0},
+};
+
+#endif
@@ -0,0 +1,208 @@
+/****************************************************************************
+  pwm_engine.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "interpolator.h"
+#include "melodies.h"
+#include "pwm_engine.h"
+
+static void channel_play_note(struct S_PWM_ENGINE *engine, uint8 channel);
+static void channel_finish(struct S_PWM_ENGINE *engine, uint8 channel, boolean finished);
+
+
+void pwm_engine_init(struct S_PWM_ENGINE *engine, uint8 channel_count, uint16 step, uint16 factor_x,
+                     PWM_ENGINE_FINISHED finished)
+{
+  TQ_ASSERT(channel_count && channel_count <= PWM_ENGINE_CHANNELS_MAX && step);
+
+  memset(engine, 0, sizeof(*engine));
+  engine->channel_count = channel_count;
+  engine->step = step;
+  engine->factor_x = factor_x;
+  engine->finished = finished;
+}
+
+void pwm_engine_play(struct S_PWM_ENGINE *engine, uint8 channel, const struct S_NOTE *melody)
+{
+  struct S_PWM_CHANNEL *ch = &engine->channels[channel];
+
+  TQ_ASSERT(channel < engine->channel_count);
+
+  ch->melody = melody;
+  ch->note_index = 0;
+  ch->repeat = 255;
+  engine->active |= (1 << channel);
+  channel_play_note(engine, channel);
+}
+
+void pwm_engine_stop(struct S_PWM_ENGINE *engine, uint8 channel)
+{
+  TQ_ASSERT(channel < engine->channel_count);
+
+  if(engine->active & (1 << channel))
+    channel_finish(engine, channel, FALSE);
+}
+
+/*
+  updates * channel_count values, a channel at a time with a stride of
+  channel_count. TRUE when any channel played a note in the block, FALSE
+  for a block of silences and stopped channels only.
+*/
+boolean pwm_engine_fill(struct S_PWM_ENGINE *engine, uint16 *out, uint16 updates)
+{
+  struct S_PWM_CHANNEL *ch;
+  uint16 scratch[PWM_ENGINE_SCRATCH];
+  uint16 *p, done, n, i;
+  boolean sounding = FALSE;
+  uint8  stride = engine->channel_count;
+  uint8  c;
+
+  for(c = 0; c < stride; c++)
+  {
+    ch = &engine->channels[c];
+    p = out + c;
+    done = 0;
+    while(done < updates)
+    {
+      if(!(engine->active & (1 << c)))
+      {
+        for(; done < updates; done++, p += stride)
+          *p = 0;
+      }
+      else if(ch->silence)
+      {
+        n = (ch->silence < updates - done) ? ch->silence : updates - done;
+        ch->silence -= n;
+        for(done += n; n; n--, p += stride)
+          *p = 0;
+        if(!ch->silence)
+        {
+          ch->note_index++;
+          channel_play_note(engine, c);
+        }
+      }
+      else
+      {
+        n = (updates - done < PWM_ENGINE_SCRATCH) ? updates - done : PWM_ENGINE_SCRATCH;
+        n = interpolator_fill(&ch->interpolator, engine->step, scratch, n);
+        for(i = 0; i < n; i++, p += stride)
+          *p = ch->descending ? ch->tone - scratch[i] : ch->tone + scratch[i];
+        done += n;
+        sounding = TRUE;
+        if(interpolator_at_end(&ch->interpolator))
+        {
+          ch->note_index++;
+          channel_play_note(engine, c);
+        }
+      }
+    }
+  }
+  return sounding;
+}
+
+/* updates until a channel playing has a note again, 0 while one has or none plays */
+uint16 pwm_engine_rest(const struct S_PWM_ENGINE *engine)
+{
+  uint16 rest = 0;
+  uint8  c;
+
+  for(c = 0; c < engine->channel_count; c++)
+  {
+    if(!(engine->active & (1 << c)))
+      continue;
+    if(!engine->channels[c].silence)
+      return 0;
+    if(!rest || engine->channels[c].silence < rest)
+      rest = engine->channels[c].silence;
+  }
+  return rest;
+}
+
+/* the silences on by updates without a value, a note is not skipped into */
+void pwm_engine_skip(struct S_PWM_ENGINE *engine, uint16 updates)
+{
+  struct S_PWM_CHANNEL *ch;
+  uint16 left, n;
+  uint8  c;
+
+  for(c = 0; c < engine->channel_count; c++)
+  {
+    ch = &engine->channels[c];
+    left = updates;
+    while(left && (engine->active & (1 << c)) && ch->silence)
+    {
+      n = (ch->silence < left) ? ch->silence : left;
+      ch->silence -= n;
+      left -= n;
+      if(!ch->silence)
+      {
+        ch->note_index++;
+        channel_play_note(engine, c);
+      }
+    }
+  }
+}
+
+/* melody_play_note() of qti_indication.c, a silence counts updates instead of a timer */
+static void channel_play_note(struct S_PWM_ENGINE *engine, uint8 channel)
+{
+  struct S_PWM_CHANNEL *ch = &engine->channels[channel];
+  const struct S_NOTE *note;
+  int16  base;
+  uint8  func;
+  uint16 period;
+
+  note = &(ch->melody[ch->note_index]);
+  func = TEMPO_GET_FUNC(note->tempo);
+  period = TEMPO_GET_PERIOD(note->tempo);
+  if(func == CTRL_STOP)
+  {
+    channel_finish(engine, channel, TRUE);
+    return;
+  }
+
+  if(func == CTRL_REPT)
+  {
+    if(period && ch->repeat > period)
+      ch->repeat = period;
+
+    if(period && ch->repeat)
+      ch->repeat--;
+
+    if(!ch->repeat)
+    {
+      channel_finish(engine, channel, TRUE);
+      return;
+    }
+    ch->note_index = 0;
+  }
+
+  note = &(ch->melody[ch->note_index]);
+  func = TEMPO_GET_FUNC(note->tempo);
+  period = TEMPO_GET_PERIOD(note->tempo);
+  if(func == WAVE_SLNT)
+  {
+    ch->silence = (uint16)((uint32)period * 10 / engine->step);
+    ch->silence = ch->silence ? ch->silence : 1;
+  }
+  else
+  {
+    base = note[1].tone - note[0].tone;
+    ch->tone = note->tone;
+    ch->descending = (base < 0);
+    interpolator_init(&(ch->interpolator), period * 10 * engine->factor_x, base < 0 ? -base : base,
+                      _wave_table[func], WAVE_TABLE_SIZE);
+  }
+}
+
+static void channel_finish(struct S_PWM_ENGINE *engine, uint8 channel, boolean finished)
+{
+  engine->active &= ~(1 << channel);
+  engine->channels[channel].melody = 0;
+  engine->channels[channel].silence = 0;
+  if(engine->finished)
+    engine->finished(channel, finished);
+}
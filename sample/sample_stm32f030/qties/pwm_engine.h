@@ -0,0 +1,56 @@
+/****************************************************************************
+  pwm_engine.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef PWM_ENGINE_H
+#define PWM_ENGINE_H
+
+/*
+  Melodies of melodies.h on the channels of a PWM timer, each with a note
+  walk and an interpolator of its own. pwm_engine_fill() writes a block of
+  updates, the compare values of all channels of an update side by side as
+  a DMA burst of the timer takes them. Notes, silences and repeats go on
+  within the fill, no timer and no interrupt a note. A stopped channel is
+  filled with 0. While every channel playing rests, pwm_engine_skip()
+  walks their silences on without filling, the timer can stop meanwhile.
+*/
+
+#ifndef PWM_ENGINE_CHANNELS_MAX
+#define PWM_ENGINE_CHANNELS_MAX             (4)             /* compare channels of a timer */
+#endif
+
+#define PWM_ENGINE_SCRATCH                  (16)            /* updates interpolated at a time */
+
+typedef void (*PWM_ENGINE_FINISHED)(uint8 channel, boolean finished);
+
+struct S_PWM_CHANNEL
+{
+  const struct S_NOTE *melody;
+  uint16 note_index;
+  uint16 silence;                           /* updates left of a silence */
+  uint8  repeat;
+  boolean descending;
+  int16  tone;
+  struct S_INTERPOLATOR interpolator;
+};
+
+struct S_PWM_ENGINE
+{
+  uint8  channel_count;
+  uint8  active;                            /* a bit a channel playing */
+  uint16 step;                              /* ms an update */
+  uint16 factor_x;
+  PWM_ENGINE_FINISHED finished;
+  struct S_PWM_CHANNEL channels[PWM_ENGINE_CHANNELS_MAX];
+};
+
+
+extern void    pwm_engine_init(struct S_PWM_ENGINE *engine, uint8 channel_count, uint16 step, uint16 factor_x,
+                               PWM_ENGINE_FINISHED finished);
+extern void    pwm_engine_play(struct S_PWM_ENGINE *engine, uint8 channel, const struct S_NOTE *melody);
+extern void    pwm_engine_stop(struct S_PWM_ENGINE *engine, uint8 channel);
+extern boolean pwm_engine_fill(struct S_PWM_ENGINE *engine, uint16 *out, uint16 updates);
+extern uint16  pwm_engine_rest(const struct S_PWM_ENGINE *engine);
+extern void    pwm_engine_skip(struct S_PWM_ENGINE *engine, uint16 updates);
+
+#endif
@@ -13,7 +13,7 @@
 #include "hw_gpio.h"
 #include "stm32f0xx_rcc.h"
 
-#define TIMER_DEBOUNCE                      (0x01)
+#define SIG_EXTI_EDGE                       TQ_SIG_MAKE_NTF(TQ_DSP_HIGH, 1)     /* from hw_exti.c */
 #define DEBOUNCE_PERIOD                     (100)
 
 #define GPIO_PIN_BUTTON                     (13)
@@ -22,12 +22,11 @@
 #define EXTI_PIN_BUTTON                     EXTI_PinSource13
 
 static void io_init(void);
-static void button_state_exti_irq(void);
-static void button_debounce_timeout(void);
+static void button_edge(const uint8 *p);
 
 static uint8 _self;
 static uint8 _listener = 0;
-static boolean _debouncing = FALSE;
+static uint8 _reported = 0;
 
 
 void qti_button_set_listener(uint8 qti)
@@ -37,8 +36,6 @@ void qti_button_set_listener(uint8 qti)
 
 void qti_button_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
 {
-  uint16 timer_id;
-  
   if(from == QTI_SYSTEM)
   {
     if(sig == SYSTEM_NTF_START)
@@ -47,11 +44,9 @@ void qti_button_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, c
       io_init();
     }
     else if(sig == SYSTEM_RSP_TIMER)
-    {
-      timer_id = *((uint16*)(p));
-      if(timer_id == TIMER_DEBOUNCE)
-        button_debounce_timeout();
-    }
+      hw_exti_timer_expired(*((uint16*)(p)));
+    else if(sig == SIG_EXTI_EDGE)
+      button_edge(p);
   }
 }
 
@@ -65,22 +60,21 @@ static void io_init(void)
   GPIO_MODE(GPIOC, GPIO_PIN_BUTTON, GPIO_MODE_INPUT);
   GPIO_PUPD(GPIOC, GPIO_PIN_BUTTON, GPIO_PULL_DOWN);
   
-  hw_exti_set(EXTI_PORT_BUTTON, EXTI_PIN_BUTTON, EXTI_Trigger_Rising_Falling, button_state_exti_irq);
+  /* the first edge of a press at once, the bounces behind it masked */
+  hw_exti_post(EXTI_PORT_BUTTON, EXTI_PIN_BUTTON, EXTI_Trigger_Rising_Falling, _self, SIG_EXTI_EDGE, DEBOUNCE_PERIOD);
 }
 
-static void button_state_exti_irq(void)
+static void button_edge(const uint8 *p)
 {
-  if(!_debouncing)
+  struct S_STM32_EXTI_EDGE edge;
+  uint8 evt;
+
+  memcpy(&edge, p, sizeof(edge));
+  hw_exti_holdoff(&edge);
+  evt = (edge.level == 0) ? BUTTON_NTF_DOWN : BUTTON_NTF_UP;
+  if(evt != _reported)
   {
-    _debouncing = TRUE;
-    qti_system_start_timer(_self, TIMER_DEBOUNCE, DEBOUNCE_PERIOD);
+    _reported = evt;
+    tinyq_send_signal(_self, _listener, evt, 0, 0);
   }
 }
-
-static void button_debounce_timeout(void)
-{
-  uint8 evt = (GPIO_GET_BITS(GPIOC, GPIO_BIT(GPIO_PIN_BUTTON)) == 0) ? BUTTON_NTF_DOWN : BUTTON_NTF_UP;
-
-  _debouncing = FALSE;
-  tinyq_send_signal(_self, _listener, evt, 0, 0);
-}
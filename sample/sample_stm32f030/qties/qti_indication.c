@@ -6,55 +6,88 @@
 #include "tq_types.h"
 #include "hw_debug.h"
 #include "interpolator.h"
+#include "tone.h"
 #include "tinyq.h"
+#include "tq_port.h"
 #include "qties.h"
 #include "qti_system.h"
 #include "qti_indication.h"
 #include "hw_gpio.h"
+#include "hw_dma.h"
 #include "stm32f0xx_rcc.h"
 #include "melodies.h"
+#include "pwm_engine.h"
+#ifndef INDICATION_NO_STREAMS
+#include "melody_streams.h"
+#endif
 
+#define INDICATION_LCL_LED_REST             TQ_SIG_MAKE_LCL(0)
+#define INDICATION_LCL_BUZZER_REST          TQ_SIG_MAKE_LCL(1)
 
-#define MELODY_TIMER_RANGE        (256)
-#define BUZZER_TIMER_BASE         (16)
-#define LED_TIMER_BASE            (BUZZER_TIMER_BASE + MELODY_TIMER_RANGE)
-
+#define TIMER_LED_REST                      (1)
+#define TIMER_BUZZER_REST                   (2)
 
 static void init_led(void);
-static void stop_led(void);
-static void play_led(uint8 id);
-static void stop_buzzer(void);
-static void play_buzzer(uint8 id);
+static void stop_led(uint8 channel);
+static void play_led(uint8 channel, uint8 id);
+static void stop_buzzer(uint8 voice);
+static void play_buzzer(uint8 voice, uint8 from, uint8 id);
 static void init_buzzer(void);
-static void timer_expire_handler(uint16 id);
+static void led_rest_timer(void);
+static void led_rest_expired(void);
+static void buzzer_rest_timer(void);
+static void buzzer_rest_expired(void);
 
 
 static uint8 _self;
-static uint8 _led_listener;
-static uint8 _buzzer_listener;
+static uint8 _led_listener[INDICATION_LED_CHANNELS];
 
 void qti_indication_play_led(uint8 from, uint8 melody)
 {
-  stop_led();
-  _led_listener = from;
-  play_led(melody);
+  qti_indication_play_led_channel(from, INDICATION_LED_STATUS, melody);
 }
 
 void qti_indication_stop_led(uint8 from)
 {
-  stop_led();
+  qti_indication_stop_led_channel(from, INDICATION_LED_STATUS);
+}
+
+void qti_indication_play_led_channel(uint8 from, uint8 channel, uint8 melody)
+{
+  if(channel >= INDICATION_LED_CHANNELS)
+    return;
+
+  stop_led(channel);
+  _led_listener[channel] = from;
+  play_led(channel, melody);
+}
+
+void qti_indication_stop_led_channel(uint8 from, uint8 channel)
+{
+  if(channel < INDICATION_LED_CHANNELS)
+    stop_led(channel);
 }
 
 void qti_indication_play_buzzer(uint8 from, uint8 melody)
 {
-  stop_buzzer();
-  _buzzer_listener = from;
-  play_buzzer(melody);
+  qti_indication_play_buzzer_voice(from, INDICATION_BUZZER_VOICE_UI, melody);
 }
 
 void qti_indication_stop_buzzer(uint8 from)
 {
-  stop_buzzer();
+  qti_indication_stop_buzzer_voice(from, INDICATION_BUZZER_VOICE_UI);
+}
+
+void qti_indication_play_buzzer_voice(uint8 from, uint8 voice, uint8 melody)
+{
+  if(voice < INDICATION_BUZZER_VOICES)
+    play_buzzer(voice, from, melody);
+}
+
+void qti_indication_stop_buzzer_voice(uint8 from, uint8 voice)
+{
+  if(voice < INDICATION_BUZZER_VOICES)
+    stop_buzzer(voice);
 }
 
 void qti_indication_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
@@ -68,25 +101,34 @@ void qti_indication_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 si
       init_buzzer();
     }
     else if(sig == SYSTEM_RSP_TIMER)
-      timer_expire_handler(*((uint16*)(p)));
+    {
+      if(*((uint16*)(p)) == TIMER_LED_REST)
+        led_rest_expired();
+      else if(*((uint16*)(p)) == TIMER_BUZZER_REST)
+        buzzer_rest_expired();
+    }
   }
+  else if(from == _self && sig == INDICATION_LCL_LED_REST)
+    led_rest_timer();
+  else if(from == _self && sig == INDICATION_LCL_BUZZER_REST)
+    buzzer_rest_timer();
 }
 
 /* MELODY_PLAY */
-typedef void (*HW_PLAY)(const struct S_NOTE*, struct S_INTERPOLATOR*, boolean descending);
-typedef void (*HW_STOP)(void);
-typedef void (*PLAY_FINISHED)(boolean finished);
+struct S_MELODY_PLAY;
+
+typedef void (*HW_PLAY)(struct S_MELODY_PLAY *play, const struct S_NOTE*, struct S_INTERPOLATOR*, boolean descending);
+typedef void (*HW_SILENCE)(struct S_MELODY_PLAY *play, uint16 period);
+typedef void (*PLAY_FINISHED)(struct S_MELODY_PLAY *play, boolean finished);
 
 struct S_MELODY_PLAY
 {
   HW_PLAY hw_play;
-  HW_STOP hw_stop;
+  HW_SILENCE hw_silence;
   PLAY_FINISHED play_finished;
   
   const struct S_NOTE *melody;
   uint16 note_index;
-  uint16 timer_id;
-  uint16 timer_base;
   uint16 factor_x;
   uint8  repeat;
   struct S_INTERPOLATOR interpolator;
@@ -96,8 +138,6 @@ static void melody_play_note(struct S_MELODY_PLAY *play);
 
 static void play_melody(struct S_MELODY_PLAY *play, const struct S_NOTE *melody, uint16 factor_x)
 {
-  play->hw_stop();
-  
   play->melody = melody;
   play->factor_x = factor_x;
   play->note_index = 0;
@@ -109,10 +149,8 @@ static void stop_melody(struct S_MELODY_PLAY *play)
 {
   if(play->melody)
   {
-    play->hw_stop();
-    qti_system_stop_timer(_self, play->timer_id);
     play->melody = 0;
-    play->play_finished(FALSE);
+    play->play_finished(play, FALSE);
   }
 }
 
@@ -129,8 +167,7 @@ static void melody_play_note(struct S_MELODY_PLAY *play)
   if(func == CTRL_STOP)
   {
     play->melody = 0;
-    play->hw_stop();
-    play->play_finished(TRUE);
+    play->play_finished(play, TRUE);
     return;
   }
   
@@ -147,8 +184,7 @@ static void melody_play_note(struct S_MELODY_PLAY *play)
     else
     {
       play->melody = 0;
-      play->hw_stop();
-      play->play_finished(TRUE);
+      play->play_finished(play, TRUE);
       return;
     }
   }
@@ -157,19 +193,13 @@ static void melody_play_note(struct S_MELODY_PLAY *play)
   func = TEMPO_GET_FUNC(note->tempo); 
   period = TEMPO_GET_PERIOD(note->tempo);
   if(func == WAVE_SLNT)
-  {
-    play->hw_stop();
-    play->timer_id++;
-    if(play->timer_id >= play->timer_base + MELODY_TIMER_RANGE)
-      play->timer_id = play->timer_base;
-    qti_system_start_timer(_self, play->timer_id, period * 10);
-  }
+    play->hw_silence(play, period);
   else
   {
     base = note[1].tone - note[0].tone;
     interpolator_init(&(play->interpolator), period * 10 * play->factor_x, base < 0 ? -base : base,
             _wave_table[func], WAVE_TABLE_SIZE);
-    play->hw_play(note, &(play->interpolator), base < 0);
+    play->hw_play(play, note, &(play->interpolator), base < 0);
   }
 }
 
@@ -179,13 +209,21 @@ static void melody_play_next_note(struct S_MELODY_PLAY *play)
   melody_play_note(play);
 }
 
-static void melody_timer_expired(struct S_MELODY_PLAY *play, uint16 id)
-{
-  if(play->melody && id == play->timer_id)
-    melody_play_next_note(play);
-}
-
 /* LED indication */
+/*
+  The channels of TIM3 run melodies of their own on one pwm_engine, a DMA
+  burst on every update writes CCR1 to CCR4 from _led_dma_buffer. The
+  half and full transfer interrupts refill a half each, LED_DMA_UPDATES / 2
+  updates apart whatever the number of channels playing. A melody played
+  starts from the next half filled.
+
+  Once both halves are filled silent TIM3 and the DMA stop and the wait
+  goes, as when nothing plays. With channels resting a system timer then
+  ends the rest, the engine is LED_DMA_UPDATES ahead of the stop and
+  skips what passed beyond that. Half a buffer is far longer than the
+  wakeup of STOP. A melody played during a rest starts at once, the
+  resting ones may come back up to LED_DMA_UPDATES early.
+*/
 #define LED_PWM_FREQ        (100)
 #define LED_LEVEL_RANGE     (100)
 
@@ -195,143 +233,205 @@ static void melody_timer_expired(struct S_MELODY_PLAY *play, uint16 id)
 #define LED_TIM             (TIM3)
 #define LED_TIM_AAR         (LED_LEVEL_RANGE - 1)
 #define LED_TIM_PSC         (LED_CLK_FREQ / LED_LEVEL_RANGE / LED_PWM_FREQ - 1)
+#define LED_DMA_CHANNEL     (3)
+#define LED_DMA             (DMA1_Channel3)
+#define LED_DMA_UPDATES     (32)            /* 320ms, an interrupt every 160ms */
+#define LED_CHANNELS        INDICATION_LED_CHANNELS
+#define LED_UPDATE_TICKS    (_PT_TIMESTAMP_FREQ / 1000 * LED_PWM_PERIOD_MS)
 
+static void hw_led_start(void);
 static void hw_led_stop(void);
-static void hw_led_play(const struct S_NOTE *note, struct S_INTERPOLATOR *interpolator, boolean descending);
-static void play_led_finished(boolean finished);
-
-static uint8    _led_melody_id;
-static boolean  _led_interpolate_descending;
-static struct S_INTERPOLATOR *_led_interpolator;
-static const struct S_NOTE   *_led_note;
-static struct S_MELODY_PLAY   _led_play;
+static void led_fill_half(uint16 *half);
+static void led_wake(void);
+static void led_dma_irq(uint8 flags);
+static void play_led_finished(uint8 channel, boolean finished);
+
+static uint8    _led_melody_id[LED_CHANNELS];
+static struct S_PWM_ENGINE _led_engine;
+static boolean  _led_running;
+static uint8    _led_idle_halves;
+static boolean  _led_resting;
+static uint16   _led_rest;                  /* updates of the engine still resting at the stop */
+static uint32   _led_rest_stamp;            /* tq_port_timestamp() of the stop */
+static uint16   _led_dma_buffer[LED_DMA_UPDATES * LED_CHANNELS];
 
 static void init_led(void)
 {
-  NVIC_InitTypeDef NVIC_InitStructure;
+  DMA_InitTypeDef  DMA_InitStructure;
   
-  memset(&_led_play, 0, sizeof(_led_play));
-  _led_play.hw_play = hw_led_play;
-  _led_play.hw_stop = hw_led_stop;
-  _led_play.play_finished = play_led_finished;
-  _led_play.timer_base = LED_TIMER_BASE;
+  pwm_engine_init(&_led_engine, LED_CHANNELS, LED_PWM_PERIOD_MS, 1, play_led_finished);
   
   RCC_APB1PeriphClockCmd(RCC_APB1Periph_TIM3, ENABLE);
   RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOB, ENABLE);
+  RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
   
-  //PB05
+  DMA_DeInit(LED_DMA);
+  DMA_StructInit(&DMA_InitStructure);
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&LED_TIM->DMAR;
+  DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)_led_dma_buffer;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+  DMA_InitStructure.DMA_BufferSize = LED_DMA_UPDATES * LED_CHANNELS;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+  DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+  DMA_Init(LED_DMA, &DMA_InitStructure);
+  DMA_ITConfig(LED_DMA, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+  //PB05, CH2, the status LED. CH1 PA06, CH3 PB00, CH4 PB01 where the board has them
   GPIO_AF(GPIOB, 5, 1);
   GPIO_MODE(GPIOB, 5, GPIO_MODE_AF);
 
   LED_TIM->SR &= (~TIM_SR_UIF);
   LED_TIM->CR1 |= TIM_CR1_ARPE;
+  LED_TIM->CCMR1 |= (TIM_CCMR1_OC1PE | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2);
   LED_TIM->CCMR1 |= (TIM_CCMR1_OC2PE | TIM_CCMR1_OC2M_1 | TIM_CCMR1_OC2M_2);
-  LED_TIM->DIER |= TIM_DIER_UIE;
+  LED_TIM->CCMR2 |= (TIM_CCMR2_OC3PE | TIM_CCMR2_OC3M_1 | TIM_CCMR2_OC3M_2);
+  LED_TIM->CCMR2 |= (TIM_CCMR2_OC4PE | TIM_CCMR2_OC4M_1 | TIM_CCMR2_OC4M_2);
+  LED_TIM->DCR = (TIM_DMABase_CCR1 | ((LED_CHANNELS - 1) << 8));    // [DMA BURST:LED_CHANNELS] [DMA BASE ADDR:TIMX_CCR1]
+  LED_TIM->DIER |= TIM_DIER_UDE;
   LED_TIM->PSC = LED_TIM_PSC;
   LED_TIM->ARR = LED_TIM_AAR;
 
-  NVIC_InitStructure.NVIC_IRQChannel = TIM3_IRQn;
-  NVIC_InitStructure.NVIC_IRQChannelPriority = 2;
-  NVIC_InitStructure.NVIC_IRQChannelCmd = ENABLE;
-  NVIC_Init(&NVIC_InitStructure);
+  hw_dma_set_handler(LED_DMA_CHANNEL, led_dma_irq);
 }
 
-static void play_led(uint8 id)
+static void play_led(uint8 channel, uint8 id)
 {
   if(id >= sizeof(_led_melody_table) / sizeof(_led_melody_table[0]))
     return;
   
-  _led_melody_id = id + 1;
-  play_melody(&_led_play, _led_melody_table[id], 1);
+  _led_melody_id[channel] = id + 1;
+  qti_system_lock();
+  led_wake();
+  pwm_engine_play(&_led_engine, channel, _led_melody_table[id]);
+  _led_idle_halves = 0;
+  qti_system_unlock();
+
+  if(!_led_running)
+    hw_led_start();
 }
 
-static void stop_led(void)
+static void stop_led(uint8 channel)
 {
-  stop_melody(&_led_play);
+  qti_system_lock();
+  pwm_engine_stop(&_led_engine, channel);
+  qti_system_unlock();
 }
 
-static void play_led_finished(boolean finished)
+static void play_led_finished(uint8 channel, boolean finished)
 {
-  TQ_ASSERT(_led_melody_id);
-  _led_melody_id--;
-  tinyq_send_signal(_self, _led_listener, INDICATION_NTF_LED_STOPPED, &_led_melody_id, 1);
-  _led_melody_id = 0;
+  uint8 p[2];
+
+  TQ_ASSERT(_led_melody_id[channel]);
+  p[0] = _led_melody_id[channel] - 1;
+  p[1] = channel;
+  _led_melody_id[channel] = 0;
+  tinyq_send_signal(_self, _led_listener[channel], INDICATION_NTF_LED_STOPPED, p, 2);
 }
 
-static void hw_led_play(const struct S_NOTE *note, struct S_INTERPOLATOR *interpolator, boolean descending)
+/* a wait for all channels, TIM3 stops in STOP mode */
+static void hw_led_start(void)
 {
-  int16 v;
-
   qti_system_lock();
-  if(!_led_interpolator)
-  {
-    qti_system_request_wait(_self);
-  }
-  _led_interpolate_descending = descending;
-  _led_note = note;
-  _led_interpolator = interpolator;
+  qti_system_request_wait(_self);
+  _led_running = TRUE;
+  _led_idle_halves = 0;
   qti_system_unlock();
-  
-  v = _led_note->tone;
-  LED_TIM->CCR2 = v;
-  LED_TIM->EGR |= TIM_EGR_UG; //trigger update event
+
+  pwm_engine_fill(&_led_engine, _led_dma_buffer, LED_DMA_UPDATES);
+
+  LED_DMA->CNDTR = LED_DMA_UPDATES * LED_CHANNELS;
+  LED_DMA->CCR |= DMA_CCR_EN;
+  LED_TIM->EGR |= TIM_EGR_UG; //trigger update event, the first burst
   LED_TIM->CR1 |= (TIM_CR1_CEN);
-  LED_TIM->CCER |= (TIM_CCER_CC2E);
+  LED_TIM->CCER |= (TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E);
 }
 
 static void hw_led_stop(void)
 {
-  LED_TIM->CCER &= (~TIM_CCER_CC2E);
+  LED_DMA->CCR &= (~DMA_CCR_EN);
+  DMA1->IFCR = DMA_IFCR_CGIF3;
+  LED_TIM->CCER &= ~(TIM_CCER_CC1E | TIM_CCER_CC2E | TIM_CCER_CC3E | TIM_CCER_CC4E);
   LED_TIM->CR1 &= (~TIM_CR1_CEN);
   LED_TIM->SR = 0;
-  NVIC_ClearPendingIRQ(TIM3_IRQn);
   
   qti_system_lock();
-  if(_led_interpolator)
+  if(_led_running)
   {
-    _led_interpolator = 0;
+    _led_running = FALSE;
     qti_system_release_wait(_self);
   }
   qti_system_unlock();
 }
 
-static boolean led_next_value(int16 step, int16 *value)
+/* stops once both halves are filled silent, the rest timer is started by the Qti */
+static void led_fill_half(uint16 *half)
 {
-  static uint16   last_counter;
+  uint16 rest;
 
-  if(_led_interpolator && interpolator_step(_led_interpolator, LED_PWM_PERIOD_MS))
+  if(pwm_engine_fill(&_led_engine, half, LED_DMA_UPDATES / 2))
+    _led_idle_halves = 0;
+  else if(++_led_idle_halves >= 2)
   {
-    last_counter = _led_note->tone;
-    if(_led_interpolate_descending)
-      last_counter -= interpolator_get_value(_led_interpolator);
-    else
-      last_counter += interpolator_get_value(_led_interpolator);
-    
-    *value = last_counter;
-    return TRUE;
-  }
-  else
-  {
-    *value = last_counter;
-    return FALSE;
+    if(!_led_engine.active)
+      hw_led_stop();
+    else if((rest = pwm_engine_rest(&_led_engine)) != 0)
+    {
+      hw_led_stop();
+      _led_resting = TRUE;
+      _led_rest = rest;
+      _led_rest_stamp = tq_port_timestamp();
+      tinyq_send_signal(_self, _self, INDICATION_LCL_LED_REST, 0, 0);
+    }
   }
 }
 
-void TIM3_IRQHandler(void)
+/* resting the DMA interrupt is off, the rest is the Qti's alone */
+static void led_rest_timer(void)
 {
-  int16 v;
-  boolean next;
-  
-  if(LED_TIM->SR & TIM_SR_UIF)
-  { // update
-    LED_TIM->SR &= ~(TIM_SR_UIF);
-    next = led_next_value(LED_PWM_PERIOD_MS, &v);
-    LED_TIM->CCR2 = v;
-    if(!next)
-    {
-      melody_play_next_note(&_led_play);
-    }
-  }
+  uint32 elapsed, rest;
+
+  if(!_led_resting)
+    return;
+  elapsed = (tq_port_timestamp() - _led_rest_stamp) / LED_UPDATE_TICKS;
+  rest = LED_DMA_UPDATES + _led_rest;
+  qti_system_start_timer(_self, TIMER_LED_REST, (elapsed < rest) ? (rest - elapsed) * LED_PWM_PERIOD_MS : 1);
+}
+
+static void led_rest_expired(void)
+{
+  if(!_led_resting)
+    return;
+  led_wake();
+  if(_led_engine.active && !_led_running)
+    hw_led_start();
+}
+
+/* the engine on by the time passed beyond the buffer it had filled, at most the rest */
+static void led_wake(void)
+{
+  uint32 elapsed;
+
+  if(!_led_resting)
+    return;
+  _led_resting = FALSE;
+  qti_system_stop_timer(_self, TIMER_LED_REST);
+
+  elapsed = (tq_port_timestamp() - _led_rest_stamp) / LED_UPDATE_TICKS;
+  if(elapsed > LED_DMA_UPDATES)
+    pwm_engine_skip(&_led_engine, (elapsed - LED_DMA_UPDATES < _led_rest) ? elapsed - LED_DMA_UPDATES : _led_rest);
+}
+
+static void led_dma_irq(uint8 flags)
+{
+  if(flags & HW_DMA_HT)
+    led_fill_half(&_led_dma_buffer[0]);
+  if(flags & HW_DMA_TC)
+    led_fill_half(&_led_dma_buffer[LED_DMA_UPDATES * LED_CHANNELS / 2]);
 }
 
 
@@ -344,39 +444,90 @@ void TIM3_IRQHandler(void)
 
 #define BUZZER_X_FACTOR         (1000 / 64)           
 #define BUZZER_CLK_FREQ         (4 * 1000 * 1000UL)
+
+#if BUZZER_CLK_FREQ != TONE_CLK_FREQ
+#error "tone periods are of another clock"
+#endif
 #define BUZZER_TIM              (TIM17)
 #define BUZZER_DMA              (DMA1_Channel1)
 #define BUZZER_DMA_SIZE         (20)
 
+/*
+  Voices by priority, the highest one playing has the buzzer and the
+  lower ones wait where they are, no timer and no signal to resume them.
+  A voice interpreted is filled into _buzzer_dma_buffer half at a time,
+  silences as well, in bursts of 1ms repeated by RCR. One ending in a fill
+  hands on to the next one down in the same fill. A compiled one goes to
+  the DMA from flash, ducked it keeps the burst it was at.
+
+  Once both halves are filled with silence of the owner and the rest left
+  is BUZZER_REST_MIN at least, TIM17 and the DMA stop and the wait goes.
+  The Qti times the rest with a system timer, the buffered silence and
+  what is left of the note, then the owner goes on from its next note. A
+  voice played or stopped that changes the owner ends the rest at once.
+*/
+#define BUZZER_VOICES           INDICATION_BUZZER_VOICES
+#define BUZZER_NO_VOICE         (0xff)
+#define BUZZER_SILENCE_PERIOD   (BUZZER_CLK_FREQ / 1000)
+#define BUZZER_SILENCE_RUN      (256)           /* ms a burst, RCR of 8 bits */
+#define BUZZER_REST_MIN         (10)            /* ms, well past the wakeup and break even of STOP */
+#define BUZZER_MS_TICKS         (_PT_TIMESTAMP_FREQ / 1000)
+
+struct S_BUZZER_VOICE
+{
+  struct S_MELODY_PLAY play;                /* first, the callbacks get it */
+  const struct S_NOTE *note;
+  boolean descending;
+  uint32  cx;
+  uint32  last_cx;
+  int16   last_step;
+  uint16  silence;                          /* ms left of a silent note */
+  uint8   melody_id;                        /* + 1, 0 : none */
+  uint8   listener;
+  const struct S_MELODY_STREAM *stream;
+  uint16  stream_pos;                       /* burst a ducked stream goes on from */
+  uint8   stream_passes;                    /* left, 0 : infinite loop */
+};
+
+static void hw_buzzer_start(void);
 static void hw_buzzer_stop(void);
-static void hw_buzzer_play(const struct S_NOTE*, struct S_INTERPOLATOR*, boolean descending);
-static void play_buzzer_finished(boolean finished);
+static void buzzer_voice_play(struct S_MELODY_PLAY *play, const struct S_NOTE *note, struct S_INTERPOLATOR *interpolator,
+                              boolean descending);
+static void buzzer_voice_silence(struct S_MELODY_PLAY *play, uint16 period);
+static void buzzer_voice_finished(struct S_MELODY_PLAY *play, boolean finished);
+static void buzzer_voice_stop(struct S_BUZZER_VOICE *voice);
+static uint8 buzzer_top_voice(void);
+static void buzzer_select(boolean restart);
+static void buzzer_stream_pass_end(void);
+static void buzzer_fill_half(uint16 *addr);
+static void buzzer_wake(void);
 static uint16 buzzer_fill_buffer(uint16 *addr, uint16 n);
 
-static uint8    _buzzer_melody_id;
-static boolean  _buzzer_interpolate_descending;
-static struct S_INTERPOLATOR  *_buzzer_interpolator;
-static const struct S_NOTE    *_buzzer_note;
-
+static struct S_BUZZER_VOICE _buzzer_voices[BUZZER_VOICES];
+static uint8    _buzzer_owner = BUZZER_NO_VOICE;
+static boolean  _buzzer_streaming;
 static boolean  _buzzer_hw_running = FALSE;
+static uint8    _buzzer_idle_halves;
+static uint32   _buzzer_fill_rest;          /* ms of the last fill, of silences of the owner only */
+static uint32   _buzzer_half_rest;          /* _buzzer_fill_rest of the half before */
+static boolean  _buzzer_resting;
+static uint32   _buzzer_rest_buffered;      /* ms of the halves filled at the stop */
+static uint32   _buzzer_rest_stamp;         /* tq_port_timestamp() of the stop */
 static uint16   _buzzer_dma_buffer[BUZZER_DMA_SIZE * 3];
-static uint16   _buzzer_dma_count;
-static uint32   _buzzer_cx;
-static uint32   _buzzer_last_cx;
-static int16    _buzzer_last_step;
-
-struct S_MELODY_PLAY _buzzer_play;
 
 static void init_buzzer(void)
 {
   NVIC_InitTypeDef NVIC_InitStructure;
   DMA_InitTypeDef DMA_InitStructure;
+  uint8 i;
  
-  memset(&_buzzer_play, 0, sizeof(_buzzer_play));
-  _buzzer_play.hw_play = hw_buzzer_play;
-  _buzzer_play.hw_stop = hw_buzzer_stop;
-  _buzzer_play.play_finished = play_buzzer_finished;
-  _buzzer_play.timer_base = BUZZER_TIMER_BASE;
+  memset(_buzzer_voices, 0, sizeof(_buzzer_voices));
+  for(i = 0; i < BUZZER_VOICES; i++)
+  {
+    _buzzer_voices[i].play.hw_play = buzzer_voice_play;
+    _buzzer_voices[i].play.hw_silence = buzzer_voice_silence;
+    _buzzer_voices[i].play.play_finished = buzzer_voice_finished;
+  }
   
   RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM17, ENABLE);
   RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOB, ENABLE);
@@ -420,58 +571,163 @@ static void init_buzzer(void)
   NVIC_Init(&NVIC_InitStructure);
 }
 
-static void play_buzzer(uint8 id)
+/* whatever the voice played is stopped first */
+static void play_buzzer(uint8 voice, uint8 from, uint8 id)
 {
-  if(id >= sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0]))
-    return;
-  
-  _buzzer_melody_id = id + 1;
-  play_melody(&_buzzer_play, _buzzer_melody_table[id], BUZZER_X_FACTOR);
+  struct S_BUZZER_VOICE *v = &_buzzer_voices[voice];
+
+  qti_system_lock();
+  if(_buzzer_resting && voice >= _buzzer_owner)
+    buzzer_wake();
+  buzzer_voice_stop(v);
+  v->listener = from;
+  if(id < sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0]))
+  {
+    v->melody_id = id + 1;
+#ifndef INDICATION_NO_STREAMS
+    if(_buzzer_stream_table[id].bursts)
+    {
+      v->stream = &_buzzer_stream_table[id];
+      v->stream_pos = 0;
+      v->stream_passes = v->stream->repeat;
+    }
+#endif
+    if(!v->stream)
+      play_melody(&v->play, _buzzer_melody_table[id], BUZZER_X_FACTOR);
+  }
+  buzzer_select(voice == _buzzer_owner);
+  qti_system_unlock();
 }
 
-static void stop_buzzer(void)
+static void stop_buzzer(uint8 voice)
 {
-  stop_melody(&_buzzer_play);
+  qti_system_lock();
+  if(_buzzer_resting && voice == _buzzer_owner)
+    buzzer_wake();
+  buzzer_voice_stop(&_buzzer_voices[voice]);
+  buzzer_select(voice == _buzzer_owner);
+  qti_system_unlock();
 }
 
-static void play_buzzer_finished(boolean finished)
+static void buzzer_voice_stop(struct S_BUZZER_VOICE *voice)
 {
-  TQ_ASSERT(_buzzer_melody_id);
-  _buzzer_melody_id--;
-  tinyq_send_signal(_self, _buzzer_listener, INDICATION_NTF_BUZZER_STOPPED, &_buzzer_melody_id, 1);
-  _buzzer_melody_id = 0;
+  if(voice->stream)
+  {
+    voice->stream = 0;
+    buzzer_voice_finished(&voice->play, FALSE);
+  }
+  stop_melody(&voice->play);
 }
 
-static void hw_buzzer_play(const struct S_NOTE* note, struct S_INTERPOLATOR* interpolator, boolean descending)
+static void buzzer_voice_play(struct S_MELODY_PLAY *play, const struct S_NOTE *note, struct S_INTERPOLATOR *interpolator,
+                              boolean descending)
 {
-  qti_system_lock();
-  if(!_buzzer_interpolator)
+  struct S_BUZZER_VOICE *v = (struct S_BUZZER_VOICE*)play;
+
+  v->note = note;
+  v->descending = descending;
+  v->cx = v->last_cx = 0;
+  v->last_step = 0;
+}
+
+static void buzzer_voice_silence(struct S_MELODY_PLAY *play, uint16 period)
+{
+  ((struct S_BUZZER_VOICE*)play)->silence = period * 10;
+}
+
+static void buzzer_voice_finished(struct S_MELODY_PLAY *play, boolean finished)
+{
+  struct S_BUZZER_VOICE *v = (struct S_BUZZER_VOICE*)play;
+  uint8 p[2];
+
+  TQ_ASSERT(v->melody_id);
+  p[0] = v->melody_id - 1;
+  p[1] = v - _buzzer_voices;
+  v->melody_id = 0;
+  v->silence = 0;
+  tinyq_send_signal(_self, v->listener, INDICATION_NTF_BUZZER_STOPPED, p, 2);
+}
+
+static uint8 buzzer_top_voice(void)
+{
+  uint8 i;
+
+  for(i = BUZZER_VOICES; i--; )
   {
-    qti_system_request_wait(_self);
+    if(_buzzer_voices[i].play.melody || _buzzer_voices[i].stream)
+      return i;
   }
-  _buzzer_interpolate_descending = descending;
-  _buzzer_note = note;
-  _buzzer_cx = _buzzer_last_cx = 0;
-  _buzzer_interpolator = interpolator;
-  qti_system_unlock();
-  
-  if(!_buzzer_hw_running)
+  return BUZZER_NO_VOICE;
+}
+
+/*
+  The buzzer to the highest voice playing. restart when the owner has
+  stopped or plays something else, there is no place of it to keep.
+*/
+static void buzzer_select(boolean restart)
+{
+  struct S_BUZZER_VOICE *v;
+  uint8 top = buzzer_top_voice();
+
+  if(top == _buzzer_owner && !restart)
+    return;
+
+  BUZZER_DMA->CCR &= (~DMA_CCR_EN);
+  if(!restart && _buzzer_streaming)
   {
-    _buzzer_dma_count = buzzer_fill_buffer(_buzzer_dma_buffer, BUZZER_DMA_SIZE);
-    BUZZER_DMA->CNDTR = 3 * BUZZER_DMA_SIZE;
-    BUZZER_DMA->CCR |= DMA_CCR_EN;
+    /* the last burst sent is still to play */
+    v = &_buzzer_voices[_buzzer_owner];
+    v->stream_pos = v->stream->burst_count - BUZZER_DMA->CNDTR / 3;
+    if(v->stream_pos)
+      v->stream_pos--;
+  }
 
-    BUZZER_TIM->PSC = 1;
-    BUZZER_TIM->ARR = 1;
-    BUZZER_TIM->RCR = 0;
-    BUZZER_TIM->CCR1 = 0;
-    BUZZER_TIM->EGR |= TIM_EGR_UG;
-    
-    BUZZER_TIM->CR1 |= (TIM_CR1_CEN);
-    BUZZER_TIM->BDTR |= TIM_BDTR_MOE;
-    
-    _buzzer_hw_running = TRUE;
+  _buzzer_owner = top;
+  _buzzer_idle_halves = 0;
+  _buzzer_half_rest = 0;
+  if(top == BUZZER_NO_VOICE)
+  {
+    hw_buzzer_stop();
+    return;
   }
+
+  v = &_buzzer_voices[top];
+  _buzzer_streaming = (v->stream != 0);
+  if(_buzzer_streaming)
+  {
+    BUZZER_DMA->CCR &= ~(DMA_CCR_CIRC | DMA_CCR_HTIE);
+    BUZZER_DMA->CMAR = (uint32_t)(v->stream->bursts + 3 * v->stream_pos);
+    BUZZER_DMA->CNDTR = 3 * (v->stream->burst_count - v->stream_pos);
+  }
+  else
+  {
+    buzzer_fill_buffer(_buzzer_dma_buffer, BUZZER_DMA_SIZE);
+    BUZZER_DMA->CMAR = (uint32_t)_buzzer_dma_buffer;
+    BUZZER_DMA->CNDTR = 3 * BUZZER_DMA_SIZE;
+    BUZZER_DMA->CCR |= (DMA_CCR_CIRC | DMA_CCR_HTIE);
+  }
+  DMA1->IFCR = DMA_IFCR_CGIF1;
+  BUZZER_DMA->CCR |= DMA_CCR_EN;
+  if(!_buzzer_hw_running)
+    hw_buzzer_start();
+}
+
+/* a wait while any voice plays, its silences too */
+static void hw_buzzer_start(void)
+{
+  qti_system_lock();
+  qti_system_request_wait(_self);
+  _buzzer_hw_running = TRUE;
+  qti_system_unlock();
+
+  BUZZER_TIM->PSC = 1;
+  BUZZER_TIM->ARR = 1;
+  BUZZER_TIM->RCR = 0;
+  BUZZER_TIM->CCR1 = 0;
+  BUZZER_TIM->EGR |= TIM_EGR_UG;
+  
+  BUZZER_TIM->CR1 |= (TIM_CR1_CEN);
+  BUZZER_TIM->BDTR |= TIM_BDTR_MOE;
 }
 
 static void hw_buzzer_stop(void)
@@ -482,70 +738,211 @@ static void hw_buzzer_stop(void)
   
   BUZZER_TIM->SR = 0;
   NVIC_ClearPendingIRQ(DMA1_Channel1_IRQn);
-  _buzzer_hw_running = FALSE;
+  _buzzer_streaming = FALSE;
 
   qti_system_lock();
-  if(_buzzer_interpolator)
+  if(_buzzer_hw_running)
   {
-    _buzzer_interpolator = 0;
+    _buzzer_hw_running = FALSE;
     qti_system_release_wait(_self);
   }
   qti_system_unlock();
 }
 
+/*
+  Bursts of ARR, RCR and CCR1 straight from flash, a DMA transfer complete
+  interrupt a pass. RCR holds a period for up to 256 of them, nothing is
+  computed a period. The two silent bursts closing a pass play while the
+  next one starts.
+*/
+static void buzzer_stream_pass_end(void)
+{
+  struct S_BUZZER_VOICE *v = &_buzzer_voices[_buzzer_owner];
+
+  if(v->stream_passes != 1)
+  {
+    if(v->stream_passes)
+      v->stream_passes--;
+    v->stream_pos = 0;
+    BUZZER_DMA->CCR &= (~DMA_CCR_EN);
+    BUZZER_DMA->CMAR = (uint32_t)v->stream->bursts;
+    BUZZER_DMA->CNDTR = 3 * v->stream->burst_count;
+    BUZZER_DMA->CCR |= DMA_CCR_EN;
+  }
+  else
+  {
+    v->stream = 0;
+    buzzer_voice_finished(&v->play, TRUE);
+    buzzer_select(TRUE);
+  }
+}
+
+/* hands over once both halves are filled with no voice, rests once both are silences of the owner */
+static void buzzer_fill_half(uint16 *addr)
+{
+  struct S_BUZZER_VOICE *v;
+  uint32 buffered;
+
+  if(buzzer_fill_buffer(addr, BUZZER_DMA_SIZE / 2))
+    _buzzer_idle_halves = 0;
+  else if(++_buzzer_idle_halves == 2)
+  {
+    buzzer_select(TRUE);
+    return;
+  }
+
+  buffered = _buzzer_half_rest + _buzzer_fill_rest;
+  _buzzer_half_rest = _buzzer_fill_rest;
+  if(!_buzzer_fill_rest || buffered == _buzzer_fill_rest || _buzzer_owner == BUZZER_NO_VOICE)
+    return;
+  v = &_buzzer_voices[_buzzer_owner];
+  if(!v->play.melody || buffered + v->silence < BUZZER_REST_MIN)
+    return;
+
+  hw_buzzer_stop();
+  _buzzer_resting = TRUE;
+  _buzzer_rest_buffered = buffered;
+  _buzzer_rest_stamp = tq_port_timestamp();
+  tinyq_send_signal(_self, _self, INDICATION_LCL_BUZZER_REST, 0, 0);
+}
+
+/* resting the DMA interrupt is off, the rest is the Qti's alone */
+static void buzzer_rest_timer(void)
+{
+  uint32 elapsed, rest;
+
+  if(!_buzzer_resting)
+    return;
+  elapsed = (tq_port_timestamp() - _buzzer_rest_stamp) / BUZZER_MS_TICKS;
+  rest = _buzzer_rest_buffered + _buzzer_voices[_buzzer_owner].silence;
+  qti_system_start_timer(_self, TIMER_BUZZER_REST, (elapsed < rest) ? rest - elapsed : 1);
+}
+
+static void buzzer_rest_expired(void)
+{
+  qti_system_lock();
+  if(_buzzer_resting)
+  {
+    buzzer_wake();
+    buzzer_select(TRUE);
+  }
+  qti_system_unlock();
+}
+
+/* before the owner changes, its silence on by the time passed beyond the halves it had filled */
+static void buzzer_wake(void)
+{
+  struct S_BUZZER_VOICE *v = &_buzzer_voices[_buzzer_owner];
+  uint32 elapsed;
+
+  _buzzer_resting = FALSE;
+  qti_system_stop_timer(_self, TIMER_BUZZER_REST);
+
+  elapsed = (tq_port_timestamp() - _buzzer_rest_stamp) / BUZZER_MS_TICKS;
+  if(elapsed <= _buzzer_rest_buffered || !v->play.melody || !v->silence)
+    return;
+  elapsed -= _buzzer_rest_buffered;
+  if(elapsed < v->silence)
+    v->silence -= elapsed;
+  else
+  {
+    v->silence = 0;
+    melody_play_next_note(&v->play);
+  }
+}
+
+/* n bursts of the owner, bursts of a voice playing counted */
 static uint16 buzzer_fill_buffer(uint16 *addr, uint16 n)
 {
-  static uint16   last_counter;
-  uint32 freq;
-  uint16 count = 0;
+  struct S_BUZZER_VOICE *v;
+  uint32 freq, rest = 0;
+  uint16 counter, run, count = 0;
+  uint8  next;
+  boolean sounding = FALSE;
   
-  while(n--)
+  while(n)
   {
-    if(_buzzer_interpolator && interpolator_step(_buzzer_interpolator, _buzzer_last_step))
+    v = (_buzzer_owner != BUZZER_NO_VOICE) ? &_buzzer_voices[_buzzer_owner] : 0;
+    if(v && !v->play.melody)
+    {
+      /* on to the next voice down where it was, a stream waits for buzzer_select() */
+      next = buzzer_top_voice();
+      if(next != BUZZER_NO_VOICE && !_buzzer_voices[next].stream)
+      {
+        _buzzer_owner = next;
+        continue;
+      }
+      v = 0;
+    }
+
+    if(!v)
+    {
+      *addr++ = BUZZER_SILENCE_PERIOD - 1;
+      *addr++ = 0;
+      *addr++ = 0;
+      n--;
+    }
+    else if(v->silence)
+    {
+      run = (v->silence < BUZZER_SILENCE_RUN) ? v->silence : BUZZER_SILENCE_RUN;
+      v->silence -= run;
+      *addr++ = BUZZER_SILENCE_PERIOD - 1;
+      *addr++ = run - 1;
+      *addr++ = 0;
+      n--;
+      count++;
+      rest += run;
+      if(!v->silence)
+        melody_play_next_note(&v->play);
+    }
+    else if(interpolator_step(&v->play.interpolator, v->last_step))
     {
-      freq = _buzzer_note->tone;
-      if(_buzzer_interpolate_descending)
-        freq -= interpolator_get_value(_buzzer_interpolator);
+      freq = v->note->tone;
+      if(v->descending)
+        freq -= interpolator_get_value(&v->play.interpolator);
       else
-        freq += interpolator_get_value(_buzzer_interpolator);
+        freq += interpolator_get_value(&v->play.interpolator);
       
-      TQ_ASSERT(freq > 0);
-      
-      last_counter = BUZZER_CLK_FREQ / freq ;
-      _buzzer_cx += last_counter;
-      _buzzer_last_step = (_buzzer_cx - _buzzer_last_cx) >> 8;
-      if(_buzzer_last_step)
-        _buzzer_last_cx = _buzzer_cx;
+      /* BUZZER_CLK_FREQ / freq, no divider on the M0 */
+      counter = tone_period(freq);
+      v->cx += counter;
+      v->last_step = (v->cx - v->last_cx) >> 8;
+      if(v->last_step)
+        v->last_cx = v->cx;
+
+      *addr++ = counter;
+      *addr++ = 0;
+      *addr++ = (counter >> 1);
+      n--;
       count++;
+      sounding = TRUE;
     }
-    
-    *addr++ = last_counter;
-    *addr++ = 0;
-    *addr++ = (last_counter >> 1);   
+    else
+      melody_play_next_note(&v->play);
   }
+  _buzzer_fill_rest = sounding ? 0 : rest;
   return count;
 }
 
 void DMA1_Channel1_IRQHandler(void)
 {
-  if(_buzzer_dma_count == 0 && _buzzer_interpolator)
+  if(_buzzer_streaming)
   {
-    melody_play_next_note(&_buzzer_play);
+    if(DMA_GetITStatus(DMA1_IT_TC1))
+    {
+      DMA_ClearITPendingBit(DMA1_IT_TC1);
+      buzzer_stream_pass_end();
+    }
+    return;
   }
   if(DMA_GetITStatus(DMA1_IT_HT1))
   {
-    _buzzer_dma_count = buzzer_fill_buffer(&_buzzer_dma_buffer[0], BUZZER_DMA_SIZE / 2);
     DMA_ClearITPendingBit(DMA1_IT_HT1);
+    buzzer_fill_half(&_buzzer_dma_buffer[0]);
   }
   if(DMA_GetITStatus(DMA1_IT_TC1))
   {
-    _buzzer_dma_count = buzzer_fill_buffer(&_buzzer_dma_buffer[BUZZER_DMA_SIZE * 3 / 2], BUZZER_DMA_SIZE / 2);
     DMA_ClearITPendingBit(DMA1_IT_TC1);
+    buzzer_fill_half(&_buzzer_dma_buffer[BUZZER_DMA_SIZE * 3 / 2]);
   }
 }
-
-static void timer_expire_handler(uint16 id)
-{
-  melody_timer_expired(&_led_play, id);
-  melody_timer_expired(&_buzzer_play, id);
-}
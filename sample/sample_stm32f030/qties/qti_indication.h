@@ -5,8 +5,8 @@
 #ifndef QTI_INDICATION_H
 #define QTI_INDICATION_H
 
-#define INDICATION_NTF_LED_STOPPED          TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 0)
-#define INDICATION_NTF_BUZZER_STOPPED       TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 1)
+#define INDICATION_NTF_LED_STOPPED          TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 0)    /* melody, channel */
+#define INDICATION_NTF_BUZZER_STOPPED       TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 1)    /* melody, voice */
 
 
 #define INDICATION_BUZZER_MELODY_POWER_UP             (0)
@@ -17,6 +17,13 @@
 #define INDICATION_BUZZER_MELODY_5                    (5)
 
 
+/* buzzer voices by priority, a higher one ducks the lower ones while it plays */
+#define INDICATION_BUZZER_VOICES                      (3)
+#define INDICATION_BUZZER_VOICE_UI                    (0)
+#define INDICATION_BUZZER_VOICE_NOTICE                (1)
+#define INDICATION_BUZZER_VOICE_ALARM                 (2)
+
+
 #define INDICATION_LED_MELODY_POWER_UP                (0)
 #define INDICATION_LED_MELODY_1                       (1)
 #define INDICATION_LED_MELODY_2                       (2)
@@ -25,10 +32,19 @@
 #define INDICATION_LED_MELODY_5                       (5)
 
 
+/* PWM channels of the LED timer, the status LED is one of them */
+#define INDICATION_LED_CHANNELS                       (4)
+#define INDICATION_LED_STATUS                         (1)
+
+
 extern void qti_indication_play_led(uint8 from, uint8 melody);
 extern void qti_indication_stop_led(uint8 from);
+extern void qti_indication_play_led_channel(uint8 from, uint8 channel, uint8 melody);
+extern void qti_indication_stop_led_channel(uint8 from, uint8 channel);
 extern void qti_indication_play_buzzer(uint8 from, uint8 melody);
 extern void qti_indication_stop_buzzer(uint8 from);
+extern void qti_indication_play_buzzer_voice(uint8 from, uint8 voice, uint8 melody);
+extern void qti_indication_stop_buzzer_voice(uint8 from, uint8 voice);
 
 extern void qti_indication_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
 
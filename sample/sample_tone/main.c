@@ -0,0 +1,200 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of the buzzer DMA fill of sample_stm32f030 on the host, the
+  notes of every buzzer melody are synthesised as the DMA interrupt does,
+  a timer period per burst. Periods come from a division, from a bit at a
+  time division as the runtime library of a Cortex-M0 does it, and from
+  tone_period(). An accuracy line compares tone_period() against the
+  exact period over the audible range.
+
+    R=../../tinyq
+    cc -O2 -I. -I../sample_stm32f030/qties -I$R/core -I$R/misc -I$R/hw/posix \
+       -o sample_tone main.c $R/misc/interpolator.c $R/misc/tone.c -lm
+    sample_tone [-k rounds]
+
+  The host divides in hardware, the soft division row is the one closer
+  to what the M0 pays. Cycles are of the time stamp counter on x86,
+  elsewhere they read 0.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CYCLES()                            __rdtsc()
+#else
+#define CYCLES()                            (0ULL)
+#endif
+#include "tq_types.h"
+#include "interpolator.h"
+#include "tone.h"
+#include "melodies.h"
+
+#define DEFAULT_ROUNDS                      (200)
+#define BUZZER_X_FACTOR                     (1000 / 64)
+#define BUZZER_CLK_FREQ                     TONE_CLK_FREQ
+#define BUZZER_DMA_SIZE                     (20)
+#define AUDIBLE_MAX                         (20000)         /* Hz */
+
+typedef uint32 (*FILL)(const struct S_NOTE *note, struct S_INTERPOLATOR *itp, boolean descending);
+
+static uint32 soft_divide(uint32 n, uint32 d);
+static void bench(const char *name, FILL fill);
+static void accuracy(void);
+
+static uint32 _rounds = DEFAULT_ROUNDS;
+static uint16 _dma_buffer[BUZZER_DMA_SIZE * 3];
+static volatile uint32 _sink;
+
+/* buzzer_fill_buffer() of qti_indication.c, half a DMA buffer at a time until the note ends */
+#define FILL_NOTE(NAME, PERIOD)                                                       \
+static uint32 NAME(const struct S_NOTE *note, struct S_INTERPOLATOR *itp, boolean descending) \
+{                                                                                     \
+  uint32 cx = 0, last_cx = 0, freq, samples = 0;                                      \
+  uint16 last_counter = 0, n, *addr;                                                  \
+  int16  last_step = 0;                                                               \
+  boolean playing = TRUE;                                                             \
+                                                                                      \
+  while(playing)                                                                      \
+  {                                                                                   \
+    addr = _dma_buffer;                                                               \
+    for(n = BUZZER_DMA_SIZE / 2; n; n--)                                              \
+    {                                                                                 \
+      if(interpolator_step(itp, last_step))                                           \
+      {                                                                               \
+        freq = note->tone;                                                            \
+        if(descending)                                                                \
+          freq -= interpolator_get_value(itp);                                        \
+        else                                                                          \
+          freq += interpolator_get_value(itp);                                        \
+                                                                                      \
+        last_counter = PERIOD;                                                        \
+        cx += last_counter;                                                           \
+        last_step = (cx - last_cx) >> 8;                                              \
+        if(last_step)                                                                 \
+          last_cx = cx;                                                               \
+        samples++;                                                                    \
+      }                                                                               \
+      else                                                                            \
+        playing = FALSE;                                                              \
+                                                                                      \
+      *addr++ = last_counter;                                                         \
+      *addr++ = 0;                                                                    \
+      *addr++ = (last_counter >> 1);                                                  \
+    }                                                                                 \
+    _sink += _dma_buffer[0];                                                          \
+  }                                                                                   \
+  return samples;                                                                     \
+}
+
+FILL_NOTE(fill_divide, BUZZER_CLK_FREQ / freq)
+FILL_NOTE(fill_soft_divide, soft_divide(BUZZER_CLK_FREQ, freq))
+FILL_NOTE(fill_tone, tone_period(freq))
+
+
+int main(int argc, char *argv[])
+{
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-k") && i + 1 < argc)
+      _rounds = atoi(argv[++i]);
+  }
+  if(!_rounds)
+  {
+    fprintf(stderr, "at least a round\n");
+    return 1;
+  }
+
+  printf("%u rounds of the %u buzzer melodies, %luHz timer clock\n", _rounds,
+         (uint32)(sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0])), (unsigned long)BUZZER_CLK_FREQ);
+  printf("%-12s %14s %10s %10s\n", "period", "samples/s", "cyc", "ns");
+  bench("divide", fill_divide);
+  bench("soft divide", fill_soft_divide);
+  bench("tone", fill_tone);
+  accuracy();
+  return 0;
+}
+
+/* shift and subtract, a bit of quotient a round */
+static uint32 soft_divide(uint32 n, uint32 d)
+{
+  uint32 q = 0, r = 0;
+  int8 bit;
+
+  for(bit = 31; bit >= 0; bit--)
+  {
+    r = (r << 1) | ((n >> bit) & 1);
+    if(r >= d)
+    {
+      r -= d;
+      q |= 1UL << bit;
+    }
+  }
+  return q;
+}
+
+/* the notes as melody_play_note() sets them up, silences and controls left out */
+static void bench(const char *name, FILL fill)
+{
+  struct S_INTERPOLATOR itp;
+  const struct S_NOTE *note;
+  struct timespec t0, t1;
+  unsigned long long cycles = 0, start, samples = 0;
+  double ns;
+  uint32 round;
+  uint8 m, func;
+  int16 base;
+
+  clock_gettime(CLOCK_MONOTONIC, &t0);
+  for(round = 0; round < _rounds; round++)
+  {
+    for(m = 0; m < sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0]); m++)
+    {
+      for(note = _buzzer_melody_table[m]; TEMPO_GET_FUNC(note->tempo) != CTRL_STOP &&
+          TEMPO_GET_FUNC(note->tempo) != CTRL_REPT; note++)
+      {
+        func = TEMPO_GET_FUNC(note->tempo);
+        if(func == WAVE_SLNT)
+          continue;
+
+        base = note[1].tone - note[0].tone;
+        interpolator_init(&itp, TEMPO_GET_PERIOD(note->tempo) * 10 * BUZZER_X_FACTOR, base < 0 ? -base : base,
+                          _wave_table[func], WAVE_TABLE_SIZE);
+        start = CYCLES();
+        samples += fill(note, &itp, base < 0);
+        cycles += CYCLES() - start;
+      }
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &t1);
+
+  ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+  printf("%-12s %14.0f %10.2f %10.2f\n", name, samples * 1e9 / ns, (double)cycles / samples, ns / samples);
+}
+
+static void accuracy(void)
+{
+  double exact, error, worst = 0, worst_divide = 0;
+  uint32 freq, worst_freq = 0;
+
+  for(freq = TONE_FREQ_MIN; freq <= AUDIBLE_MAX; freq++)
+  {
+    exact = (double)BUZZER_CLK_FREQ / freq;
+    error = fabs(tone_period(freq) - exact);
+    if(error > worst)
+    {
+      worst = error;
+      worst_freq = freq;
+    }
+    error = exact - BUZZER_CLK_FREQ / freq;
+    worst_divide = (error > worst_divide) ? error : worst_divide;
+  }
+  printf("%u to %uHz, worst period off by %.3f ticks at %uHz, %.3f ticks with the division\n",
+         (uint32)TONE_FREQ_MIN, AUDIBLE_MAX, worst, worst_freq, worst_divide);
+}
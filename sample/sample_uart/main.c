@@ -0,0 +1,138 @@
+/****************************************************************************
+  main.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Benchmark of qti_uart on the virtual time port. A pattern is fed to the
+  simulated UART in bursts, the echo Qti checks every span in place and
+  sends it back, the tx sink checks the echo.
+
+    R=../../tinyq
+    cc -O2 -I. -I$R/core -I$R/misc -I$R/hw/sim -I$R/qties -o sample_uart [a-z]*.c \
+       $R/core/[a-z]*.c $R/misc/[a-z]*.c $R/hw/sim/tq_port.c $R/hw/sim/hw_uart.c $R/qties/qti_uart.c
+    sample_uart [-b baud] [-n burst bytes] [-l load %] [-c listener us per span] [-t seconds]
+
+  Results are in virtual time: bytes through and interrupts per KB, one
+  per byte for a UART without DMA, and how fast the host simulated it.
+  With -c the listener takes that long per span, enough of it and the DMA
+  overruns bytes the listener has not released. The checks lose step at
+  the first overrun and count errors from there on.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qti_system.h"
+#include "tq_sim.h"
+#include "hw_uart.h"
+#include "qti_uart.h"
+#include "qties.h"
+
+#define DEFAULT_BAUD                        (921600)
+#define DEFAULT_BURST                       (200)
+#define DEFAULT_LOAD                        (90)            /* % of the line */
+#define DEFAULT_RUN_TIME                    (10)            /* seconds */
+
+static void feed_irq(uint8 irq, uint32 arg);
+static void tx_sink(const uint8 *data, uint16 size);
+static void print_results(double host_seconds);
+
+static uint16 _burst = DEFAULT_BURST;
+static uint32 _load = DEFAULT_LOAD;
+static unsigned long long _fed;
+static TQ_SIM_TIME _feed_time;
+static unsigned long long _echoed;
+static unsigned long long _echo_errors;
+static unsigned long long _tx_calls;
+
+
+int main(int argc, char *argv[])
+{
+  TQ_SIM_TIME run_time = DEFAULT_RUN_TIME;
+  clock_t started;
+  int i;
+
+  echo_baud = DEFAULT_BAUD;
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-b") && i + 1 < argc)
+      echo_baud = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-n") && i + 1 < argc)
+      _burst = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-l") && i + 1 < argc)
+      _load = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-c") && i + 1 < argc)
+      echo_span_time = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      run_time = strtoull(argv[++i], 0, 10);
+  }
+  if(echo_baud < 1200 || !_burst || _burst > HW_UART_SIM_LINE_SIZE || !_load || _load > 100 || !run_time)
+  {
+    fprintf(stderr, "baud from 1200, burst 1 to %u bytes, load 1 to 100 %%\n", HW_UART_SIM_LINE_SIZE);
+    return 1;
+  }
+
+  hw_uart_sim_set_tx_sink(tx_sink);
+  tq_sim_set_irq_handler(SIM_IRQ_FEED, feed_irq);
+  _feed_time = 1000;
+  tq_sim_raise_irq(_feed_time, SIM_IRQ_FEED, 0);
+
+  started = clock();
+  tq_sim_run(run_time * 1000 * 1000);
+  print_results((double)(clock() - started) / CLOCKS_PER_SEC);
+  return 0;
+}
+
+uint8 pattern_byte(unsigned long long index)
+{
+  return (uint8)(index ^ (index >> 8) ^ (index >> 16));
+}
+
+/* a burst, the next one after the line has been busy _load % of the time, late or not */
+static void feed_irq(uint8 irq, uint32 arg)
+{
+  uint8 burst[HW_UART_SIM_LINE_SIZE];
+  uint16 i, size;
+
+  for(i = 0; i < _burst; i++)
+    burst[i] = pattern_byte(_fed + i);
+  size = hw_uart_sim_receive(burst, _burst);
+  _fed += size;
+
+  _feed_time += (TQ_SIM_TIME)_burst * 10 * 1000000 * 100 / _load / echo_baud;
+  tq_sim_raise_irq(_feed_time, SIM_IRQ_FEED, 0);
+}
+
+static void tx_sink(const uint8 *data, uint16 size)
+{
+  uint16 i;
+
+  for(i = 0; i < size; i++)
+  {
+    if(data[i] != pattern_byte(_echoed++))
+      _echo_errors++;
+  }
+  _tx_calls++;
+}
+
+static void print_results(double host_seconds)
+{
+  struct QTI_UART_STATS stats;
+  double seconds = tq_sim_now() / 1e6;
+  double kbytes;
+
+  qti_uart_get_stats(&stats);
+  kbytes = stats.rx_bytes / 1024.0;
+
+  printf("%u baud, bursts of %u bytes, %u %% load, %u us per span\n", echo_baud, _burst, _load, echo_span_time);
+  printf("virtual time %.3fs in %.3fs on the host\n", seconds, host_seconds);
+  printf("rx %10u bytes %10.0f B/s %8.2f spans/KB, line %.0f B/s\n", stats.rx_bytes, stats.rx_bytes / seconds,
+         kbytes ? stats.rx_spans / kbytes : 0.0, echo_baud / 10.0);
+  printf("tx %10u bytes %10.0f B/s %8.2f buffers/KB\n", stats.tx_bytes, stats.tx_bytes / seconds,
+         stats.tx_bytes ? stats.tx_buffers / (stats.tx_bytes / 1024.0) : 0.0);
+  printf("interrupts per KB %.2f, 1024 byte by byte\n", kbytes ? (stats.rx_spans + stats.tx_buffers) / kbytes : 0.0);
+  printf("host %.1f MB/s simulated\n", host_seconds > 0 ? (stats.rx_bytes + stats.tx_bytes) / host_seconds / 1e6 : 0.0);
+  printf("fed %llu, overruns %u, not echoed %llu, errors rx %llu echo %llu\n", _fed, stats.rx_overruns, echo_dropped,
+         echo_rx_errors, _echo_errors);
+}
@@ -0,0 +1,94 @@
+/****************************************************************************
+  qti_echo.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Checks the bytes of every span in place and sends them back, copied
+  straight from the ring into buffers of the UART. A span is released as
+  far as it went out, the rest waits for UART_NTF_TX_READY. Spans beyond
+  SPANS_MAX are not sent back.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "qti_uart.h"
+#include "tq_sim.h"
+
+#define SPANS_MAX                           (16)
+
+static void echo_pump(void);
+
+static const uint8 *_backlog_data;          /* next byte to send back, in the ring */
+static uint16 _backlog_size;
+static struct QTI_UART_SPAN _spans[SPANS_MAX];  /* received after the backlog */
+static uint8  _span_count;
+static unsigned long long _rx_index;
+
+uint32 echo_baud;
+uint32 echo_span_time;
+unsigned long long echo_rx_errors;
+unsigned long long echo_dropped;
+
+
+void qti_echo_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  const struct QTI_UART_SPAN *span;
+  uint16 i;
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    qti_uart_set_listener(QTI_ECHO);
+    qti_uart_open(echo_baud);
+  }
+  else if(from == QTI_UART && sig == UART_NTF_RX)
+  {
+    span = (const struct QTI_UART_SPAN*)p;
+    for(i = 0; i < span->size; i++)
+    {
+      if(span->data[i] != pattern_byte(_rx_index++))
+        echo_rx_errors++;
+    }
+    if(echo_span_time)
+      tq_sim_consume(echo_span_time);
+
+    if(_span_count < SPANS_MAX)
+      _spans[_span_count++] = *span;
+    else
+    {
+      echo_dropped += span->size;
+      qti_uart_rx_release(span->size);
+    }
+    echo_pump();
+  }
+  else if(from == QTI_UART && sig == UART_NTF_TX_READY)
+    echo_pump();
+}
+
+static void echo_pump(void)
+{
+  uint16 chunk;
+  uint8 *buffer;
+
+  while(_backlog_size || _span_count)
+  {
+    if(!_backlog_size)
+    {
+      _backlog_data = _spans[0].data;
+      _backlog_size = _spans[0].size;
+      memmove(_spans, _spans + 1, --_span_count * sizeof(_spans[0]));
+    }
+
+    buffer = qti_uart_tx_alloc();
+    if(!buffer)
+      return;
+
+    chunk = (_backlog_size > QTI_UART_TX_BUFFER_SIZE) ? QTI_UART_TX_BUFFER_SIZE : _backlog_size;
+    memcpy(buffer, _backlog_data, chunk);
+    qti_uart_tx_send(buffer, chunk);
+    qti_uart_rx_release(chunk);
+    _backlog_data += chunk;
+    _backlog_size -= chunk;
+  }
+}
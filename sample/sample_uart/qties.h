@@ -0,0 +1,33 @@
+/****************************************************************************
+  qties.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTIES_H
+#define QTIES_H
+
+enum e_QTIES
+{
+  QTI_SYSTEM = 0,
+  QTI_ECHO,
+  QTI_UART,
+  _QTI_COUNT_
+};
+
+/* interrupt lines of the simulated board apart from those of hw_uart */
+enum e_SIM_IRQS
+{
+  SIM_IRQ_FEED = 0,
+  _SIM_IRQ_COUNT_
+};
+
+extern void qti_echo_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+/* of the run, see main.c */
+extern uint32 echo_baud;
+extern uint32 echo_span_time;
+extern unsigned long long echo_rx_errors;
+extern unsigned long long echo_dropped;
+
+extern uint8 pattern_byte(unsigned long long index);
+
+#endif
@@ -2,35 +2,46 @@
   qti_system.c
   Copyright (c) 2020 - 2021, Xiaofu Yan.  All rights reserved.
 ****************************************************************************/
+#include <string.h>
 #include "tq_types.h"
 #include "tinyq.h"
 #include "qti_system.h"
 #include "hw_debug.h"
 #include "tq_port.h"
+#include "ring_buffer.h"
+#include "tq_context.h"
+#include "tq_trace.h"
+#include "tq_record.h"
+#include "tq_profile.h"
 
 
-struct S_TIMER
-{
-  uint32 id;
-  uint32 period;
-};
-
-static uint8 start_timer(uint32 id, uint32 period, uint32 *timeup_table);
-static void  cancel_timer(uint32 id);
+static uint8 start_timer(struct TQ_CONTEXT *context, uint32 id, uint32 period, uint32 *timeup_table);
+static void  cancel_timer(struct TQ_CONTEXT *context, uint32 id);
 static void  notify_timer_clients(uint32 *table, uint8 count);
+static uint8 select_sleep_mode(struct TQ_CONTEXT *context);
 
+#if _PT_RETAINED_WORDS
+#define RETAIN_TAG_TIMERS                   (0)             /* QTI_SYSTEM, ids and ticks left */
+#define RETAIN_TAG_TAKEN                    (0xfe)          /* restored already */
+#define RETAIN_TAG_END                      (QTI_BROADCAST)
+#define RETAIN_BYTES                        (_PT_RETAINED_WORDS * 4)
+#define RETAIN_TIMER_SIZE                   (8)
 
-static int32  _system_wait_counter = 0;
-static int32  _system_lock_counter = 0;
-
-static uint32 _timer_map;
-static struct S_TIMER _timer_table[32];
+static uint8 standby(struct TQ_CONTEXT *context);
+static uint8 retain_image(struct TQ_CONTEXT *context, uint8 *image, uint32 elapsed);
+static uint8 resume_timers(struct TQ_CONTEXT *context, uint32 slept, uint32 *timeup_table);
+#endif
 
-#ifdef TQ_DEBUG
-uint8 debug_system_wait_table[256];
+#ifdef TQ_POWER_STATS
+static void  power_time_add(struct QTI_SYSTEM_TIME *time, uint32 ticks);
+static void  power_wait_changed(struct TQ_CONTEXT *context, uint8 qti, boolean request);
+static void  power_sleep_finished(struct TQ_CONTEXT *context, uint8 mode, uint8 cause, uint32 sleep_start);
 #endif
 
 
+extern const struct QTI_SYSTEM_SLEEP_MODE tq_port_sleep_modes[QTI_SYSTEM_SLEEP_MODES];
+
+
 void qti_system_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
 {
 }
@@ -47,51 +58,129 @@ void qti_system_reset(void)
 
 void qti_system_lock(void)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
+
   tq_port_disable_irq();
-  _system_lock_counter++;
+#ifdef TQ_LOCK_MONITOR
+  if(!context->lock_counter)
+    tq_lock_monitor_enter(tq_port_return_address());
+#endif
+  context->lock_counter++;
 }
 
 void qti_system_unlock(void)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
+
   tq_port_disable_irq();
-  _system_lock_counter = _system_lock_counter > 0 ? _system_lock_counter - 1 : 0;
-  if(!_system_lock_counter)
+  context->lock_counter = context->lock_counter > 0 ? context->lock_counter - 1 : 0;
+  if(!context->lock_counter)
+  {
+#ifdef TQ_LOCK_MONITOR
+    tq_lock_monitor_exit();
+#endif
     tq_port_enable_irq();
+  }
 }
 
 void qti_system_request_wait(uint8 qti)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
+
   qti_system_lock();
 #ifdef TQ_DEBUG
-  debug_system_wait_table[qti]++;
+  context->wait_table[qti]++;
+#endif
+  context->wait_counter++;
+#ifdef TQ_POWER_STATS
+  power_wait_changed(context, qti, TRUE);
 #endif
-  _system_wait_counter++;
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_WAIT_REQUEST, qti, context->wait_counter, 0);
   qti_system_unlock();
 }
 
 void qti_system_release_wait(uint8 qti)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
+
   qti_system_lock();
 #ifdef TQ_DEBUG
-  debug_system_wait_table[qti]--;
+  context->wait_table[qti]--;
+#endif
+  context->wait_counter--;
+#ifdef TQ_POWER_STATS
+  power_wait_changed(context, qti, FALSE);
 #endif
-  _system_wait_counter--;
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_WAIT_RELEASE, qti, context->wait_counter, 0);
   qti_system_unlock();
 }
 
 void qti_system_sleep(void)
 {
-  TQ_ASSERT(_system_lock_counter == 1);
+  struct TQ_CONTEXT *context = TQ_CTX;
+  uint8 mode;
+#ifdef TQ_POWER_STATS
+  uint32 sleep_start;
+#endif
+  
+  TQ_ASSERT(context->lock_counter == 1);
   
   /*balancing the system lock in dispatch_loop()*/
-  _system_lock_counter--; 
+  context->lock_counter--; 
+#ifdef TQ_LOCK_MONITOR
+  tq_lock_monitor_exit();
+#endif
 
-  tq_port_sleep(_system_wait_counter ? FALSE : TRUE);
+  mode = select_sleep_mode(context);
+#if _PT_RETAINED_WORDS
+  if(mode == QTI_SYSTEM_SLEEP_STANDBY)
+    mode = standby(context);
+#endif
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_SLEEP_ENTER, mode, context->wait_counter, 0);
+#ifdef TQ_POWER_STATS
+  sleep_start = tq_port_timestamp();
+  power_time_add(&context->power_stats.active, sleep_start - context->power_checkpoint);
+  power_sleep_finished(context, mode, tq_port_sleep(mode), sleep_start);
+#else
+  tq_port_sleep(mode);
+#endif
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_SLEEP_EXIT, mode, 0, 0);
   tq_port_enable_irq();
 }
 
+/* deepest mode whose break-even and wakeup latency fit before the next alarm */
+static uint8 select_sleep_mode(struct TQ_CONTEXT *context)
+{
+  uint8 mode;
+  uint32 remaining, elapsed;
+  
+  if(context->wait_counter)
+    return QTI_SYSTEM_SLEEP_WFI;
+  
+  /* without a timer only an interrupt ends the sleep */
+  remaining = QTI_SYSTEM_SLEEP_UNAVAILABLE - 1;
+  if(context->timer_map)
+  {
+    elapsed = tq_port_sleep_timer_get_time_elapsed(FALSE);
+    remaining = (context->timer_next_alarm > elapsed) ? context->timer_next_alarm - elapsed : 0;
+  }
+  
+  for(mode = QTI_SYSTEM_SLEEP_MODES - 1; mode > QTI_SYSTEM_SLEEP_WFI; mode--)
+  {
+#if _PT_RETAINED_WORDS
+    if(mode == QTI_SYSTEM_SLEEP_STANDBY && !context->standby_allowed)
+      continue;
+#endif
+    if(remaining > tq_port_sleep_modes[mode].wakeup_latency &&
+       remaining - tq_port_sleep_modes[mode].wakeup_latency >= tq_port_sleep_modes[mode].break_even)
+      break;
+  }
+  return mode;
+}
+
 void qti_system_start_timer(uint8 qti, uint16 id, uint32 period)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
   uint32 timeup_table[32];
   uint8 timeups;
   
@@ -99,7 +188,8 @@ void qti_system_start_timer(uint8 qti, uint16 id, uint32 period)
   timer_id = (timer_id << 16) | id;
   
   qti_system_lock();
-  timeups = start_timer(timer_id, period, timeup_table);
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_TIMER_START, qti, id, id >> 8);
+  timeups = start_timer(context, timer_id, period, timeup_table);
   qti_system_unlock();
   
   notify_timer_clients(timeup_table, timeups);
@@ -107,17 +197,93 @@ void qti_system_start_timer(uint8 qti, uint16 id, uint32 period)
 
 void qti_system_stop_timer(uint8 qti, uint16 id)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
   uint32 timer_id = qti;
   timer_id = (timer_id << 16) | id;
   
   qti_system_lock();
-  cancel_timer(timer_id);
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_TIMER_STOP, qti, id, id >> 8);
+  cancel_timer(context, timer_id);
+  qti_system_unlock();
+}
+
+/* STANDBY resets into SYSTEM_NTF_RESUME, see qti_system.h */
+void qti_system_allow_standby(boolean allowed)
+{
+#if _PT_RETAINED_WORDS
+  TQ_CTX->standby_allowed = allowed;
+#endif
+}
+
+/* FALSE when the blocks are all taken, after a warm boot the same call copies the block back */
+boolean qti_system_retain(uint8 qti, void *data, uint8 size)
+{
+#if _PT_RETAINED_WORDS
+  struct TQ_CONTEXT *context = TQ_CTX;
+  uint8 *image = (uint8 *)context->resume_image;
+  uint16 at, bytes = context->resume_words * 4;
+  uint8 i;
+
+  qti_system_lock();
+  for(i = 0; i < context->retained_count && context->retained[i].data != data; i++)
+    ;
+  if(i == QTI_SYSTEM_RETAINED_BLOCKS)
+  {
+    qti_system_unlock();
+    return FALSE;
+  }
+  if(i == context->retained_count)
+    context->retained_count++;
+  context->retained[i].qti = qti;
+  context->retained[i].size = size;
+  context->retained[i].data = data;
+
+  /* the first record of the Qti of that size, once */
+  for(at = 0; at + 2 <= bytes && image[at] != RETAIN_TAG_END; at += 2 + image[at + 1])
+  {
+    if(image[at] == qti && image[at + 1] == size && at + 2 + size <= bytes)
+    {
+      memcpy(data, &image[at + 2], size);
+      image[at] = RETAIN_TAG_TAKEN;
+      break;
+    }
+  }
   qti_system_unlock();
+  return TRUE;
+#else
+  return FALSE;
+#endif
 }
 
 void qti_system_start(void)
 {
+#if _PT_RETAINED_WORDS
+  struct TQ_CONTEXT *context = TQ_CTX;
+  uint32 timeup_table[32];
+  uint32 slept;
+  uint8 timeups;
+#endif
+
   tq_port_init();
+#ifdef TQ_POWER_STATS
+  qti_system_reset_power_stats();
+#endif
+
+#if _PT_RETAINED_WORDS
+  /* a warm boot out of STANDBY, timers due while asleep go out after the resume */
+  context->resume_words = tq_port_resume(context->resume_image, &slept);
+  if(context->resume_words)
+  {
+    qti_system_lock();
+    timeups = resume_timers(context, slept, timeup_table);
+    qti_system_unlock();
+
+    slept /= _PT_SLEEP_TIMER_TICK_PER_MS;
+    tinyq_send_signal(0, QTI_BROADCAST, SYSTEM_NTF_RESUME, &slept, sizeof(slept));
+    notify_timer_clients(timeup_table, timeups);
+    return;
+  }
+#endif
   
   tinyq_send_signal(0, QTI_BROADCAST, SYSTEM_NTF_START, 0, 0);
 }
@@ -132,19 +298,20 @@ static void notify_timer_clients(uint32 *table, uint8 count)
     timer_id = table[i] & 0xffff;
     qti = (table[i] >> 16) & 0xff;
     
+    TQ_TRACE_EVENT(TQ_TRACE_EVT_TIMER_EXPIRE, qti, timer_id, timer_id >> 8);
     tinyq_send_signal(0, qti, SYSTEM_RSP_TIMER, &timer_id, sizeof(timer_id));
   }
 }
 
-static uint8 start_timer(uint32 id, uint32 period, uint32 *timeup_table)
+static uint8 start_timer(struct TQ_CONTEXT *context, uint32 id, uint32 period, uint32 *timeup_table)
 {
   uint8 i, timeups = 0;
   uint32 ticks_elapsed;
   uint32 next_alarm = 0x7fffffff;
   uint32 mask = 1;
-  uint32 timer_map = _timer_map;
+  uint32 timer_map = context->timer_map;
  
-  TQ_ASSERT(_timer_map != 0xffffffff);   // you are starting too many timers.
+  TQ_ASSERT(context->timer_map != 0xffffffff);   // you are starting too many timers.
   TQ_ASSERT(period  < (0x7fffffff / _PT_SLEEP_TIMER_TICK_PER_MS));
 
   period *= _PT_SLEEP_TIMER_TICK_PER_MS;
@@ -156,32 +323,32 @@ static uint8 start_timer(uint32 id, uint32 period, uint32 *timeup_table)
   {
     if(timer_map & 1)
     {
-      if(_timer_table[i].id == id)
+      if(context->timer_table[i].id == id)
       {
-        _timer_map ^= mask;
+        context->timer_map ^= mask;
         timer_map ^= 1;
       }
       else
       {
-        if(_timer_table[i].period <= ticks_elapsed)
+        if(context->timer_table[i].period <= ticks_elapsed)
         {
-          _timer_map ^= mask;
+          context->timer_map ^= mask;
           timer_map ^= 1;
-          timeup_table[timeups++] = _timer_table[i].id; 
+          timeup_table[timeups++] = context->timer_table[i].id; 
         }
         else
         {
-          _timer_table[i].period -= ticks_elapsed;
-          next_alarm = (next_alarm < _timer_table[i].period) ? next_alarm : _timer_table[i].period;
+          context->timer_table[i].period -= ticks_elapsed;
+          next_alarm = (next_alarm < context->timer_table[i].period) ? next_alarm : context->timer_table[i].period;
         }
       }
     }
 
     if(period && !(timer_map & 1))
     {
-      _timer_table[i].id = id;
-      _timer_table[i].period = period;
-      _timer_map |= mask;
+      context->timer_table[i].id = id;
+      context->timer_table[i].period = period;
+      context->timer_map |= mask;
       next_alarm = (next_alarm < period) ?  next_alarm : period;
       period = 0;
     }
@@ -193,36 +360,37 @@ static uint8 start_timer(uint32 id, uint32 period, uint32 *timeup_table)
       break;
   }
   
-  TQ_ASSERT(_timer_map);
+  TQ_ASSERT(context->timer_map);
+  context->timer_next_alarm = next_alarm;
   tq_port_sleep_timer_start(next_alarm);
   return timeups;
 }
 
-static void cancel_timer(uint32 id)
+static void cancel_timer(struct TQ_CONTEXT *context, uint32 id)
 {
   uint8 i;
   uint32 mask = 1;
-  uint32 timer_map = _timer_map;
+  uint32 timer_map = context->timer_map;
   
   for(i = 0; i < 32; i++)
   {
     if(!timer_map)
       break;
     
-    if((timer_map & 1) && _timer_table[i].id == id)
-      _timer_map ^= mask;
+    if((timer_map & 1) && context->timer_table[i].id == id)
+      context->timer_map ^= mask;
 
     timer_map >>= 1;
     mask <<= 1;
   }
 }
 
-static uint32 timer_timeup(uint32 *timeup_table)
+static uint32 timer_timeup(struct TQ_CONTEXT *context, uint32 *timeup_table)
 {
   uint8 i, timeups = 0;
   uint32 ticks_elapsed;
   uint32 mask = 1;
-  uint32 timer_map = _timer_map;
+  uint32 timer_map = context->timer_map;
   uint32 next_alarm = 0x7fffffff;
   
   ticks_elapsed = tq_port_sleep_timer_get_time_elapsed(FALSE);
@@ -234,33 +402,241 @@ static uint32 timer_timeup(uint32 *timeup_table)
     
     if((timer_map & 1))
     {
-      if(_timer_table[i].period <= ticks_elapsed)
+      if(context->timer_table[i].period <= ticks_elapsed)
       {
-        _timer_map ^= mask;
-        timeup_table[timeups++] = _timer_table[i].id; 
+        context->timer_map ^= mask;
+        timeup_table[timeups++] = context->timer_table[i].id; 
       }
       else
       {
-        _timer_table[i].period -= ticks_elapsed;
-        next_alarm = next_alarm > _timer_table[i].period ? _timer_table[i].period : next_alarm;
+        context->timer_table[i].period -= ticks_elapsed;
+        next_alarm = next_alarm > context->timer_table[i].period ? context->timer_table[i].period : next_alarm;
       }
     }
     timer_map >>= 1;
     mask <<= 1;
   }
   
+  context->timer_next_alarm = next_alarm;
   tq_port_sleep_timer_start(next_alarm);
   return timeups;
 }
 
 void _system_sleep_timer_handler(void)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
   uint32 timeup_table[32];
   uint8 timeups;
   
+  TQ_RECORD_STIMULUS(TQ_RECORD_TIMER, 0, 0, 0, 0, 0);
   qti_system_lock();
-  timeups = timer_timeup(timeup_table);
+  timeups = timer_timeup(context, timeup_table);
   qti_system_unlock();
   
   notify_timer_clients(timeup_table, timeups);
 }
+
+#if _PT_RETAINED_WORDS
+/* a STANDBY that does not fit the retained words or that the port turns down is a STOP */
+static uint8 standby(struct TQ_CONTEXT *context)
+{
+  uint32 image[_PT_RETAINED_WORDS];
+  uint32 elapsed = tq_port_sleep_timer_get_time_elapsed(FALSE);
+  uint32 ticks = 0;
+  uint8 words = retain_image(context, (uint8 *)image, elapsed);
+
+  if(!words)
+    return QTI_SYSTEM_SLEEP_STOP;
+
+  if(context->timer_map)
+    ticks = (context->timer_next_alarm > elapsed) ? context->timer_next_alarm - elapsed : 1;
+  tq_port_standby(image, words, ticks);
+  return QTI_SYSTEM_SLEEP_STOP;
+}
+
+/* records of qti, size and data, the timers first, 0 words when they do not fit */
+static uint8 retain_image(struct TQ_CONTEXT *context, uint8 *image, uint32 elapsed)
+{
+  struct TQ_CONTEXT_RETAINED *block = context->retained;
+  uint32 map, left;
+  uint16 used = 0;
+  uint8 i;
+
+  for(i = 0, map = context->timer_map; map; i++, map >>= 1)
+  {
+    if(!(map & 1))
+      continue;
+    if(!used)
+      used = 2;
+    if(used + RETAIN_TIMER_SIZE > RETAIN_BYTES || used - 2 + RETAIN_TIMER_SIZE > 0xff)
+      return 0;
+
+    left = (context->timer_table[i].period > elapsed) ? context->timer_table[i].period - elapsed : 1;
+    memcpy(&image[used], &context->timer_table[i].id, sizeof(uint32));
+    memcpy(&image[used + 4], &left, sizeof(left));
+    used += RETAIN_TIMER_SIZE;
+  }
+  if(used)
+  {
+    image[0] = RETAIN_TAG_TIMERS;
+    image[1] = (uint8)(used - 2);
+  }
+
+  for(i = 0; i < context->retained_count; i++, block++)
+  {
+    if(used + 2 + block->size > RETAIN_BYTES)
+      return 0;
+    image[used] = block->qti;
+    image[used + 1] = block->size;
+    memcpy(&image[used + 2], block->data, block->size);
+    used += 2 + block->size;
+  }
+
+  if(used < RETAIN_BYTES)
+    image[used++] = RETAIN_TAG_END;
+  return (uint8)((used + 3) / 4);
+}
+
+/* the timers of the image less the ticks asleep, the ones due are returned */
+static uint8 resume_timers(struct TQ_CONTEXT *context, uint32 slept, uint32 *timeup_table)
+{
+  uint8 *image = (uint8 *)context->resume_image;
+  uint32 id, left, next_alarm = 0x7fffffff;
+  uint8 i, count, timeups = 0, slot = 0;
+
+  if(image[0] != RETAIN_TAG_TIMERS || 2 + image[1] > context->resume_words * 4)
+    return 0;
+
+  count = image[1] / RETAIN_TIMER_SIZE;
+  image[0] = RETAIN_TAG_TAKEN;
+  for(i = 0, image += 2; i < count; i++, image += RETAIN_TIMER_SIZE)
+  {
+    memcpy(&id, image, sizeof(id));
+    memcpy(&left, image + 4, sizeof(left));
+    if(left <= slept)
+    {
+      timeup_table[timeups++] = id;
+      continue;
+    }
+
+    context->timer_table[slot].id = id;
+    context->timer_table[slot].period = left - slept;
+    context->timer_map |= 1UL << slot++;
+    next_alarm = (next_alarm < left - slept) ? next_alarm : left - slept;
+  }
+
+  if(context->timer_map)
+  {
+    context->timer_next_alarm = next_alarm;
+    tq_port_sleep_timer_start(next_alarm);
+  }
+  return timeups;
+}
+#endif
+
+#ifdef TQ_POWER_STATS
+/* power accounting, time is checkpointed at every wakeup, holders are a 32 bit map */
+void qti_system_reset_power_stats(void)
+{
+  struct TQ_CONTEXT *context = TQ_CTX;
+  uint8 i;
+  
+  qti_system_lock();
+  memset(&context->power_stats, 0, sizeof(context->power_stats));
+  context->power_stats.timestamp_freq = _PT_TIMESTAMP_FREQ;
+  context->power_checkpoint = tq_port_timestamp();
+  for(i = 0; i < QTI_SYSTEM_WAIT_HOLDERS; i++)
+  {
+    memset(&context->wait_holders[i].stats, 0, sizeof(context->wait_holders[i].stats));
+    context->wait_holders[i].since = context->power_checkpoint;
+  }
+  qti_system_unlock();
+}
+
+void qti_system_get_power_stats(struct QTI_SYSTEM_POWER_STATS *stats)
+{
+  struct TQ_CONTEXT *context = TQ_CTX;
+
+  qti_system_lock();
+  *stats = context->power_stats;
+  power_time_add(&stats->active, tq_port_timestamp() - context->power_checkpoint);
+  qti_system_unlock();
+}
+
+boolean qti_system_get_wait_stats(uint8 qti, struct QTI_SYSTEM_WAIT_STATS *stats)
+{
+  struct TQ_CONTEXT *context = TQ_CTX;
+
+  if(qti >= QTI_SYSTEM_WAIT_HOLDERS)
+    return FALSE;
+  
+  qti_system_lock();
+  *stats = context->wait_holders[qti].stats;
+  if(context->wait_holders[qti].count)
+    power_time_add(&stats->held, tq_port_timestamp() - context->wait_holders[qti].since);
+  qti_system_unlock();
+  return TRUE;
+}
+
+static void power_time_add(struct QTI_SYSTEM_TIME *time, uint32 ticks)
+{
+  time->ticks += ticks;
+  if(time->ticks >= _PT_TIMESTAMP_FREQ)
+  {
+    time->seconds += time->ticks / _PT_TIMESTAMP_FREQ;
+    time->ticks %= _PT_TIMESTAMP_FREQ;
+  }
+}
+
+static void power_wait_changed(struct TQ_CONTEXT *context, uint8 qti, boolean request)
+{
+  struct TQ_CONTEXT_WAIT_HOLDER *holder;
+  
+  if(qti >= QTI_SYSTEM_WAIT_HOLDERS)
+  {
+    if(request)
+      context->power_stats.untracked_waits++;
+    return;
+  }
+  
+  holder = &context->wait_holders[qti];
+  if(request)
+  {
+    if(!holder->count++)
+    {
+      holder->since = tq_port_timestamp();
+      context->power_holder_map |= (1UL << qti);
+    }
+    holder->stats.requests++;
+  }
+  else if(holder->count && !--holder->count)
+  {
+    power_time_add(&holder->stats.held, tq_port_timestamp() - holder->since);
+    context->power_holder_map &= ~(1UL << qti);
+  }
+}
+
+static void power_sleep_finished(struct TQ_CONTEXT *context, uint8 mode, uint8 cause, uint32 sleep_start)
+{
+  uint8 i;
+  uint32 map = context->power_holder_map;
+  uint32 wakeup = tq_port_timestamp();
+  uint32 slept = wakeup - sleep_start;
+  
+  power_time_add(&context->power_stats.asleep[mode], slept);
+  context->power_stats.sleeps[mode]++;
+  context->power_stats.wakeups[cause]++;
+  context->power_checkpoint = wakeup;
+  
+  for(i = 0; map; i++, map >>= 1)
+  {
+    if(!(map & 1))
+      continue;
+    
+    if(mode == QTI_SYSTEM_SLEEP_WFI)
+      power_time_add(&context->wait_holders[i].stats.stop_denied, slept);
+    power_time_add(&context->wait_holders[i].stats.held, wakeup - context->wait_holders[i].since);
+    context->wait_holders[i].since = wakeup;
+  }
+}
+#endif
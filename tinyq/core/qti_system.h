@@ -8,9 +8,81 @@
 
 #define SYSTEM_NTF_START                    TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 0)
 #define SYSTEM_NTF_TIME_CHANGE              TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 1)
+#define SYSTEM_NTF_RESUME                   TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 2)   /* p: uint32 ms in STANDBY */
 
 #define SYSTEM_RSP_TIMER                    TQ_SIG_MAKE_RSP(TQ_DSP_NORMAL, 0)
 
+/* wakeup causes reported by tq_port_sleep() */
+#define QTI_SYSTEM_WAKEUP_RTC               (0)
+#define QTI_SYSTEM_WAKEUP_EXTI              (1)
+#define QTI_SYSTEM_WAKEUP_OTHER             (2)
+#define QTI_SYSTEM_WAKEUP_CAUSES            (3)
+
+/* sleep modes, lightest first */
+#define QTI_SYSTEM_SLEEP_WFI                (0)
+#define QTI_SYSTEM_SLEEP_STOP               (1)
+#define QTI_SYSTEM_SLEEP_STANDBY            (2)
+#define QTI_SYSTEM_SLEEP_MODES              (3)
+
+#define QTI_SYSTEM_SLEEP_UNAVAILABLE        (0xffffffff)
+
+/* port cost model of a sleep mode, in sleep timer ticks */
+struct QTI_SYSTEM_SLEEP_MODE
+{
+  uint32 wakeup_latency;        /* from wakeup event to running code */
+  uint32 break_even;            /* shortest sleep that saves energy over the lighter mode */
+};
+
+/*
+  Power accounting, built with TQ_POWER_STATS defined. Waits of Qties at
+  QTI_SYSTEM_WAIT_HOLDERS and above keep the system out of STOP all the
+  same, they are only counted in untracked_waits, not held per Qti.
+*/
+#ifndef QTI_SYSTEM_WAIT_HOLDERS
+#define QTI_SYSTEM_WAIT_HOLDERS             (16)
+#endif
+
+#if QTI_SYSTEM_WAIT_HOLDERS > 32
+#error "the holders are a 32 bit map"
+#endif
+
+/*
+  STANDBY, on a port with _PT_RETAINED_WORDS, loses RAM and ends in a reset.
+  It is only taken once allowed, by an application whose Qties wake on the
+  RTC and the wakeup pins alone, and when the timers and the blocks given
+  to qti_system_retain() fit the retained words. The reset is a warm boot:
+  the port keeps the RTC running, the timers come back less the time asleep
+  and SYSTEM_NTF_RESUME goes out instead of SYSTEM_NTF_START. A Qti calls
+  qti_system_retain() again on it to get its block back, and allows STANDBY
+  again. Qties not handling it are left as they come out of reset.
+*/
+#ifndef QTI_SYSTEM_RETAINED_BLOCKS
+#define QTI_SYSTEM_RETAINED_BLOCKS          (4)
+#endif
+
+struct QTI_SYSTEM_TIME
+{
+  uint32 seconds;
+  uint32 ticks;                 /* port timestamp ticks, below one second */
+};
+
+struct QTI_SYSTEM_POWER_STATS
+{
+  uint32 timestamp_freq;
+  struct QTI_SYSTEM_TIME active;
+  struct QTI_SYSTEM_TIME asleep[QTI_SYSTEM_SLEEP_MODES];
+  uint32 sleeps[QTI_SYSTEM_SLEEP_MODES];
+  uint32 wakeups[QTI_SYSTEM_WAKEUP_CAUSES];
+  uint32 untracked_waits;               /* requests of Qties past the holders */
+};
+
+struct QTI_SYSTEM_WAIT_STATS
+{
+  uint32 requests;
+  struct QTI_SYSTEM_TIME held;          /* time holding a wait */
+  struct QTI_SYSTEM_TIME stop_denied;   /* time in WFI sleep while holding a wait */
+};
+
 struct TQ_QTI;
 
 extern void qti_system_us_delay(uint32 us);
@@ -21,6 +93,14 @@ extern void qti_system_request_wait(uint8 qti);
 extern void qti_system_release_wait(uint8 qti);
 extern void qti_system_start_timer(uint8 qti, uint16 id, uint32 period);
 extern void qti_system_stop_timer(uint8 qti, uint16 id);
+extern void qti_system_allow_standby(boolean allowed);
+extern boolean qti_system_retain(uint8 qti, void *data, uint8 size);
+
+#ifdef TQ_POWER_STATS
+extern void qti_system_reset_power_stats(void);
+extern void qti_system_get_power_stats(struct QTI_SYSTEM_POWER_STATS *stats);
+extern boolean qti_system_get_wait_stats(uint8 qti, struct QTI_SYSTEM_WAIT_STATS *stats);
+#endif
 
 extern void qti_system_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
 
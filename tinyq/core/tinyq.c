@@ -2,67 +2,88 @@
   tinyq.c
   Copyright (c) 2020 - 2021, Xiaofu Yan.  All rights reserved.
 ****************************************************************************/
+#include <string.h>
 #include "tq_types.h"
 #include "tinyq.h"
 #include "hw_debug.h"
 #include "ring_buffer.h"
 #include "qti_system.h"
 #include "tq_port.h"
+#include "tq_context.h"
+#include "tq_profile.h"
+#include "tq_trace.h"
+#include "tq_record.h"
+#ifdef TQ_POOL
+#include "tq_pool.h"
+#endif
 
 
-/* signal ring buffer */
-#define INTERFACE_BUFFER_SIZE               (256 * 2)
-#define LOGIC_BUFFER_SIZE                   (256 * 2)
-
 extern void   qti_system_start(void);
 extern void   qti_system_sleep(void);
 
 
-/* temporary signal parameter buffer */
-static uint8 _logic_parameter_buffer[256];
-static uint8 _interface_parameter_buffer[256];
+extern const uint8 tq_qti_count;
+extern const struct TQ_QTI tq_qti_table[];
 
-static uint8 _interface_buffer[INTERFACE_BUFFER_SIZE];
-static struct RING_BUFFER _interface_ring_buffer = {0, 0, sizeof(_interface_buffer), _interface_buffer};
+struct TQ_CONTEXT tq_default_context;
 
-static uint8 _logic_buffer[LOGIC_BUFFER_SIZE];
-static struct RING_BUFFER _logic_ring_buffer = {0, 0, sizeof(_logic_buffer), _logic_buffer};
+#ifdef TQ_CONTEXTS
+_PT_THREAD_LOCAL struct TQ_CONTEXT *tq_context = &tq_default_context;
+#endif
 
 
 /* signal processing */
-extern const uint8 tq_qti_count;
-extern const struct TQ_QTI tq_qti_table[];
+void _tq_invoke_qti(const struct TQ_QTI *qti_table, uint8 qti, const uint8 *header, const uint8 *param)
+{
+#ifdef TQ_PROFILE
+  uint32 enqueued, start;
+  
+  memcpy(&enqueued, &header[4], sizeof(enqueued));
+  start = tq_port_timestamp();
+#endif
+  
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_DISPATCH_BEGIN, qti, header[2], header[0]);
+  qti_table[qti].signal_entry(&qti_table[qti], header[0], header[2], param, header[3]);
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_DISPATCH_END, qti, header[2], 0);
+  
+#ifdef TQ_PROFILE
+  tq_profile_record(qti, header[2], enqueued, start, tq_port_timestamp());
+#endif
+}
 
-static void process_signal(uint8 from, uint8 to, uint8 sig, const uint8 *param, uint8 size)
+static void process_signal(struct TQ_CONTEXT *context, const uint8 *header, const uint8 *param)
 {
+  uint8 to = header[1];
+  
   if(to == QTI_BROADCAST)
   {
-    for(to = 0; to < tq_qti_count; to++)
-      tq_qti_table[to].signal_entry(&tq_qti_table[to], from, sig, param, size);
+    for(to = 0; to < context->qti_count; to++)
+      _tq_invoke_qti(context->qti_table, to, header, param);
   }
-  else if(to < tq_qti_count)
-    tq_qti_table[to].signal_entry(&tq_qti_table[to], from, sig, param, size);
+  else if(to < context->qti_count)
+    _tq_invoke_qti(context->qti_table, to, header, param);
 }
 
 /* main dispatch loop */
 static void normal_priority_dispatch_loop(void)
 {
-  uint8 buffer[4];
+  struct TQ_CONTEXT *context = TQ_CTX;
+  uint8 buffer[TQ_SIGNAL_HEADER_SIZE];
   
   /*the main loop*/
   while(1)
   {
     qti_system_lock();
-    if(ring_buffer_size(&_logic_ring_buffer))
+    if(ring_buffer_size(&context->logic_ring))
     {
-      ring_buffer_pop_front(&_logic_ring_buffer, buffer, 4);
+      ring_buffer_pop_front(&context->logic_ring, buffer, TQ_SIGNAL_HEADER_SIZE);
       if(buffer[3] != 0)
-        ring_buffer_pop_front(&_logic_ring_buffer, &_logic_parameter_buffer[0], buffer[3]);
+        ring_buffer_pop_front(&context->logic_ring, &context->logic_parameter[0], buffer[3]);
 
       qti_system_unlock();
       
       TQ_DEBUG_PIN_SET(DEBUG_PIN_TINYQ_NORMAL_EVT, TRUE);
-      process_signal(buffer[0], buffer[1], buffer[2], _logic_parameter_buffer, buffer[3]);
+      process_signal(context, buffer, context->logic_parameter);
       TQ_DEBUG_PIN_SET(DEBUG_PIN_TINYQ_NORMAL_EVT, FALSE);
     }
     else
@@ -77,17 +98,18 @@ static void normal_priority_dispatch_loop(void)
 
 void _tq_high_priority_dispatch(void)
 {
+  struct TQ_CONTEXT *context = TQ_CTX;
   boolean signal;
-  uint8 buffer[4];
+  uint8 buffer[TQ_SIGNAL_HEADER_SIZE];
   
   do
   {
     qti_system_lock();
-    if(ring_buffer_size(&_interface_ring_buffer))
+    if(ring_buffer_size(&context->interface_ring))
     {
-      ring_buffer_pop_front(&_interface_ring_buffer, buffer, 4);
+      ring_buffer_pop_front(&context->interface_ring, buffer, TQ_SIGNAL_HEADER_SIZE);
       if(buffer[3] != 0)
-        ring_buffer_pop_front(&_interface_ring_buffer, &_interface_parameter_buffer[0], buffer[3]);
+        ring_buffer_pop_front(&context->interface_ring, &context->interface_parameter[0], buffer[3]);
       signal = TRUE;
     }
     else
@@ -99,24 +121,61 @@ void _tq_high_priority_dispatch(void)
     if(signal)
     {
       TQ_DEBUG_PIN_SET(DEBUG_PIN_TINYQ_HIGH_EVT, TRUE);
-      process_signal(buffer[0], buffer[1], buffer[2], _interface_parameter_buffer, buffer[3]);
+      process_signal(context, buffer, context->interface_parameter);
       TQ_DEBUG_PIN_SET(DEBUG_PIN_TINYQ_HIGH_EVT, TRUE);
     }
   } while(signal);
 }
 
 /* public interface */
-void tinyq_run(void)
+void tinyq_context_init(struct TQ_CONTEXT *context, const struct TQ_QTI *qti_table, uint8 qti_count)
+{
+  memset(context, 0, sizeof(*context));
+  context->qti_table = qti_table;
+  context->qti_count = qti_count;
+  ring_buffer_init(&context->interface_ring, context->interface_buffer, sizeof(context->interface_buffer));
+  ring_buffer_init(&context->logic_ring, context->logic_buffer, sizeof(context->logic_buffer));
+}
+
+/* runs an instance set up by tinyq_context_init() in the calling thread, never returns */
+void tinyq_run_context(struct TQ_CONTEXT *context)
 {
+#ifdef TQ_CONTEXTS
+  tq_context = context;
+#else
+  TQ_ASSERT(context == &tq_default_context);
+#endif
   TQ_DEBUG_INIT();
+#ifdef TQ_PROFILE
+  tq_profile_reset();
+#endif
+#ifdef TQ_TRACE
+  tq_trace_reset();
+#endif
+#ifdef TQ_RECORD
+  tq_record_reset();
+#endif
+#ifdef TQ_LOCK_MONITOR
+  tq_lock_monitor_reset();
+#endif
   
   qti_system_start();
   normal_priority_dispatch_loop();
 }
 
+void tinyq_run(void)
+{
+  tinyq_context_init(&tq_default_context, tq_qti_table, tq_qti_count);
+  tinyq_run_context(&tq_default_context);
+}
+
 void tinyq_send_signal(uint8 from, uint8 to, uint8 sig, const void *param, uint8 size)
 {
-  uint8 buffer[4];
+  struct TQ_CONTEXT *context = TQ_CTX;
+  uint8 buffer[TQ_SIGNAL_HEADER_SIZE];
+#ifdef TQ_PROFILE
+  uint32 enqueued;
+#endif
   
   if(!to)
     return;
@@ -125,20 +184,51 @@ void tinyq_send_signal(uint8 from, uint8 to, uint8 sig, const void *param, uint8
   buffer[1] = to;
   buffer[2] = sig;
   buffer[3] = size;
+#ifdef TQ_PROFILE
+  enqueued = tq_port_timestamp();
+  memcpy(&buffer[4], &enqueued, sizeof(enqueued));
+#endif
+  
+#ifdef TQ_POOL
+  /* mailboxes of the pool have locks of their own */
+  if(context->pool)
+  {
+    _tq_pool_post(context->pool, buffer, param);
+    return;
+  }
+#endif
   
   qti_system_lock();
+  TQ_TRACE_EVENT(TQ_TRACE_EVT_ENQUEUE, from, to, sig);
+#ifdef TQ_RECORD
+  /* timer responses and sends from dispatched Qties are replayed by themselves */
+  if(from && tq_port_in_isr())
+    tq_record(TQ_RECORD_SIGNAL, from, to, sig, param, size);
+#endif
   if(TQ_SIG_DISPATCHER(sig) == TQ_DSP_HIGH)
   {
-    ring_buffer_push_back(&_interface_ring_buffer, buffer, 4);
+    ring_buffer_push_back(&context->interface_ring, buffer, TQ_SIGNAL_HEADER_SIZE);
     if(size)
-      ring_buffer_push_back(&_interface_ring_buffer, param, size);
+      ring_buffer_push_back(&context->interface_ring, param, size);
     tq_port_trigger_high_priority_dispatch();
   }
   else
   {
-    ring_buffer_push_back(&_logic_ring_buffer, buffer, 4);
+    ring_buffer_push_back(&context->logic_ring, buffer, TQ_SIGNAL_HEADER_SIZE);
     if(size)
-      ring_buffer_push_back(&_logic_ring_buffer, param, size);
+      ring_buffer_push_back(&context->logic_ring, param, size);
   }
   qti_system_unlock();
 }
+
+#ifdef TQ_DEBUG
+void tinyq_get_queue_high_water(int16 *interface_bytes, int16 *logic_bytes)
+{
+  struct TQ_CONTEXT *context = TQ_CTX;
+  
+  qti_system_lock();
+  *interface_bytes = context->interface_ring.high_water_mark;
+  *logic_bytes = context->logic_ring.high_water_mark;
+  qti_system_unlock();
+}
+#endif
@@ -35,4 +35,8 @@ struct  TQ_QTI
 extern void tinyq_run(void);
 extern void tinyq_send_signal(uint8 from, uint8 to, uint8 sig, const void *param, uint8 param_size);
 
+#ifdef TQ_DEBUG
+extern void tinyq_get_queue_high_water(int16 *interface_bytes, int16 *logic_bytes);
+#endif
+
 #endif
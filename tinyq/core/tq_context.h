@@ -0,0 +1,122 @@
+/****************************************************************************
+  tq_context.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_CONTEXT_H
+#define TQ_CONTEXT_H
+
+/*
+  Kernel state of one tinyq instance. tinyq_run() runs tq_default_context
+  with the application's tq_qti_table. Built with TQ_CONTEXTS defined, on a
+  host port, more instances can be set up with tinyq_context_init() and run
+  with tinyq_run_context(), each in a thread of its own. The kernel, the
+  port and the diagnostics buffers of a thread work on the instance of that
+  thread, signals never cross instances. Qties keeping state in file scope
+  variables need it per thread too, TQ_CONTEXT.user is theirs.
+*/
+
+/* signal header: from, to, sig, size [, enqueue timestamp] */
+#ifdef TQ_PROFILE
+  #define TQ_SIGNAL_HEADER_SIZE             (8)
+#else
+  #define TQ_SIGNAL_HEADER_SIZE             (4)
+#endif
+
+#ifndef TQ_INTERFACE_BUFFER_SIZE
+#define TQ_INTERFACE_BUFFER_SIZE            (256 * 2)
+#endif
+
+#ifndef TQ_LOGIC_BUFFER_SIZE
+#define TQ_LOGIC_BUFFER_SIZE                (256 * 2)
+#endif
+
+/* words the port keeps over STANDBY, none without it */
+#ifndef _PT_RETAINED_WORDS
+#define _PT_RETAINED_WORDS                  (0)
+#endif
+
+struct TQ_CONTEXT_TIMER
+{
+  uint32 id;
+  uint32 period;
+};
+
+#if _PT_RETAINED_WORDS
+struct TQ_CONTEXT_RETAINED
+{
+  uint8  qti;
+  uint8  size;
+  void  *data;
+};
+#endif
+
+#ifdef TQ_POWER_STATS
+struct TQ_CONTEXT_WAIT_HOLDER
+{
+  uint8  count;
+  uint32 since;
+  struct QTI_SYSTEM_WAIT_STATS stats;
+};
+#endif
+
+#ifdef TQ_POOL
+struct TQ_WORKER_POOL;
+#endif
+
+struct TQ_CONTEXT
+{
+  const struct TQ_QTI *qti_table;
+  uint8  qti_count;
+  void  *user;
+#ifdef TQ_POOL
+  struct TQ_WORKER_POOL *pool;                     /* signals go to the worker pool of tq_pool.h */
+#endif
+
+  /* signal queues */
+  struct RING_BUFFER interface_ring;
+  struct RING_BUFFER logic_ring;
+  uint8  interface_buffer[TQ_INTERFACE_BUFFER_SIZE];
+  uint8  logic_buffer[TQ_LOGIC_BUFFER_SIZE];
+  uint8  interface_parameter[256];
+  uint8  logic_parameter[256];
+
+  /* qti_system */
+  int32  lock_counter;
+  int32  wait_counter;
+  uint32 timer_map;
+  uint32 timer_next_alarm;
+  struct TQ_CONTEXT_TIMER timer_table[32];
+#ifdef TQ_DEBUG
+  uint8  wait_table[256];
+#endif
+#if _PT_RETAINED_WORDS
+  boolean standby_allowed;
+  uint8  retained_count;
+  uint8  resume_words;                             /* of the image a warm boot read back */
+  struct TQ_CONTEXT_RETAINED retained[QTI_SYSTEM_RETAINED_BLOCKS];
+  uint32 resume_image[_PT_RETAINED_WORDS];
+#endif
+#ifdef TQ_POWER_STATS
+  uint32 power_checkpoint;
+  uint32 power_holder_map;
+  struct QTI_SYSTEM_POWER_STATS power_stats;
+  struct TQ_CONTEXT_WAIT_HOLDER wait_holders[QTI_SYSTEM_WAIT_HOLDERS];
+#endif
+};
+
+extern struct TQ_CONTEXT tq_default_context;
+
+extern void tinyq_context_init(struct TQ_CONTEXT *context, const struct TQ_QTI *qti_table, uint8 qti_count);
+extern void tinyq_run_context(struct TQ_CONTEXT *context);
+
+/* for ports dispatching signals themselves */
+extern void _tq_invoke_qti(const struct TQ_QTI *qti_table, uint8 qti, const uint8 *header, const uint8 *param);
+
+#ifdef TQ_CONTEXTS
+  extern _PT_THREAD_LOCAL struct TQ_CONTEXT *tq_context;
+  #define TQ_CTX                            (tq_context)
+#else
+  #define TQ_CTX                            (&tq_default_context)
+#endif
+
+#endif
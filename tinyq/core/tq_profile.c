@@ -0,0 +1,187 @@
+/****************************************************************************
+  tq_profile.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "tq_profile.h"
+
+#if defined(TQ_PROFILE) || defined(TQ_LOCK_MONITOR)
+static uint8 histogram_bucket(uint32 ticks, uint8 shift, uint8 buckets);
+
+static uint8 histogram_bucket(uint32 ticks, uint8 shift, uint8 buckets)
+{
+  uint8 bucket = 0;
+
+  ticks >>= (shift + 1);
+  while(ticks && bucket < buckets - 1)
+  {
+    ticks >>= 1;
+    bucket++;
+  }
+  return bucket;
+}
+#endif
+
+#ifdef TQ_PROFILE
+static struct TQ_PROFILE_ENTRY *find_entry(uint8 qti, uint8 sig, boolean create);
+
+
+_PT_THREAD_LOCAL struct TQ_PROFILE_TABLE tq_profile;
+
+
+void tq_profile_reset(void)
+{
+  qti_system_lock();
+  memset(&tq_profile, 0, sizeof(tq_profile));
+  tq_profile.magic = TQ_PROFILE_MAGIC;
+  tq_profile.timestamp_freq = _PT_TIMESTAMP_FREQ;
+  tq_profile.slot_count = TQ_PROFILE_SLOTS;
+  tq_profile.bucket_count = TQ_PROFILE_BUCKETS;
+  tq_profile.bucket_shift = TQ_PROFILE_BUCKET_SHIFT;
+  qti_system_unlock();
+}
+
+void tq_profile_record(uint8 qti, uint8 sig, uint32 enqueued, uint32 start, uint32 end)
+{
+  struct TQ_PROFILE_ENTRY *entry;
+  uint32 time = end - start;
+  uint32 residency = start - enqueued;
+  uint16 *bucket;
+
+  qti_system_lock();
+  if(tq_profile.magic != TQ_PROFILE_MAGIC)
+    tq_profile_reset();
+
+  entry = find_entry(qti, sig, TRUE);
+  if(entry)
+  {
+    entry->count++;
+    entry->time_total += time;
+    entry->time_max = (entry->time_max < time) ? time : entry->time_max;
+    entry->residency_max = (entry->residency_max < residency) ? residency : entry->residency_max;
+
+    bucket = &entry->histogram[histogram_bucket(time, TQ_PROFILE_BUCKET_SHIFT, TQ_PROFILE_BUCKETS)];
+    if(*bucket != 0xffff)
+      (*bucket)++;
+  }
+  else
+  {
+    tq_profile.dropped++;
+  }
+  qti_system_unlock();
+}
+
+boolean tq_profile_get(uint8 qti, uint8 sig, struct TQ_PROFILE_ENTRY *entry)
+{
+  struct TQ_PROFILE_ENTRY *found;
+
+  qti_system_lock();
+  found = find_entry(qti, sig, FALSE);
+  if(found)
+    *entry = *found;
+  qti_system_unlock();
+
+  return found ? TRUE : FALSE;
+}
+
+const struct TQ_PROFILE_TABLE *tq_profile_get_data(void)
+{
+  return &tq_profile;
+}
+
+static struct TQ_PROFILE_ENTRY *find_entry(uint8 qti, uint8 sig, boolean create)
+{
+  uint8 i;
+  struct TQ_PROFILE_ENTRY *entry = tq_profile.entries;
+
+  for(i = 0; i < TQ_PROFILE_SLOTS; i++, entry++)
+  {
+    if(!entry->count)
+    {
+      if(!create)
+        break;
+
+      entry->qti = qti;
+      entry->sig = sig;
+      return entry;
+    }
+
+    if(entry->qti == qti && entry->sig == sig)
+      return entry;
+  }
+  return 0;
+}
+
+#endif
+
+#ifdef TQ_LOCK_MONITOR
+#define LOCK_BUDGET             (TQ_LOCK_BUDGET_US * (_PT_TIMESTAMP_FREQ / 1000000))
+
+_PT_THREAD_LOCAL struct TQ_LOCK_STATS tq_lock_stats;
+
+static _PT_THREAD_LOCAL boolean _lock_active = FALSE;
+static _PT_THREAD_LOCAL uint32 _lock_start;
+static _PT_THREAD_LOCAL const void *_lock_caller;
+
+
+void tq_lock_monitor_reset(void)
+{
+  uint32 irq = tq_port_irq_save();
+
+  memset(&tq_lock_stats, 0, sizeof(tq_lock_stats));
+  tq_port_irq_restore(irq);
+}
+
+/* called with interrupts disabled */
+void tq_lock_monitor_enter(const void *caller)
+{
+  _lock_active = TRUE;
+  _lock_caller = caller;
+  _lock_start = tq_port_timestamp();
+}
+
+/* called with interrupts disabled */
+void tq_lock_monitor_exit(void)
+{
+  uint32 time;
+  uint16 *bucket;
+
+  if(!_lock_active)
+    return;
+
+  time = tq_port_timestamp() - _lock_start;
+  _lock_active = FALSE;
+
+  tq_lock_stats.count++;
+  if(time > tq_lock_stats.time_max)
+  {
+    tq_lock_stats.time_max = time;
+    tq_lock_stats.max_caller = _lock_caller;
+  }
+
+  bucket = &tq_lock_stats.histogram[histogram_bucket(time, TQ_LOCK_BUCKET_SHIFT, TQ_LOCK_BUCKETS)];
+  if(*bucket != 0xffff)
+    (*bucket)++;
+
+  if(time > LOCK_BUDGET)
+  {
+    tq_lock_stats.over_budget++;
+    tq_lock_stats.last_over_caller = _lock_caller;
+    TQ_DEBUG_PIN_SET(DEBUG_PIN_TINYQ_LOCK_BUDGET, TRUE);
+    TQ_DEBUG_PIN_SET(DEBUG_PIN_TINYQ_LOCK_BUDGET, FALSE);
+  }
+}
+
+void tq_lock_monitor_get(struct TQ_LOCK_STATS *stats)
+{
+  uint32 irq = tq_port_irq_save();
+
+  *stats = tq_lock_stats;
+  tq_port_irq_restore(irq);
+}
+
+#endif
@@ -0,0 +1,96 @@
+/****************************************************************************
+  tq_profile.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_PROFILE_H
+#define TQ_PROFILE_H
+
+/*
+  Per (Qti, signal) dispatch statistics, built with TQ_PROFILE defined.
+  Times are in port timestamp ticks (_PT_TIMESTAMP_FREQ).
+  Histogram bucket i counts handler times in [2^(i + shift), 2^(i + shift + 1)),
+  the first and the last bucket also take everything below and above.
+*/
+
+#define TQ_PROFILE_MAGIC                    (0x46505154)    /* "TQPF" */
+
+#ifndef TQ_PROFILE_SLOTS
+#define TQ_PROFILE_SLOTS                    (16)
+#endif
+
+#ifndef TQ_PROFILE_BUCKETS
+#define TQ_PROFILE_BUCKETS                  (16)
+#endif
+
+#ifndef TQ_PROFILE_BUCKET_SHIFT
+#define TQ_PROFILE_BUCKET_SHIFT             (4)
+#endif
+
+struct TQ_PROFILE_ENTRY
+{
+  uint8  qti;
+  uint8  sig;
+  uint16 reserved;
+  uint32 count;
+  uint32 time_total;
+  uint32 time_max;
+  uint32 residency_max;
+  uint16 histogram[TQ_PROFILE_BUCKETS];
+};
+
+struct TQ_PROFILE_TABLE
+{
+  uint32 magic;
+  uint32 timestamp_freq;
+  uint16 slot_count;
+  uint8  bucket_count;
+  uint8  bucket_shift;
+  uint32 dropped;
+  struct TQ_PROFILE_ENTRY entries[TQ_PROFILE_SLOTS];
+};
+
+/*
+  Critical section monitor, built with TQ_LOCK_MONITOR defined. Measures the
+  time from the outermost qti_system_lock() to the matching unlock,
+  started over by tinyq_run(). In TQ_DEBUG builds sections longer than
+  TQ_LOCK_BUDGET_US pulse DEBUG_PIN_TINYQ_LOCK_BUDGET, PC11 on the
+  STM32F030.
+*/
+
+#ifndef TQ_LOCK_BUCKETS
+#define TQ_LOCK_BUCKETS                     (12)
+#endif
+
+#ifndef TQ_LOCK_BUCKET_SHIFT
+#define TQ_LOCK_BUCKET_SHIFT                (3)
+#endif
+
+#ifndef TQ_LOCK_BUDGET_US
+#define TQ_LOCK_BUDGET_US                   (50)
+#endif
+
+struct TQ_LOCK_STATS
+{
+  uint32 count;
+  uint32 time_max;
+  const void *max_caller;
+  uint32 over_budget;
+  const void *last_over_caller;
+  uint16 histogram[TQ_LOCK_BUCKETS];
+};
+
+#ifdef TQ_PROFILE
+  extern void tq_profile_reset(void);
+  extern void tq_profile_record(uint8 qti, uint8 sig, uint32 enqueued, uint32 start, uint32 end);
+  extern boolean tq_profile_get(uint8 qti, uint8 sig, struct TQ_PROFILE_ENTRY *entry);
+  extern const struct TQ_PROFILE_TABLE *tq_profile_get_data(void);
+#endif
+
+#ifdef TQ_LOCK_MONITOR
+  extern void tq_lock_monitor_reset(void);
+  extern void tq_lock_monitor_enter(const void *caller);
+  extern void tq_lock_monitor_exit(void);
+  extern void tq_lock_monitor_get(struct TQ_LOCK_STATS *stats);
+#endif
+
+#endif
@@ -0,0 +1,65 @@
+/****************************************************************************
+  tq_record.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "tq_port.h"
+#include "tq_record.h"
+
+#ifdef TQ_RECORD
+
+_PT_THREAD_LOCAL struct TQ_RECORD_BUFFER tq_record_buffer;
+
+
+void tq_record_reset(void)
+{
+  uint32 irq = tq_port_irq_save();
+
+  memset(&tq_record_buffer, 0, sizeof(tq_record_buffer));
+  tq_record_buffer.magic = TQ_RECORD_MAGIC;
+  tq_record_buffer.timestamp_freq = _PT_TIMESTAMP_FREQ;
+  tq_record_buffer.size = TQ_RECORD_SIZE;
+
+  tq_port_irq_restore(irq);
+}
+
+/* callable from interrupts, a stream with holes can not be replayed so it stops at the first drop */
+void tq_record(uint8 type, uint8 a, uint8 b, uint8 c, const void *param, uint8 size)
+{
+  uint8 *item;
+  uint32 time, length = TQ_RECORD_ITEM_SIZE + ((type == TQ_RECORD_SIGNAL) ? 1 + size : 0);
+  uint32 irq = tq_port_irq_save();
+
+  if(tq_record_buffer.dropped || tq_record_buffer.used + length > TQ_RECORD_SIZE)
+  {
+    tq_record_buffer.dropped++;
+    tq_port_irq_restore(irq);
+    return;
+  }
+
+  item = &tq_record_buffer.data[tq_record_buffer.used];
+  time = tq_port_timestamp();
+  memcpy(item, &time, sizeof(time));
+  item[4] = type;
+  item[5] = a;
+  item[6] = b;
+  item[7] = c;
+  if(type == TQ_RECORD_SIGNAL)
+  {
+    item[8] = size;
+    if(size)
+      memcpy(&item[9], param, size);
+  }
+  tq_record_buffer.used += length;
+
+  tq_port_irq_restore(irq);
+}
+
+const struct TQ_RECORD_BUFFER *tq_record_get_data(void)
+{
+  return &tq_record_buffer;
+}
+
+#endif
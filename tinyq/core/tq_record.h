@@ -0,0 +1,51 @@
+/****************************************************************************
+  tq_record.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_RECORD_H
+#define TQ_RECORD_H
+
+/*
+  Stimulus recorder, built with TQ_RECORD defined. Keeps the ordered stream
+  of what drives the system from outside: EXTI edges with the pin level,
+  sleep timer alarms and signals sent from interrupt handlers. Everything
+  the Qties derive from them is left out, tinyq/hw/sim/tq_replay.c plays a
+  dump of tq_record_buffer back against the same Qti code.
+  Recording starts with tinyq_run() and stops when the buffer is full.
+*/
+
+#define TQ_RECORD_MAGIC                     (0x43525154)    /* "TQRC" */
+
+#ifndef TQ_RECORD_SIZE
+#define TQ_RECORD_SIZE                      (2048)          /* bytes */
+#endif
+
+/* item: time(4) type a b c [size param...]                    a       b       c */
+#define TQ_RECORD_EXTI                      (0x01)          /* line    level   - */
+#define TQ_RECORD_TIMER                     (0x02)          /* -       -       - */
+#define TQ_RECORD_SIGNAL                    (0x03)          /* from    to      sig */
+
+#define TQ_RECORD_ITEM_SIZE                 (8)
+
+struct TQ_RECORD_BUFFER
+{
+  uint32 magic;
+  uint32 timestamp_freq;
+  uint16 size;
+  uint16 reserved;
+  uint32 used;
+  uint32 dropped;
+  uint8  data[TQ_RECORD_SIZE];
+};
+
+#ifdef TQ_RECORD
+  extern void tq_record_reset(void);
+  extern void tq_record(uint8 type, uint8 a, uint8 b, uint8 c, const void *param, uint8 size);
+  extern const struct TQ_RECORD_BUFFER *tq_record_get_data(void);
+
+  #define TQ_RECORD_STIMULUS(TYPE, A, B, C, P, SIZE)  tq_record((TYPE), (uint8)(A), (uint8)(B), (uint8)(C), (P), (SIZE))
+#else
+  #define TQ_RECORD_STIMULUS(TYPE, A, B, C, P, SIZE)
+#endif
+
+#endif
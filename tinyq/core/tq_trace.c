@@ -0,0 +1,50 @@
+/****************************************************************************
+  tq_trace.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "tq_port.h"
+#include "tq_trace.h"
+
+#ifdef TQ_TRACE
+
+_PT_THREAD_LOCAL struct TQ_TRACE_BUFFER tq_trace_buffer;
+
+
+void tq_trace_reset(void)
+{
+  uint32 irq = tq_port_irq_save();
+
+  memset(&tq_trace_buffer, 0, sizeof(tq_trace_buffer));
+  tq_trace_buffer.magic = TQ_TRACE_MAGIC;
+  tq_trace_buffer.timestamp_freq = _PT_TIMESTAMP_FREQ;
+  tq_trace_buffer.size = TQ_TRACE_SIZE;
+
+  tq_port_irq_restore(irq);
+}
+
+/* callable from interrupts and with the system lock held */
+void tq_trace(uint8 event, uint8 a, uint8 b, uint8 c)
+{
+  struct TQ_TRACE_RECORD *record;
+  uint32 irq = tq_port_irq_save();
+
+  record = &tq_trace_buffer.records[tq_trace_buffer.head & (TQ_TRACE_SIZE - 1)];
+  record->time = tq_port_timestamp();
+  record->event = event;
+  record->a = a;
+  record->b = b;
+  record->c = c;
+  tq_trace_buffer.head++;
+
+  tq_port_irq_restore(irq);
+}
+
+const struct TQ_TRACE_BUFFER *tq_trace_get_data(void)
+{
+  return &tq_trace_buffer;
+}
+
+#endif
@@ -0,0 +1,62 @@
+/****************************************************************************
+  tq_trace.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_TRACE_H
+#define TQ_TRACE_H
+
+/*
+  Binary event trace, built with TQ_TRACE defined. The newest TQ_TRACE_SIZE
+  records are kept, tools/tq_trace_json.c turns a dump of tq_trace_buffer
+  into Chrome trace / Perfetto JSON.
+*/
+
+#define TQ_TRACE_MAGIC                      (0x52545154)    /* "TQTR" */
+
+#ifndef TQ_TRACE_SIZE
+#define TQ_TRACE_SIZE                       (128)           /* power of 2 */
+#endif
+
+/* event                                                       a       b       c */
+#define TQ_TRACE_EVT_ENQUEUE                (0x01)          /* from    to      sig */
+#define TQ_TRACE_EVT_DISPATCH_BEGIN         (0x02)          /* qti     sig     from */
+#define TQ_TRACE_EVT_DISPATCH_END           (0x03)          /* qti     sig     - */
+#define TQ_TRACE_EVT_TIMER_START            (0x04)          /* qti     id lo   id hi */
+#define TQ_TRACE_EVT_TIMER_STOP             (0x05)          /* qti     id lo   id hi */
+#define TQ_TRACE_EVT_TIMER_EXPIRE           (0x06)          /* qti     id lo   id hi */
+#define TQ_TRACE_EVT_SLEEP_ENTER            (0x07)          /* mode    waits   - */
+#define TQ_TRACE_EVT_SLEEP_EXIT             (0x08)          /* mode    -       - */
+#define TQ_TRACE_EVT_WAIT_REQUEST           (0x09)          /* qti     waits   - */
+#define TQ_TRACE_EVT_WAIT_RELEASE           (0x0a)          /* qti     waits   - */
+#define TQ_TRACE_EVT_EXTI                   (0x0b)          /* line    -       - */
+
+struct TQ_TRACE_RECORD
+{
+  uint32 time;
+  uint8  event;
+  uint8  a;
+  uint8  b;
+  uint8  c;
+};
+
+struct TQ_TRACE_BUFFER
+{
+  uint32 magic;
+  uint32 timestamp_freq;
+  uint16 size;
+  uint16 reserved;
+  uint32 head;
+  struct TQ_TRACE_RECORD records[TQ_TRACE_SIZE];
+};
+
+#ifdef TQ_TRACE
+  extern void tq_trace_reset(void);
+  extern void tq_trace(uint8 event, uint8 a, uint8 b, uint8 c);
+  extern const struct TQ_TRACE_BUFFER *tq_trace_get_data(void);
+
+  #define TQ_TRACE_EVENT(EVT, A, B, C)      tq_trace((EVT), (uint8)(A), (uint8)(B), (uint8)(C))
+#else
+  #define TQ_TRACE_EVENT(EVT, A, B, C)
+#endif
+
+#endif
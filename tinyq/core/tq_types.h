@@ -12,8 +12,13 @@ typedef signed char     int8;
 typedef unsigned char   uint8;
 typedef signed short    int16;
 typedef unsigned short  uint16;
+#if defined(__LP64__) || defined(_LP64)
+typedef signed int      int32;
+typedef unsigned int    uint32;
+#else
 typedef signed long     int32;
 typedef unsigned long   uint32;
+#endif
 typedef unsigned char   boolean;
 
 #endif
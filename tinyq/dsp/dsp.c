@@ -0,0 +1,66 @@
+/****************************************************************************
+  dsp.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "dsp.h"
+
+
+void dsp_run(struct DSP_STAGE *const stages[], uint8 stage_count, void *samples, uint16 count)
+{
+  uint8 i;
+
+  for(i = 0; i < stage_count; i++)
+    stages[i]->process(stages[i], samples, count);
+}
+
+/* offset is the code of zero, a 12 bit ADC at mid scale takes offset 0x800 and 12 bits */
+void dsp_adc_to_q15(const uint16 *adc, q15 *samples, uint16 count, uint16 offset, uint8 bits)
+{
+  uint8 shift = 16 - bits;
+  uint16 i;
+
+  for(i = 0; i < count; i++)
+    samples[i] = (q15)((int32)(adc[i] - offset) << shift);
+}
+
+/* bit by bit, floor of the root */
+uint16 dsp_sqrt32(uint32 x)
+{
+  uint32 root = 0, bit = 1UL << 30;
+
+  while(bit > x)
+    bit >>= 2;
+  while(bit)
+  {
+    if(x >= root + bit)
+    {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+  return (uint16)root;
+}
+
+uint32 dsp_sqrt64(unsigned long long x)
+{
+  unsigned long long root = 0, bit = 1ULL << 62;
+
+  while(bit > x)
+    bit >>= 2;
+  while(bit)
+  {
+    if(x >= root + bit)
+    {
+      x -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+      root >>= 1;
+    bit >>= 2;
+  }
+  return (uint32)root;
+}
@@ -0,0 +1,51 @@
+/****************************************************************************
+  dsp.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef DSP_H
+#define DSP_H
+
+/*
+  Fixed point pipeline stages working on a block of samples in place. A
+  stage is a struct with a struct DSP_STAGE first, set up by its init
+  function, a Qti keeps an array of stages and runs a block through all of
+  them with dsp_run() in one handler. Filters change the samples, measures
+  leave them as they are and keep their result in the stage until the
+  next block. Stages of a pipeline share one format, q15 or q31.
+
+  Kernels are plain C without a divide on a sample. q15 multiplies in 32
+  bits, q31 needs 64 bit products, several times the cost on the M0. Loops
+  are laid out for the auto-vectoriser of a host compiler, build host
+  ports with -O3 -march=native to get SIMD.
+*/
+
+#ifndef DSP_BLOCK_MAX
+#define DSP_BLOCK_MAX                       (128)           /* samples a FIR takes in one go, longer blocks are split */
+#endif
+
+#define Q15_MAX                             (32767)
+#define Q15_MIN                             (-32768)
+#define Q31_MAX                             (2147483647L)
+#define Q31_MIN                             (-2147483647L - 1)
+
+typedef int16 q15;
+typedef int32 q31;
+
+struct DSP_STAGE;
+typedef void (*DSP_PROCESS)(struct DSP_STAGE *stage, void *samples, uint16 count);
+
+struct DSP_STAGE
+{
+  DSP_PROCESS process;
+};
+
+extern void   dsp_run(struct DSP_STAGE *const stages[], uint8 stage_count, void *samples, uint16 count);
+extern void   dsp_adc_to_q15(const uint16 *adc, q15 *samples, uint16 count, uint16 offset, uint8 bits);
+extern uint16 dsp_sqrt32(uint32 x);
+extern uint32 dsp_sqrt64(unsigned long long x);
+
+/* X is evaluated more than once */
+#define DSP_SAT_Q15(X)                      ((q15)(((X) > Q15_MAX) ? Q15_MAX : ((X) < Q15_MIN) ? Q15_MIN : (X)))
+#define DSP_SAT_Q31(X)                      ((q31)(((X) > Q31_MAX) ? Q31_MAX : ((X) < Q31_MIN) ? Q31_MIN : (X)))
+
+#endif
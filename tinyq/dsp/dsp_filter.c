@@ -0,0 +1,270 @@
+/****************************************************************************
+  dsp_filter.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "dsp.h"
+#include "dsp_filter.h"
+
+static void fir_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void fir_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void biquad_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void biquad_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void average_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void average_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+
+
+void dsp_fir_q15_init(struct DSP_FIR_Q15 *fir, const q15 *coeffs, uint16 taps, q15 *state)
+{
+  TQ_ASSERT(taps > 0);
+
+  fir->stage.process = fir_q15_process;
+  fir->coeffs = coeffs;
+  fir->state = state;
+  fir->taps = taps;
+  memset(state, 0, DSP_FIR_STATE_SIZE(taps) * sizeof(q15));
+}
+
+void dsp_fir_q31_init(struct DSP_FIR_Q31 *fir, const q31 *coeffs, uint16 taps, q31 *state)
+{
+  TQ_ASSERT(taps > 0);
+
+  fir->stage.process = fir_q31_process;
+  fir->coeffs = coeffs;
+  fir->state = state;
+  fir->taps = taps;
+  memset(state, 0, DSP_FIR_STATE_SIZE(taps) * sizeof(q31));
+}
+
+void dsp_biquad_q15_init(struct DSP_BIQUAD_Q15 *biquad, const q15 *coeffs, uint8 sections, uint8 post_shift, q15 *state)
+{
+  TQ_ASSERT(sections > 0 && post_shift < 15);
+
+  biquad->stage.process = biquad_q15_process;
+  biquad->coeffs = coeffs;
+  biquad->state = state;
+  biquad->sections = sections;
+  biquad->post_shift = post_shift;
+  memset(state, 0, DSP_BIQUAD_STATE_SIZE(sections) * sizeof(q15));
+}
+
+void dsp_biquad_q31_init(struct DSP_BIQUAD_Q31 *biquad, const q31 *coeffs, uint8 sections, uint8 post_shift, q31 *state)
+{
+  TQ_ASSERT(sections > 0 && post_shift < 31);
+
+  biquad->stage.process = biquad_q31_process;
+  biquad->coeffs = coeffs;
+  biquad->state = state;
+  biquad->sections = sections;
+  biquad->post_shift = post_shift;
+  memset(state, 0, DSP_BIQUAD_STATE_SIZE(sections) * sizeof(q31));
+}
+
+void dsp_average_q15_init(struct DSP_AVERAGE_Q15 *average, uint8 shift, q15 *history)
+{
+  TQ_ASSERT(shift <= 15);
+
+  average->stage.process = average_q15_process;
+  average->history = history;
+  average->sum = 0;
+  average->index = 0;
+  average->shift = shift;
+  memset(history, 0, (1 << shift) * sizeof(q15));
+}
+
+void dsp_average_q31_init(struct DSP_AVERAGE_Q31 *average, uint8 shift, q31 *history)
+{
+  TQ_ASSERT(shift <= 15);
+
+  average->stage.process = average_q31_process;
+  average->history = history;
+  average->sum = 0;
+  average->index = 0;
+  average->shift = shift;
+  memset(history, 0, (1 << shift) * sizeof(q31));
+}
+
+/*
+  The block goes behind the last taps - 1 samples in the state, every
+  output is then a dot product of the coefficients with a run of the
+  state, the inner loop the vectoriser turns into multiply-adds.
+*/
+static void fir_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_FIR_Q15 *fir = (struct DSP_FIR_Q15*)stage;
+  const q15 *coeffs = fir->coeffs;
+  q15 *x = (q15*)samples;
+  q15 *state = fir->state;
+  uint16 taps = fir->taps, n, i, j;
+  const q15 *run;
+  int32 acc;
+
+  while(count)
+  {
+    n = (count > DSP_BLOCK_MAX) ? DSP_BLOCK_MAX : count;
+    memcpy(state + taps - 1, x, n * sizeof(q15));
+
+    for(i = 0; i < n; i++)
+    {
+      run = state + i;
+      acc = 1 << 14;
+      for(j = 0; j < taps; j++)
+        acc += (int32)coeffs[j] * run[j];
+      acc >>= 15;
+      x[i] = DSP_SAT_Q15(acc);
+    }
+
+    memmove(state, state + n, (taps - 1) * sizeof(q15));
+    x += n;
+    count -= n;
+  }
+}
+
+static void fir_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_FIR_Q31 *fir = (struct DSP_FIR_Q31*)stage;
+  const q31 *coeffs = fir->coeffs;
+  q31 *x = (q31*)samples;
+  q31 *state = fir->state;
+  uint16 taps = fir->taps, n, i, j;
+  const q31 *run;
+  long long acc;
+
+  while(count)
+  {
+    n = (count > DSP_BLOCK_MAX) ? DSP_BLOCK_MAX : count;
+    memcpy(state + taps - 1, x, n * sizeof(q31));
+
+    for(i = 0; i < n; i++)
+    {
+      run = state + i;
+      acc = 1LL << 30;
+      for(j = 0; j < taps; j++)
+        acc += (long long)coeffs[j] * run[j];
+      acc >>= 31;
+      x[i] = DSP_SAT_Q31(acc);
+    }
+
+    memmove(state, state + n, (taps - 1) * sizeof(q31));
+    x += n;
+    count -= n;
+  }
+}
+
+/* a section over the whole block, then the next */
+static void biquad_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_BIQUAD_Q15 *biquad = (struct DSP_BIQUAD_Q15*)stage;
+  const q15 *c = biquad->coeffs;
+  q15 *state = biquad->state;
+  q15 *x = (q15*)samples;
+  uint8 shift = 15 - biquad->post_shift, s;
+  int32 x1, x2, y1, y2, x0, y0;
+  long long acc;
+  uint16 i;
+
+  for(s = 0; s < biquad->sections; s++, c += 5, state += 4)
+  {
+    x1 = state[0];
+    x2 = state[1];
+    y1 = state[2];
+    y2 = state[3];
+    for(i = 0; i < count; i++)
+    {
+      x0 = x[i];
+      acc = (int32)c[0] * x0;
+      acc += (int32)c[1] * x1;
+      acc += (int32)c[2] * x2;
+      acc += (int32)c[3] * y1;
+      acc += (int32)c[4] * y2;
+      acc >>= shift;
+      y0 = DSP_SAT_Q15(acc);
+      x[i] = (q15)y0;
+      x2 = x1;
+      x1 = x0;
+      y2 = y1;
+      y1 = y0;
+    }
+    state[0] = (q15)x1;
+    state[1] = (q15)x2;
+    state[2] = (q15)y1;
+    state[3] = (q15)y2;
+  }
+}
+
+static void biquad_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_BIQUAD_Q31 *biquad = (struct DSP_BIQUAD_Q31*)stage;
+  const q31 *c = biquad->coeffs;
+  q31 *state = biquad->state;
+  q31 *x = (q31*)samples;
+  uint8 shift = 31 - biquad->post_shift, s;
+  q31 x1, x2, y1, y2, x0, y0;
+  long long acc;
+  uint16 i;
+
+  for(s = 0; s < biquad->sections; s++, c += 5, state += 4)
+  {
+    x1 = state[0];
+    x2 = state[1];
+    y1 = state[2];
+    y2 = state[3];
+    for(i = 0; i < count; i++)
+    {
+      x0 = x[i];
+      acc = (long long)c[0] * x0 + (long long)c[1] * x1 + (long long)c[2] * x2 + (long long)c[3] * y1 + (long long)c[4] * y2;
+      acc >>= shift;
+      y0 = DSP_SAT_Q31(acc);
+      x[i] = y0;
+      x2 = x1;
+      x1 = x0;
+      y2 = y1;
+      y1 = y0;
+    }
+    state[0] = x1;
+    state[1] = x2;
+    state[2] = y1;
+    state[3] = y2;
+  }
+}
+
+/* running sum, the sample leaving the window comes off it */
+static void average_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_AVERAGE_Q15 *average = (struct DSP_AVERAGE_Q15*)stage;
+  q15 *history = average->history;
+  q15 *x = (q15*)samples;
+  uint16 mask = (uint16)((1 << average->shift) - 1), index = average->index, i;
+  int32 sum = average->sum;
+
+  for(i = 0; i < count; i++)
+  {
+    sum += x[i] - history[index];
+    history[index] = x[i];
+    index = (index + 1) & mask;
+    x[i] = (q15)(sum >> average->shift);
+  }
+  average->sum = sum;
+  average->index = index;
+}
+
+static void average_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_AVERAGE_Q31 *average = (struct DSP_AVERAGE_Q31*)stage;
+  q31 *history = average->history;
+  q31 *x = (q31*)samples;
+  uint16 mask = (uint16)((1 << average->shift) - 1), index = average->index, i;
+  long long sum = average->sum;
+
+  for(i = 0; i < count; i++)
+  {
+    sum += (long long)x[i] - history[index];
+    history[index] = x[i];
+    index = (index + 1) & mask;
+    x[i] = (q31)(sum >> average->shift);
+  }
+  average->sum = sum;
+  average->index = index;
+}
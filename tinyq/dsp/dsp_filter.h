@@ -0,0 +1,85 @@
+/****************************************************************************
+  dsp_filter.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef DSP_FILTER_H
+#define DSP_FILTER_H
+
+/*
+  Filter stages, the caller owns coefficients and state and keeps them
+  for the life of the stage.
+
+  FIR: coefficients in time reversed order, coeffs[0] takes the oldest
+  sample. The q15 FIR adds up in 32 bits, the magnitudes of its
+  coefficients have to add up to less than 2, any low pass does.
+
+  Biquad: direct form I cascade, per section b0 b1 b2 a1 a2 with the sign
+  of a1 a2 flipped, y = b0 x0 + b1 x1 + b2 x2 + a1 y1 + a2 y2. Coefficients
+  are scaled down by 2^post_shift to fit the format.
+
+  Average: moving average over 2^shift samples.
+*/
+
+#define DSP_FIR_STATE_SIZE(TAPS)            ((TAPS) - 1 + DSP_BLOCK_MAX)
+#define DSP_BIQUAD_STATE_SIZE(SECTIONS)     ((SECTIONS) * 4)
+
+struct DSP_FIR_Q15
+{
+  struct DSP_STAGE stage;
+  const q15 *coeffs;
+  q15 *state;                               /* DSP_FIR_STATE_SIZE(taps) */
+  uint16 taps;
+};
+
+struct DSP_FIR_Q31
+{
+  struct DSP_STAGE stage;
+  const q31 *coeffs;
+  q31 *state;
+  uint16 taps;
+};
+
+struct DSP_BIQUAD_Q15
+{
+  struct DSP_STAGE stage;
+  const q15 *coeffs;                        /* 5 per section */
+  q15 *state;                               /* DSP_BIQUAD_STATE_SIZE(sections), x1 x2 y1 y2 */
+  uint8 sections;
+  uint8 post_shift;
+};
+
+struct DSP_BIQUAD_Q31
+{
+  struct DSP_STAGE stage;
+  const q31 *coeffs;
+  q31 *state;
+  uint8 sections;
+  uint8 post_shift;
+};
+
+struct DSP_AVERAGE_Q15
+{
+  struct DSP_STAGE stage;
+  q15 *history;                             /* 2^shift */
+  int32 sum;
+  uint16 index;
+  uint8 shift;
+};
+
+struct DSP_AVERAGE_Q31
+{
+  struct DSP_STAGE stage;
+  q31 *history;
+  long long sum;
+  uint16 index;
+  uint8 shift;
+};
+
+extern void dsp_fir_q15_init(struct DSP_FIR_Q15 *fir, const q15 *coeffs, uint16 taps, q15 *state);
+extern void dsp_fir_q31_init(struct DSP_FIR_Q31 *fir, const q31 *coeffs, uint16 taps, q31 *state);
+extern void dsp_biquad_q15_init(struct DSP_BIQUAD_Q15 *biquad, const q15 *coeffs, uint8 sections, uint8 post_shift, q15 *state);
+extern void dsp_biquad_q31_init(struct DSP_BIQUAD_Q31 *biquad, const q31 *coeffs, uint8 sections, uint8 post_shift, q31 *state);
+extern void dsp_average_q15_init(struct DSP_AVERAGE_Q15 *average, uint8 shift, q15 *history);
+extern void dsp_average_q31_init(struct DSP_AVERAGE_Q31 *average, uint8 shift, q31 *history);
+
+#endif
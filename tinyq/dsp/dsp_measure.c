@@ -0,0 +1,204 @@
+/****************************************************************************
+  dsp_measure.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "dsp.h"
+#include "dsp_measure.h"
+
+static void rms_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void rms_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void minmax_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void minmax_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void threshold_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+static void threshold_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count);
+
+
+void dsp_rms_q15_init(struct DSP_RMS_Q15 *rms)
+{
+  rms->stage.process = rms_q15_process;
+  rms->rms = 0;
+}
+
+void dsp_rms_q31_init(struct DSP_RMS_Q31 *rms)
+{
+  rms->stage.process = rms_q31_process;
+  rms->rms = 0;
+}
+
+void dsp_minmax_q15_init(struct DSP_MINMAX_Q15 *minmax)
+{
+  minmax->stage.process = minmax_q15_process;
+  minmax->min = minmax->max = 0;
+  minmax->min_index = minmax->max_index = DSP_INDEX_NONE;
+}
+
+void dsp_minmax_q31_init(struct DSP_MINMAX_Q31 *minmax)
+{
+  minmax->stage.process = minmax_q31_process;
+  minmax->min = minmax->max = 0;
+  minmax->min_index = minmax->max_index = DSP_INDEX_NONE;
+}
+
+void dsp_threshold_q15_init(struct DSP_THRESHOLD_Q15 *threshold, q15 high, q15 low)
+{
+  TQ_ASSERT(low <= high);
+
+  threshold->stage.process = threshold_q15_process;
+  threshold->high = high;
+  threshold->low = low;
+  threshold->above = FALSE;
+  threshold->rising = threshold->falling = 0;
+  threshold->first = DSP_INDEX_NONE;
+}
+
+void dsp_threshold_q31_init(struct DSP_THRESHOLD_Q31 *threshold, q31 high, q31 low)
+{
+  TQ_ASSERT(low <= high);
+
+  threshold->stage.process = threshold_q31_process;
+  threshold->high = high;
+  threshold->low = low;
+  threshold->above = FALSE;
+  threshold->rising = threshold->falling = 0;
+  threshold->first = DSP_INDEX_NONE;
+}
+
+/* the one divide is per block */
+static void rms_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  const q15 *x = (const q15*)samples;
+  unsigned long long sum = 0;
+  int32 root;
+  uint16 i;
+
+  if(!count)
+    return;
+
+  for(i = 0; i < count; i++)
+    sum += (uint32)((int32)x[i] * x[i]);
+
+  root = dsp_sqrt32((uint32)(sum / count));
+  ((struct DSP_RMS_Q15*)stage)->rms = DSP_SAT_Q15(root);
+}
+
+/* squares in q31 keep the sum in 64 bits */
+static void rms_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  const q31 *x = (const q31*)samples;
+  unsigned long long sum = 0;
+  uint32 root;
+  uint16 i;
+
+  if(!count)
+    return;
+
+  for(i = 0; i < count; i++)
+    sum += (unsigned long long)((long long)x[i] * x[i]) >> 31;
+
+  root = dsp_sqrt64((sum / count) << 31);
+  ((struct DSP_RMS_Q31*)stage)->rms = (q31)((root > Q31_MAX) ? Q31_MAX : root);
+}
+
+static void minmax_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_MINMAX_Q15 *minmax = (struct DSP_MINMAX_Q15*)stage;
+  const q15 *x = (const q15*)samples;
+  q15 min = Q15_MAX, max = Q15_MIN;
+  uint16 min_index = DSP_INDEX_NONE, max_index = DSP_INDEX_NONE, i;
+
+  for(i = 0; i < count; i++)
+  {
+    if(x[i] < min || min_index == DSP_INDEX_NONE)
+    {
+      min = x[i];
+      min_index = i;
+    }
+    if(x[i] > max || max_index == DSP_INDEX_NONE)
+    {
+      max = x[i];
+      max_index = i;
+    }
+  }
+  minmax->min = min;
+  minmax->max = max;
+  minmax->min_index = min_index;
+  minmax->max_index = max_index;
+}
+
+static void minmax_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_MINMAX_Q31 *minmax = (struct DSP_MINMAX_Q31*)stage;
+  const q31 *x = (const q31*)samples;
+  q31 min = Q31_MAX, max = Q31_MIN;
+  uint16 min_index = DSP_INDEX_NONE, max_index = DSP_INDEX_NONE, i;
+
+  for(i = 0; i < count; i++)
+  {
+    if(x[i] < min || min_index == DSP_INDEX_NONE)
+    {
+      min = x[i];
+      min_index = i;
+    }
+    if(x[i] > max || max_index == DSP_INDEX_NONE)
+    {
+      max = x[i];
+      max_index = i;
+    }
+  }
+  minmax->min = min;
+  minmax->max = max;
+  minmax->min_index = min_index;
+  minmax->max_index = max_index;
+}
+
+static void threshold_q15_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_THRESHOLD_Q15 *threshold = (struct DSP_THRESHOLD_Q15*)stage;
+  const q15 *x = (const q15*)samples;
+  boolean above = threshold->above;
+  uint16 i;
+
+  threshold->rising = threshold->falling = 0;
+  threshold->first = DSP_INDEX_NONE;
+  for(i = 0; i < count; i++)
+  {
+    if(above ? (x[i] >= threshold->low) : (x[i] < threshold->high))
+      continue;
+
+    above = !above;
+    if(above)
+      threshold->rising++;
+    else
+      threshold->falling++;
+    if(threshold->first == DSP_INDEX_NONE)
+      threshold->first = i;
+  }
+  threshold->above = above;
+}
+
+static void threshold_q31_process(struct DSP_STAGE *stage, void *samples, uint16 count)
+{
+  struct DSP_THRESHOLD_Q31 *threshold = (struct DSP_THRESHOLD_Q31*)stage;
+  const q31 *x = (const q31*)samples;
+  boolean above = threshold->above;
+  uint16 i;
+
+  threshold->rising = threshold->falling = 0;
+  threshold->first = DSP_INDEX_NONE;
+  for(i = 0; i < count; i++)
+  {
+    if(above ? (x[i] >= threshold->low) : (x[i] < threshold->high))
+      continue;
+
+    above = !above;
+    if(above)
+      threshold->rising++;
+    else
+      threshold->falling++;
+    if(threshold->first == DSP_INDEX_NONE)
+      threshold->first = i;
+  }
+  threshold->above = above;
+}
@@ -0,0 +1,77 @@
+/****************************************************************************
+  dsp_measure.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef DSP_MEASURE_H
+#define DSP_MEASURE_H
+
+/*
+  Measure stages, the samples pass unchanged and the result of the last
+  block stays in the stage. Indexes are within the block.
+
+  Threshold: the signal goes above at high and back below at low, a
+  crossing is counted once per hysteresis band.
+*/
+
+#define DSP_INDEX_NONE                      (0xffff)
+
+struct DSP_RMS_Q15
+{
+  struct DSP_STAGE stage;
+  q15 rms;
+};
+
+struct DSP_RMS_Q31
+{
+  struct DSP_STAGE stage;
+  q31 rms;
+};
+
+struct DSP_MINMAX_Q15
+{
+  struct DSP_STAGE stage;
+  q15 min;
+  q15 max;
+  uint16 min_index;
+  uint16 max_index;
+};
+
+struct DSP_MINMAX_Q31
+{
+  struct DSP_STAGE stage;
+  q31 min;
+  q31 max;
+  uint16 min_index;
+  uint16 max_index;
+};
+
+struct DSP_THRESHOLD_Q15
+{
+  struct DSP_STAGE stage;
+  q15 high;
+  q15 low;
+  boolean above;                            /* at the end of the block */
+  uint16 rising;                            /* crossings in the block */
+  uint16 falling;
+  uint16 first;                             /* of the first crossing, DSP_INDEX_NONE without */
+};
+
+struct DSP_THRESHOLD_Q31
+{
+  struct DSP_STAGE stage;
+  q31 high;
+  q31 low;
+  boolean above;
+  uint16 rising;
+  uint16 falling;
+  uint16 first;
+};
+
+extern void dsp_rms_q15_init(struct DSP_RMS_Q15 *rms);
+extern void dsp_rms_q31_init(struct DSP_RMS_Q31 *rms);
+extern void dsp_minmax_q15_init(struct DSP_MINMAX_Q15 *minmax);
+extern void dsp_minmax_q31_init(struct DSP_MINMAX_Q31 *minmax);
+extern void dsp_threshold_q15_init(struct DSP_THRESHOLD_Q15 *threshold, q15 high, q15 low);
+extern void dsp_threshold_q31_init(struct DSP_THRESHOLD_Q31 *threshold, q31 high, q31 low);
+
+#endif
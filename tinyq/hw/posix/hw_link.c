@@ -0,0 +1,64 @@
+/****************************************************************************
+  hw_link.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <errno.h>
+#include <unistd.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "tq_fd.h"
+#include "hw_link.h"
+#include "qti_bridge.h"
+
+static int32 _rx_fd = -1;
+static int32 _tx_fd = -1;
+
+
+void hw_link_set_fds(int32 rx_fd, int32 tx_fd)
+{
+  _rx_fd = rx_fd;
+  _tx_fd = tx_fd;
+}
+
+/* edge triggered, the bridge reads and writes until the fds take no more */
+boolean bridge_link_open(uint8 qti)
+{
+  if(_rx_fd < 0 || _tx_fd < 0)
+    return FALSE;
+
+  if(_rx_fd == _tx_fd)
+    return tq_fd_add(_rx_fd, TQ_FD_IN | TQ_FD_OUT, qti, BRIDGE_NTF_LINK);
+
+  if(!tq_fd_add(_rx_fd, TQ_FD_IN, qti, BRIDGE_NTF_LINK))
+    return FALSE;
+  if(!tq_fd_add(_tx_fd, TQ_FD_OUT, qti, BRIDGE_NTF_LINK))
+  {
+    tq_fd_remove(_rx_fd);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* EAGAIN and a closed peer both read nothing */
+uint16 bridge_link_read(uint8 *data, uint16 size)
+{
+  ssize_t n;
+
+  do
+  {
+    n = read(_rx_fd, data, size);
+  } while(n < 0 && errno == EINTR);
+  return (n > 0) ? (uint16)n : 0;
+}
+
+uint16 bridge_link_write(const uint8 *data, uint16 size)
+{
+  ssize_t n;
+
+  do
+  {
+    n = write(_tx_fd, data, size);
+  } while(n < 0 && errno == EINTR);
+  return (n > 0) ? (uint16)n : 0;
+}
@@ -0,0 +1,16 @@
+/****************************************************************************
+  hw_link.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_LINK_H
+#define HW_LINK_H
+
+/*
+  The link of qti_bridge on the POSIX port, a byte stream over non blocking
+  fds: one socket for both ways, or the two ends of a pair of pipes. The
+  fds are set before tinyq_run(), readiness comes through tq_fd.h.
+*/
+
+extern void hw_link_set_fds(int32 rx_fd, int32 tx_fd);
+
+#endif
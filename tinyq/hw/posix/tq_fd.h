@@ -0,0 +1,40 @@
+/****************************************************************************
+  tq_fd.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_FD_H
+#define TQ_FD_H
+
+/*
+  File descriptors as signal sources of the POSIX port. The loop sleeps in
+  epoll_wait() on the sleep timer's timerfd and every registered fd, a fd
+  getting ready is an interrupt that sends its Qti the registered signal
+  from QTI_SYSTEM with a struct TQ_FD_EVENT. No thread and no polling.
+
+  Readiness is edge triggered, a signal comes when a fd becomes ready.
+  The Qti reads or writes until EAGAIN, or calls tq_fd_modify() for another
+  signal about what is still pending. Fds are collected when the loop goes
+  to sleep, at most TQ_FD_EVENTS per wakeup, the signal queue has to hold
+  that many. A signal queued before tq_fd_remove() still arrives.
+*/
+
+#define TQ_FD_IN                            (0x001)         /* the EPOLLxxx values */
+#define TQ_FD_OUT                           (0x004)
+#define TQ_FD_ERR                           (0x008)
+#define TQ_FD_HUP                           (0x010)
+
+#ifndef TQ_FD_EVENTS
+#define TQ_FD_EVENTS                        (32)
+#endif
+
+struct TQ_FD_EVENT
+{
+  int32  fd;
+  uint32 events;                            /* TQ_FD_xxx */
+};
+
+extern boolean tq_fd_add(int32 fd, uint32 events, uint8 qti, uint8 sig);
+extern boolean tq_fd_modify(int32 fd, uint32 events, uint8 qti, uint8 sig);
+extern void    tq_fd_remove(int32 fd);
+
+#endif
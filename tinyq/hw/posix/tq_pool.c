@@ -0,0 +1,419 @@
+/****************************************************************************
+  tq_pool.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "ring_buffer.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "tq_context.h"
+#include "tq_pool.h"
+
+/*
+  A Qti is IDLE, READY with an entry on a ready queue or RUNNING on a worker,
+  the state only changes under its mailbox lock. Its queued bits tell which
+  ready queues hold an entry of it, so a queue never holds more than
+  tq_qti_count entries. An entry left behind by a priority raise is stale,
+  whoever takes it finds the Qti not READY and drops it. A signal finding
+  the mailbox full is dropped and counted against the Qti, a sender never
+  blocks on a Qti that may be blocked on it in turn.
+*/
+
+#define POOL_HIGH                           (0)
+#define POOL_NORMAL                         (1)
+#define POOL_PRIORITIES                     (2)
+
+#define POOL_IDLE                           (0)
+#define POOL_READY                          (1)
+#define POOL_RUNNING                        (2)
+
+#define POOL_SPIN                           (64)            /* ready checks before parking */
+#define POOL_CACHE_LINE                     (64)
+
+struct POOL_QTI
+{
+  pthread_mutex_t lock;
+  uint8  state;
+  uint8  queued;                            /* 1 << priority */
+  uint32 dropped;                           /* signals that found the mailbox full */
+  struct RING_BUFFER mailbox[POOL_PRIORITIES];
+  uint8  buffer[POOL_PRIORITIES][TQ_POOL_MAILBOX_SIZE];
+} __attribute__((aligned(POOL_CACHE_LINE)));
+
+struct POOL_QUEUE
+{
+  pthread_mutex_t lock;
+  uint8  front;
+  uint16 count;
+  uint8  qti[256];
+};
+
+struct POOL_WORKER
+{
+  pthread_t thread;
+  uint8  index;
+  uint32 victim;
+  struct POOL_QUEUE ready[POOL_PRIORITIES];
+  struct TQ_POOL_STATS stats;
+} __attribute__((aligned(POOL_CACHE_LINE)));
+
+struct TQ_WORKER_POOL
+{
+  struct TQ_CONTEXT *context;
+  struct POOL_QTI *qties;
+  struct POOL_WORKER workers[TQ_POOL_WORKERS_MAX];
+  uint8  worker_count;
+  uint32 inject;                            /* next worker for posts from off the pool */
+
+  uint32 ready;                             /* entries on all ready queues */
+  uint32 parked;
+  pthread_mutex_t park_lock;
+  pthread_cond_t  park_cond;
+};
+
+static void *worker_main(void *arg);
+static boolean take_ready(struct POOL_WORKER *worker, uint8 *qti, uint8 *priority);
+static void run_qti(struct POOL_WORKER *worker, uint8 qti, uint8 priority);
+static boolean post_qti(struct POOL_QTI *q, uint8 priority, const uint8 *header, const void *param);
+static void push_ready(struct TQ_WORKER_POOL *pool, uint8 qti, uint8 priority);
+static void park(struct POOL_WORKER *worker);
+
+extern const uint8 tq_qti_count;
+extern const struct TQ_QTI tq_qti_table[];
+
+static struct TQ_WORKER_POOL _pool;
+static __thread struct POOL_WORKER *_worker;
+
+
+void tinyq_run_pool(uint8 workers)
+{
+  struct TQ_WORKER_POOL *pool = &_pool;
+  uint8 i, p;
+
+  TQ_ASSERT(workers > 0 && workers <= TQ_POOL_WORKERS_MAX);
+
+  tinyq_context_init(&tq_default_context, tq_qti_table, tq_qti_count);
+  pool->context = &tq_default_context;
+  pool->qties = calloc(tq_qti_count, sizeof(struct POOL_QTI));
+  TQ_ASSERT(pool->qties);
+  for(i = 0; i < tq_qti_count; i++)
+  {
+    pthread_mutex_init(&pool->qties[i].lock, 0);
+    for(p = 0; p < POOL_PRIORITIES; p++)
+      ring_buffer_init(&pool->qties[i].mailbox[p], pool->qties[i].buffer[p], TQ_POOL_MAILBOX_SIZE);
+  }
+
+  pthread_mutex_init(&pool->park_lock, 0);
+  pthread_cond_init(&pool->park_cond, 0);
+  pool->worker_count = workers;
+  for(i = 0; i < workers; i++)
+  {
+    pool->workers[i].index = i;
+    pool->workers[i].victim = i + 1;
+    for(p = 0; p < POOL_PRIORITIES; p++)
+      pthread_mutex_init(&pool->workers[i].ready[p].lock, 0);
+  }
+
+  /* the pool runs on the workers it got, nothing is posted before the broadcast */
+  for(i = 0; i < workers; i++)
+  {
+    if(pthread_create(&pool->workers[i].thread, 0, worker_main, &pool->workers[i]))
+      break;
+  }
+  if(!i)
+  {
+    fprintf(stderr, "tq_pool: no worker thread\n");
+    exit(EXIT_FAILURE);
+  }
+  if(i < workers)
+    fprintf(stderr, "tq_pool: %u of %u worker threads\n", i, workers);
+  pool->worker_count = i;
+
+  /* the workers park until qti_system_start() broadcasts */
+  tq_default_context.pool = pool;
+  tinyq_run_context(&tq_default_context);
+}
+
+uint8 tq_pool_worker(void)
+{
+  return _worker ? _worker->index : TQ_POOL_WORKER_NONE;
+}
+
+uint8 tq_pool_worker_count(void)
+{
+  return _pool.worker_count;
+}
+
+uint32 tq_pool_dropped(uint8 qti)
+{
+  struct POOL_QTI *q = &_pool.qties[qti];
+  uint32 dropped;
+
+  TQ_ASSERT(qti < _pool.context->qti_count);
+  pthread_mutex_lock(&q->lock);
+  dropped = q->dropped;
+  pthread_mutex_unlock(&q->lock);
+  return dropped;
+}
+
+void tq_pool_get_stats(uint8 worker, struct TQ_POOL_STATS *stats)
+{
+  const struct TQ_POOL_STATS *source = &_pool.workers[worker].stats;
+
+  TQ_ASSERT(worker < _pool.worker_count);
+  stats->signals = __atomic_load_n(&source->signals, __ATOMIC_RELAXED);
+  stats->runs = __atomic_load_n(&source->runs, __ATOMIC_RELAXED);
+  stats->steals = __atomic_load_n(&source->steals, __ATOMIC_RELAXED);
+  stats->parks = __atomic_load_n(&source->parks, __ATOMIC_RELAXED);
+}
+
+/* from tinyq_send_signal(), a broadcast is in every mailbox before any Qti can run it */
+void _tq_pool_post(struct TQ_WORKER_POOL *pool, const uint8 *header, const void *param)
+{
+  uint8 schedule[256];
+  uint8 to = header[1];
+  uint8 priority = (TQ_SIG_DISPATCHER(header[2]) == TQ_DSP_HIGH) ? POOL_HIGH : POOL_NORMAL;
+
+  if(to == QTI_BROADCAST)
+  {
+    for(to = 0; to < pool->context->qti_count; to++)
+      pthread_mutex_lock(&pool->qties[to].lock);
+    for(to = 0; to < pool->context->qti_count; to++)
+      schedule[to] = post_qti(&pool->qties[to], priority, header, param);
+    for(to = 0; to < pool->context->qti_count; to++)
+      pthread_mutex_unlock(&pool->qties[to].lock);
+    for(to = 0; to < pool->context->qti_count; to++)
+    {
+      if(schedule[to])
+        push_ready(pool, to, priority);
+    }
+  }
+  else if(to < pool->context->qti_count)
+  {
+    pthread_mutex_lock(&pool->qties[to].lock);
+    schedule[0] = post_qti(&pool->qties[to], priority, header, param);
+    pthread_mutex_unlock(&pool->qties[to].lock);
+    if(schedule[0])
+      push_ready(pool, to, priority);
+  }
+}
+
+/* under the mailbox lock, TRUE when the Qti needs an entry on a ready queue */
+static boolean post_qti(struct POOL_QTI *q, uint8 priority, const uint8 *header, const void *param)
+{
+  if(ring_buffer_space(&q->mailbox[priority]) < TQ_SIGNAL_HEADER_SIZE + header[3])
+  {
+    q->dropped++;
+    return FALSE;
+  }
+
+  ring_buffer_push_back(&q->mailbox[priority], header, TQ_SIGNAL_HEADER_SIZE);
+  ring_buffer_push_back(&q->mailbox[priority], param, header[3]);
+
+  /* a READY Qti is raised to high priority by a second entry */
+  if(q->state == POOL_IDLE || (q->state == POOL_READY && priority == POOL_HIGH))
+  {
+    q->state = POOL_READY;
+    if(!(q->queued & (1 << priority)))
+    {
+      q->queued |= 1 << priority;
+      return TRUE;
+    }
+  }
+  return FALSE;
+}
+
+/* on the queue of the posting worker, posts from off the pool go round robin */
+static void push_ready(struct TQ_WORKER_POOL *pool, uint8 qti, uint8 priority)
+{
+  struct POOL_WORKER *worker = _worker;
+  struct POOL_QUEUE *queue;
+
+  if(!worker)
+    worker = &pool->workers[__atomic_fetch_add(&pool->inject, 1, __ATOMIC_RELAXED) % pool->worker_count];
+
+  queue = &worker->ready[priority];
+  pthread_mutex_lock(&queue->lock);
+  TQ_ASSERT(queue->count < sizeof(queue->qti));
+  queue->qti[(uint8)(queue->front + queue->count)] = qti;
+  queue->count++;
+  pthread_mutex_unlock(&queue->lock);
+
+  __atomic_fetch_add(&pool->ready, 1, __ATOMIC_SEQ_CST);
+  if(__atomic_load_n(&pool->parked, __ATOMIC_SEQ_CST))
+  {
+    pthread_mutex_lock(&pool->park_lock);
+    pthread_cond_signal(&pool->park_cond);
+    pthread_mutex_unlock(&pool->park_lock);
+  }
+}
+
+static void *worker_main(void *arg)
+{
+  struct POOL_WORKER *worker = (struct POOL_WORKER *)arg;
+  uint8 qti = 0, priority = 0;
+  uint16 spin = 0;
+
+  _worker = worker;
+  while(1)
+  {
+    if(take_ready(worker, &qti, &priority))
+    {
+      run_qti(worker, qti, priority);
+      spin = 0;
+    }
+    else if(++spin < POOL_SPIN)
+      sched_yield();
+    else
+    {
+      park(worker);
+      spin = 0;
+    }
+  }
+  return 0;
+}
+
+/* own queue first, then the others from a rotating victim, high priority over all workers first */
+static boolean take_ready(struct POOL_WORKER *worker, uint8 *qti, uint8 *priority)
+{
+  struct TQ_WORKER_POOL *pool = &_pool;
+  struct POOL_QUEUE *queue;
+  uint8 p, i, victim;
+
+  if(!__atomic_load_n(&pool->ready, __ATOMIC_SEQ_CST))
+    return FALSE;
+
+  for(p = 0; p < POOL_PRIORITIES; p++)
+  {
+    queue = &worker->ready[p];
+    pthread_mutex_lock(&queue->lock);
+    if(queue->count)
+    {
+      *qti = queue->qti[queue->front++];
+      queue->count--;
+      pthread_mutex_unlock(&queue->lock);
+      *priority = p;
+      break;
+    }
+    pthread_mutex_unlock(&queue->lock);
+
+    /* thieves take the newest entry, away from the owner's end */
+    for(i = 1; i < pool->worker_count; i++)
+    {
+      victim = (worker->victim + i) % pool->worker_count;
+      if(victim == worker->index)
+        continue;
+      queue = &pool->workers[victim].ready[p];
+      if(pthread_mutex_trylock(&queue->lock))
+        continue;
+      if(queue->count)
+      {
+        queue->count--;
+        *qti = queue->qti[(uint8)(queue->front + queue->count)];
+        pthread_mutex_unlock(&queue->lock);
+        worker->victim = victim;
+        __atomic_store_n(&worker->stats.steals, worker->stats.steals + 1, __ATOMIC_RELAXED);
+        *priority = p;
+        break;
+      }
+      pthread_mutex_unlock(&queue->lock);
+    }
+    if(i < pool->worker_count)
+      break;
+  }
+
+  if(p == POOL_PRIORITIES)
+    return FALSE;
+
+  __atomic_fetch_sub(&pool->ready, 1, __ATOMIC_SEQ_CST);
+  return TRUE;
+}
+
+static void run_qti(struct POOL_WORKER *worker, uint8 qti, uint8 priority)
+{
+  struct TQ_WORKER_POOL *pool = &_pool;
+  struct POOL_QTI *q = &pool->qties[qti];
+  struct RING_BUFFER *mailbox;
+  uint8 header[TQ_SIGNAL_HEADER_SIZE];
+  uint8 param[256];
+  uint16 count;
+  boolean schedule = FALSE;
+
+  pthread_mutex_lock(&q->lock);
+  q->queued &= ~(1 << priority);
+  if(q->state != POOL_READY)
+  {
+    pthread_mutex_unlock(&q->lock);
+    return;
+  }
+  q->state = POOL_RUNNING;
+  pthread_mutex_unlock(&q->lock);
+  __atomic_store_n(&worker->stats.runs, worker->stats.runs + 1, __ATOMIC_RELAXED);
+
+  for(count = 0; count < TQ_POOL_BATCH; count++)
+  {
+    pthread_mutex_lock(&q->lock);
+    mailbox = ring_buffer_size(&q->mailbox[POOL_HIGH]) ? &q->mailbox[POOL_HIGH] : &q->mailbox[POOL_NORMAL];
+    if(!ring_buffer_size(mailbox))
+    {
+      q->state = POOL_IDLE;
+      pthread_mutex_unlock(&q->lock);
+      return;
+    }
+    ring_buffer_pop_front(mailbox, header, TQ_SIGNAL_HEADER_SIZE);
+    if(header[3] != 0)
+      ring_buffer_pop_front(mailbox, param, header[3]);
+    pthread_mutex_unlock(&q->lock);
+
+    _tq_invoke_qti(pool->context->qti_table, qti, header, param);
+    __atomic_store_n(&worker->stats.signals, worker->stats.signals + 1, __ATOMIC_RELAXED);
+  }
+
+  /* batch used up, back to the queue behind the others */
+  pthread_mutex_lock(&q->lock);
+  if(ring_buffer_size(&q->mailbox[POOL_HIGH]))
+    priority = POOL_HIGH;
+  else if(ring_buffer_size(&q->mailbox[POOL_NORMAL]))
+    priority = POOL_NORMAL;
+  else
+    priority = POOL_PRIORITIES;
+
+  if(priority == POOL_PRIORITIES)
+    q->state = POOL_IDLE;
+  else
+  {
+    q->state = POOL_READY;
+    if(!(q->queued & (1 << priority)))
+    {
+      q->queued |= 1 << priority;
+      schedule = TRUE;
+    }
+  }
+  pthread_mutex_unlock(&q->lock);
+
+  if(schedule)
+    push_ready(pool, qti, priority);
+}
+
+/* parked counts before ready is checked, a push either sees the worker parked or the worker sees the push */
+static void park(struct POOL_WORKER *worker)
+{
+  struct TQ_WORKER_POOL *pool = &_pool;
+
+  pthread_mutex_lock(&pool->park_lock);
+  __atomic_fetch_add(&pool->parked, 1, __ATOMIC_SEQ_CST);
+  while(!__atomic_load_n(&pool->ready, __ATOMIC_SEQ_CST))
+    pthread_cond_wait(&pool->park_cond, &pool->park_lock);
+  __atomic_fetch_sub(&pool->parked, 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&pool->park_lock);
+
+  __atomic_store_n(&worker->stats.parks, worker->stats.parks + 1, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,65 @@
+/****************************************************************************
+  tq_pool.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_POOL_H
+#define TQ_POOL_H
+
+/*
+  Worker pool of the POSIX port, built with TQ_POOL. tinyq_run_pool() runs
+  tq_qti_table on a number of worker threads instead of the dispatch loop.
+  Every Qti has a mailbox of its own and runs on one worker at a time, a
+  handler written for the single threaded kernel needs no change as long as
+  it shares nothing with other Qties but signals and qti_system calls.
+  Signals to different Qties are dispatched in parallel.
+
+  A Qti with signals waiting is put on the ready queue of the worker that
+  sent them, TQ_DSP_HIGH before TQ_DSP_NORMAL. Workers out of work steal from
+  each other and park when the whole pool is idle. High priority signals of
+  a Qti are taken before its normal ones, at most TQ_POOL_BATCH in a row
+  before the Qti goes back to the queue. A signal to a full mailbox is
+  dropped, tq_pool_dropped() counts them per Qti.
+
+  The calling thread takes the sleep timer, qti_system timers and waits
+  work as before under qti_system_lock, which is a mutex here. One instance
+  with its 255 Qties per process, the profile, trace and record buffers are
+  not thread safe.
+*/
+
+#ifdef TQ_POOL
+#if defined(TQ_CONTEXTS) || defined(TQ_PROFILE) || defined(TQ_TRACE) || defined(TQ_RECORD)
+#error "TQ_POOL can not be built with TQ_CONTEXTS, TQ_PROFILE, TQ_TRACE or TQ_RECORD"
+#endif
+#endif
+
+#define TQ_POOL_WORKERS_MAX                 (64)
+
+#ifndef TQ_POOL_MAILBOX_SIZE
+#define TQ_POOL_MAILBOX_SIZE                (4 * 1024)      /* bytes per Qti and priority */
+#endif
+
+#ifndef TQ_POOL_BATCH
+#define TQ_POOL_BATCH                       (32)
+#endif
+
+#define TQ_POOL_WORKER_NONE                 (0xff)
+
+struct TQ_POOL_STATS
+{
+  uint32 signals;                           /* dispatched */
+  uint32 runs;                              /* Qties taken from a ready queue */
+  uint32 steals;                            /* of them taken from another worker */
+  uint32 parks;
+};
+
+struct TQ_WORKER_POOL;
+
+extern void  tinyq_run_pool(uint8 workers);
+extern uint8 tq_pool_worker(void);          /* of the calling thread, TQ_POOL_WORKER_NONE off the pool */
+extern uint8 tq_pool_worker_count(void);    /* fewer than asked when threads could not be created */
+extern uint32 tq_pool_dropped(uint8 qti);
+extern void  tq_pool_get_stats(uint8 worker, struct TQ_POOL_STATS *stats);
+
+extern void  _tq_pool_post(struct TQ_WORKER_POOL *pool, const uint8 *header, const void *param);
+
+#endif
@@ -0,0 +1,407 @@
+/****************************************************************************
+  tq_port.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <time.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#ifdef TQ_POOL
+#include <pthread.h>
+#endif
+#include "tq_types.h"
+#include "tinyq.h"
+#include "ring_buffer.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "tq_context.h"
+#include "tq_fd.h"
+#include "hw_debug.h"
+
+/*
+  Single threaded host port for Linux. There are no real interrupts, the
+  sleep timer alarm, ready fds (tq_fd.h) and PendSV are kept pending and
+  serviced when interrupts get enabled, the same points where the MCU would
+  take them. The sleep is an epoll_wait() on a timerfd holding the alarm
+  and on the registered fds.
+
+  With TQ_POOL the Qties run on worker threads (tq_pool.h). Interrupts
+  disabled then means holding _irq_lock, a thread taking it waits like a
+  core would for PRIMASK. The interrupt mask is per thread, the pending
+  interrupts and the sleep timer are shared under the lock. The loop waits
+  without the lock, a worker starting a timer sets the timerfd at once.
+*/
+
+typedef unsigned long long  PT_TIME;
+
+/* epoll data of a source, a fd carries its Qti and signal */
+#define PT_TIMER_SOURCE                     (~0ULL)
+#define PT_FD_SOURCE(FD, QTI, SIG)          ((uint32)(FD) | ((PT_TIME)(QTI) << 32) | ((PT_TIME)(SIG) << 40))
+#define PT_SOURCE_FD(SOURCE)                ((int32)(uint32)(SOURCE))
+#define PT_SOURCE_QTI(SOURCE)               ((uint8)((SOURCE) >> 32))
+#define PT_SOURCE_SIG(SOURCE)               ((uint8)((SOURCE) >> 40))
+
+/* TQ_FD_xxx are the EPOLLxxx values, an enum in the C library */
+typedef char PT_FD_EVENTS_ARE_EPOLL[(TQ_FD_IN == EPOLLIN && TQ_FD_OUT == EPOLLOUT && TQ_FD_ERR == EPOLLERR && TQ_FD_HUP == EPOLLHUP) ? 1 : -1];
+
+#if (TQ_FD_EVENTS * (TQ_SIGNAL_HEADER_SIZE + 8) > TQ_LOGIC_BUFFER_SIZE) || (TQ_FD_EVENTS * (TQ_SIGNAL_HEADER_SIZE + 8) > TQ_INTERFACE_BUFFER_SIZE)
+#error "the signal queues can not hold TQ_FD_EVENTS fd signals"
+#endif
+
+static PT_TIME monotonic_us(void);
+static void service_pending_irqs(void);
+static void irq_lock(void);
+static void irq_unlock(void);
+static void epoll_open(void);
+static void timer_arm(void);
+static boolean fd_control(int op, int32 fd, uint32 events, uint8 qti, uint8 sig);
+
+#ifdef TQ_POOL
+  #define PT_IRQ_MASK                       __thread
+#else
+  #define PT_IRQ_MASK                       _PT_THREAD_LOCAL
+#endif
+
+/* a process sleeps the same in every mode, STANDBY would lose the state */
+const struct QTI_SYSTEM_SLEEP_MODE tq_port_sleep_modes[QTI_SYSTEM_SLEEP_MODES] =
+{
+  {0, 0},
+  {0, 0},
+  {QTI_SYSTEM_SLEEP_UNAVAILABLE, QTI_SYSTEM_SLEEP_UNAVAILABLE},
+};
+
+static PT_IRQ_MASK boolean _irq_disabled = FALSE;
+static PT_IRQ_MASK boolean _irq_active = FALSE;
+static PT_IRQ_MASK boolean _dispatch_active = FALSE;
+static _PT_THREAD_LOCAL boolean _dispatch_pending = FALSE;
+static _PT_THREAD_LOCAL boolean _timer_pending = FALSE;
+
+static _PT_THREAD_LOCAL boolean _timer_running = FALSE;
+static _PT_THREAD_LOCAL PT_TIME _timer_ref;
+static _PT_THREAD_LOCAL PT_TIME _timer_alarm;
+static _PT_THREAD_LOCAL PT_TIME _timer_set;                 /* alarm in the timerfd, 0 none */
+
+static _PT_THREAD_LOCAL int _epoll_fd = -1;
+static _PT_THREAD_LOCAL int _timer_fd = -1;
+static _PT_THREAD_LOCAL struct epoll_event _fd_pending[TQ_FD_EVENTS];
+static _PT_THREAD_LOCAL uint8 _fd_pending_count;
+
+#ifdef TQ_POOL
+static pthread_mutex_t _irq_lock = PTHREAD_MUTEX_INITIALIZER;
+static boolean _sleeping;
+#endif
+
+
+void tq_port_init(void)
+{
+  epoll_open();
+  _timer_running = FALSE;
+  _timer_pending = FALSE;
+}
+
+/* fds may be added before tinyq runs */
+static void epoll_open(void)
+{
+  struct epoll_event event;
+
+  if(_epoll_fd >= 0)
+    return;
+
+  _epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+  _timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+
+  /* without the timerfd watched the sleep timer never fires, nothing can run */
+  event.events = EPOLLIN;
+  event.data.u64 = PT_TIMER_SOURCE;
+  if(_epoll_fd < 0 || _timer_fd < 0 || epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, _timer_fd, &event))
+  {
+    perror("tq_port: sleep timer");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void tq_port_us_delay(uint32 us)
+{
+  struct timespec ts;
+
+  ts.tv_sec = us / 1000000;
+  ts.tv_nsec = (us % 1000000) * 1000L;
+  while(nanosleep(&ts, &ts) && errno == EINTR)
+    ;
+}
+
+void tq_port_system_reset(void)
+{
+  /* a process can not reset itself, terminate it */
+  exit(EXIT_FAILURE);
+}
+
+uint32 tq_port_timestamp(void)
+{
+  return (uint32)monotonic_us();
+}
+
+static void irq_lock(void)
+{
+#ifdef TQ_POOL
+  if(!_irq_disabled)
+    pthread_mutex_lock(&_irq_lock);
+#endif
+  _irq_disabled = TRUE;
+}
+
+static void irq_unlock(void)
+{
+#ifdef TQ_POOL
+  if(_irq_disabled)
+    pthread_mutex_unlock(&_irq_lock);
+#endif
+  _irq_disabled = FALSE;
+}
+
+void tq_port_disable_irq(void)
+{
+  irq_lock();
+}
+
+void tq_port_enable_irq(void)
+{
+  irq_unlock();
+  service_pending_irqs();
+}
+
+uint32 tq_port_irq_save(void)
+{
+  uint32 state = _irq_disabled;
+
+  irq_lock();
+  return state;
+}
+
+void tq_port_irq_restore(uint32 state)
+{
+  if(!state)
+    tq_port_enable_irq();
+}
+
+boolean tq_port_in_isr(void)
+{
+  return (_irq_active && !_dispatch_active) ? TRUE : FALSE;
+}
+
+void tq_port_trigger_high_priority_dispatch(void)
+{
+  _dispatch_pending = TRUE;
+}
+
+/* a ready fd wakes like an EXTI line, a stopped timer's alarm is ignored */
+uint8 tq_port_sleep(uint8 mode)
+{
+  struct epoll_event events[TQ_FD_EVENTS];
+  unsigned long long expirations;
+  uint8 cause = QTI_SYSTEM_WAKEUP_OTHER;
+  int count, i;
+
+  /* WFI returns at once with an interrupt pending */
+  if(_timer_pending)
+    return QTI_SYSTEM_WAKEUP_RTC;
+  if(_dispatch_pending || _fd_pending_count)
+    return QTI_SYSTEM_WAKEUP_OTHER;
+
+  timer_arm();
+#ifdef TQ_POOL
+  /* called with _irq_lock held, the workers get it while the loop waits */
+  _sleeping = TRUE;
+  pthread_mutex_unlock(&_irq_lock);
+#endif
+  count = epoll_wait(_epoll_fd, events, TQ_FD_EVENTS, -1);
+#ifdef TQ_POOL
+  pthread_mutex_lock(&_irq_lock);
+  _sleeping = FALSE;
+#endif
+
+  for(i = 0; i < count; i++)
+  {
+    if(events[i].data.u64 == PT_TIMER_SOURCE)
+    {
+      if(read(_timer_fd, &expirations, sizeof(expirations)) < 0)
+        continue;
+      _timer_set = 0;
+      if(_timer_running && monotonic_us() >= _timer_alarm)
+      {
+        _timer_pending = TRUE;
+        cause = QTI_SYSTEM_WAKEUP_RTC;
+      }
+    }
+    else
+    {
+      _fd_pending[_fd_pending_count++] = events[i];
+      cause = (cause == QTI_SYSTEM_WAKEUP_RTC) ? cause : QTI_SYSTEM_WAKEUP_EXTI;
+    }
+  }
+  return cause;
+}
+
+/* the pending flags are taken under the lock, handlers run with interrupts enabled */
+static void service_pending_irqs(void)
+{
+  struct epoll_event events[TQ_FD_EVENTS];
+  struct TQ_FD_EVENT event;
+  boolean timer, dispatch;
+  uint8 fds, i;
+
+  if(_irq_active)
+    return;
+
+  _irq_active = TRUE;
+  while(!_irq_disabled)
+  {
+    irq_lock();
+    if(_timer_running && !_timer_pending && monotonic_us() >= _timer_alarm)
+      _timer_pending = TRUE;
+
+    timer = _timer_pending;
+    fds = timer ? 0 : _fd_pending_count;
+    dispatch = !timer && !fds && _dispatch_pending;
+    if(timer)
+      _timer_pending = FALSE;
+    else if(fds)
+    {
+      memcpy(events, _fd_pending, fds * sizeof(events[0]));
+      _fd_pending_count = 0;
+    }
+    else if(dispatch)
+      _dispatch_pending = FALSE;
+    irq_unlock();
+
+    if(timer)
+      _system_sleep_timer_handler();
+    else if(fds)
+    {
+      /* from QTI_SYSTEM */
+      for(i = 0; i < fds; i++)
+      {
+        event.fd = PT_SOURCE_FD(events[i].data.u64);
+        event.events = events[i].events & (TQ_FD_IN | TQ_FD_OUT | TQ_FD_ERR | TQ_FD_HUP);
+        tinyq_send_signal(0, PT_SOURCE_QTI(events[i].data.u64), PT_SOURCE_SIG(events[i].data.u64), &event, sizeof(event));
+      }
+    }
+    else if(dispatch)
+    {
+      _dispatch_active = TRUE;
+      _tq_high_priority_dispatch();
+      _dispatch_active = FALSE;
+    }
+    else
+      break;
+  }
+  _irq_active = FALSE;
+}
+
+/* timer with CLOCK_MONOTONIC */
+static PT_TIME monotonic_us(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((PT_TIME)ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+uint32 tq_port_sleep_timer_get_time_elapsed(boolean update)
+{
+  PT_TIME now;
+  uint32 period;
+
+  if(!_timer_running)
+    return 0;
+
+  now = monotonic_us();
+  period = (uint32)(now - _timer_ref);
+
+  if(update)
+    _timer_ref = now;
+
+  return period;
+}
+
+void tq_port_sleep_timer_start(int32 ticks)
+{
+  TQ_ASSERT(ticks > 0);
+
+  ticks = (ticks > _PT_SLEEP_TIMER_PERIOD_MAX) ? _PT_SLEEP_TIMER_PERIOD_MAX : ticks;
+  ticks = (ticks < 1) ? 1 : ticks;
+
+  _timer_ref = monotonic_us();
+  _timer_alarm = _timer_ref + ticks;
+  _timer_running = TRUE;
+  _timer_pending = FALSE;
+#ifdef TQ_POOL
+  if(_sleeping)
+    timer_arm();
+#endif
+}
+
+void tq_port_sleep_timer_stop(void)
+{
+  _timer_running = FALSE;
+  _timer_pending = FALSE;
+}
+
+/* the timerfd is set when the loop goes to sleep, only an alarm that changed costs a call */
+static void timer_arm(void)
+{
+  struct itimerspec its;
+
+  if(!_timer_running || _timer_set == _timer_alarm)
+    return;
+
+  memset(&its, 0, sizeof(its));
+  its.it_value.tv_sec = _timer_alarm / 1000000;
+  its.it_value.tv_nsec = (_timer_alarm % 1000000) * 1000L;
+  if(!timerfd_settime(_timer_fd, TFD_TIMER_ABSTIME, &its, 0))
+    _timer_set = _timer_alarm;
+}
+
+/* fd sources, edge triggered, errors and hang ups always come */
+boolean tq_fd_add(int32 fd, uint32 events, uint8 qti, uint8 sig)
+{
+  return fd_control(EPOLL_CTL_ADD, fd, events, qti, sig);
+}
+
+/* re-arms the fd, a signal comes at once for what is ready */
+boolean tq_fd_modify(int32 fd, uint32 events, uint8 qti, uint8 sig)
+{
+  return fd_control(EPOLL_CTL_MOD, fd, events, qti, sig);
+}
+
+void tq_fd_remove(int32 fd)
+{
+  uint32 state;
+  uint8 i, count = 0;
+
+  epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, fd, 0);
+
+  state = tq_port_irq_save();
+  for(i = 0; i < _fd_pending_count; i++)
+  {
+    if(PT_SOURCE_FD(_fd_pending[i].data.u64) != fd)
+      _fd_pending[count++] = _fd_pending[i];
+  }
+  _fd_pending_count = count;
+  tq_port_irq_restore(state);
+}
+
+static boolean fd_control(int op, int32 fd, uint32 events, uint8 qti, uint8 sig)
+{
+  struct epoll_event event;
+
+  epoll_open();
+  event.events = (events & (TQ_FD_IN | TQ_FD_OUT)) | EPOLLET;
+  event.data.u64 = PT_FD_SOURCE(fd, qti, sig);
+  return epoll_ctl(_epoll_fd, op, fd, &event) ? FALSE : TRUE;
+}
@@ -0,0 +1,48 @@
+/****************************************************************************
+  tq_port.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_PORT_H
+#define TQ_PORT_H
+
+#define _PT_SLEEP_TIMER_TICK_PER_SECOND                 (1000 * 1000)
+#define _PT_SLEEP_TIMER_TICK_PER_MS                     (_PT_SLEEP_TIMER_TICK_PER_SECOND / 1000)
+#define _PT_SLEEP_TIMER_PERIOD_MAX                      (_PT_SLEEP_TIMER_TICK_PER_SECOND)
+
+/* CLOCK_MONOTONIC in microseconds */
+#define _PT_TIMESTAMP_FREQ                              (1000 * 1000)
+
+/* with TQ_CONTEXTS every thread runs an instance of its own, see tq_context.h */
+#ifdef TQ_CONTEXTS
+#define _PT_THREAD_LOCAL                                __thread
+#else
+#define _PT_THREAD_LOCAL
+#endif
+
+/* the CPU divides in hardware, loops may trade a division for a vector of multiplies */
+#define _PT_HW_DIVIDE
+
+#define tq_port_return_address()                        ((const void *)__builtin_return_address(0))
+
+extern void tq_port_disable_irq(void);
+extern void tq_port_enable_irq(void);
+extern uint32 tq_port_irq_save(void);
+extern void tq_port_irq_restore(uint32 state);
+extern boolean tq_port_in_isr(void);                  /* in an interrupt handler other than the high priority dispatch */
+
+extern void tq_port_init(void);
+extern void tq_port_system_reset(void);
+extern void tq_port_us_delay(uint32 us);
+extern uint32 tq_port_timestamp(void);
+
+extern void tq_port_trigger_high_priority_dispatch(void);
+extern uint8 tq_port_sleep(uint8 mode);               /* QTI_SYSTEM_SLEEP_xxx, returns QTI_SYSTEM_WAKEUP_xxx */
+
+extern void tq_port_sleep_timer_stop(void);
+extern void tq_port_sleep_timer_start(int32 ticks);
+extern uint32 tq_port_sleep_timer_get_time_elapsed(boolean update);
+
+extern void _system_sleep_timer_handler(void);
+extern void _tq_high_priority_dispatch(void);
+
+#endif
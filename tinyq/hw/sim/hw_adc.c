@@ -0,0 +1,92 @@
+/****************************************************************************
+  hw_adc.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "tq_sim.h"
+#include "hw_adc.h"
+
+#define ADC_CHANNELS                        (19)
+#define ADC_MID_SCALE                       (0x800)
+
+static void adc_irq(uint8 irq, uint32 arg);
+static void schedule_half(void);
+
+static uint8  _channels[ADC_CHANNELS];      /* of the sequence, ascending */
+static uint8  _channel_count;
+static uint32 _rate;
+static uint16 *_buffer;
+static uint16 _half;
+static uint16 _half_sequences;
+static uint8  _next_half;                   /* of the buffer the DMA fills */
+static uint32 _sequence;                    /* first of that half */
+static TQ_SIM_TIME _start;
+static HW_ADC_IRQ_HANDLER _handler;
+static HW_ADC_SIM_GENERATOR _generator;
+
+
+void hw_adc_start(uint32 channels, uint32 rate, uint16 *buffer, uint16 size, HW_ADC_IRQ_HANDLER handler)
+{
+  uint8 i;
+
+  TQ_ASSERT(rate > 0);
+
+  _channel_count = 0;
+  for(i = 0; i < ADC_CHANNELS; i++)
+  {
+    if(channels & (1UL << i))
+      _channels[_channel_count++] = i;
+  }
+  TQ_ASSERT(_channel_count && (size / 2) % _channel_count == 0);
+
+  _rate = rate;
+  _buffer = buffer;
+  _half = size / 2;
+  _half_sequences = _half / _channel_count;
+  _handler = handler;
+  _next_half = 0;
+  _sequence = 0;
+  _start = tq_sim_now();
+
+  tq_sim_set_irq_handler(HW_ADC_SIM_IRQ, adc_irq);
+  schedule_half();
+}
+
+void hw_adc_stop(void)
+{
+  tq_sim_cancel_irq(HW_ADC_SIM_IRQ);
+  tq_sim_set_irq_handler(HW_ADC_SIM_IRQ, 0);
+}
+
+void hw_adc_sim_set_generator(HW_ADC_SIM_GENERATOR generator)
+{
+  _generator = generator;
+}
+
+/* times from the start, no drift at rates that do not divide a second */
+static void schedule_half(void)
+{
+  unsigned long long last = _sequence + _half_sequences - 1;
+
+  tq_sim_raise_irq(_start + last * 1000000 / _rate, HW_ADC_SIM_IRQ, _next_half ? TQ_SIM_DMA_FULL : TQ_SIM_DMA_HALF);
+}
+
+static void adc_irq(uint8 irq, uint32 arg)
+{
+  uint16 *samples = _buffer + (_next_half ? _half : 0);
+  uint16 i, n = 0;
+  uint8 c;
+
+  for(i = 0; i < _half_sequences; i++)
+  {
+    for(c = 0; c < _channel_count; c++)
+      samples[n++] = _generator ? (_generator(_channels[c], _sequence + i) & 0x0fff) : ADC_MID_SCALE;
+  }
+  _sequence += _half_sequences;
+  _next_half ^= 1;
+
+  schedule_half();
+  _handler(samples, _half);
+}
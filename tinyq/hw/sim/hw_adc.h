@@ -0,0 +1,28 @@
+/****************************************************************************
+  hw_adc.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_ADC_H
+#define HW_ADC_H
+
+/*
+  Stand-in of stm32f030/hw_adc.h on the virtual time port. Sequence n is
+  converted at n / rate seconds after the start, a half of the buffer is
+  filled by the generator when its last sequence is due and the handler
+  runs on HW_ADC_SIM_IRQ. Without a generator every sample is mid-scale.
+*/
+
+#ifndef HW_ADC_SIM_IRQ
+#define HW_ADC_SIM_IRQ                      (TQ_SIM_IRQS - 3)
+#endif
+
+typedef void (*HW_ADC_IRQ_HANDLER)(const uint16 *samples, uint16 count);
+typedef uint16 (*HW_ADC_SIM_GENERATOR)(uint8 channel, uint32 sequence);
+
+extern void hw_adc_start(uint32 channels, uint32 rate, uint16 *buffer, uint16 size, HW_ADC_IRQ_HANDLER handler);
+extern void hw_adc_stop(void);
+
+/* simulation interface */
+extern void hw_adc_sim_set_generator(HW_ADC_SIM_GENERATOR generator);
+
+#endif
@@ -0,0 +1,32 @@
+/****************************************************************************
+  hw_debug.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_DEBUG_H
+#define HW_DEBUG_H
+
+#include <assert.h>
+
+#define TQ_DEBUG_PIN_NONE                   (0)
+
+#ifdef TQ_DEBUG
+  #define TQ_DEBUG_INIT()
+  #define TQ_ASSERT(C)                      assert(C)
+  #define TQ_DEBUG_PIN_SET(PIN, ASSERT)
+#else
+  #define TQ_DEBUG_INIT()
+  #define TQ_ASSERT(C)
+  #define TQ_DEBUG_PIN_SET(PIN, ASSERT)
+  #define TQ_DEBUG_PIN_NUM(PIN, NUM)
+#endif
+
+
+#define DEBUG_PIN_TINYQ_NORMAL_EVT                  TQ_DEBUG_PIN_NONE
+#define DEBUG_PIN_TINYQ_HIGH_EVT                    TQ_DEBUG_PIN_NONE
+#define DEBUG_PIN_TINYQ_SLEEP                       TQ_DEBUG_PIN_NONE
+#define DEBUG_PIN_TINYQ_LOCK_BUDGET                 TQ_DEBUG_PIN_NONE
+
+#define DEBUG_PIN_SAMPLE                            TQ_DEBUG_PIN_NONE
+
+
+#endif
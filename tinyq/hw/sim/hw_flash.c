@@ -0,0 +1,86 @@
+/****************************************************************************
+  hw_flash.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "tq_sim.h"
+#include "hw_flash.h"
+
+#define FLASH_SIZE                          (HW_FLASH_SIM_PAGES * HW_FLASH_PAGE_SIZE)
+
+static void flash_init(void);
+
+static uint16 _flash[FLASH_SIZE / 2];
+static uint32 _erases[HW_FLASH_SIM_PAGES];
+static boolean _initialised;
+static boolean _power_cut;
+
+
+boolean hw_flash_erase_page(uint32 address)
+{
+  uint32 offset = address - HW_FLASH_SIM_BASE;
+
+  TQ_ASSERT(offset < FLASH_SIZE && (offset & (HW_FLASH_PAGE_SIZE - 1)) == 0);
+  flash_init();
+
+  if(_power_cut)
+    return TRUE;
+
+  memset(&_flash[offset / 2], 0xff, HW_FLASH_PAGE_SIZE);
+  _erases[offset / HW_FLASH_PAGE_SIZE]++;
+  tq_sim_consume(HW_FLASH_SIM_ERASE_TIME);
+  return TRUE;
+}
+
+boolean hw_flash_program(uint32 address, const uint16 *data, uint16 count)
+{
+  uint32 offset = address - HW_FLASH_SIM_BASE;
+  uint16 i;
+
+  TQ_ASSERT(offset + count * 2 <= FLASH_SIZE && (offset & 1) == 0);
+  flash_init();
+
+  if(_power_cut)
+    return TRUE;
+
+  for(i = 0; i < count; i++)
+  {
+    if(_flash[offset / 2 + i] != 0xffff)
+      break;
+    _flash[offset / 2 + i] = data[i];
+  }
+  tq_sim_consume(i * HW_FLASH_SIM_PROGRAM_TIME);
+
+  return (i == count) ? TRUE : FALSE;
+}
+
+const void *hw_flash_map(uint32 address)
+{
+  TQ_ASSERT(address - HW_FLASH_SIM_BASE < FLASH_SIZE);
+  flash_init();
+
+  return (const uint8*)_flash + (address - HW_FLASH_SIM_BASE);
+}
+
+uint32 hw_flash_sim_erases(uint32 address)
+{
+  return _erases[(address - HW_FLASH_SIM_BASE) / HW_FLASH_PAGE_SIZE];
+}
+
+void hw_flash_sim_cut_power(boolean cut)
+{
+  _power_cut = cut;
+}
+
+/* a new part comes erased */
+static void flash_init(void)
+{
+  if(_initialised)
+    return;
+
+  memset(_flash, 0xff, sizeof(_flash));
+  _initialised = TRUE;
+}
@@ -0,0 +1,42 @@
+/****************************************************************************
+  hw_flash.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_FLASH_H
+#define HW_FLASH_H
+
+/*
+  Stand-in of stm32f030/hw_flash.h on the virtual time port, the 64KB of
+  flash of an STM32F030x8 in RAM. Programming a half word that is not
+  erased fails as it does on target, operations take their time on the
+  virtual clock. Erases are counted per page, and the power can be cut:
+  operations after it change nothing.
+*/
+
+#define HW_FLASH_PAGE_SIZE                  (1024)
+
+#ifndef HW_FLASH_SIM_BASE
+#define HW_FLASH_SIM_BASE                   (0x08000000UL)
+#endif
+
+#ifndef HW_FLASH_SIM_PAGES
+#define HW_FLASH_SIM_PAGES                  (64)
+#endif
+
+#ifndef HW_FLASH_SIM_PROGRAM_TIME
+#define HW_FLASH_SIM_PROGRAM_TIME           (53)            /* us a half word */
+#endif
+
+#ifndef HW_FLASH_SIM_ERASE_TIME
+#define HW_FLASH_SIM_ERASE_TIME             (30000)         /* us a page */
+#endif
+
+extern boolean     hw_flash_erase_page(uint32 address);
+extern boolean     hw_flash_program(uint32 address, const uint16 *data, uint16 count);
+extern const void *hw_flash_map(uint32 address);
+
+/* simulation interface */
+extern uint32 hw_flash_sim_erases(uint32 address);
+extern void   hw_flash_sim_cut_power(boolean cut);
+
+#endif
@@ -0,0 +1,82 @@
+/****************************************************************************
+  hw_input.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "tq_sim.h"
+#include "hw_input.h"
+
+static void input_irq(uint8 irq, uint32 arg);
+static void schedule_change(void);
+
+static uint16  _levels[HW_INPUT_PORTS];
+static uint16  _pins[HW_INPUT_PORTS];       /* opened */
+static boolean _armed;
+static uint32  _interrupts;
+static HW_INPUT_IRQ_HANDLER _handler;
+static HW_INPUT_SIM_SCRIPT _script;
+static struct HW_INPUT_SIM_CHANGE _change;  /* the next one, raised */
+
+
+void hw_input_open(uint8 port, uint16 pins, uint16 pull_ups, HW_INPUT_IRQ_HANDLER handler)
+{
+  TQ_ASSERT(port < HW_INPUT_PORTS);
+
+  _levels[port] = (_levels[port] & ~pins) | (pull_ups & pins);
+  _pins[port] |= pins;
+  _handler = handler;
+}
+
+void hw_input_close(uint8 port, uint16 pins)
+{
+  _pins[port] &= ~pins;
+}
+
+void hw_input_arm(boolean armed)
+{
+  _armed = armed;
+}
+
+uint16 hw_input_read(uint8 port)
+{
+  return _levels[port];
+}
+
+/* its levels start from the pulls of the pins opened before the first change */
+void hw_input_sim_set_script(HW_INPUT_SIM_SCRIPT script)
+{
+  _script = script;
+  tq_sim_set_irq_handler(HW_INPUT_SIM_IRQ, input_irq);
+  schedule_change();
+}
+
+uint32 hw_input_sim_interrupts(void)
+{
+  return _interrupts;
+}
+
+static void schedule_change(void)
+{
+  if(_script && _script(&_change))
+  {
+    TQ_ASSERT(_change.port < HW_INPUT_PORTS);
+    tq_sim_raise_irq(_change.time, HW_INPUT_SIM_IRQ, 0);
+  }
+}
+
+static void input_irq(uint8 irq, uint32 arg)
+{
+  uint16 moved = (_levels[_change.port] ^ _change.levels) & _pins[_change.port];
+
+  _levels[_change.port] = _change.levels;
+  schedule_change();
+
+  if(moved && _armed)
+  {
+    _armed = FALSE;
+    _interrupts++;
+    _handler();
+  }
+}
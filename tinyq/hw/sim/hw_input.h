@@ -0,0 +1,41 @@
+/****************************************************************************
+  hw_input.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_INPUT_H
+#define HW_INPUT_H
+
+/*
+  Stand-in of stm32f030/hw_input.h on the virtual time port. The levels
+  of the ports come from a script, a change at a time on HW_INPUT_SIM_IRQ.
+  A change that moves an opened pin while armed calls the handler and
+  counts as an interrupt. Opened pins rest at their pulls until the script
+  moves them.
+*/
+
+#ifndef HW_INPUT_SIM_IRQ
+#define HW_INPUT_SIM_IRQ                    (TQ_SIM_IRQS - 4)
+#endif
+
+#define HW_INPUT_PORTS                      (6)
+
+struct HW_INPUT_SIM_CHANGE
+{
+  unsigned long long time;                  /* TQ_SIM_TIME */
+  uint8  port;
+  uint16 levels;                            /* of the whole port from then on */
+};
+
+typedef void (*HW_INPUT_IRQ_HANDLER)(void);
+typedef boolean (*HW_INPUT_SIM_SCRIPT)(struct HW_INPUT_SIM_CHANGE *change);    /* FALSE at the end */
+
+extern void hw_input_open(uint8 port, uint16 pins, uint16 pull_ups, HW_INPUT_IRQ_HANDLER handler);
+extern void hw_input_close(uint8 port, uint16 pins);
+extern void hw_input_arm(boolean armed);
+extern uint16 hw_input_read(uint8 port);
+
+/* simulation interface */
+extern void hw_input_sim_set_script(HW_INPUT_SIM_SCRIPT script);
+extern uint32 hw_input_sim_interrupts(void);
+
+#endif
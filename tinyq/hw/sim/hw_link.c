@@ -0,0 +1,126 @@
+/****************************************************************************
+  hw_link.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  The one of stm32f030 over the simulated UART, kept in step with it.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "hw_uart.h"
+#include "hw_link.h"
+#include "qti_bridge.h"
+
+static void rx_irq(void);
+static void tx_irq(void);
+static void tx_start(void);
+
+static uint32 _baud = HW_LINK_BAUD;
+static uint8  _qti;
+
+static uint8  _rx_ring[HW_LINK_RX_SIZE];
+static uint16 _rx_tail;                     /* next byte to read */
+static boolean _rx_told;                    /* BRIDGE_NTF_LINK sent, the ring not read empty since */
+
+static uint8  _tx_buffers[2][HW_LINK_TX_SIZE];
+static uint16 _tx_fill;                     /* bytes in the buffer filling */
+static uint8  _tx_filling;
+static boolean _tx_busy;                    /* the other buffer is on the line */
+static boolean _tx_blocked;                 /* a write took less than it was given */
+
+
+void hw_link_set_baud(uint32 baud)
+{
+  _baud = baud;
+}
+
+boolean bridge_link_open(uint8 qti)
+{
+  _qti = qti;
+  _rx_tail = 0;
+  _rx_told = FALSE;
+  _tx_fill = 0;
+  _tx_filling = 0;
+  _tx_busy = FALSE;
+  _tx_blocked = FALSE;
+
+  qti_system_request_wait(qti);
+  hw_uart_open(_baud, _rx_ring, HW_LINK_RX_SIZE, rx_irq, tx_irq);
+  return TRUE;
+}
+
+/* the ring read empty arms the next BRIDGE_NTF_LINK, with no byte landing in between */
+uint16 bridge_link_read(uint8 *data, uint16 size)
+{
+  uint16 position, available;
+
+  qti_system_lock();
+  position = hw_uart_rx_position();
+  available = (position >= _rx_tail) ? position - _rx_tail : HW_LINK_RX_SIZE - _rx_tail;
+  if(!available)
+    _rx_told = FALSE;
+  qti_system_unlock();
+
+  size = (size > available) ? available : size;
+  memcpy(data, &_rx_ring[_rx_tail], size);
+  _rx_tail = (_rx_tail + size == HW_LINK_RX_SIZE) ? 0 : _rx_tail + size;
+  return size;
+}
+
+/* fills the buffer behind the one on the line, an idle line starts at once */
+uint16 bridge_link_write(const uint8 *data, uint16 size)
+{
+  uint16 written = 0, take;
+
+  qti_system_lock();
+  while(written < size)
+  {
+    take = HW_LINK_TX_SIZE - _tx_fill;
+    if(!take)
+      break;
+    take = (take > size - written) ? size - written : take;
+    memcpy(&_tx_buffers[_tx_filling][_tx_fill], data + written, take);
+    _tx_fill += take;
+    written += take;
+    if(!_tx_busy)
+      tx_start();
+  }
+  if(written < size)
+    _tx_blocked = TRUE;
+  qti_system_unlock();
+
+  return written;
+}
+
+/* from QTI_SYSTEM, as the links of the other ports */
+static void rx_irq(void)
+{
+  if(_rx_told)
+    return;
+  _rx_told = TRUE;
+  tinyq_send_signal(0, _qti, BRIDGE_NTF_LINK, 0, 0);
+}
+
+/* the next buffer goes out before the bridge is told, the line keeps busy */
+static void tx_irq(void)
+{
+  _tx_busy = FALSE;
+  if(_tx_fill)
+    tx_start();
+  if(_tx_blocked)
+  {
+    _tx_blocked = FALSE;
+    tinyq_send_signal(0, _qti, BRIDGE_NTF_LINK, 0, 0);
+  }
+}
+
+/* called locked or in the interrupt */
+static void tx_start(void)
+{
+  hw_uart_tx(_tx_buffers[_tx_filling], _tx_fill);
+  _tx_filling ^= 1;
+  _tx_fill = 0;
+  _tx_busy = TRUE;
+}
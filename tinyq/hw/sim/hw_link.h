@@ -0,0 +1,30 @@
+/****************************************************************************
+  hw_link.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_LINK_H
+#define HW_LINK_H
+
+/*
+  Stand-in of stm32f030/hw_link.h on the virtual time port, the link of
+  qti_bridge on the simulated UART of hw_uart.h, not to be opened by
+  qti_uart as well. Bytes given to hw_uart_sim_receive() are read from the
+  ring as they land, what the bridge writes reaches the tx sink. The baud
+  rate is set before tinyq_run().
+*/
+
+#ifndef HW_LINK_BAUD
+#define HW_LINK_BAUD                        (115200)
+#endif
+
+#ifndef HW_LINK_RX_SIZE
+#define HW_LINK_RX_SIZE                     (256)
+#endif
+
+#ifndef HW_LINK_TX_SIZE
+#define HW_LINK_TX_SIZE                     (128)           /* bytes of each of the two buffers */
+#endif
+
+extern void hw_link_set_baud(uint32 baud);
+
+#endif
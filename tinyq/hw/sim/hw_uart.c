@@ -0,0 +1,184 @@
+/****************************************************************************
+  hw_uart.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Bytes of the line are copied into the ring lazily, whenever the position
+  of the DMA is read or one of its interrupts falls due. Only the next
+  interrupt of either direction is ever raised.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "tq_sim.h"
+#include "hw_uart.h"
+
+#define BITS_PER_CHAR                       (10)            /* 8N1 */
+
+static void rx_sync(void);
+static void rx_schedule(void);
+static void rx_irq(uint8 irq, uint32 arg);
+static void tx_irq(uint8 irq, uint32 arg);
+static TQ_SIM_TIME char_time(uint32 chars);
+
+static uint32 _baud;
+static uint8 *_rx_ring;
+static uint16 _rx_size;
+static uint16 _rx_position;
+static HW_UART_IRQ_HANDLER _rx_handler;
+static HW_UART_IRQ_HANDLER _tx_handler;
+static HW_UART_SIM_TX_SINK _tx_sink;
+
+/* bytes on the line, the burst started arriving at _burst_start */
+static uint8  _line[HW_UART_SIM_LINE_SIZE];
+static uint16 _line_head;
+static uint16 _line_count;
+static TQ_SIM_TIME _burst_start;
+static uint32 _burst_arrived;
+static uint32 _rx_flags;                    /* TQ_SIM_DMA_xxx latched by bytes copied early */
+static boolean _idle_pending;
+
+static const uint8 *_tx_data;
+static uint16 _tx_size;
+
+
+void hw_uart_open(uint32 baud, uint8 *rx_ring, uint16 rx_size, HW_UART_IRQ_HANDLER rx_handler, HW_UART_IRQ_HANDLER tx_handler)
+{
+  TQ_ASSERT(baud > 0 && rx_size >= 2);
+
+  _baud = baud;
+  _rx_ring = rx_ring;
+  _rx_size = rx_size;
+  _rx_position = 0;
+  _rx_handler = rx_handler;
+  _tx_handler = tx_handler;
+  _line_head = 0;
+  _line_count = 0;
+  _rx_flags = 0;
+  _idle_pending = FALSE;
+
+  tq_sim_set_irq_handler(HW_UART_SIM_RX_IRQ, rx_irq);
+  tq_sim_set_irq_handler(HW_UART_SIM_TX_IRQ, tx_irq);
+}
+
+void hw_uart_close(void)
+{
+  tq_sim_cancel_irq(HW_UART_SIM_RX_IRQ);
+  tq_sim_cancel_irq(HW_UART_SIM_TX_IRQ);
+  tq_sim_set_irq_handler(HW_UART_SIM_RX_IRQ, 0);
+  tq_sim_set_irq_handler(HW_UART_SIM_TX_IRQ, 0);
+  _baud = 0;
+}
+
+uint16 hw_uart_rx_position(void)
+{
+  rx_sync();
+  return _rx_position;
+}
+
+void hw_uart_tx(const uint8 *data, uint16 size)
+{
+  TQ_ASSERT(_baud && size > 0);
+
+  _tx_data = data;
+  _tx_size = size;
+  tq_sim_raise_irq(tq_sim_now() + char_time(size), HW_UART_SIM_TX_IRQ, 0);
+}
+
+/* a burst goes on while bytes of the last one have not arrived yet */
+uint16 hw_uart_sim_receive(const uint8 *data, uint16 size)
+{
+  uint16 tail;
+
+  if(!_baud)
+    return 0;
+
+  rx_sync();
+  if(!_line_count)
+  {
+    _burst_start = tq_sim_now();
+    _burst_arrived = 0;
+  }
+
+  size = (size > HW_UART_SIM_LINE_SIZE - _line_count) ? HW_UART_SIM_LINE_SIZE - _line_count : size;
+  tail = (_line_head + _line_count) % HW_UART_SIM_LINE_SIZE;
+  if(tail + size > HW_UART_SIM_LINE_SIZE)
+  {
+    memcpy(_line + tail, data, HW_UART_SIM_LINE_SIZE - tail);
+    memcpy(_line, data + HW_UART_SIM_LINE_SIZE - tail, size - (HW_UART_SIM_LINE_SIZE - tail));
+  }
+  else
+    memcpy(_line + tail, data, size);
+  _line_count += size;
+
+  rx_schedule();
+  return size;
+}
+
+void hw_uart_sim_set_tx_sink(HW_UART_SIM_TX_SINK sink)
+{
+  _tx_sink = sink;
+}
+
+/* byte k of a burst has arrived a character time after byte k - 1 */
+static void rx_sync(void)
+{
+  TQ_SIM_TIME now = tq_sim_now();
+
+  while(_line_count && _burst_start + char_time(_burst_arrived + 1) <= now)
+  {
+    _rx_ring[_rx_position] = _line[_line_head];
+    _rx_position = (_rx_position + 1 == _rx_size) ? 0 : _rx_position + 1;
+    if(_rx_position == _rx_size / 2)
+      _rx_flags |= TQ_SIM_DMA_HALF;
+    else if(!_rx_position)
+      _rx_flags |= TQ_SIM_DMA_FULL;
+    _line_head = (_line_head + 1) % HW_UART_SIM_LINE_SIZE;
+    _line_count--;
+    _burst_arrived++;
+    _idle_pending = TRUE;
+  }
+}
+
+/*
+  A transfer the bytes copied have already got to is due now, the next
+  half or full transfer if the line gets that far, or else the idle line.
+*/
+static void rx_schedule(void)
+{
+  uint16 half = _rx_size / 2;
+  uint16 to_boundary = (_rx_position < half) ? half - _rx_position : _rx_size - _rx_position;
+
+  tq_sim_cancel_irq(HW_UART_SIM_RX_IRQ);
+  if(_rx_flags)
+    tq_sim_raise_irq(tq_sim_now(), HW_UART_SIM_RX_IRQ, _rx_flags);
+  else if(to_boundary <= _line_count)
+  {
+    tq_sim_raise_irq(_burst_start + char_time(_burst_arrived + to_boundary), HW_UART_SIM_RX_IRQ,
+                     (_rx_position < half) ? TQ_SIM_DMA_HALF : TQ_SIM_DMA_FULL);
+  }
+  else if(_line_count || _idle_pending)
+    tq_sim_raise_irq(_burst_start + char_time(_burst_arrived + _line_count + 1), HW_UART_SIM_RX_IRQ, 0);
+}
+
+static void rx_irq(uint8 irq, uint32 arg)
+{
+  rx_sync();
+  _rx_flags = 0;
+  if(!arg)
+    _idle_pending = FALSE;
+  rx_schedule();
+  _rx_handler();
+}
+
+static void tx_irq(uint8 irq, uint32 arg)
+{
+  if(_tx_sink)
+    _tx_sink(_tx_data, _tx_size);
+  _tx_handler();
+}
+
+static TQ_SIM_TIME char_time(uint32 chars)
+{
+  return (TQ_SIM_TIME)chars * BITS_PER_CHAR * 1000000 / _baud;
+}
@@ -0,0 +1,42 @@
+/****************************************************************************
+  hw_uart.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_UART_H
+#define HW_UART_H
+
+/*
+  Stand-in of stm32f030/hw_uart.h on the virtual time port. Bytes given to
+  hw_uart_sim_receive() arrive one character time apart at the baud rate
+  of the open UART and land in the ring as the circular DMA would put
+  them, the rx handler runs on HW_UART_SIM_RX_IRQ at half and full
+  transfer and a character time after the last byte of a burst. A buffer
+  passed to hw_uart_tx() reaches the tx sink and the tx handler runs on
+  HW_UART_SIM_TX_IRQ when its last byte would be out on the line.
+*/
+
+#ifndef HW_UART_SIM_RX_IRQ
+#define HW_UART_SIM_RX_IRQ                  (TQ_SIM_IRQS - 2)
+#endif
+
+#ifndef HW_UART_SIM_TX_IRQ
+#define HW_UART_SIM_TX_IRQ                  (TQ_SIM_IRQS - 1)
+#endif
+
+#ifndef HW_UART_SIM_LINE_SIZE
+#define HW_UART_SIM_LINE_SIZE               (8192)          /* bytes queued on the line */
+#endif
+
+typedef void (*HW_UART_IRQ_HANDLER)(void);
+typedef void (*HW_UART_SIM_TX_SINK)(const uint8 *data, uint16 size);
+
+extern void   hw_uart_open(uint32 baud, uint8 *rx_ring, uint16 rx_size, HW_UART_IRQ_HANDLER rx_handler, HW_UART_IRQ_HANDLER tx_handler);
+extern void   hw_uart_close(void);
+extern uint16 hw_uart_rx_position(void);      /* of the next byte the DMA writes */
+extern void   hw_uart_tx(const uint8 *data, uint16 size);
+
+/* simulation interface */
+extern uint16 hw_uart_sim_receive(const uint8 *data, uint16 size);
+extern void   hw_uart_sim_set_tx_sink(HW_UART_SIM_TX_SINK sink);
+
+#endif
@@ -0,0 +1,425 @@
+/****************************************************************************
+  tq_port.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <setjmp.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qti_system.h"
+#include "tq_port.h"
+#include "tq_trace.h"
+#include "tq_sim.h"
+#include "hw_debug.h"
+
+/*
+  Virtual time port, see tq_sim.h. Like the POSIX port interrupts are kept
+  pending and serviced when interrupts get enabled. Nothing here reads the
+  host clock, the same script gives the same run.
+
+  STANDBY is a jump back into tinyq_run() at the wakeup, after the reset
+  latency and the boot, warm or cold. The retained words and the file
+  scope variables of Qties live on, the kernel context starts over.
+*/
+
+#define SIM_US_PER_TICK                     (_PT_TIMESTAMP_FREQ / _PT_SLEEP_TIMER_TICK_PER_SECOND)
+
+struct SIM_EVENT
+{
+  TQ_SIM_TIME time;
+  uint8  irq;
+  boolean recorded;
+  uint32 arg;
+};
+
+static void service_pending_irqs(void);
+static boolean raise_irq(TQ_SIM_TIME time, uint8 irq, uint32 arg, boolean recorded);
+static boolean timer_due(void);
+static boolean event_due(void);
+static void sleep_until(uint8 mode, TQ_SIM_TIME next);
+
+#if TQ_SIM_SLEEP_MODES != QTI_SYSTEM_SLEEP_MODES
+#error "TQ_SIM_SLEEP_MODES out of step with qti_system.h"
+#endif
+
+/* sleep timer ticks, the same costs as the STM32F030 port */
+const struct QTI_SYSTEM_SLEEP_MODE tq_port_sleep_modes[QTI_SYSTEM_SLEEP_MODES] =
+{
+  {0, 0},
+  {1, 8},
+  {4, 4000},
+};
+
+static _PT_THREAD_LOCAL TQ_SIM_TIME _now;
+static _PT_THREAD_LOCAL TQ_SIM_TIME _end;
+static _PT_THREAD_LOCAL jmp_buf _end_jump;
+static _PT_THREAD_LOCAL jmp_buf _reset_jump;
+
+static _PT_THREAD_LOCAL boolean _irq_disabled = FALSE;
+static _PT_THREAD_LOCAL boolean _irq_active = FALSE;
+static _PT_THREAD_LOCAL boolean _dispatch_pending = FALSE;
+static _PT_THREAD_LOCAL boolean _dispatch_active = FALSE;
+
+static _PT_THREAD_LOCAL boolean _timer_running = FALSE;
+static _PT_THREAD_LOCAL boolean _timer_armed = FALSE;               /* the alarm fires once */
+static _PT_THREAD_LOCAL TQ_SIM_TIME _timer_ref;                     /* in sleep timer ticks */
+static _PT_THREAD_LOCAL TQ_SIM_TIME _timer_alarm;
+static _PT_THREAD_LOCAL uint32 _timer_expiries;
+
+static _PT_THREAD_LOCAL TQ_SIM_IRQ_HANDLER _irq_handlers[TQ_SIM_IRQS];
+static _PT_THREAD_LOCAL struct SIM_EVENT _events[TQ_SIM_EVENTS];
+static _PT_THREAD_LOCAL uint16 _event_count;
+
+static _PT_THREAD_LOCAL boolean _warm_boot = TRUE;
+static _PT_THREAD_LOCAL uint32 _retained[_PT_RETAINED_WORDS];
+static _PT_THREAD_LOCAL uint8 _retained_words;                      /* left by the last STANDBY, until resumed */
+static _PT_THREAD_LOCAL TQ_SIM_TIME _standby_entry;
+static _PT_THREAD_LOCAL TQ_SIM_TIME _wake;
+static _PT_THREAD_LOCAL struct TQ_SIM_SLEEP_STATS _sleep_stats;
+
+
+void tq_port_init(void)
+{
+  _timer_running = FALSE;
+  _timer_armed = FALSE;
+}
+
+void tq_port_us_delay(uint32 us)
+{
+  tq_sim_consume(us);
+}
+
+void tq_port_system_reset(void)
+{
+  exit(EXIT_FAILURE);
+}
+
+uint32 tq_port_timestamp(void)
+{
+  return (uint32)_now;
+}
+
+void tq_port_disable_irq(void)
+{
+  _irq_disabled = TRUE;
+}
+
+void tq_port_enable_irq(void)
+{
+  _irq_disabled = FALSE;
+  service_pending_irqs();
+}
+
+uint32 tq_port_irq_save(void)
+{
+  uint32 state = _irq_disabled;
+
+  _irq_disabled = TRUE;
+  return state;
+}
+
+void tq_port_irq_restore(uint32 state)
+{
+  if(!state)
+    tq_port_enable_irq();
+}
+
+boolean tq_port_in_isr(void)
+{
+  return (_irq_active && !_dispatch_active) ? TRUE : FALSE;
+}
+
+void tq_port_trigger_high_priority_dispatch(void)
+{
+  _dispatch_pending = TRUE;
+}
+
+/* jumps to the next alarm or scripted interrupt, the run ends when there is none before the end */
+uint8 tq_port_sleep(uint8 mode)
+{
+  TQ_SIM_TIME next;
+  uint8 cause;
+  boolean recorded = FALSE;
+
+  if(event_due())
+    return QTI_SYSTEM_WAKEUP_EXTI;
+  if(timer_due())
+    return QTI_SYSTEM_WAKEUP_RTC;
+  if(_dispatch_pending)
+    return QTI_SYSTEM_WAKEUP_OTHER;
+
+  next = _end + 1;
+  cause = QTI_SYSTEM_WAKEUP_OTHER;
+  if(_timer_armed)
+  {
+    next = _timer_alarm * SIM_US_PER_TICK;
+    cause = QTI_SYSTEM_WAKEUP_RTC;
+  }
+  if(_event_count && _events[0].time < next)
+  {
+    next = _events[0].time;
+    cause = QTI_SYSTEM_WAKEUP_EXTI;
+    recorded = _events[0].recorded;
+  }
+
+  sleep_until(mode, next);
+  if(mode != QTI_SYSTEM_SLEEP_WFI && !recorded)
+    _now += tq_port_sleep_modes[mode].wakeup_latency * SIM_US_PER_TICK;
+  return cause;
+}
+
+/* the same wakeups as a sleep, a scripted interrupt stands for a wakeup pin, then the reset */
+boolean tq_port_standby(const uint32 *retained, uint8 words, uint32 ticks)
+{
+  TQ_SIM_TIME next = _end + 1;
+
+  TQ_ASSERT(words <= _PT_RETAINED_WORDS);
+  if(event_due() || timer_due() || _dispatch_pending)
+    return FALSE;
+
+  memcpy(_retained, retained, words * sizeof(uint32));
+  _retained_words = words;
+  _standby_entry = _now;
+
+  if(ticks)
+    next = (_now / SIM_US_PER_TICK + ticks) * SIM_US_PER_TICK;
+  if(_event_count && _events[0].time < next)
+    next = _events[0].time;
+  sleep_until(QTI_SYSTEM_SLEEP_STANDBY, next);
+
+  _wake = _now;
+  _now += tq_port_sleep_modes[QTI_SYSTEM_SLEEP_STANDBY].wakeup_latency * SIM_US_PER_TICK;
+  _now += _warm_boot ? TQ_SIM_WARM_BOOT_US : TQ_SIM_COLD_BOOT_US;
+  _sleep_stats.booting += _now - _wake;
+  if(_warm_boot)
+    _sleep_stats.warm_boots++;
+  else
+    _sleep_stats.cold_boots++;
+  if(_now > _end)
+  {
+    _now = _end;
+    longjmp(_end_jump, 1);
+  }
+
+  _irq_disabled = FALSE;
+  _irq_active = FALSE;
+  _dispatch_pending = FALSE;
+  _dispatch_active = FALSE;
+  _timer_running = FALSE;
+  _timer_armed = FALSE;
+  longjmp(_reset_jump, 1);
+  return FALSE;
+}
+
+/* the RTC ran on, a cold boot forgets the words */
+uint8 tq_port_resume(uint32 *retained, uint32 *slept)
+{
+  uint8 words = _warm_boot ? _retained_words : 0;
+
+  _retained_words = 0;
+  if(!words)
+    return 0;
+
+  memcpy(retained, _retained, words * sizeof(uint32));
+  *slept = (uint32)(_now / SIM_US_PER_TICK - _standby_entry / SIM_US_PER_TICK);
+  return words;
+}
+
+static void sleep_until(uint8 mode, TQ_SIM_TIME next)
+{
+  TQ_SIM_TIME wake = (next > _end) ? _end : next;
+
+  _sleep_stats.asleep[mode] += wake - _now;
+  _sleep_stats.sleeps[mode]++;
+  _now = wake;
+  if(next > _end)
+    longjmp(_end_jump, 1);
+}
+
+static boolean timer_due(void)
+{
+  return (_timer_armed && _now >= _timer_alarm * SIM_US_PER_TICK) ? TRUE : FALSE;
+}
+
+static boolean event_due(void)
+{
+  return (_event_count && _now >= _events[0].time) ? TRUE : FALSE;
+}
+
+static void service_pending_irqs(void)
+{
+  struct SIM_EVENT event;
+  uint16 i;
+
+  if(_irq_active)
+    return;
+
+  _irq_active = TRUE;
+  while(!_irq_disabled)
+  {
+    if(event_due())
+    {
+      event = _events[0];
+      _event_count--;
+      for(i = 0; i < _event_count; i++)
+        _events[i] = _events[i + 1];
+
+      TQ_TRACE_EVENT(TQ_TRACE_EVT_EXTI, event.irq, 0, 0);
+      if(_irq_handlers[event.irq])
+        _irq_handlers[event.irq](event.irq, event.arg);
+    }
+    else if(timer_due())
+    {
+      _timer_armed = FALSE;
+      _timer_expiries++;
+      _system_sleep_timer_handler();
+    }
+    else if(_dispatch_pending)
+    {
+      _dispatch_pending = FALSE;
+      _dispatch_active = TRUE;
+      _tq_high_priority_dispatch();
+      _dispatch_active = FALSE;
+    }
+    else
+      break;
+  }
+  _irq_active = FALSE;
+}
+
+/* sleep timer on the virtual clock */
+uint32 tq_port_sleep_timer_get_time_elapsed(boolean update)
+{
+  TQ_SIM_TIME now = _now / SIM_US_PER_TICK;
+  uint32 period;
+
+  if(!_timer_running)
+    return 0;
+
+  period = (uint32)(now - _timer_ref);
+  if(update)
+    _timer_ref = now;
+
+  return period;
+}
+
+void tq_port_sleep_timer_start(int32 ticks)
+{
+  TQ_ASSERT(ticks > 0);
+
+  ticks = (ticks > _PT_SLEEP_TIMER_PERIOD_MAX) ? _PT_SLEEP_TIMER_PERIOD_MAX : ticks;
+  ticks = (ticks < 4) ? 4 : ticks;  // same minimum as the RTC alarm
+
+  _timer_ref = _now / SIM_US_PER_TICK;
+  _timer_alarm = _timer_ref + ticks;
+  _timer_running = TRUE;
+  _timer_armed = TRUE;
+}
+
+void tq_port_sleep_timer_stop(void)
+{
+  _timer_running = FALSE;
+  _timer_armed = FALSE;
+}
+
+/* simulation interface */
+void tq_sim_set_irq_handler(uint8 irq, TQ_SIM_IRQ_HANDLER handler)
+{
+  TQ_ASSERT(irq < TQ_SIM_IRQS);
+  _irq_handlers[irq] = handler;
+}
+
+boolean tq_sim_raise_irq(TQ_SIM_TIME time, uint8 irq, uint32 arg)
+{
+  return raise_irq(time, irq, arg, FALSE);
+}
+
+/* a recorded time is when the handler ran on the device, the wakeup latency is already in it */
+boolean tq_sim_raise_recorded_irq(TQ_SIM_TIME time, uint8 irq, uint32 arg)
+{
+  return raise_irq(time, irq, arg, TRUE);
+}
+
+/* events at the same time keep the order they were raised in */
+static boolean raise_irq(TQ_SIM_TIME time, uint8 irq, uint32 arg, boolean recorded)
+{
+  uint16 i;
+
+  TQ_ASSERT(irq < TQ_SIM_IRQS);
+  if(_event_count >= TQ_SIM_EVENTS)
+    return FALSE;
+
+  for(i = _event_count; i > 0 && _events[i - 1].time > time; i--)
+    _events[i] = _events[i - 1];
+
+  _events[i].time = time;
+  _events[i].irq = irq;
+  _events[i].recorded = recorded;
+  _events[i].arg = arg;
+  _event_count++;
+  return TRUE;
+}
+
+void tq_sim_cancel_irq(uint8 irq)
+{
+  uint16 i, count = 0;
+
+  for(i = 0; i < _event_count; i++)
+  {
+    if(_events[i].irq != irq)
+      _events[count++] = _events[i];
+  }
+  _event_count = count;
+}
+
+TQ_SIM_TIME tq_sim_now(void)
+{
+  return _now;
+}
+
+uint32 tq_sim_timer_expiries(void)
+{
+  return _timer_expiries;
+}
+
+void tq_sim_get_sleep_stats(struct TQ_SIM_SLEEP_STATS *stats)
+{
+  *stats = _sleep_stats;
+}
+
+void tq_sim_set_warm_boot(boolean warm)
+{
+  _warm_boot = warm;
+}
+
+TQ_SIM_TIME tq_sim_wake_time(void)
+{
+  return _wake;
+}
+
+/* models code run time, interrupts falling due in between are taken afterwards, a system never idle ends too */
+void tq_sim_consume(uint32 us)
+{
+  _now += us;
+  if(_end && _now > _end)
+  {
+    _now = _end;
+    longjmp(_end_jump, 1);
+  }
+  if(!_irq_disabled)
+    service_pending_irqs();
+}
+
+/* runs tinyq until the virtual time end, once per process, a STANDBY runs it again */
+void tq_sim_run(TQ_SIM_TIME end)
+{
+  _end = end;
+  if(!setjmp(_end_jump))
+  {
+    setjmp(_reset_jump);
+    tinyq_run();
+  }
+
+  _irq_disabled = FALSE;
+}
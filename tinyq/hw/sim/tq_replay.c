@@ -0,0 +1,178 @@
+/****************************************************************************
+  tq_replay.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <stdio.h>
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "tq_record.h"
+#include "tq_sim.h"
+#include "tq_replay.h"
+
+/* dump layout of struct TQ_RECORD_BUFFER */
+#define DUMP_HEADER_SIZE                    (20)
+
+#define REPLAY_UNMAPPED                     (0xff)
+
+/* recorded alarms waiting to be matched, a power of 2 */
+#define REPLAY_ALARMS                       (64)
+
+static void schedule_next(void);
+static void check_alarms(TQ_SIM_TIME now);
+static void replay_irq(uint8 irq, uint32 arg);
+static void replay_item(const uint8 *item);
+
+static const uint8 *_data;
+static uint32 _used;
+static uint32 _offset;
+static uint32 _freq;
+static uint32 _last_time;
+static TQ_SIM_TIME _ticks;                          /* recorded time, unwrapped */
+
+static uint8 _irq;
+static uint8 _exti_irqs[16];
+static TQ_SIM_TIME _alarms[REPLAY_ALARMS];
+static uint32 _alarms_checked;
+static struct TQ_REPLAY_STATS _stats;
+
+
+static uint32 get_u32(const uint8 *p)
+{
+  return p[0] | (p[1] << 8) | ((uint32)p[2] << 16) | ((uint32)p[3] << 24);
+}
+
+boolean tq_replay_load(const void *dump, uint32 size)
+{
+  const uint8 *p = dump;
+
+  if(size < DUMP_HEADER_SIZE || get_u32(p) != TQ_RECORD_MAGIC)
+    return FALSE;
+
+  _freq = get_u32(&p[4]);
+  _used = get_u32(&p[12]);
+  if(!_freq || _used > size - DUMP_HEADER_SIZE)
+    return FALSE;
+
+  memset(&_stats, 0, sizeof(_stats));
+  memset(_exti_irqs, REPLAY_UNMAPPED, sizeof(_exti_irqs));
+  _stats.dropped = get_u32(&p[16]);
+  _data = &p[DUMP_HEADER_SIZE];
+  _offset = 0;
+  _last_time = 0;
+  _ticks = 0;
+  _alarms_checked = 0;
+  return TRUE;
+}
+
+void tq_replay_map_exti(uint8 line, uint8 irq)
+{
+  TQ_ASSERT(line < 16);
+  _exti_irqs[line] = irq;
+}
+
+/* replays on interrupt line irq from virtual time 0, the recorder starts with tinyq_run() too */
+void tq_replay_start(uint8 irq)
+{
+  _irq = irq;
+  tq_sim_set_irq_handler(irq, replay_irq);
+  schedule_next();
+}
+
+void tq_replay_get_stats(struct TQ_REPLAY_STATS *stats)
+{
+  uint32 expiries;
+
+  check_alarms(tq_sim_now());
+  expiries = tq_sim_timer_expiries();
+  *stats = _stats;
+  if(expiries > _stats.timers - _stats.timers_missed)
+    stats->timers_extra = expiries - (_stats.timers - _stats.timers_missed);
+}
+
+static void schedule_next(void)
+{
+  uint32 time;
+
+  if(_offset + TQ_RECORD_ITEM_SIZE > _used)
+  {
+    _stats.finished = TRUE;
+    return;
+  }
+
+  time = get_u32(&_data[_offset]);
+  _ticks += (uint32)(time - _last_time);
+  _last_time = time;
+  tq_sim_raise_recorded_irq(_ticks * 1000000 / _freq, _irq, 0);
+}
+
+/*
+  Checked lazily at the next stimulus, a checkpoint interrupt of its own
+  would wake the system where the device did not. One missing alarm is
+  counted once, later alarms compare against what the replay did.
+*/
+static void check_alarms(TQ_SIM_TIME now)
+{
+  while(_alarms_checked < _stats.timers &&
+        _alarms[_alarms_checked & (REPLAY_ALARMS - 1)] + TQ_REPLAY_TIMER_TOLERANCE <= now)
+  {
+    _alarms_checked++;
+    if(tq_sim_timer_expiries() + _stats.timers_missed < _alarms_checked)
+    {
+      _stats.timers_missed++;
+      fprintf(stderr, "replay: sleep timer alarm %u at %.6fs missing\n", _alarms_checked,
+              _alarms[(_alarms_checked - 1) & (REPLAY_ALARMS - 1)] / 1e6);
+    }
+  }
+}
+
+/* a field is read only once the recording is known to hold it, a truncated item ends the replay */
+static void replay_irq(uint8 irq, uint32 arg)
+{
+  const uint8 *item;
+  uint32 size = TQ_RECORD_ITEM_SIZE;
+
+  check_alarms(tq_sim_now());
+  item = &_data[_offset];
+  if(_offset + size <= _used && item[4] == TQ_RECORD_SIGNAL)
+    size += (_offset + size < _used) ? 1 + item[8] : 1;
+  if(_offset + size > _used)
+  {
+    _stats.finished = TRUE;
+    return;
+  }
+  _offset += size;
+
+  replay_item(item);
+  schedule_next();
+}
+
+static void replay_item(const uint8 *item)
+{
+  switch(item[4])
+  {
+    case TQ_RECORD_EXTI:
+      if(item[5] < 16 && _exti_irqs[item[5]] != REPLAY_UNMAPPED)
+      {
+        _stats.extis++;
+        tq_sim_raise_irq(tq_sim_now(), _exti_irqs[item[5]], item[6]);
+      }
+      else
+        _stats.unmapped++;
+      break;
+
+    case TQ_RECORD_TIMER:
+      /* more unmatched alarms than the ring holds drops the oldest unchecked */
+      if(_stats.timers - _alarms_checked >= REPLAY_ALARMS)
+        _alarms_checked++;
+      _alarms[_stats.timers & (REPLAY_ALARMS - 1)] = tq_sim_now();
+      _stats.timers++;
+      break;
+
+    case TQ_RECORD_SIGNAL:
+      _stats.signals++;
+      tinyq_send_signal(item[5], item[6], item[7], &item[9], item[8]);
+      break;
+  }
+}
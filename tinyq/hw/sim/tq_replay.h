@@ -0,0 +1,38 @@
+/****************************************************************************
+  tq_replay.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_REPLAY_H
+#define TQ_REPLAY_H
+
+/*
+  Plays a dump of tq_record_buffer (tq_record.h) back on the virtual time
+  port. Stimuli come in at their recorded times: EXTI edges raise the mapped
+  interrupt line with the pin level as arg, recorded signals are sent from
+  interrupt context. Recorded sleep timer alarms are checkpoints, an alarm
+  the replay has not reproduced TQ_REPLAY_TIMER_TOLERANCE later is counted
+  as missed.
+*/
+
+#ifndef TQ_REPLAY_TIMER_TOLERANCE
+#define TQ_REPLAY_TIMER_TOLERANCE           (1000)          /* virtual us */
+#endif
+
+struct TQ_REPLAY_STATS
+{
+  uint32 extis;
+  uint32 unmapped;              /* EXTI edges on lines without an interrupt */
+  uint32 signals;
+  uint32 timers;
+  uint32 timers_missed;
+  uint32 timers_extra;
+  uint32 dropped;               /* stimuli the recorder had no room for */
+  boolean finished;
+};
+
+extern boolean tq_replay_load(const void *dump, uint32 size);
+extern void tq_replay_map_exti(uint8 line, uint8 irq);
+extern void tq_replay_start(uint8 irq);
+extern void tq_replay_get_stats(struct TQ_REPLAY_STATS *stats);
+
+#endif
@@ -0,0 +1,67 @@
+/****************************************************************************
+  tq_sim.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TQ_SIM_H
+#define TQ_SIM_H
+
+/*
+  Deterministic simulation port. Time is virtual and only moves when the
+  system sleeps, jumping to the next alarm or scripted interrupt, or when
+  code calls tq_sim_consume() / tq_port_us_delay() to model its own run time.
+  Interrupt lines are numbered by the application, a raised line runs its
+  handler at the given virtual time with interrupt priority: before the
+  sleep timer and high priority dispatch, never while interrupts are
+  disabled.
+*/
+
+#ifndef TQ_SIM_IRQS
+#define TQ_SIM_IRQS                         (16)
+#endif
+
+#ifndef TQ_SIM_EVENTS
+#define TQ_SIM_EVENTS                       (256)
+#endif
+
+/* boot out of STANDBY after the reset latency, warm skips the RTC domain reset and calendar */
+#ifndef TQ_SIM_WARM_BOOT_US
+#define TQ_SIM_WARM_BOOT_US                 (50)
+#endif
+
+#ifndef TQ_SIM_COLD_BOOT_US
+#define TQ_SIM_COLD_BOOT_US                 (300)
+#endif
+
+#define TQ_SIM_SLEEP_MODES                  (3)             /* QTI_SYSTEM_SLEEP_MODES */
+
+/* conventional arg of DMA lines */
+#define TQ_SIM_DMA_HALF                     (1)
+#define TQ_SIM_DMA_FULL                     (2)
+
+typedef unsigned long long  TQ_SIM_TIME;            /* virtual microseconds */
+typedef void (*TQ_SIM_IRQ_HANDLER)(uint8 irq, uint32 arg);
+
+/* over the whole run, kept over STANDBY resets */
+struct TQ_SIM_SLEEP_STATS
+{
+  TQ_SIM_TIME asleep[TQ_SIM_SLEEP_MODES];   /* from sleep to the wakeup event */
+  uint32 sleeps[TQ_SIM_SLEEP_MODES];
+  uint32 warm_boots;
+  uint32 cold_boots;
+  TQ_SIM_TIME booting;                      /* from a STANDBY wakeup event to tinyq_run() */
+};
+
+extern void tq_sim_set_irq_handler(uint8 irq, TQ_SIM_IRQ_HANDLER handler);
+extern boolean tq_sim_raise_irq(TQ_SIM_TIME time, uint8 irq, uint32 arg);
+extern boolean tq_sim_raise_recorded_irq(TQ_SIM_TIME time, uint8 irq, uint32 arg);
+extern void tq_sim_cancel_irq(uint8 irq);
+
+extern TQ_SIM_TIME tq_sim_now(void);
+extern uint32 tq_sim_timer_expiries(void);
+extern void tq_sim_get_sleep_stats(struct TQ_SIM_SLEEP_STATS *stats);
+extern void tq_sim_set_warm_boot(boolean warm);     /* FALSE: STANDBY resets boot cold, SYSTEM_NTF_START */
+extern TQ_SIM_TIME tq_sim_wake_time(void);          /* of the last STANDBY */
+extern void tq_sim_consume(uint32 us);
+extern void tq_sim_run(TQ_SIM_TIME end);
+
+#endif
@@ -0,0 +1,104 @@
+/****************************************************************************
+  hw_adc.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "hw_adc.h"
+#include "hw_dma.h"
+#include "stm32f0xx.h"
+#include "stm32f0xx_rcc.h"
+#include "stm32f0xx_dma.h"
+#include "stm32f0xx_adc.h"
+#include "stm32f0xx_tim.h"
+#include "stm32f0xx_syscfg.h"
+
+#define ADC_DMA_CHANNEL                     (2)
+#define ADC_DMA                             (DMA1_Channel2)
+#define ADC_TIM                             (TIM15)
+#define ADC_TIM_CLK_FREQ                    (8 * 1000 * 1000)
+#define ADC_TIM_TICK_FREQ                   (1000 * 1000)
+
+static void dma_irq(uint8 flags);
+
+static const uint16 *_buffer;
+static uint16 _half;
+static HW_ADC_IRQ_HANDLER _handler;
+
+
+void hw_adc_start(uint32 channels, uint32 rate, uint16 *buffer, uint16 size, HW_ADC_IRQ_HANDLER handler)
+{
+  ADC_InitTypeDef ADC_InitStructure;
+  DMA_InitTypeDef DMA_InitStructure;
+
+  TQ_ASSERT(rate >= ADC_TIM_TICK_FREQ / 0x10000 && rate <= ADC_TIM_TICK_FREQ / 2);
+
+  _buffer = buffer;
+  _half = size / 2;
+  _handler = handler;
+
+  RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1 | RCC_APB2Periph_TIM15 | RCC_APB2Periph_SYSCFG, ENABLE);
+  SYSCFG_DMAChannelRemapConfig(SYSCFG_DMARemap_ADC1, ENABLE);
+
+  /* channel 1 is the buzzer's */
+  DMA_DeInit(ADC_DMA);
+  DMA_StructInit(&DMA_InitStructure);
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ADC1->DR;
+  DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)buffer;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+  DMA_InitStructure.DMA_BufferSize = size;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_HalfWord;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_High;
+  DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+  DMA_Init(ADC_DMA, &DMA_InitStructure);
+  DMA_ITConfig(ADC_DMA, DMA_IT_HT | DMA_IT_TC, ENABLE);
+  DMA_Cmd(ADC_DMA, ENABLE);
+
+  ADC_DeInit(ADC1);
+  ADC_ClockModeConfig(ADC1, ADC_ClockMode_SynClkDiv2);
+  ADC_GetCalibrationFactor(ADC1);
+  ADC_StructInit(&ADC_InitStructure);
+  ADC_InitStructure.ADC_ExternalTrigConvEdge = ADC_ExternalTrigConvEdge_Rising;
+  ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_T15_TRGO;
+  ADC_Init(ADC1, &ADC_InitStructure);
+  ADC_ChannelConfig(ADC1, channels, ADC_SampleTime_55_5Cycles);
+  ADC_DMARequestModeConfig(ADC1, ADC_DMAMode_Circular);
+  ADC_DMACmd(ADC1, ENABLE);
+  ADC_Cmd(ADC1, ENABLE);
+  while(!ADC_GetFlagStatus(ADC1, ADC_FLAG_ADRDY));
+  ADC_StartOfConversion(ADC1);
+
+  hw_dma_set_handler(ADC_DMA_CHANNEL, dma_irq);
+
+  /* update at rate, a trigger per update */
+  ADC_TIM->PSC = ADC_TIM_CLK_FREQ / ADC_TIM_TICK_FREQ - 1;
+  ADC_TIM->ARR = ADC_TIM_TICK_FREQ / rate - 1;
+  ADC_TIM->CR2 = TIM_TRGOSource_Update;
+  ADC_TIM->EGR = TIM_EGR_UG;
+  ADC_TIM->CR1 |= TIM_CR1_CEN;
+}
+
+void hw_adc_stop(void)
+{
+  ADC_TIM->CR1 &= (~TIM_CR1_CEN);
+  ADC_StopOfConversion(ADC1);
+  ADC_Cmd(ADC1, DISABLE);
+  DMA_Cmd(ADC_DMA, DISABLE);
+
+  hw_dma_set_handler(ADC_DMA_CHANNEL, 0);
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1 | RCC_APB2Periph_TIM15, DISABLE);
+}
+
+static void dma_irq(uint8 flags)
+{
+  if(flags & HW_DMA_HT)
+    _handler(_buffer, _half);
+  if(flags & HW_DMA_TC)
+    _handler(_buffer + _half, _half);
+}
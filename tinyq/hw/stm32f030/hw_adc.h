@@ -0,0 +1,21 @@
+/****************************************************************************
+  hw_adc.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_ADC_H
+#define HW_ADC_H
+
+/*
+  ADC1 converting a sequence of channels in ascending order on every
+  update of TIM15, rate sequences a second. A circular DMA on channel 2
+  fills the buffer, the handler gets each half in interrupt context as it
+  completes, the other half fills meanwhile. The size is a whole number of
+  sequences per half.
+*/
+
+typedef void (*HW_ADC_IRQ_HANDLER)(const uint16 *samples, uint16 count);
+
+extern void hw_adc_start(uint32 channels, uint32 rate, uint16 *buffer, uint16 size, HW_ADC_IRQ_HANDLER handler);
+extern void hw_adc_stop(void);
+
+#endif
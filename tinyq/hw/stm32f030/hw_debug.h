@@ -34,6 +34,7 @@
 #define DEBUG_PIN_TINYQ_NORMAL_EVT                  TQ_DEBUG_PIN_NONE
 #define DEBUG_PIN_TINYQ_HIGH_EVT                    TQ_DEBUG_PIN_NONE
 #define DEBUG_PIN_TINYQ_SLEEP                       TQ_DEBUG_PIN_NONE
+#define DEBUG_PIN_TINYQ_LOCK_BUDGET                 TQ_DEBUG_PIN_2
 
 #define DEBUG_PIN_SAMPLE                            TQ_DEBUG_PIN_1
 
@@ -0,0 +1,70 @@
+/****************************************************************************
+  hw_dma.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "hw_dma.h"
+#include "stm32f0xx.h"
+#include "stm32f0xx_misc.h"
+
+#define DMA_FIRST_CHANNEL                   (2)
+#define DMA_CHANNELS                        (4)             /* 2 to 5 */
+#define DMA_CHANNEL_FLAGS(ISR, CHANNEL)     (((ISR) >> (4 * ((CHANNEL) - 1))) & 0x0f)
+#define DMA_CCR_IE                          (DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE)    /* at the positions of the flags */
+
+static void dispatch(uint8 first);
+
+static HW_DMA_IRQ_HANDLER _handlers[DMA_CHANNELS];
+static DMA_Channel_TypeDef * const _channels[DMA_CHANNELS] =
+{
+  DMA1_Channel2, DMA1_Channel3, DMA1_Channel4, DMA1_Channel5,
+};
+
+
+void hw_dma_set_handler(uint8 channel, HW_DMA_IRQ_HANDLER handler)
+{
+  NVIC_InitTypeDef NVIC_InitStructure;
+  uint8 index = channel - DMA_FIRST_CHANNEL;
+  uint8 pair = index & (~1);
+
+  TQ_ASSERT(channel >= DMA_FIRST_CHANNEL && index < DMA_CHANNELS);
+
+  _handlers[index] = handler;
+
+  NVIC_InitStructure.NVIC_IRQChannel = pair ? DMA1_Channel4_5_IRQn : DMA1_Channel2_3_IRQn;
+  NVIC_InitStructure.NVIC_IRQChannelPriority = HW_DMA_IRQ_PRIORITY;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = (_handlers[pair] || _handlers[pair + 1]) ? ENABLE : DISABLE;
+  NVIC_Init(&NVIC_InitStructure);
+}
+
+/*
+  The flags of both channels of the vector with their interrupt enabled,
+  each cleared before its handler. Those of a channel polled are left.
+*/
+static void dispatch(uint8 first)
+{
+  uint32 isr = DMA1->ISR;
+  uint8 channel, flags;
+
+  for(channel = first; channel < first + 2; channel++)
+  {
+    flags = DMA_CHANNEL_FLAGS(isr, channel) & (_channels[channel - DMA_FIRST_CHANNEL]->CCR & DMA_CCR_IE);
+    if(!flags)
+      continue;
+    DMA1->IFCR = (uint32)flags << (4 * (channel - 1));
+    if(_handlers[channel - DMA_FIRST_CHANNEL])
+      _handlers[channel - DMA_FIRST_CHANNEL](flags);
+  }
+}
+
+void DMA1_Channel2_3_IRQHandler(void)
+{
+  dispatch(2);
+}
+
+void DMA1_Channel4_5_IRQHandler(void)
+{
+  dispatch(4);
+}
@@ -0,0 +1,28 @@
+/****************************************************************************
+  hw_dma.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_DMA_H
+#define HW_DMA_H
+
+/*
+  The shared DMA1 vectors, channels 2 and 3 on one, 4 and 5 on the other.
+  Each channel has a handler of its own, called in interrupt context with
+  the flags of that channel its interrupts are enabled for, cleared
+  already. The vector is enabled while a handler of either channel is
+  set, at HW_DMA_IRQ_PRIORITY. Channel 1 has a vector to itself and is
+  not served here.
+*/
+#define HW_DMA_IRQ_PRIORITY                 (2)
+
+/* flags of a channel */
+#define HW_DMA_TC                           (0x02)          /* transfer complete */
+#define HW_DMA_HT                           (0x04)          /* half transfer */
+#define HW_DMA_TE                           (0x08)          /* transfer error */
+
+typedef void (*HW_DMA_IRQ_HANDLER)(uint8 flags);
+
+/* 0 as handler clears it */
+extern void hw_dma_set_handler(uint8 channel, HW_DMA_IRQ_HANDLER handler);
+
+#endif
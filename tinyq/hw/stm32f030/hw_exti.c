@@ -3,10 +3,13 @@
   Copyright (c) 2017 - 2018, Xiaofu Yan.  All rights reserved.
 ****************************************************************************/
 #include "tq_types.h"
+#include "tq_port.h"
 #include "tinyq.h"
 #include "qti_system.h"
 #include "hw_debug.h"
 #include "hw_exti.h"
+#include "tq_trace.h"
+#include "tq_record.h"
 #include "stm32f0xx.h"
 #include "stm32f0xx_misc.h"
 #include "stm32f0xx_gpio.h"
@@ -15,25 +18,39 @@
 #include "stm32f0xx_syscfg.h"
 
 
+/* EXTI_PortSourceGPIOx to its GPIO, the ports are 0x400 apart */
+#define EXTI_PORT_GPIO(PORT)          ((GPIO_TypeDef *)(GPIOA_BASE + (PORT) * 0x400UL))
+#define EXTI_ENTRY_USED(ENTRY)        ((ENTRY)->handler || (ENTRY)->qti)
+
+/* the lowest bit set, no CLZ on the M0, a multiply of a de Bruijn sequence, to 32 bits where a long is wider */
+#define EXTI_LOWEST_BIT(BIT)          (_debruijn_position[(uint32)((BIT) * 0x077CB531UL) >> 27])
+
 struct S_STM32_EXTI_ENTRY
 {
   uint8 port;
   uint8 mode;
   uint8 trigger;
   STM32_EXTI_IRQ_HANDLER handler;
+  uint8  qti;                         /* of hw_exti_post(), 0 : none */
+  uint8  sig;
+  uint16 holdoff;                     /* ms */
+  uint8  level;                       /* last posted */
 };
 
+static void set_line(uint8 port, uint8 pin, uint8 trigger, STM32_EXTI_IRQ_HANDLER irq_handler, uint8 qti, uint8 sig,
+                     uint16 holdoff);
 static void config_exti(uint8 pin, struct S_STM32_EXTI_ENTRY *entry);
 static void config_irq(uint8 priority, uint8 channel, boolean enable);
 static void invoke_irqs(uint32 irq_flags);
+static void post_edge(uint8 pin, struct S_STM32_EXTI_ENTRY *entry, boolean settled);
 
 
-static struct S_STM32_EXTI_ENTRY _exti_table[16] =
+static struct S_STM32_EXTI_ENTRY _exti_table[16];
+
+static const uint8 _debruijn_position[32] =
 {
-{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 
-{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 
-{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 
-{0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, 
+  0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+  31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9,
 };
 
 static int8 _exti_0_1_active = 0;
@@ -43,24 +60,87 @@ static int8 _exti_4_15_active = 0;
 
 void hw_exti_set(uint8 port, uint8 pin, uint8 trigger, STM32_EXTI_IRQ_HANDLER irq_handler)
 {
+  set_line(port, pin, trigger, irq_handler, 0, 0, 0);
+}
+
+/* qti 0 turns the line off */
+void hw_exti_post(uint8 port, uint8 pin, uint8 trigger, uint8 qti, uint8 sig, uint16 holdoff)
+{
+  TQ_ASSERT(!qti || TQ_SIG_DISPATCHER(sig) == TQ_DSP_HIGH);
+
+  set_line(port, pin, trigger, 0, qti, sig, holdoff);
+}
+
+/* the Qti posted to, not the interrupt, starts the holdoff of the edge, a line unmasked since has none */
+void hw_exti_holdoff(const struct S_STM32_EXTI_EDGE *edge)
+{
+  struct S_STM32_EXTI_ENTRY *entry;
+  uint32 elapsed;                     /* ms */
+
+  if(edge->line >= 16)
+    return;
+  entry = &_exti_table[edge->line];
+  if(!entry->qti || !entry->holdoff || (EXTI->IMR & (1UL << edge->line)))
+    return;
+
+  elapsed = (tq_port_timestamp() - edge->timestamp) / (_PT_TIMESTAMP_FREQ / 1000);
+  qti_system_start_timer(entry->qti, HW_EXTI_TIMER_ID(edge->line),
+                         (elapsed < entry->holdoff) ? entry->holdoff - elapsed : 1);
+}
+
+/* TRUE when the timer is one of a holdoff, a line turned off since takes it too */
+boolean hw_exti_timer_expired(uint16 timer_id)
+{
+  struct S_STM32_EXTI_ENTRY *entry;
+  uint32 bit;
+  uint8 pin;
+
+  if(timer_id < HW_EXTI_TIMER_BASE || timer_id >= HW_EXTI_TIMER_ID(16))
+    return FALSE;
+
+  pin = timer_id - HW_EXTI_TIMER_BASE;
+  bit = 1UL << pin;
+  entry = &_exti_table[pin];
+
+  qti_system_lock();
+  if(entry->qti && entry->holdoff && !(EXTI->IMR & bit))
+  {
+    EXTI->PR = bit;
+    EXTI->IMR |= bit;
+    if(((EXTI_PORT_GPIO(entry->port)->IDR >> pin) & 1) != entry->level)
+      post_edge(pin, entry, TRUE);
+  }
+  qti_system_unlock();
+  return TRUE;
+}
+
+static void set_line(uint8 port, uint8 pin, uint8 trigger, STM32_EXTI_IRQ_HANDLER irq_handler, uint8 qti, uint8 sig,
+                     uint16 holdoff)
+{
+  struct S_STM32_EXTI_ENTRY *entry = &_exti_table[pin];
+  boolean used = (irq_handler || qti);
   int8 i, last;
   TQ_ASSERT(pin < 16);
   
   qti_system_lock();
   
-  if(_exti_table[pin].handler && !irq_handler)
+  if(EXTI_ENTRY_USED(entry) && !used)
     i = -1;
-  else if(!_exti_table[pin].handler && irq_handler)
+  else if(!EXTI_ENTRY_USED(entry) && used)
     i = 1;
   else
     i = 0;
   
-  _exti_table[pin].mode = EXTI_Mode_Interrupt;
-  _exti_table[pin].port = port;
-  _exti_table[pin].trigger = trigger;
-  _exti_table[pin].handler = irq_handler;
+  entry->mode = EXTI_Mode_Interrupt;
+  entry->port = port;
+  entry->trigger = trigger;
+  entry->handler = irq_handler;
+  entry->qti = qti;
+  entry->sig = sig;
+  entry->holdoff = holdoff;
+  entry->level = (EXTI_PORT_GPIO(port)->IDR >> pin) & 1;
   
-  config_exti(pin, &_exti_table[pin]);
+  config_exti(pin, entry);
   
   if(pin == 0 || pin == 1)
   {
@@ -91,13 +171,13 @@ static void config_exti(uint8 pin, struct S_STM32_EXTI_ENTRY *entry)
 {
   EXTI_InitTypeDef    EXTI_InitStructure;
 
-  if(entry->handler)
+  if(EXTI_ENTRY_USED(entry))
     SYSCFG_EXTILineConfig(entry->port, pin);
   
   EXTI_InitStructure.EXTI_Line = (1UL) << pin;
   EXTI_InitStructure.EXTI_Mode = (EXTIMode_TypeDef)entry->mode;
   EXTI_InitStructure.EXTI_Trigger = (EXTITrigger_TypeDef)entry->trigger;
-  EXTI_InitStructure.EXTI_LineCmd = entry->handler ? ENABLE : DISABLE;
+  EXTI_InitStructure.EXTI_LineCmd = EXTI_ENTRY_USED(entry) ? ENABLE : DISABLE;
   EXTI_Init(&EXTI_InitStructure);
 }
 
@@ -111,37 +191,60 @@ static void config_irq(uint8 priority, uint8 channel, boolean enable)
   NVIC_Init(&NVIC_InitStructure);
 }
 
+/* pending bits of masked lines in a holdoff are left for later */
 void EXTI0_1_IRQHandler(void)
 {
-  invoke_irqs(EXTI->PR & 0x0003);
+  invoke_irqs(EXTI->PR & EXTI->IMR & 0x0003);
 }
 
 void EXTI2_3_IRQHandler(void)
 {
-  invoke_irqs(EXTI->PR & 0x000c);
+  invoke_irqs(EXTI->PR & EXTI->IMR & 0x000c);
 }
 
 void EXTI4_15_IRQHandler(void)
 {
-  invoke_irqs(EXTI->PR & 0xfff0);
+  invoke_irqs(EXTI->PR & EXTI->IMR & 0xfff0);
 }
 
+/* the lines pending only, lowest first */
 static void invoke_irqs(uint32 irq_flags)
 {
+  struct S_STM32_EXTI_ENTRY *entry;
+  uint32 bit;
   uint8 i;
-  uint32 mask = 1;
   
-  for(i = 0; i < 16; i++)
+  while(irq_flags)
   {
-    if(!irq_flags)
-      break;
+    bit = irq_flags & (0 - irq_flags);
+    irq_flags ^= bit;
+    i = EXTI_LOWEST_BIT(bit);
+    entry = &_exti_table[i];
     
-    if((irq_flags & 1) && _exti_table[i].handler)
+    if(EXTI_ENTRY_USED(entry))
     {
-      _exti_table[i].handler();
-      EXTI_ClearITPendingBit(mask);
+      TQ_TRACE_EVENT(TQ_TRACE_EVT_EXTI, i, 0, 0);
+      TQ_RECORD_STIMULUS(TQ_RECORD_EXTI, i, (EXTI_PORT_GPIO(entry->port)->IDR >> i) & 1, 0, 0, 0);
+      if(entry->handler)
+        entry->handler();
+      else
+        post_edge(i, entry, FALSE);
+      EXTI->PR = bit;
     }
-    irq_flags >>= 1;
-    mask <<= 1;
   }
 }
+
+/* from the interrupt or the end of a holdoff, masked for hw_exti_holdoff() */
+static void post_edge(uint8 pin, struct S_STM32_EXTI_ENTRY *entry, boolean settled)
+{
+  struct S_STM32_EXTI_EDGE edge;
+
+  edge.timestamp = tq_port_timestamp();
+  edge.line = pin;
+  edge.level = (EXTI_PORT_GPIO(entry->port)->IDR >> pin) & 1;
+  edge.settled = settled;
+  entry->level = edge.level;
+  if(entry->holdoff)
+    EXTI->IMR &= ~(1UL << pin);
+  tinyq_send_signal(0, entry->qti, entry->sig, &edge, sizeof(edge));
+}
@@ -5,8 +5,36 @@
 #ifndef EXTI_H
 #define EXTI_H
 
+/*
+  A line either calls its handler in the interrupt or, set with
+  hw_exti_post(), posts sig with a struct S_STM32_EXTI_EDGE to a Qti,
+  from QTI_SYSTEM. sig goes to the high priority queue, the Qti is
+  dispatched at once. The signal payload is not aligned, copy it out.
+
+  With a holdoff the line is masked after an edge it posts, a bouncing
+  contact takes one interrupt. The interrupt starts no timer, the Qti
+  hands every edge it gets to hw_exti_holdoff(), which starts a system
+  timer of the Qti, id HW_EXTI_TIMER_ID(pin), for what is left of holdoff
+  ms from the edge. The Qti hands its timers to hw_exti_timer_expired()
+  first, it unmasks the line. If the level then differs from the one
+  posted, it is posted again as settled and held off the same way.
+*/
+#define HW_EXTI_TIMER_BASE            (0xff00)
+#define HW_EXTI_TIMER_ID(PIN)         (HW_EXTI_TIMER_BASE + (PIN))
+
+struct S_STM32_EXTI_EDGE
+{
+  uint32 timestamp;                   /* tq_port_timestamp() of the edge */
+  uint8  line;
+  uint8  level;                       /* of the pin */
+  boolean settled;                    /* the level at the end of a holdoff */
+};
+
 typedef void (*STM32_EXTI_IRQ_HANDLER)(void);
 
 extern void hw_exti_set(uint8 port, uint8 pin, uint8 trigger, STM32_EXTI_IRQ_HANDLER irq_handler);
+extern void hw_exti_post(uint8 port, uint8 pin, uint8 trigger, uint8 qti, uint8 sig, uint16 holdoff);
+extern void hw_exti_holdoff(const struct S_STM32_EXTI_EDGE *edge);
+extern boolean hw_exti_timer_expired(uint16 timer_id);
 
 #endif
@@ -0,0 +1,49 @@
+/****************************************************************************
+  hw_flash.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "hw_flash.h"
+#include "stm32f0xx.h"
+#include "stm32f0xx_flash.h"
+
+#define FLASH_ERRORS                        (FLASH_FLAG_EOP | FLASH_FLAG_PGERR | FLASH_FLAG_WRPERR)
+
+
+boolean hw_flash_erase_page(uint32 address)
+{
+  FLASH_Status status;
+
+  TQ_ASSERT((address & (HW_FLASH_PAGE_SIZE - 1)) == 0);
+
+  FLASH_Unlock();
+  FLASH_ClearFlag(FLASH_ERRORS);
+  status = FLASH_ErasePage(address);
+  FLASH_Lock();
+
+  return (status == FLASH_COMPLETE) ? TRUE : FALSE;
+}
+
+/* stops at the first half word that fails, one not erased before */
+boolean hw_flash_program(uint32 address, const uint16 *data, uint16 count)
+{
+  FLASH_Status status = FLASH_COMPLETE;
+  uint16 i;
+
+  TQ_ASSERT((address & 1) == 0);
+
+  FLASH_Unlock();
+  FLASH_ClearFlag(FLASH_ERRORS);
+  for(i = 0; i < count && status == FLASH_COMPLETE; i++)
+    status = FLASH_ProgramHalfWord(address + i * 2, data[i]);
+  FLASH_Lock();
+
+  return (status == FLASH_COMPLETE) ? TRUE : FALSE;
+}
+
+const void *hw_flash_map(uint32 address)
+{
+  return (const void*)address;
+}
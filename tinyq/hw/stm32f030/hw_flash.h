@@ -0,0 +1,21 @@
+/****************************************************************************
+  hw_flash.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_FLASH_H
+#define HW_FLASH_H
+
+/*
+  Main flash of the STM32F030, erased a page at a time to 0xff and
+  programmed a half word at a time over erased ones only. The CPU stalls
+  while an operation runs, about 50us a half word and 20ms a page, for
+  every interrupt too, the code runs from flash.
+*/
+
+#define HW_FLASH_PAGE_SIZE                  (1024)
+
+extern boolean     hw_flash_erase_page(uint32 address);
+extern boolean     hw_flash_program(uint32 address, const uint16 *data, uint16 count);
+extern const void *hw_flash_map(uint32 address);
+
+#endif
@@ -0,0 +1,100 @@
+/****************************************************************************
+  hw_input.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "qti_system.h"
+#include "hw_debug.h"
+#include "hw_gpio.h"
+#include "hw_exti.h"
+#include "hw_input.h"
+#include "stm32f0xx.h"
+#include "stm32f0xx_rcc.h"
+#include "stm32f0xx_exti.h"
+
+/* the ports are 0x400 apart, their clocks a bit apart from GPIOA on */
+#define INPUT_PORT_GPIO(PORT)               ((GPIO_TypeDef *)(GPIOA_BASE + (PORT) * 0x400UL))
+#define INPUT_PORT_CLOCK(PORT)              (RCC_AHBPeriph_GPIOA << (PORT))
+
+static void input_irq(void);
+
+static uint16  _lines;                      /* EXTI lines of all input pins */
+static boolean _armed;
+static HW_INPUT_IRQ_HANDLER _handler;
+
+
+/* pins in pull_ups are pulled up, the others down */
+void hw_input_open(uint8 port, uint16 pins, uint16 pull_ups, HW_INPUT_IRQ_HANDLER handler)
+{
+  GPIO_TypeDef *gpio = INPUT_PORT_GPIO(port);
+  uint8 pin;
+
+  TQ_ASSERT(port < HW_INPUT_PORTS && !(_lines & pins));
+
+  RCC_AHBPeriphClockCmd(INPUT_PORT_CLOCK(port), ENABLE);
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_SYSCFG, ENABLE);
+
+  qti_system_lock();
+  _handler = handler;
+  for(pin = 0; pin < 16; pin++)
+  {
+    if(!(pins & GPIO_BIT(pin)))
+      continue;
+    GPIO_MODE(gpio, pin, GPIO_MODE_INPUT);
+    GPIO_PUPD(gpio, pin, (pull_ups & GPIO_BIT(pin)) ? GPIO_PULL_UP : GPIO_PULL_DOWN);
+    hw_exti_set(port, pin, EXTI_Trigger_Rising_Falling, input_irq);
+  }
+  _lines |= pins;
+  EXTI->IMR &= ~((uint32)pins);
+  if(_armed)
+  {
+    EXTI->PR = pins;
+    EXTI->IMR |= pins;
+  }
+  qti_system_unlock();
+}
+
+void hw_input_close(uint8 port, uint16 pins)
+{
+  uint8 pin;
+
+  TQ_ASSERT((_lines & pins) == pins);
+
+  for(pin = 0; pin < 16; pin++)
+  {
+    if(pins & GPIO_BIT(pin))
+      hw_exti_set(port, pin, EXTI_Trigger_Rising_Falling, 0);
+  }
+  _lines &= ~pins;
+}
+
+/* pending edges from while masked are cleared, not taken */
+void hw_input_arm(boolean armed)
+{
+  qti_system_lock();
+  _armed = armed;
+  if(armed)
+  {
+    EXTI->PR = _lines;
+    EXTI->IMR |= _lines;
+  }
+  else
+    EXTI->IMR &= ~((uint32)_lines);
+  qti_system_unlock();
+}
+
+uint16 hw_input_read(uint8 port)
+{
+  return (uint16)INPUT_PORT_GPIO(port)->IDR;
+}
+
+/* lines pending together call it once, the first masks the rest */
+static void input_irq(void)
+{
+  if(!_armed)
+    return;
+
+  _armed = FALSE;
+  EXTI->IMR &= ~((uint32)_lines);
+  _handler();
+}
@@ -0,0 +1,25 @@
+/****************************************************************************
+  hw_input.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_INPUT_H
+#define HW_INPUT_H
+
+/*
+  Input pins read a port at a time, woken by one shared edge handler. The
+  pins of a port are opened together, each on the EXTI line of its pin
+  number, a line serves one port only. Armed, any edge on any input pin
+  masks them all and calls the handler once from its interrupt, they stay
+  masked until armed again. Edges while masked are dropped, read the
+  ports after arming to catch one that fell in between.
+*/
+#define HW_INPUT_PORTS                      (6)             /* GPIOA to GPIOF */
+
+typedef void (*HW_INPUT_IRQ_HANDLER)(void);
+
+extern void hw_input_open(uint8 port, uint16 pins, uint16 pull_ups, HW_INPUT_IRQ_HANDLER handler);
+extern void hw_input_close(uint8 port, uint16 pins);
+extern void hw_input_arm(boolean armed);
+extern uint16 hw_input_read(uint8 port);
+
+#endif
@@ -0,0 +1,35 @@
+/****************************************************************************
+  hw_link.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_LINK_H
+#define HW_LINK_H
+
+/*
+  The link of qti_bridge on the STM32F030, USART1 of hw_uart.h to itself,
+  not to be opened by qti_uart as well. Reception runs into a circular
+  ring the bridge reads straight from, it is told at half and full
+  transfer and on an idle line. Writes are copied into two buffers, one
+  on the line while the other fills, the bridge is told when a write it
+  could not finish can go on. The link holds a wait once open, the DMA
+  stops in STOP mode. The baud rate is set before tinyq_run().
+
+  The ring is read well within half of it at the baud rate, a lap lost
+  by a late bridge fails the CRC of the frames it cut.
+*/
+
+#ifndef HW_LINK_BAUD
+#define HW_LINK_BAUD                        (115200)
+#endif
+
+#ifndef HW_LINK_RX_SIZE
+#define HW_LINK_RX_SIZE                     (256)
+#endif
+
+#ifndef HW_LINK_TX_SIZE
+#define HW_LINK_TX_SIZE                     (128)           /* bytes of each of the two buffers */
+#endif
+
+extern void hw_link_set_baud(uint32 baud);
+
+#endif
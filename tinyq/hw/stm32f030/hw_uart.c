@@ -0,0 +1,159 @@
+/****************************************************************************
+  hw_uart.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "tinyq.h"
+#include "hw_debug.h"
+#include "hw_gpio.h"
+#include "hw_uart.h"
+#include "hw_dma.h"
+#include "stm32f0xx.h"
+#include "stm32f0xx_misc.h"
+#include "stm32f0xx_rcc.h"
+#include "stm32f0xx_dma.h"
+#include "stm32f0xx_usart.h"
+#include "stm32f0xx_syscfg.h"
+
+#define UART                                (USART1)
+#define UART_RX_DMA_CHANNEL                 (5)
+#define UART_RX_DMA                         (DMA1_Channel5)
+#define UART_TX_DMA                         (DMA1_Channel4)
+#define UART_IRQ_PRIORITY                   (2)
+
+#define GPIO_PIN_TX                         (9)
+#define GPIO_PIN_RX                         (10)
+#define GPIO_AF_USART1                      (1)
+
+static void config_irq(uint8 channel, boolean enable);
+static void rx_dma_irq(uint8 flags);
+
+static uint16 _rx_size;
+static HW_UART_IRQ_HANDLER _rx_handler;
+static HW_UART_IRQ_HANDLER _tx_handler;
+
+
+void hw_uart_open(uint32 baud, uint8 *rx_ring, uint16 rx_size, HW_UART_IRQ_HANDLER rx_handler, HW_UART_IRQ_HANDLER tx_handler)
+{
+  USART_InitTypeDef USART_InitStructure;
+  DMA_InitTypeDef DMA_InitStructure;
+
+  _rx_size = rx_size;
+  _rx_handler = rx_handler;
+  _tx_handler = tx_handler;
+
+  RCC_AHBPeriphClockCmd(RCC_AHBPeriph_GPIOA | RCC_AHBPeriph_DMA1, ENABLE);
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1 | RCC_APB2Periph_SYSCFG, ENABLE);
+  SYSCFG_DMAChannelRemapConfig(SYSCFG_DMARemap_USART1Tx | SYSCFG_DMARemap_USART1Rx, ENABLE);
+
+  GPIO_AF(GPIOA, GPIO_PIN_TX, GPIO_AF_USART1);
+  GPIO_AF(GPIOA, GPIO_PIN_RX, GPIO_AF_USART1);
+  GPIO_PUPD(GPIOA, GPIO_PIN_RX, GPIO_PULL_UP);
+  GPIO_MODE(GPIOA, GPIO_PIN_TX, GPIO_MODE_AF);
+  GPIO_MODE(GPIOA, GPIO_PIN_RX, GPIO_MODE_AF);
+
+  USART_DeInit(UART);
+  USART_StructInit(&USART_InitStructure);
+  USART_InitStructure.USART_BaudRate = baud;
+  USART_Init(UART, &USART_InitStructure);
+  USART_OverrunDetectionConfig(UART, USART_OVRDetection_Disable);
+
+  /* RX, the ring over and over */
+  DMA_DeInit(UART_RX_DMA);
+  DMA_StructInit(&DMA_InitStructure);
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&UART->RDR;
+  DMA_InitStructure.DMA_MemoryBaseAddr = (uint32_t)rx_ring;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralSRC;
+  DMA_InitStructure.DMA_BufferSize = rx_size;
+  DMA_InitStructure.DMA_PeripheralInc = DMA_PeripheralInc_Disable;
+  DMA_InitStructure.DMA_MemoryInc = DMA_MemoryInc_Enable;
+  DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+  DMA_InitStructure.DMA_MemoryDataSize = DMA_MemoryDataSize_Byte;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Circular;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_VeryHigh;
+  DMA_InitStructure.DMA_M2M = DMA_M2M_Disable;
+  DMA_Init(UART_RX_DMA, &DMA_InitStructure);
+  DMA_ITConfig(UART_RX_DMA, DMA_IT_HT | DMA_IT_TC, ENABLE);
+
+  /* TX, address and count are set per buffer */
+  DMA_DeInit(UART_TX_DMA);
+  DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&UART->TDR;
+  DMA_InitStructure.DMA_DIR = DMA_DIR_PeripheralDST;
+  DMA_InitStructure.DMA_BufferSize = 1;
+  DMA_InitStructure.DMA_Mode = DMA_Mode_Normal;
+  DMA_InitStructure.DMA_Priority = DMA_Priority_Medium;
+  DMA_Init(UART_TX_DMA, &DMA_InitStructure);
+
+  USART_DMACmd(UART, USART_DMAReq_Rx | USART_DMAReq_Tx, ENABLE);
+  USART_ClearITPendingBit(UART, USART_IT_IDLE);
+  USART_ITConfig(UART, USART_IT_IDLE, ENABLE);
+  config_irq(USART1_IRQn, TRUE);
+  hw_dma_set_handler(UART_RX_DMA_CHANNEL, rx_dma_irq);
+
+  DMA_Cmd(UART_RX_DMA, ENABLE);
+  USART_Cmd(UART, ENABLE);
+}
+
+void hw_uart_close(void)
+{
+  config_irq(USART1_IRQn, FALSE);
+  hw_dma_set_handler(UART_RX_DMA_CHANNEL, 0);
+  USART_Cmd(UART, DISABLE);
+  DMA_Cmd(UART_RX_DMA, DISABLE);
+  DMA_Cmd(UART_TX_DMA, DISABLE);
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_USART1, DISABLE);
+}
+
+/* CNDTR counts down and reloads, it reads rx_size right after a wrap */
+uint16 hw_uart_rx_position(void)
+{
+  uint16 position = _rx_size - UART_RX_DMA->CNDTR;
+
+  return (position == _rx_size) ? 0 : position;
+}
+
+/* the transfer complete of the USART, not of the DMA, the buffer may be reused before */
+void hw_uart_tx(const uint8 *data, uint16 size)
+{
+  TQ_ASSERT(size > 0);
+
+  UART_TX_DMA->CCR &= (~DMA_CCR_EN);
+  UART_TX_DMA->CMAR = (uint32_t)data;
+  UART_TX_DMA->CNDTR = size;
+  USART_ClearITPendingBit(UART, USART_IT_TC);
+  USART_ITConfig(UART, USART_IT_TC, ENABLE);
+  UART_TX_DMA->CCR |= DMA_CCR_EN;
+}
+
+static void config_irq(uint8 channel, boolean enable)
+{
+  NVIC_InitTypeDef NVIC_InitStructure;
+
+  NVIC_InitStructure.NVIC_IRQChannelPriority = UART_IRQ_PRIORITY;
+  NVIC_InitStructure.NVIC_IRQChannelCmd = enable ? ENABLE : DISABLE;
+  NVIC_InitStructure.NVIC_IRQChannel = channel;
+  NVIC_Init(&NVIC_InitStructure);
+}
+
+void USART1_IRQHandler(void)
+{
+  uint32 isr = UART->ISR;
+
+  if(isr & USART_ISR_IDLE)
+  {
+    UART->ICR = USART_ICR_IDLECF;
+    _rx_handler();
+  }
+  if((isr & USART_ISR_TC) && (UART->CR1 & USART_CR1_TCIE))
+  {
+    UART->CR1 &= (~USART_CR1_TCIE);
+    UART->ICR = USART_ICR_TCCF;
+    _tx_handler();
+  }
+}
+
+static void rx_dma_irq(uint8 flags)
+{
+  if(flags & (HW_DMA_HT | HW_DMA_TC))
+    _rx_handler();
+}
@@ -0,0 +1,24 @@
+/****************************************************************************
+  hw_uart.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef HW_UART_H
+#define HW_UART_H
+
+/*
+  USART1 on PA9 / PA10, 8N1. Reception runs for good in a circular DMA on
+  channel 5, the rx handler is called at half and full transfer and on an
+  idle line. Transmission is a DMA on channel 4 from the caller's buffer,
+  the tx handler is called once the last byte is out on the line. Both
+  DMA requests are remapped, channels 2 and 3 stay free. Handlers run in
+  interrupt context.
+*/
+
+typedef void (*HW_UART_IRQ_HANDLER)(void);
+
+extern void   hw_uart_open(uint32 baud, uint8 *rx_ring, uint16 rx_size, HW_UART_IRQ_HANDLER rx_handler, HW_UART_IRQ_HANDLER tx_handler);
+extern void   hw_uart_close(void);
+extern uint16 hw_uart_rx_position(void);      /* of the next byte the DMA writes */
+extern void   hw_uart_tx(const uint8 *data, uint16 size);
+
+#endif
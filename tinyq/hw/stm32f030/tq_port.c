@@ -3,6 +3,8 @@
   Copyright (c) 2020 - 2021, Xiaofu Yan.  All rights reserved.
 ****************************************************************************/
 #include "tq_types.h"
+#include "tinyq.h"
+#include "qti_system.h"
 #include "tq_port.h"
 #include "hw_debug.h"
 #include "stm32f0xx.h"
@@ -15,18 +17,50 @@
 
 #define RTC_PREDIV_A                          ((_PT_SLEEP_TIMER_FREQ / _PT_SLEEP_TIMER_TICK_PER_SECOND) - 1)
 #define RTC_PREDIV_S                          (_PT_SLEEP_TIMER_TICK_PER_SECOND - 1)
+#define RTC_TICKS_PER_DAY                     (24UL * 3600 * _PT_SLEEP_TIMER_TICK_PER_SECOND)
+#define RTC_BCD(V)                            ((((V) >> 4) & 0x0f) * 10 + ((V) & 0x0f))
+#define RTC_TO_BCD(V)                         ((((V) / 10) << 4) | ((V) % 10))
+
+/* the port's backup register: words retained over the ticks of day at STANDBY entry */
+#define RETAIN_WORDS_SHIFT                    (29)
+#define RETAIN_TICKS_MASK                     ((1UL << RETAIN_WORDS_SHIFT) - 1)
+
+#define SYSTICK_RANGE                         (SysTick_LOAD_RELOAD_Msk + 1)
+#define TIMESTAMP_PER_RTC_TICK                (_PT_TIMESTAMP_FREQ / _PT_SLEEP_TIMER_TICK_PER_SECOND)
 
 
 static void rtc_init(void);
+static uint32 rtc_get_ticks(void);
+static void rtc_alarm_at(uint32 ticks);
 static void pendsv_init(void);
+static void timestamp_init(void);
+static void timestamp_sleep_compensate(uint8 mode, uint32 rtc_ticks, uint32 timestamp);
+static uint8 wakeup_cause(void);
+
+/*
+  In RTC ticks (250us). STOP restarts HSI and the regulator within a tick, it
+  only pays off over the flash and clock restart energy after about 2ms.
+  STANDBY loses RAM and wakes through a reset and a warm boot, about 1ms
+  at run current, for a few uA less than STOP, it pays off after a second.
+*/
+const struct QTI_SYSTEM_SLEEP_MODE tq_port_sleep_modes[QTI_SYSTEM_SLEEP_MODES] =
+{
+  {0, 0},                                                               /* WFI */
+  {1, 8},                                                               /* STOP */
+  {4, 4000},                                                            /* STANDBY */
+};
 
 static int32 _last_rtc_tick = -1;
+static uint32 _timestamp;
+static uint32 _timestamp_systick;
+static uint8 _resume_words;                 /* retained at the STANDBY this boot came out of */
 
 
 void tq_port_init(void)
 {
   pendsv_init();
   rtc_init();
+  timestamp_init();
 }
 
 void tq_port_us_delay(uint32 us)
@@ -47,6 +81,27 @@ void tq_port_system_reset(void)
   NVIC_SystemReset();
 }
 
+uint32 tq_port_irq_save(void)
+{
+  uint32 primask = __get_PRIMASK();
+  
+  __disable_irq();
+  return primask;
+}
+
+void tq_port_irq_restore(uint32 state)
+{
+  __set_PRIMASK(state);
+}
+
+/* IPSR holds the active exception number, PendSV runs the high priority dispatch */
+boolean tq_port_in_isr(void)
+{
+  uint32 ipsr = __get_IPSR();
+  
+  return (ipsr && ipsr != (uint32)(PendSV_IRQn + 16)) ? TRUE : FALSE;
+}
+
 static void pendsv_init(void)
 {
   /* Set PendSV to lowest priority : 3 */
@@ -64,16 +119,133 @@ void tq_port_trigger_high_priority_dispatch(void)
   SCB->ICSR = SCB->ICSR | (1UL << 28); 
 }
 
-void tq_port_sleep(boolean low_power)
+uint8 tq_port_sleep(uint8 mode)
 {
+  uint32 rtc_ticks = rtc_get_ticks();
+  uint32 timestamp = tq_port_timestamp();
+  
 #ifdef TQ_DEBUG
+  mode = QTI_SYSTEM_SLEEP_WFI;
   PWR_EnterSleepMode(PWR_SLEEPEntry_WFI);
 #else
-  if(!low_power)
+  if(mode == QTI_SYSTEM_SLEEP_WFI)
     PWR_EnterSleepMode(PWR_SLEEPEntry_WFI);
   else
     PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);
 #endif
+
+  timestamp_sleep_compensate(mode, rtc_ticks, timestamp);
+  return wakeup_cause();
+}
+
+/* RTC alarm or a wakeup pin the application enabled, the debugger keeps STOP */
+boolean tq_port_standby(const uint32 *retained, uint8 words, uint32 ticks)
+{
+#ifdef TQ_DEBUG
+  return FALSE;
+#else
+  volatile uint32 *backup = &RTC->BKP0R;
+  uint32 now = rtc_get_ticks();
+  uint8 i;
+
+  TQ_ASSERT(words && words <= _PT_RETAINED_WORDS);
+
+  for(i = 0; i < words; i++)
+    backup[i] = retained[i];
+  backup[_PT_RETAINED_WORDS] = now | ((uint32)words << RETAIN_WORDS_SHIFT);
+
+  if(ticks)
+  {
+    /* the date is masked, longer sleeps wake early and go back to STANDBY */
+    ticks = (ticks < RTC_TICKS_PER_DAY) ? ticks : RTC_TICKS_PER_DAY - 1;
+    rtc_alarm_at((now + ticks) % RTC_TICKS_PER_DAY);
+  }
+  else
+    tq_port_sleep_timer_stop();
+
+  PWR_ClearFlag(PWR_FLAG_WU);
+  PWR_EnterSTANDBYMode();
+  return FALSE;
+#endif
+}
+
+/* the backup registers, valid with the standby flag and the calendar kept */
+uint8 tq_port_resume(uint32 *retained, uint32 *slept)
+{
+  volatile uint32 *backup = &RTC->BKP0R;
+  uint32 entry;
+  uint8 i;
+
+  if(!_resume_words)
+    return 0;
+
+  for(i = 0; i < _resume_words; i++)
+    retained[i] = backup[i];
+
+  entry = backup[_PT_RETAINED_WORDS] & RETAIN_TICKS_MASK;
+  *slept = rtc_get_ticks() + RTC_TICKS_PER_DAY - entry;
+  if(*slept >= RTC_TICKS_PER_DAY)
+    *slept -= RTC_TICKS_PER_DAY;
+  return _resume_words;
+}
+
+/* interrupts are masked while sleeping, the waking one is still pending */
+static uint8 wakeup_cause(void)
+{
+  uint32 pending = NVIC->ISPR[0];
+  
+  if(pending & (1UL << RTC_IRQn))
+    return QTI_SYSTEM_WAKEUP_RTC;
+  if(pending & ((1UL << EXTI0_1_IRQn) | (1UL << EXTI2_3_IRQn) | (1UL << EXTI4_15_IRQn)))
+    return QTI_SYSTEM_WAKEUP_EXTI;
+  return QTI_SYSTEM_WAKEUP_OTHER;
+}
+
+/* timestamp with SysTick, extended to 32 bits in software */
+static void timestamp_init(void)
+{
+  SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+  SysTick->VAL = 0;
+  SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+  
+  _timestamp_systick = 0;
+  _timestamp = 0;
+}
+
+/* must be called at least once per SysTick period (2s) while awake */
+uint32 tq_port_timestamp(void)
+{
+  uint32 irq, systick, timestamp;
+  
+  irq = tq_port_irq_save();
+  
+  systick = SysTick_LOAD_RELOAD_Msk - SysTick->VAL;
+  _timestamp += (systick - _timestamp_systick) & SysTick_LOAD_RELOAD_Msk;
+  _timestamp_systick = systick;
+  timestamp = _timestamp;
+  
+  tq_port_irq_restore(irq);
+  return timestamp;
+}
+
+/* SysTick stops in STOP and may wrap in a long SLEEP, RTC tells the real time */
+static void timestamp_sleep_compensate(uint8 mode, uint32 rtc_ticks, uint32 timestamp)
+{
+  uint32 slept, counted;
+  
+  rtc_ticks = rtc_get_ticks() + RTC_TICKS_PER_DAY - rtc_ticks;
+  if(rtc_ticks >= RTC_TICKS_PER_DAY)
+    rtc_ticks -= RTC_TICKS_PER_DAY;
+  
+  slept = rtc_ticks * TIMESTAMP_PER_RTC_TICK;
+  counted = tq_port_timestamp() - timestamp;
+  if(slept <= counted)
+    return;
+  
+  if(mode != QTI_SYSTEM_SLEEP_WFI)
+    _timestamp += slept - counted;
+  else
+    _timestamp += ((slept - counted + SYSTICK_RANGE / 2) / SYSTICK_RANGE) * SYSTICK_RANGE;
 }
 
 /* timer with RTC*/
@@ -86,19 +258,41 @@ static void rtc_init(void)
   /* Allow access to Backup Domain */
   PWR_BackupAccessCmd(ENABLE);
 
-  /* Clear Wakeup flag */
+  /* out of STANDBY with the calendar kept the RTC runs on, a warm boot */
+  _resume_words = 0;
+  if(PWR_GetFlagStatus(PWR_FLAG_SB) == SET && (RTC->ISR & RTC_ISR_INITS))
+    _resume_words = (uint8)(RTC->BKP4R >> RETAIN_WORDS_SHIFT);
+  _resume_words = (_resume_words <= _PT_RETAINED_WORDS) ? _resume_words : 0;
+
+  /* Clear Wakeup and Standby flags */
   PWR_ClearFlag(PWR_FLAG_WU);
+  PWR_ClearFlag(PWR_FLAG_SB);
 
   /* Reset RTC domain */
-  RCC_BackupResetCmd(ENABLE);
-  RCC_BackupResetCmd(DISABLE);
+  if(!_resume_words)
+  {
+    RCC_BackupResetCmd(ENABLE);
+    RCC_BackupResetCmd(DISABLE);
+  }
  
-  /* Enable the LSI OSC */
+  /* Enable the LSI OSC, ready at once when it kept the RTC running */
   RCC_LSICmd(ENABLE);
   /* Wait till LSI is ready */
   while (RCC_GetFlagStatus(RCC_FLAG_LSIRDY) == RESET)
     ;
   
+  if(_resume_words)
+  {/* alarm A back to the sleep timer, sub-seconds only */
+    RTC->WPR = 0xca;
+    RTC->WPR = 0x53;
+    RTC->CR &= ~(RTC_CR_ALRAE | RTC_CR_ALRAIE);
+    while(!(RTC->ISR & RTC_ISR_ALRAWF))
+      ;
+    RTC->ALRMAR = 0x80808080;
+    RTC->ISR &= ~(RTC_ISR_ALRAF);
+    RTC->WPR = 0xff;
+  }
+  else
   {/* RTC Configuration*/        
     RCC_RTCCLKConfig(RCC_RTCCLKSource_LSI);
     RCC_RTCCLKCmd(ENABLE);
@@ -140,6 +334,44 @@ static void rtc_init(void)
   }
 }
 
+static uint32 rtc_get_ticks(void)
+{
+  uint32 ssr, tr;
+  
+  do
+  {
+    ssr = RTC->SSR;
+    tr = RTC->TR;
+  } while(ssr != RTC->SSR);
+  
+  tr = RTC_BCD((tr >> 16) & 0x3f) * 3600 + RTC_BCD((tr >> 8) & 0x7f) * 60 + RTC_BCD(tr & 0x7f);
+  return tr * _PT_SLEEP_TIMER_TICK_PER_SECOND + (RTC_PREDIV_S - ssr);
+}
+
+/* ticks of day, one division a STANDBY */
+static void rtc_alarm_at(uint32 ticks)
+{
+  uint32 seconds = ticks / _PT_SLEEP_TIMER_TICK_PER_SECOND;
+  uint32 alarm;
+
+  alarm = RTC_TO_BCD(seconds / 3600) << 16;
+  alarm |= RTC_TO_BCD((seconds / 60) % 60) << 8;
+  alarm |= RTC_TO_BCD(seconds % 60);
+
+  RTC->WPR = 0xca;
+  RTC->WPR = 0x53;
+  RTC->CR &= ~(RTC_CR_ALRAE);
+  while(!(RTC->ISR & RTC_ISR_ALRAWF))
+    ;
+  RTC->ALRMAR = RTC_AlarmMask_DateWeekDay | alarm;
+  RTC->ALRMASSR = (RTC_PREDIV_S - (ticks - seconds * _PT_SLEEP_TIMER_TICK_PER_SECOND)) |
+                  ((uint32)RTC_AlarmSubSecondMask_None << 24);
+  RTC->CR |= RTC_CR_ALRAIE;
+  RTC->ISR &= ~(RTC_ISR_ALRAF);
+  RTC->CR |= RTC_CR_ALRAE;
+  RTC->WPR = 0xff;
+}
+
 uint32 tq_port_sleep_timer_get_time_elapsed(boolean update)
 {
   int32 current_rtc_tick;
@@ -10,15 +10,37 @@
 #define _PT_SLEEP_TIMER_TICK_PER_MS                     (_PT_SLEEP_TIMER_TICK_PER_SECOND / 1000)
 #define _PT_SLEEP_TIMER_PERIOD_MAX                      (_PT_SLEEP_TIMER_TICK_PER_SECOND)
 
+/* RTC backup registers kept over STANDBY, the last one is the port's */
+#define _PT_RETAINED_WORDS                              (4)
+
+/* one tinyq instance, no thread local storage */
+#define _PT_THREAD_LOCAL
+
+/* SysTick on HCLK, Cortex-M0 has no DWT cycle counter */
+#define _PT_TIMESTAMP_FREQ                              (8 * 1000 * 1000)
+
 #define tq_port_disable_irq                             __disable_irq
 #define tq_port_enable_irq                              __enable_irq
 
+#if defined(__CC_ARM)
+  #define tq_port_return_address()                      ((const void *)__return_address())
+#else
+  #define tq_port_return_address()                      ((const void *)__builtin_return_address(0))
+#endif
+
+extern uint32 tq_port_irq_save(void);
+extern void tq_port_irq_restore(uint32 state);
+extern boolean tq_port_in_isr(void);                  /* in an interrupt handler other than the high priority dispatch */
+
 extern void tq_port_init(void);
 extern void tq_port_system_reset(void);
 extern void tq_port_us_delay(uint32 us);
+extern uint32 tq_port_timestamp(void);
 
 extern void tq_port_trigger_high_priority_dispatch(void);
-extern void tq_port_sleep(boolean low_power);
+extern uint8 tq_port_sleep(uint8 mode);               /* QTI_SYSTEM_SLEEP_xxx, returns QTI_SYSTEM_WAKEUP_xxx */
+extern boolean tq_port_standby(const uint32 *retained, uint8 words, uint32 ticks);  /* resets after ticks, 0 for none */
+extern uint8 tq_port_resume(uint32 *retained, uint32 *slept);                     /* words and ticks, 0 on a cold boot */
 
 extern void tq_port_sleep_timer_stop(void);
 extern void tq_port_sleep_timer_start(int32 ticks);
@@ -0,0 +1,43 @@
+/****************************************************************************
+  curve.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "curve.h"
+
+static int16 slot_value(const struct S_CURVE *curve, uint16 dx);
+
+
+int16 curve_value(const struct S_CURVE *curve, uint16 x)
+{
+  TQ_ASSERT(((uint32)(curve->x_max - curve->x_min) >> curve->slot_bits) < curve->slot_count);
+
+  x = (x < curve->x_min) ? curve->x_min : (x > curve->x_max) ? curve->x_max : x;
+  return slot_value(curve, x - curve->x_min);
+}
+
+/* curve_value() of n x, an ADC block at a time */
+void curve_map(const struct S_CURVE *curve, const uint16 *x, int16 *y, uint16 n)
+{
+  uint16 x_min = curve->x_min;
+  uint16 x_max = curve->x_max;
+  uint16 v, i;
+
+  TQ_ASSERT(((uint32)(x_max - x_min) >> curve->slot_bits) < curve->slot_count);
+
+  for(i = 0; i < n; i++)
+  {
+    v = (x[i] < x_min) ? x_min : (x[i] > x_max) ? x_max : x[i];
+    y[i] = slot_value(curve, v - x_min);
+  }
+}
+
+/* dx from x_min, the slot it is in and y within it rounded */
+static int16 slot_value(const struct S_CURVE *curve, uint16 dx)
+{
+  const struct S_CURVE_SLOT *slot = &curve->slots[dx >> curve->slot_bits];
+  int32 f = dx & ((1U << curve->slot_bits) - 1);
+
+  return (int16)(slot->y + ((slot->k * f + ((1L << curve->slot_bits) >> 1)) >> curve->slot_bits));
+}
@@ -0,0 +1,37 @@
+/****************************************************************************
+  curve.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef CURVE_H
+#define CURVE_H
+
+/*
+  Piecewise linear curves of 16 bit values, a lookup for a hot path such
+  as the linearisation of a sensor. The x range is cut in slots of
+  1 << slot_bits, as many as the curve needs, each with its value at the
+  start and the slope to the next one. tools/curve_compile.c builds the
+  const tables, nothing is computed at run time but a shift, a mask and a
+  multiply a value, no division and no search. x outside the curve takes
+  the value of its end.
+*/
+
+struct S_CURVE_SLOT
+{
+  int16 y;
+  int16 k;                                  /* y of the next slot - y */
+};
+
+struct S_CURVE
+{
+  const struct S_CURVE_SLOT *slots;
+  uint16 slot_count;
+  uint16 x_min;
+  uint16 x_max;                             /* x_min + (slot_count << slot_bits) - 1 at most */
+  uint8  slot_bits;
+};
+
+
+extern int16 curve_value(const struct S_CURVE *curve, uint16 x);
+extern void  curve_map(const struct S_CURVE *curve, const uint16 *x, int16 *y, uint16 n);
+
+#endif
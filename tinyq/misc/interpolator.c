@@ -5,14 +5,20 @@
 #include <string.h>
 #include "tq_types.h"
 #include "hw_debug.h"
+#include "tq_port.h"
 #include "interpolator.h"
 
 #define WAVE_TABLE_BITS         (8)
 #define WAVE_VALUE_MAX          (1UL << (WAVE_TABLE_BITS))
 
+static void set_slot(struct S_INTERPOLATOR *itp);
+static void next_slot(struct S_INTERPOLATOR *itp);
+
 
 void interpolator_init(struct S_INTERPOLATOR *itp, uint16 range_x, uint16 range_y, const uint8 *function_table, uint8 table_size)
 {
+  uint32 width, inverse;
+
   memset(itp, 0, sizeof(*itp));
   itp->table = function_table;
   itp->table_size = table_size;
@@ -22,47 +28,47 @@ void interpolator_init(struct S_INTERPOLATOR *itp, uint16 range_x, uint16 range_
   TQ_ASSERT(itp->f_slot_width > 0);
   
   itp->f_wave_factor = (((uint32)range_y) << WAVE_TABLE_BITS);
+
+  /* the one division of a slope, slots multiply */
+  width = itp->f_slot_width >> 16;
+  itp->f_unit_k = (((uint32)range_y) << 16) / (width ? width : 1);
+
+  /* and one of the slots a unit of x, a seek multiplies, 16 bits of it */
+  inverse = 0xffffffffUL / itp->f_slot_width;
+  itp->inverse_shift = 16;
+  while(inverse > 0xffff)
+  {
+    inverse >>= 1;
+    itp->inverse_shift--;
+  }
+  itp->slot_inverse = inverse;
   interpolator_set_pos(itp, 0);
 }
 
 void interpolator_set_pos(struct S_INTERPOLATOR *itp, uint16 pos)
 {
-  uint32 wav_y1, wav_y2;
   uint32 f_x = ((uint32)pos << 16);
   
   TQ_ASSERT(f_x <= itp->f_range_x);
   
-  itp->slot_index = f_x / itp->f_slot_width;
+  /* the truncated inverse is low by a slot at most, never high */
+  itp->slot_index = ((uint32)pos * itp->slot_inverse) >> itp->inverse_shift;
   itp->f_slot_dx = f_x - itp->slot_index * itp->f_slot_width;
-  
-  if(itp->slot_index < itp->table_size)
+  while(itp->f_slot_dx >= itp->f_slot_width)
   {
-    wav_y1 = itp->table[itp->slot_index];
-    wav_y2 = itp->slot_index == itp->table_size - 1 ? wav_y1 : itp->table[itp->slot_index + 1];
-    itp->f_slot_y =  wav_y1 * itp->f_wave_factor;
-    itp->f_slot_k = (wav_y2 * itp->f_wave_factor - itp->f_slot_y) / (itp->f_slot_width >> 16);
+    itp->f_slot_dx -= itp->f_slot_width;
+    itp->slot_index++;
   }
+  set_slot(itp);
 }
 
 boolean interpolator_step(struct S_INTERPOLATOR *itp, uint16 offset)
 {
-  uint32 wav_y1, wav_y2;
-  
   if(itp->slot_index < itp->table_size)
   {  
     itp->f_slot_dx += ((uint32)offset << 16);
-    while(itp->f_slot_dx >= itp->f_slot_width)
-    {
-      itp->f_slot_dx -= itp->f_slot_width;
-      itp->slot_index++;
-      if(itp->f_slot_dx < itp->f_slot_width && itp->slot_index < itp->table_size)
-      {
-        wav_y1 = itp->table[itp->slot_index];
-        wav_y2 = itp->slot_index == itp->table_size - 1 ? wav_y1 : itp->table[itp->slot_index + 1];
-        itp->f_slot_y =  wav_y1 * itp->f_wave_factor;
-        itp->f_slot_k = (wav_y2 * itp->f_wave_factor - itp->f_slot_y) / (itp->f_slot_width >> 16);
-      }
-    }
+    if(itp->f_slot_dx >= itp->f_slot_width)
+      next_slot(itp);
   }
   return itp->slot_index < itp->table_size;
 }
@@ -91,3 +97,82 @@ uint16 interpolator_get_value(struct S_INTERPOLATOR *itp)
   
   return y;
 }
+
+/*
+  n times interpolator_step(itp, step) and interpolator_get_value(), fewer
+  when the end comes first. Within a slot a value is the one before plus
+  step * f_slot_k, the sums wrap as those of interpolator_get_value() do.
+*/
+uint16 interpolator_fill(struct S_INTERPOLATOR *itp, uint16 step, uint16 *out, uint16 n)
+{
+  uint32 f_step = ((uint32)step << 16);
+  uint32 y, dy;
+  uint16 count = 0;
+#ifdef _PT_HW_DIVIDE
+  uint32 run, i;
+#endif
+
+  while(count < n && itp->slot_index < itp->table_size)
+  {
+    y = itp->f_slot_y + (itp->f_slot_dx >> 16) * itp->f_slot_k;
+    dy = step * itp->f_slot_k;
+
+#ifdef _PT_HW_DIVIDE
+    /* steps left in the slot, a loop the compiler vectorises */
+    run = f_step ? (itp->f_slot_width - 1 - itp->f_slot_dx) / f_step : n;
+    run = (run < (uint32)(n - count)) ? run : (uint32)(n - count);
+    for(i = 0; i < run; i++)
+      out[count + i] = (uint16)((y + (i + 1) * dy) >> 16);
+    itp->f_slot_dx += run * f_step;
+    count += run;
+    if(count == n)
+      break;
+    itp->f_slot_dx += f_step;
+#else
+    /* an add and a compare a value */
+    while(count < n)
+    {
+      itp->f_slot_dx += f_step;
+      if(itp->f_slot_dx >= itp->f_slot_width)
+        break;
+      y += dy;
+      out[count++] = (uint16)(y >> 16);
+    }
+    if(count == n)
+      break;
+#endif
+
+    next_slot(itp);
+    if(itp->slot_index < itp->table_size)
+      out[count++] = interpolator_get_value(itp);
+  }
+  return count;
+}
+
+/* f_slot_dx past the width, on to the slot it is in */
+static void next_slot(struct S_INTERPOLATOR *itp)
+{
+  while(itp->f_slot_dx >= itp->f_slot_width)
+  {
+    itp->f_slot_dx -= itp->f_slot_width;
+    itp->slot_index++;
+  }
+  set_slot(itp);
+}
+
+/* Start and slope of the slot, the slope of the table step times f_unit_k */
+static void set_slot(struct S_INTERPOLATOR *itp)
+{
+  uint32 wav_y1, wav_y2, dy, k;
+
+  if(itp->slot_index < itp->table_size)
+  {
+    wav_y1 = itp->table[itp->slot_index];
+    wav_y2 = itp->slot_index == itp->table_size - 1 ? wav_y1 : itp->table[itp->slot_index + 1];
+    itp->f_slot_y =  wav_y1 * itp->f_wave_factor;
+
+    dy = (wav_y2 >= wav_y1) ? wav_y2 - wav_y1 : wav_y1 - wav_y2;
+    k = dy * (itp->f_unit_k >> 8) + ((dy * (itp->f_unit_k & 0xff)) >> 8);
+    itp->f_slot_k = (wav_y2 >= wav_y1) ? k : 0 - k;
+  }
+}
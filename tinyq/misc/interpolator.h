@@ -17,6 +17,9 @@ struct S_INTERPOLATOR
   uint32  f_slot_dx;
   uint32  f_slot_y;
   uint32  f_slot_k;
+  uint32  f_unit_k;                         /* slope of a table step of 1, 8 more fraction bits */
+  uint16  slot_inverse;                     /* slots a unit of x, >> inverse_shift */
+  uint8   inverse_shift;
 };
 
 
@@ -26,5 +29,6 @@ extern void     interpolator_set_pos(struct S_INTERPOLATOR *itp, uint16 pos);
 extern boolean  interpolator_at_end(struct S_INTERPOLATOR *itp);
 extern uint16   interpolator_get_pos(struct S_INTERPOLATOR *itp);
 extern uint16   interpolator_get_value(struct S_INTERPOLATOR *itp);
+extern uint16   interpolator_fill(struct S_INTERPOLATOR *itp, uint16 step, uint16 *out, uint16 n);
 
 #endif
@@ -0,0 +1,69 @@
+/****************************************************************************
+  tone.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include "tq_types.h"
+#include "hw_debug.h"
+#include "tone.h"
+
+#if TONE_CLK_FREQ > 16 * 1000 * 1000UL
+#error "TONE_CLK_FREQ too high for the reciprocal table"
+#endif
+
+#if TONE_TABLE_BITS != 7
+#error "the table below has 129 entries"
+#endif
+
+/* slots of the table are (1 << SLOT_BITS) Hz wide */
+#define SLOT_BITS               (11 - TONE_TABLE_BITS)
+#define NORM(I)                 (TONE_NORM_MIN + ((uint32)(I) << SLOT_BITS))
+#define EXACT(I)                (((TONE_CLK_FREQ << 8) + NORM(I) / 2) / NORM(I))
+#define SAG(I)                  (EXACT(I) * (1UL << (2 * SLOT_BITS)) / (8UL * NORM(I) * NORM(I)))
+#define R(I)                    (EXACT(I) - SAG(I))
+#define R8(I)                   R(I), R(I + 1), R(I + 2), R(I + 3), R(I + 4), R(I + 5), R(I + 6), R(I + 7)
+#define R32(I)                  R8(I), R8(I + 8), R8(I + 16), R8(I + 24)
+
+/*
+  TONE_CLK_FREQ / NORM(i), 8 fraction bits, lowered by half the sag of
+  the reciprocal below the chord of a slot
+*/
+static const uint32 _reciprocal[(1 << TONE_TABLE_BITS) + 1] =
+{
+  R32(0), R32(32), R32(64), R32(96), R(128),
+};
+
+
+uint16 tone_period(uint32 freq)
+{
+  uint32 norm = freq, r, fraction;
+  uint16 index;
+  uint8  shift = 0, fraction_bits;
+
+  TQ_ASSERT(freq >= TONE_FREQ_MIN);
+
+  if(norm < TONE_NORM_MIN)
+  {
+    /* low tones, freq << shift */
+    while(norm < TONE_NORM_MIN)
+    {
+      norm <<= 1;
+      shift++;
+    }
+    index = (norm - TONE_NORM_MIN) >> SLOT_BITS;
+    fraction = norm & ((1UL << SLOT_BITS) - 1);
+    r = _reciprocal[index] - (((_reciprocal[index] - _reciprocal[index + 1]) * fraction) >> SLOT_BITS);
+    return (uint16)(((r << shift) + 0x80) >> 8);
+  }
+
+  /* high tones, the bits shifted out stay in the fraction */
+  while(norm >= 2 * TONE_NORM_MIN)
+  {
+    norm >>= 1;
+    shift++;
+  }
+  index = (norm - TONE_NORM_MIN) >> SLOT_BITS;
+  fraction_bits = SLOT_BITS + shift;
+  fraction = freq & ((1UL << fraction_bits) - 1);
+  r = _reciprocal[index] - (((_reciprocal[index] - _reciprocal[index + 1]) * fraction) >> fraction_bits);
+  return (uint16)((r + (0x80UL << shift)) >> (8 + shift));
+}
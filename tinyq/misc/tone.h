@@ -0,0 +1,27 @@
+/****************************************************************************
+  tone.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef TONE_H
+#define TONE_H
+
+/*
+  Timer periods of tones without a division, for a Cortex-M0 filling a
+  DMA buffer from an interrupt. The frequency is shifted into
+  [TONE_NORM_MIN, 2 * TONE_NORM_MIN) and the period is interpolated in a
+  table of reciprocals built at compile time. Periods are within 0.65 of
+  a tick of TONE_CLK_FREQ / freq from TONE_FREQ_MIN to 20kHz, a division
+  truncates by up to a tick.
+*/
+
+#ifndef TONE_CLK_FREQ
+#define TONE_CLK_FREQ                       (4 * 1000 * 1000UL)     /* at most 16MHz */
+#endif
+
+#define TONE_NORM_MIN                       (2048)
+#define TONE_TABLE_BITS                     (7)
+#define TONE_FREQ_MIN                       ((TONE_CLK_FREQ >> 16) + 1)   /* for a 16 bit period */
+
+extern uint16 tone_period(uint32 freq);
+
+#endif
@@ -0,0 +1,201 @@
+/****************************************************************************
+  qti_adc.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "hw_debug.h"
+#include "ring_buffer.h"
+#include "qti_system.h"
+#include "tq_context.h"
+#include "hw_adc.h"
+#include "qti_adc.h"
+
+#if QTI_ADC_BLOCK_SAMPLES < 1 || 2 + 2 * QTI_ADC_BLOCK_SAMPLES > 255
+#error "QTI_ADC_BLOCK_SAMPLES out of range"
+#endif
+
+#define ADC_LCL_DELIVERED                   TQ_SIG_MAKE_LCL(0)  /* p: uint16 bytes the block took in the queue */
+
+#define ADC_CHANNELS                        (19)
+
+static void adc_irq(const uint16 *samples, uint16 count);
+static void deliver_block(void);
+
+static uint8 _self;
+static uint8 _subscribers[QTI_ADC_SUBSCRIBERS];
+static uint8 _subscriber_count;
+static boolean _running;
+static struct QTI_ADC_STATS _stats;
+
+static uint16 _dma_buffer[QTI_ADC_BLOCK_SAMPLES * 2];
+static uint8  _channel_count;
+static uint8  _decimation_shift;
+static uint16 _block_samples;               /* whole sequences */
+static uint16 _queue_bytes;                 /* of blocks not dispatched yet */
+
+/* sums of the sequences in a decimation window */
+static uint32 _sums[ADC_CHANNELS];
+static uint8  _summed;
+static struct QTI_ADC_BLOCK _block;
+static uint16 _block_fill;
+
+
+boolean qti_adc_subscribe(uint8 qti)
+{
+  boolean done = FALSE;
+  uint8 i;
+
+  qti_system_lock();
+  for(i = 0; i < _subscriber_count && _subscribers[i] != qti; i++);
+  if(i < _subscriber_count)
+    done = TRUE;
+  else if(_subscriber_count < QTI_ADC_SUBSCRIBERS)
+  {
+    _subscribers[_subscriber_count++] = qti;
+    done = TRUE;
+  }
+  qti_system_unlock();
+
+  return done;
+}
+
+void qti_adc_unsubscribe(uint8 qti)
+{
+  uint8 i;
+
+  qti_system_lock();
+  for(i = 0; i < _subscriber_count && _subscribers[i] != qti; i++);
+  if(i < _subscriber_count)
+    _subscribers[i] = _subscribers[--_subscriber_count];
+  qti_system_unlock();
+}
+
+boolean qti_adc_start(const struct QTI_ADC_CONFIG *config)
+{
+  uint32 channels = config->channels;
+  uint16 per_half;
+
+  TQ_ASSERT(!_running);
+
+  _channel_count = 0;
+  for(; channels; channels &= channels - 1)
+    _channel_count++;
+
+  for(_decimation_shift = 0; (1 << _decimation_shift) < config->decimation; _decimation_shift++);
+  if(!_channel_count || _channel_count > ADC_CHANNELS || _channel_count > QTI_ADC_BLOCK_SAMPLES ||
+     !config->rate || config->decimation > QTI_ADC_DECIMATION_MAX || (1 << _decimation_shift) != config->decimation)
+    return FALSE;
+
+  /* a division at start only, no divider on the M0 */
+  per_half = QTI_ADC_BLOCK_SAMPLES / _channel_count;
+  _block_samples = per_half * _channel_count;
+
+  memset(_sums, 0, sizeof(_sums));
+  memset(&_stats, 0, sizeof(_stats));
+  _summed = 0;
+  _block.index = 0;
+  _block_fill = 0;
+  _running = TRUE;
+
+  qti_system_request_wait(_self);
+  hw_adc_start(config->channels, config->rate, _dma_buffer, _block_samples * 2, adc_irq);
+  return TRUE;
+}
+
+/* a part filled block is dropped */
+void qti_adc_stop(void)
+{
+  if(!_running)
+    return;
+
+  hw_adc_stop();
+  _running = FALSE;
+  qti_system_release_wait(_self);
+}
+
+void qti_adc_get_stats(struct QTI_ADC_STATS *stats)
+{
+  qti_system_lock();
+  *stats = _stats;
+  qti_system_unlock();
+}
+
+void qti_adc_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint16 bytes;
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+    _self = self->self;
+  else if(sig == ADC_LCL_DELIVERED)
+  {
+    memcpy(&bytes, p, sizeof(bytes));
+    qti_system_lock();
+    _queue_bytes -= bytes;
+    qti_system_unlock();
+  }
+}
+
+/* a half of the DMA buffer, whole sequences */
+static void adc_irq(const uint16 *samples, uint16 count)
+{
+  const uint16 *end = samples + count;
+  uint8 c;
+
+  _stats.irqs++;
+  if(!_decimation_shift)
+  {
+    for(; samples < end; samples += _channel_count)
+    {
+      memcpy(_block.samples + _block_fill, samples, _channel_count * sizeof(uint16));
+      _block_fill += _channel_count;
+      _stats.sequences++;
+      if(_block_fill == _block_samples)
+        deliver_block();
+    }
+  }
+  else
+  {
+    for(; samples < end; samples += _channel_count)
+    {
+      for(c = 0; c < _channel_count; c++)
+        _sums[c] += samples[c];
+      _stats.sequences++;
+      if(++_summed < (1 << _decimation_shift))
+        continue;
+
+      for(c = 0; c < _channel_count; c++)
+      {
+        _block.samples[_block_fill++] = (uint16)(_sums[c] >> _decimation_shift);
+        _sums[c] = 0;
+      }
+      _summed = 0;
+      if(_block_fill == _block_samples)
+        deliver_block();
+    }
+  }
+}
+
+/* then a marker to self, dispatched after the block at every subscriber */
+static void deliver_block(void)
+{
+  uint8 size = (uint8)(sizeof(_block.index) + _block_fill * sizeof(uint16));
+  uint16 bytes = _subscriber_count * (TQ_SIGNAL_HEADER_SIZE + size) + TQ_SIGNAL_HEADER_SIZE + sizeof(bytes);
+  uint8 i;
+
+  if(_queue_bytes + bytes > QTI_ADC_QUEUE_BYTES)
+    _stats.dropped++;
+  else if(_subscriber_count)
+  {
+    _queue_bytes += bytes;
+    for(i = 0; i < _subscriber_count; i++)
+      tinyq_send_signal(_self, _subscribers[i], ADC_NTF_BLOCK, &_block, size);
+    tinyq_send_signal(_self, _self, ADC_LCL_DELIVERED, &bytes, sizeof(bytes));
+    _stats.blocks++;
+  }
+
+  _block.index++;
+  _block_fill = 0;
+}
@@ -0,0 +1,63 @@
+/****************************************************************************
+  qti_adc.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTI_ADC_H
+#define QTI_ADC_H
+
+/*
+  Streaming acquisition on the hw_adc.h of the port. A timer triggers a
+  sequence of channels at the configured rate and a circular DMA fills
+  one half of a buffer while the other is processed, in the interrupt of
+  the half that completed. Sequences are averaged by the decimation
+  factor and packed into blocks, each block goes to every subscriber as
+  one signal. Blocks that would take the logic queue over
+  QTI_ADC_QUEUE_BYTES are dropped and counted. A wait is held from start
+  to stop only, the ADC does not run in STOP mode.
+*/
+
+#ifndef QTI_ADC_BLOCK_SAMPLES
+#define QTI_ADC_BLOCK_SAMPLES               (32)            /* of all channels, also half the DMA buffer */
+#endif
+
+#ifndef QTI_ADC_SUBSCRIBERS
+#define QTI_ADC_SUBSCRIBERS                 (2)
+#endif
+
+#ifndef QTI_ADC_QUEUE_BYTES
+#define QTI_ADC_QUEUE_BYTES                 (TQ_LOGIC_BUFFER_SIZE / 2)
+#endif
+
+#define QTI_ADC_DECIMATION_MAX              (16)
+
+#define ADC_NTF_BLOCK                       TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 1)   /* p: struct QTI_ADC_BLOCK up to its last sample */
+
+struct QTI_ADC_CONFIG
+{
+  uint32 channels;                          /* ADC_Channel_xxx mask, converted in ascending order */
+  uint32 rate;                              /* sequences a second */
+  uint8  decimation;                        /* 1, 2, 4, 8 or 16 sequences to one */
+};
+
+struct QTI_ADC_BLOCK
+{
+  uint16 index;                             /* of the block since start, a gap is a drop */
+  uint16 samples[QTI_ADC_BLOCK_SAMPLES];    /* sequences one after the other */
+};
+
+struct QTI_ADC_STATS
+{
+  uint32 sequences;                         /* converted */
+  uint32 blocks;                            /* delivered */
+  uint32 dropped;
+  uint32 irqs;
+};
+
+extern boolean qti_adc_subscribe(uint8 qti);
+extern void    qti_adc_unsubscribe(uint8 qti);
+extern boolean qti_adc_start(const struct QTI_ADC_CONFIG *config);
+extern void    qti_adc_stop(void);
+extern void    qti_adc_get_stats(struct QTI_ADC_STATS *stats);
+extern void    qti_adc_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+#endif
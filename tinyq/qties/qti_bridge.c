@@ -0,0 +1,439 @@
+/****************************************************************************
+  qti_bridge.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "hw_debug.h"
+#include "ring_buffer.h"
+#include "qti_system.h"
+#include "tq_context.h"
+#include "qti_bridge.h"
+
+#define FRAME_SYNC0                         (0x7e)
+#define FRAME_SYNC1                         (0xa5)
+#define FRAME_HEADER_SIZE                   (6)             /* sync(2) length(2) seq ack */
+#define FRAME_CRC_SIZE                      (2)
+#define FRAME_MAX                           (FRAME_HEADER_SIZE + BRIDGE_FRAME_SIZE + FRAME_CRC_SIZE)
+#define SIGNAL_HEADER_SIZE                  (4)             /* from to sig size */
+
+#if BRIDGE_FRAME_SIZE < SIGNAL_HEADER_SIZE + 255
+#error "BRIDGE_FRAME_SIZE has to hold a signal with 255 bytes of param"
+#endif
+
+#if BRIDGE_WINDOW < 1 || BRIDGE_WINDOW > 127
+#error "BRIDGE_WINDOW out of range"
+#endif
+
+/* queue bytes of a frame of signals without param and its drained signal, headers grow with TQ_PROFILE */
+#define FRAME_QUEUE_SIZE                    (BRIDGE_FRAME_SIZE / SIGNAL_HEADER_SIZE * TQ_SIGNAL_HEADER_SIZE + \
+                                             TQ_SIGNAL_HEADER_SIZE + 1)
+
+#if BRIDGE_WINDOW * FRAME_QUEUE_SIZE >= TQ_LOGIC_BUFFER_SIZE
+#error "the logic queue can not hold BRIDGE_WINDOW frames"
+#endif
+
+#define BRIDGE_LCL_FLUSH                    TQ_SIG_MAKE_LCL(0)
+#define BRIDGE_LCL_DRAINED                  TQ_SIG_MAKE_LCL(1)  /* p: seq */
+
+#define TIMER_STALL                         (0x01)
+#define TIMER_OPEN                          (0x02)
+
+#define RX_CHUNK                            (64)
+
+static void    link_open(void);
+static void    proxy_send(uint8 remote, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+static void    tx_seal(void);
+static boolean tx_start(void);
+static void    tx_pump(void);
+static void    tx_acked(uint8 ack);
+static void    tx_stall_timeout(void);
+static void    rx_pump(void);
+static void    rx_frame(void);
+static uint8   local_of_remote(uint8 remote);
+static const struct QTI_BRIDGE_ROUTE *route_of_local(uint8 local);
+static uint8   find_self(void);
+static uint16  crc16(const uint8 *data, uint16 size);
+
+extern const uint8 tq_qti_count;
+extern const struct TQ_QTI tq_qti_table[];
+
+/*
+  The sealed frames wait from head on in the order they go out, the one
+  after them takes new signals. A frame is sealed when it is full or when
+  the link can take it, so signals keep going into the same frame while
+  the link is busy or the window closed.
+*/
+struct S_TX
+{
+  uint8  frames[BRIDGE_TX_FRAMES][FRAME_MAX];
+  uint8  ack_frame[FRAME_HEADER_SIZE + FRAME_CRC_SIZE];
+  uint16 fill_size;                         /* bytes of signals in the frame after the sealed ones */
+  uint8  head;
+  uint8  sealed;
+  uint8  sent;                              /* seq of the last frame sent */
+  uint8  acked;                             /* seq of the last frame the receiver has dispatched */
+  const uint8 *current;                     /* being written to the link */
+  uint16 remaining;
+  boolean writing_frame;                    /* the head frame, not the ack frame */
+  boolean flush_pending;
+  boolean stall_timer;
+};
+
+struct S_RX
+{
+  uint8  frame[FRAME_MAX];
+  uint16 used;
+  uint16 length;                            /* bytes of signals of the frame being read */
+  uint8  ack;                               /* seq of the last frame dispatched here */
+  boolean ack_pending;
+};
+
+static uint8 _self = QTI_BROADCAST;
+static struct S_TX _tx;
+static struct S_RX _rx;
+static struct QTI_BRIDGE_STATS _stats;
+
+static const uint16 _crc_table[16] =
+{
+  0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
+  0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
+};
+
+
+void qti_bridge_get_stats(struct QTI_BRIDGE_STATS *stats)
+{
+  memcpy(stats, &_stats, sizeof(_stats));
+}
+
+void qti_bridge_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  const struct QTI_BRIDGE_ROUTE *route = route_of_local(self->self);
+  uint16 timer_id;
+
+  /* a proxy */
+  if(route)
+  {
+    if(from != QTI_SYSTEM)
+      proxy_send(route->remote, from, sig, p, size);
+    return;
+  }
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    _self = self->self;
+    link_open();
+  }
+  else if(from == QTI_SYSTEM && sig == SYSTEM_RSP_TIMER)
+  {
+    timer_id = *((uint16*)(p));
+    if(timer_id == TIMER_STALL)
+      tx_stall_timeout();
+    else if(timer_id == TIMER_OPEN)
+      link_open();
+  }
+  else if(sig == BRIDGE_NTF_LINK)
+  {
+    rx_pump();
+    tx_pump();
+  }
+  else if(from == _self && sig == BRIDGE_LCL_FLUSH)
+  {
+    _tx.flush_pending = FALSE;
+    tx_pump();
+  }
+  else if(from == _self && sig == BRIDGE_LCL_DRAINED)
+  {
+    /* a flush to come takes the ack along */
+    _rx.ack = p[0];
+    _rx.ack_pending = TRUE;
+    if(!_tx.flush_pending)
+      tx_pump();
+  }
+}
+
+/* a link that can not be watched yet is tried again, frames wait meanwhile */
+static void link_open(void)
+{
+  if(bridge_link_open(_self))
+    return;
+  _stats.link_errors++;
+  qti_system_start_timer(_self, TIMER_OPEN, BRIDGE_STALL_TIME);
+}
+
+/* into the frame, sent once the signals queued before are dispatched */
+static void proxy_send(uint8 remote, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint8 *signal;
+
+  if(_self == QTI_BROADCAST)
+    _self = find_self();
+
+  if(_tx.fill_size + SIGNAL_HEADER_SIZE + size > BRIDGE_FRAME_SIZE)
+    tx_seal();
+  if(_tx.sealed == BRIDGE_TX_FRAMES)
+  {
+    _stats.dropped++;
+    return;
+  }
+
+  signal = &_tx.frames[(_tx.head + _tx.sealed) % BRIDGE_TX_FRAMES][FRAME_HEADER_SIZE + _tx.fill_size];
+  signal[0] = from;
+  signal[1] = remote;
+  signal[2] = sig;
+  signal[3] = size;
+  memcpy(&signal[SIGNAL_HEADER_SIZE], p, size);
+  _tx.fill_size += SIGNAL_HEADER_SIZE + size;
+  _stats.tx_signals++;
+
+  if(TQ_SIG_DISPATCHER(sig) == TQ_DSP_HIGH)
+    tx_pump();
+  else if(!_tx.flush_pending)
+  {
+    _tx.flush_pending = TRUE;
+    tinyq_send_signal(_self, _self, BRIDGE_LCL_FLUSH, 0, 0);
+  }
+}
+
+static void tx_seal(void)
+{
+  uint8 *frame;
+
+  if(!_tx.fill_size)
+    return;
+
+  frame = _tx.frames[(_tx.head + _tx.sealed) % BRIDGE_TX_FRAMES];
+  frame[2] = (uint8)_tx.fill_size;
+  frame[3] = (uint8)(_tx.fill_size >> 8);
+  _tx.sealed++;
+  _tx.fill_size = 0;
+}
+
+/* the head frame when the window is open, else an ack of its own when one is due */
+static boolean tx_start(void)
+{
+  boolean window = (uint8)(_tx.sent - _tx.acked) < BRIDGE_WINDOW;
+  uint8 *frame;
+  uint16 length, crc;
+
+  if(window && !_tx.sealed)
+    tx_seal();
+
+  if(_tx.sealed && window)
+  {
+    frame = _tx.frames[_tx.head];
+    length = frame[2] | ((uint16)frame[3] << 8);
+    _tx.writing_frame = TRUE;
+    _stats.tx_frames++;
+  }
+  else if(_rx.ack_pending)
+  {
+    frame = _tx.ack_frame;
+    length = 0;
+    frame[2] = 0;
+    frame[3] = 0;
+    _tx.writing_frame = FALSE;
+  }
+  else
+    frame = 0;
+
+  if(_tx.sealed && !window && !_tx.stall_timer)
+  {
+    _tx.stall_timer = TRUE;
+    qti_system_start_timer(_self, TIMER_STALL, BRIDGE_STALL_TIME);
+  }
+  if(!frame)
+    return FALSE;
+
+  frame[0] = FRAME_SYNC0;
+  frame[1] = FRAME_SYNC1;
+  frame[4] = _tx.writing_frame ? ++_tx.sent : _tx.sent;
+  frame[5] = _rx.ack;
+  crc = crc16(&frame[2], FRAME_HEADER_SIZE - 2 + length);
+  frame[FRAME_HEADER_SIZE + length] = (uint8)crc;
+  frame[FRAME_HEADER_SIZE + length + 1] = (uint8)(crc >> 8);
+  _rx.ack_pending = FALSE;
+
+  _tx.current = frame;
+  _tx.remaining = FRAME_HEADER_SIZE + length + FRAME_CRC_SIZE;
+  return TRUE;
+}
+
+/* as much as the link takes, BRIDGE_NTF_LINK comes when it takes more */
+static void tx_pump(void)
+{
+  uint16 written;
+
+  while(_tx.remaining || tx_start())
+  {
+    written = bridge_link_write(_tx.current, _tx.remaining);
+    _tx.current += written;
+    _tx.remaining -= written;
+    if(_tx.remaining)
+      return;
+
+    if(_tx.writing_frame)
+    {
+      _tx.head = (_tx.head + 1) % BRIDGE_TX_FRAMES;
+      _tx.sealed--;
+    }
+  }
+}
+
+/* an ack out of the frames in flight is from a receiver started over */
+static void tx_acked(uint8 ack)
+{
+  if(ack == _tx.acked || (uint8)(ack - _tx.acked) > (uint8)(_tx.sent - _tx.acked))
+    return;
+
+  _tx.acked = ack;
+  if(_tx.stall_timer)
+  {
+    _tx.stall_timer = FALSE;
+    qti_system_stop_timer(_self, TIMER_STALL);
+  }
+}
+
+/* frames lost on the link are never acked, the window opens again */
+static void tx_stall_timeout(void)
+{
+  _tx.stall_timer = FALSE;
+  if((uint8)(_tx.sent - _tx.acked) < BRIDGE_WINDOW)
+    return;
+
+  _tx.acked = _tx.sent;
+  _stats.stalls++;
+  tx_pump();
+}
+
+/* sync and header byte by byte, the rest of a frame in one copy */
+static void rx_pump(void)
+{
+  uint8 chunk[RX_CHUNK];
+  uint16 size, i, take;
+
+  while((size = bridge_link_read(chunk, sizeof(chunk))) != 0)
+  {
+    for(i = 0; i < size; i += take)
+    {
+      take = 1;
+      if(_rx.used == 0 && chunk[i] != FRAME_SYNC0)
+        continue;
+      if(_rx.used == 1 && chunk[i] != FRAME_SYNC1)
+      {
+        _rx.used = (chunk[i] == FRAME_SYNC0) ? 1 : 0;
+        continue;
+      }
+
+      if(_rx.used < FRAME_HEADER_SIZE)
+        _rx.frame[_rx.used] = chunk[i];
+      else
+      {
+        take = FRAME_HEADER_SIZE + _rx.length + FRAME_CRC_SIZE - _rx.used;
+        take = (take > size - i) ? size - i : take;
+        memcpy(&_rx.frame[_rx.used], &chunk[i], take);
+      }
+      _rx.used += take;
+
+      if(_rx.used == 4)
+      {
+        _rx.length = _rx.frame[2] | ((uint16)_rx.frame[3] << 8);
+        if(_rx.length > BRIDGE_FRAME_SIZE)
+        {
+          _stats.crc_errors++;
+          _rx.used = 0;
+        }
+      }
+      else if(_rx.used == FRAME_HEADER_SIZE + _rx.length + FRAME_CRC_SIZE)
+      {
+        rx_frame();
+        _rx.used = 0;
+      }
+    }
+  }
+}
+
+/* the signals go to the queue, the ack once they are dispatched */
+static void rx_frame(void)
+{
+  const uint8 *signal = &_rx.frame[FRAME_HEADER_SIZE];
+  const uint8 *end = signal + _rx.length;
+  uint16 crc = _rx.frame[FRAME_HEADER_SIZE + _rx.length] | ((uint16)_rx.frame[FRAME_HEADER_SIZE + _rx.length + 1] << 8);
+  uint8 seq = _rx.frame[4];
+
+  if(crc16(&_rx.frame[2], FRAME_HEADER_SIZE - 2 + _rx.length) != crc)
+  {
+    _stats.crc_errors++;
+    return;
+  }
+
+  tx_acked(_rx.frame[5]);
+  if(!_rx.length)
+    return;
+
+  _stats.rx_frames++;
+  while(signal + SIGNAL_HEADER_SIZE <= end && signal + SIGNAL_HEADER_SIZE + signal[3] <= end)
+  {
+    if(signal[1] < tq_qti_count)
+    {
+      tinyq_send_signal(local_of_remote(signal[0]), signal[1], signal[2], &signal[SIGNAL_HEADER_SIZE], signal[3]);
+      _stats.rx_signals++;
+    }
+    signal += SIGNAL_HEADER_SIZE + signal[3];
+  }
+  tinyq_send_signal(_self, _self, BRIDGE_LCL_DRAINED, &seq, sizeof(seq));
+}
+
+static uint8 local_of_remote(uint8 remote)
+{
+  uint8 i;
+
+  for(i = 0; i < qti_bridge_route_count; i++)
+  {
+    if(qti_bridge_routes[i].remote == remote)
+      return qti_bridge_routes[i].local;
+  }
+  return _self;
+}
+
+static const struct QTI_BRIDGE_ROUTE *route_of_local(uint8 local)
+{
+  uint8 i;
+
+  for(i = 0; i < qti_bridge_route_count; i++)
+  {
+    if(qti_bridge_routes[i].local == local)
+      return &qti_bridge_routes[i];
+  }
+  return 0;
+}
+
+/* for a proxy signalled before SYSTEM_NTF_START got to the bridge */
+static uint8 find_self(void)
+{
+  uint8 i;
+
+  for(i = 0; i < tq_qti_count; i++)
+  {
+    if(tq_qti_table[i].signal_entry == qti_bridge_signal_entry && !route_of_local(i))
+      return i;
+  }
+  TQ_ASSERT(FALSE);
+  return 0;
+}
+
+/* CRC-16/CCITT-FALSE, a nibble at a time */
+static uint16 crc16(const uint8 *data, uint16 size)
+{
+  uint16 crc = 0xffff;
+
+  while(size--)
+  {
+    crc = (crc << 4) ^ _crc_table[(crc >> 12) ^ (*data >> 4)];
+    crc = (crc << 4) ^ _crc_table[(crc >> 12) ^ (*data & 0x0f)];
+    data++;
+  }
+  return crc;
+}
@@ -0,0 +1,81 @@
+/****************************************************************************
+  qti_bridge.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTI_BRIDGE_H
+#define QTI_BRIDGE_H
+
+/*
+  Signal bridge between two tinyq instances over a byte stream, a UART on
+  target, a socket or a pipe on the host. Remote Qties are proxies in the
+  local tq_qti_table with qti_bridge_signal_entry as their entry, the
+  application lists them in qti_bridge_routes[] with their id on the other
+  side. A signal sent to a proxy arrives at the remote Qti from the proxy of
+  the sender, or from the remote bridge when the sender has none. Signals
+  from QTI_SYSTEM stay local. One more entry with qti_bridge_signal_entry
+  and no route is the bridge itself.
+
+  Signals are written straight into the frame the link sends from, a frame
+  holds as many as fit and goes out when the signals queued before it are
+  dispatched, or at once for a TQ_DSP_HIGH signal. Every frame carries a
+  CRC-16 and the sequence of the last frame the sender has dispatched.
+  At most BRIDGE_WINDOW frames wait for that, so the logic queue of the
+  receiver has to hold BRIDGE_WINDOW frames of signals, checked at build
+  time. The queue headers of TQ_PROFILE take twice the frame bytes for
+  short signals. Signals sent while BRIDGE_TX_FRAMES frames wait are
+  dropped and counted.
+
+  Frame: 0x7e 0xa5 length(2) seq ack signals... crc(2)
+  Signal: from to sig size param...
+*/
+
+#ifndef BRIDGE_FRAME_SIZE
+#define BRIDGE_FRAME_SIZE                   (260)           /* bytes of signals in a frame, one with 255 bytes of param */
+#endif
+
+#ifndef BRIDGE_TX_FRAMES
+#define BRIDGE_TX_FRAMES                    (3)
+#endif
+
+#ifndef BRIDGE_WINDOW
+#define BRIDGE_WINDOW                       (1)             /* frames waiting for the receiver */
+#endif
+
+#ifndef BRIDGE_STALL_TIME
+#define BRIDGE_STALL_TIME                   (200)           /* ms without an ack before frames count as lost */
+#endif
+
+/* from the link when it can be read or written, apart from the SYSTEM_NTF_xxx for a link sending from QTI_SYSTEM */
+#define BRIDGE_NTF_LINK                     TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 16)
+
+struct QTI_BRIDGE_ROUTE
+{
+  uint8 local;                              /* proxy in tq_qti_table */
+  uint8 remote;                             /* the Qti on the other side */
+};
+
+struct QTI_BRIDGE_STATS
+{
+  uint32 tx_signals;
+  uint32 tx_frames;
+  uint32 rx_signals;
+  uint32 rx_frames;
+  uint32 crc_errors;
+  uint32 dropped;
+  uint32 stalls;
+  uint32 link_errors;                       /* opens of the link that failed, tried again after BRIDGE_STALL_TIME */
+};
+
+/* of the application */
+extern const struct QTI_BRIDGE_ROUTE qti_bridge_routes[];
+extern const uint8 qti_bridge_route_count;
+
+/* of the link, which sends BRIDGE_NTF_LINK to qti when it can be read or written again, FALSE when it can not */
+extern boolean bridge_link_open(uint8 qti);
+extern uint16  bridge_link_read(uint8 *data, uint16 size);
+extern uint16  bridge_link_write(const uint8 *data, uint16 size);
+
+extern void qti_bridge_get_stats(struct QTI_BRIDGE_STATS *stats);
+extern void qti_bridge_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+#endif
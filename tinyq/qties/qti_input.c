@@ -0,0 +1,327 @@
+/****************************************************************************
+  qti_input.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tq_port.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "hw_input.h"
+#include "qti_input.h"
+
+#if QTI_INPUT_LINES_MAX < 1 || QTI_INPUT_LINES_MAX > 32
+#error "QTI_INPUT_LINES_MAX out of range"
+#endif
+
+#define INPUT_LCL_EDGE                      TQ_SIG_MAKE_LCL(0)
+
+#define TIMER_INPUT                         (1)             /* the one timer, of the scan or of the next hold event */
+#define INPUT_TICKS_PER_MS                  (_PT_TIMESTAMP_FREQ / 1000)
+#define INPUT_HOLD_NONE                     (0xffffffff)
+
+extern const uint8 tq_qti_count;
+extern const struct TQ_QTI tq_qti_table[];
+
+static uint8 find_self(void);
+static void input_irq(void);
+static void input_tick(void);
+static uint32 input_read(void);
+static void input_scan(void);
+static void input_changed(uint8 line, uint32 bit);
+static uint32 input_hold(void);
+static void input_schedule(uint32 hold_ticks);
+static void input_notify(uint8 sig, uint8 line);
+
+static uint8 _self = QTI_BROADCAST;
+static uint8 _listener;
+static const struct QTI_INPUT_CONFIG *_config;
+static uint16 _port_pins[HW_INPUT_PORTS];
+static uint32 _active_low;                  /* lines */
+static boolean _scanning;                   /* from an edge until no line moves */
+
+/* a bit a line */
+static uint32 _stable;                      /* pressed, debounced */
+static uint32 _moving;                      /* away from _stable, not for debounce scans yet */
+static uint32 _timed;                       /* held, a long press or a repeat due */
+static uint32 _repeating;                   /* held past the long press */
+
+static uint8  _counts[QTI_INPUT_LINES_MAX]; /* scans in a row away from _stable */
+static uint32 _due[QTI_INPUT_LINES_MAX];    /* tq_port_timestamp() of the next hold event */
+
+
+/* FALSE for a pin twice or a pin number on two ports, one EXTI line a pin number */
+boolean qti_input_open(const struct QTI_INPUT_CONFIG *config)
+{
+  const struct QTI_INPUT_LINE *line = config->lines;
+  uint16 pull_ups[HW_INPUT_PORTS];
+  uint16 pins = 0, bit;
+  uint8 i;
+
+  TQ_ASSERT(!_config);
+
+  if(!config->line_count || config->line_count > QTI_INPUT_LINES_MAX || !config->debounce || !config->scan_period)
+    return FALSE;
+
+  memset(_port_pins, 0, sizeof(_port_pins));
+  memset(pull_ups, 0, sizeof(pull_ups));
+  _active_low = 0;
+  for(i = 0; i < config->line_count; i++, line++)
+  {
+    bit = (uint16)(1 << line->pin);
+    if(line->port >= HW_INPUT_PORTS || line->pin > 15 || (pins & bit) ||
+       ((line->flags & QTI_INPUT_REPEAT) && !config->repeat_period))
+      return FALSE;
+
+    pins |= bit;
+    _port_pins[line->port] |= bit;
+    if(line->flags & QTI_INPUT_ACTIVE_LOW)
+    {
+      pull_ups[line->port] |= bit;
+      _active_low |= 1UL << i;
+    }
+  }
+
+  if(_self == QTI_BROADCAST)
+    _self = find_self();
+
+  _config = config;
+  _stable = 0;
+  _moving = 0;
+  _timed = 0;
+  _repeating = 0;
+  memset(_counts, 0, sizeof(_counts));
+  for(i = 0; i < HW_INPUT_PORTS; i++)
+  {
+    if(_port_pins[i])
+      hw_input_open(i, _port_pins[i], pull_ups[i], input_irq);
+  }
+
+  /* lines already pressed are reported after a debounce */
+  _scanning = TRUE;
+  input_tick();
+  return TRUE;
+}
+
+void qti_input_close(void)
+{
+  uint8 i;
+
+  if(!_config)
+    return;
+
+  hw_input_arm(FALSE);
+  for(i = 0; i < HW_INPUT_PORTS; i++)
+  {
+    if(_port_pins[i])
+      hw_input_close(i, _port_pins[i]);
+  }
+  qti_system_stop_timer(_self, TIMER_INPUT);
+  _config = 0;
+}
+
+void qti_input_set_listener(uint8 qti)
+{
+  _listener = qti;
+}
+
+uint32 qti_input_get_state(void)
+{
+  return _stable;
+}
+
+void qti_input_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint16 timer_id;
+
+  if(from == QTI_SYSTEM)
+  {
+    if(sig == SYSTEM_NTF_START)
+      _self = self->self;
+    else if(sig == SYSTEM_RSP_TIMER && _config)
+    {
+      memcpy(&timer_id, p, sizeof(timer_id));
+      if(timer_id == TIMER_INPUT)
+        input_tick();
+    }
+  }
+  else if(sig == INPUT_LCL_EDGE && _config)
+  {
+    _scanning = TRUE;
+    input_tick();
+  }
+}
+
+/* for an open before SYSTEM_NTF_START got here */
+static uint8 find_self(void)
+{
+  uint8 i;
+
+  for(i = 0; i < tq_qti_count; i++)
+  {
+    if(tq_qti_table[i].signal_entry == qti_input_signal_entry)
+      return i;
+  }
+  TQ_ASSERT(FALSE);
+  return 0;
+}
+
+/* masked by hw_input until armed again, one a burst of edges */
+static void input_irq(void)
+{
+  tinyq_send_signal(_self, _self, INPUT_LCL_EDGE, 0, 0);
+}
+
+/* hold events due go out before a release the same scan takes */
+static void input_tick(void)
+{
+  input_hold();
+  if(_scanning)
+    input_scan();
+  input_schedule(input_hold());
+}
+
+/* every port once, pressed lines at 1 */
+static uint32 input_read(void)
+{
+  const struct QTI_INPUT_LINE *line = _config->lines;
+  uint16 levels[HW_INPUT_PORTS];
+  uint32 pressed = 0, bit = 1;
+  uint8 i;
+
+  for(i = 0; i < HW_INPUT_PORTS; i++)
+  {
+    if(_port_pins[i])
+      levels[i] = hw_input_read(i);
+  }
+  for(i = 0; i < _config->line_count; i++, line++, bit <<= 1)
+  {
+    if((levels[line->port] >> line->pin) & 1)
+      pressed |= bit;
+  }
+  return pressed ^ _active_low;
+}
+
+/* the lines away from their level or moving only */
+static void input_scan(void)
+{
+  uint32 away = input_read() ^ _stable;
+  uint32 lines = away | _moving;
+  uint32 bit;
+  uint8 i;
+
+  for(i = 0, bit = 1; lines; i++, bit <<= 1)
+  {
+    if(!(lines & bit))
+      continue;
+    lines ^= bit;
+
+    if(!(away & bit))
+    {
+      _counts[i] = 0;
+      _moving &= ~bit;
+    }
+    else if(++_counts[i] < _config->debounce)
+      _moving |= bit;
+    else
+    {
+      _counts[i] = 0;
+      _moving &= ~bit;
+      _stable ^= bit;
+      input_changed(i, bit);
+    }
+  }
+}
+
+static void input_changed(uint8 line, uint32 bit)
+{
+  if(!(_stable & bit))
+  {
+    _timed &= ~bit;
+    input_notify(INPUT_NTF_RELEASE, line);
+    return;
+  }
+
+  input_notify(INPUT_NTF_PRESS, line);
+  if(_config->lines[line].flags & (QTI_INPUT_LONG | QTI_INPUT_REPEAT))
+  {
+    _due[line] = tq_port_timestamp() + (uint32)_config->long_press * INPUT_TICKS_PER_MS;
+    _timed |= bit;
+    _repeating &= ~bit;
+  }
+}
+
+/* the hold events due, then the timestamp ticks to the next one */
+static uint32 input_hold(void)
+{
+  uint32 now, lines = _timed, bit, left, next = INPUT_HOLD_NONE;
+  uint32 repeat = (uint32)_config->repeat_period * INPUT_TICKS_PER_MS;
+  uint8 flags, i;
+
+  if(!lines)
+    return INPUT_HOLD_NONE;
+
+  now = tq_port_timestamp();
+  for(i = 0, bit = 1; lines; i++, bit <<= 1)
+  {
+    if(!(lines & bit))
+      continue;
+    lines ^= bit;
+
+    if((int32)(now - _due[i]) >= 0)
+    {
+      flags = _config->lines[i].flags;
+      if((flags & QTI_INPUT_LONG) && !(_repeating & bit))
+        input_notify(INPUT_NTF_LONG, i);
+      if(!(flags & QTI_INPUT_REPEAT))
+      {
+        _timed &= ~bit;
+        continue;
+      }
+      input_notify(INPUT_NTF_REPEAT, i);
+      _repeating |= bit;
+
+      /* repeats missed while late are dropped, not sent in a burst */
+      _due[i] += repeat;
+      if((int32)(now - _due[i]) >= 0)
+        _due[i] = now + repeat;
+    }
+
+    left = _due[i] - now;
+    next = (left < next) ? left : next;
+  }
+  return next;
+}
+
+/*
+  While scanning the timer ticks every scan period and the hold events
+  wait for a scan. Still, the pins are armed and a line held keeps the
+  timer at its next event, one division an event.
+*/
+static void input_schedule(uint32 hold_ticks)
+{
+  if(_scanning && !_moving)
+  {
+    /* an edge between the last scan and arming leaves a level away */
+    hw_input_arm(TRUE);
+    if(input_read() == _stable)
+      _scanning = FALSE;
+    else
+      hw_input_arm(FALSE);
+  }
+
+  if(_scanning)
+    qti_system_start_timer(_self, TIMER_INPUT, _config->scan_period);
+  else if(hold_ticks != INPUT_HOLD_NONE)
+    qti_system_start_timer(_self, TIMER_INPUT, (hold_ticks + INPUT_TICKS_PER_MS - 1) / INPUT_TICKS_PER_MS);
+  else
+    qti_system_stop_timer(_self, TIMER_INPUT);
+}
+
+static void input_notify(uint8 sig, uint8 line)
+{
+  if(_listener)
+    tinyq_send_signal(_self, _listener, sig, &line, sizeof(line));
+}
@@ -0,0 +1,59 @@
+/****************************************************************************
+  qti_input.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTI_INPUT_H
+#define QTI_INPUT_H
+
+/*
+  Buttons and keypads on the hw_input.h of the port, any number of lines
+  up to QTI_INPUT_LINES_MAX on one system timer. While every line is
+  stable the pins wait on their edge interrupts and no timer runs. The
+  first edge masks them all and starts a scan, the ports are read whole
+  every scan_period ms and a line takes a new level after debounce scans
+  in a row at it. The scan stops and the pins are armed again once no line
+  is moving. A line held with QTI_INPUT_LONG or QTI_INPUT_REPEAT keeps the
+  timer for its next event only, long_press ms after the press, then every
+  repeat_period ms.
+
+  Events go to the listener with the index of the line in the config.
+*/
+
+#ifndef QTI_INPUT_LINES_MAX
+#define QTI_INPUT_LINES_MAX                 (32)
+#endif
+
+/* flags of a line */
+#define QTI_INPUT_ACTIVE_LOW                (0x01)          /* pressed at 0, pulled up, else pulled down */
+#define QTI_INPUT_LONG                      (0x02)          /* INPUT_NTF_LONG once held long_press ms */
+#define QTI_INPUT_REPEAT                    (0x04)          /* INPUT_NTF_REPEAT from long_press ms on */
+
+#define INPUT_NTF_PRESS                     TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 1)   /* p: uint8 line */
+#define INPUT_NTF_RELEASE                   TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 2)   /* p: uint8 line */
+#define INPUT_NTF_LONG                      TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 3)   /* p: uint8 line */
+#define INPUT_NTF_REPEAT                    TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 4)   /* p: uint8 line */
+
+struct QTI_INPUT_LINE
+{
+  uint8 port;                               /* 0 GPIOA, 1 GPIOB ... as EXTI_PortSourceGPIOx */
+  uint8 pin;
+  uint8 flags;
+};
+
+struct QTI_INPUT_CONFIG
+{
+  const struct QTI_INPUT_LINE *lines;       /* kept, not copied */
+  uint8  line_count;
+  uint8  debounce;                          /* scans in a row at a level */
+  uint16 scan_period;                       /* ms */
+  uint16 long_press;                        /* ms */
+  uint16 repeat_period;                     /* ms */
+};
+
+extern boolean qti_input_open(const struct QTI_INPUT_CONFIG *config);
+extern void    qti_input_close(void);
+extern void    qti_input_set_listener(uint8 qti);
+extern uint32  qti_input_get_state(void);   /* a bit a line, pressed as debounced */
+extern void    qti_input_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+#endif
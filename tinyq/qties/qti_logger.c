@@ -0,0 +1,404 @@
+/****************************************************************************
+  qti_logger.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "hw_flash.h"
+#include "qti_logger.h"
+
+#define PAGE_MAGIC                          (0x4c47)
+#define PAGE_HEADER_SIZE                    (8)
+#define ERASED                              (0xffff)
+#define RECORD_WORDS(LENGTH)                (1 + ((LENGTH) + 1) / 2)
+
+#if QTI_LOGGER_PAGES < 2 || QTI_LOGGER_PAGES > 255
+#error "QTI_LOGGER_PAGES out of range"
+#endif
+
+#if QTI_LOGGER_RECORD_MAX < 1 || QTI_LOGGER_RECORD_MAX > 255 || QTI_LOGGER_RECORD_MAX + 2 > QTI_LOGGER_BUFFER_SIZE || \
+    QTI_LOGGER_RECORD_MAX + 2 > HW_FLASH_PAGE_SIZE - PAGE_HEADER_SIZE
+#error "QTI_LOGGER_RECORD_MAX out of range"
+#endif
+
+#define LOGGER_LCL_KICK                     TQ_SIG_MAKE_LCL(0)
+#define LOGGER_LCL_STEP                     TQ_SIG_MAKE_LCL(1)
+
+#define TIMER_FLUSH                         (0x01)
+
+static void    kick(void);
+static void    step(void);
+static void    advance_page(void);
+static boolean page_sequence(uint8 page, uint32 *sequence);
+static boolean in_run(uint8 reference, uint32 sequence, uint8 distance);
+static uint32  page_address(uint8 page);
+
+static uint8 _self;
+static struct QTI_LOGGER_STATS _stats;
+
+/* records as they go to flash, from _buffer_head on */
+static uint16 _buffer[QTI_LOGGER_BUFFER_SIZE / 2];
+static uint16 _buffer_head;
+static uint16 _buffer_count;                /* half words */
+
+static uint8  _page;                        /* head of the log */
+static uint32 _sequence;                    /* of the head page */
+static uint16 _page_used;                   /* bytes, HW_FLASH_PAGE_SIZE when no more fit */
+static uint8  _record_done;                 /* data half words of the first record programmed */
+
+static boolean _busy;                       /* steps running */
+static boolean _kick_pending;
+static boolean _flushing;
+static boolean _timer_running;
+
+
+/* from anywhere, interrupts too */
+boolean qti_logger_append(const void *data, uint8 size)
+{
+  const uint8 *bytes = (const uint8*)data;
+  uint16 words = RECORD_WORDS(size), tail, i;
+  uint16 word;
+  boolean need_kick;
+
+  qti_system_lock();
+  if(!size || size > QTI_LOGGER_RECORD_MAX || _buffer_count + words > QTI_LOGGER_BUFFER_SIZE / 2)
+  {
+    _stats.dropped++;
+    qti_system_unlock();
+    return FALSE;
+  }
+
+  tail = (_buffer_head + _buffer_count) % (QTI_LOGGER_BUFFER_SIZE / 2);
+  _buffer[tail] = size;
+  for(i = 0; i < size; i += 2)
+  {
+    word = ERASED;
+    memcpy(&word, bytes + i, (size - i > 1) ? 2 : 1);
+    tail = (tail + 1 == QTI_LOGGER_BUFFER_SIZE / 2) ? 0 : tail + 1;
+    _buffer[tail] = word;
+  }
+  _buffer_count += words;
+
+  /* records appended before the start wait for it */
+  need_kick = (_self && !_busy && !_kick_pending) ? TRUE : FALSE;
+  _kick_pending |= need_kick;
+  qti_system_unlock();
+
+  if(need_kick)
+    tinyq_send_signal(_self, _self, LOGGER_LCL_KICK, 0, 0);
+  return TRUE;
+}
+
+void qti_logger_flush(void)
+{
+  boolean need_kick;
+
+  qti_system_lock();
+  _flushing = TRUE;
+  need_kick = (_self && !_busy && !_kick_pending) ? TRUE : FALSE;
+  _kick_pending |= need_kick;
+  qti_system_unlock();
+
+  if(need_kick)
+    tinyq_send_signal(_self, _self, LOGGER_LCL_KICK, 0, 0);
+}
+
+/* nothing waits in RAM */
+boolean qti_logger_idle(void)
+{
+  return (!_buffer_count && !_busy) ? TRUE : FALSE;
+}
+
+/* from the oldest page on, records programmed by then */
+void qti_logger_rewind(struct QTI_LOGGER_CURSOR *cursor)
+{
+  cursor->page = (_page + 1) % QTI_LOGGER_PAGES;
+  cursor->pages_left = QTI_LOGGER_PAGES;
+  cursor->offset = 0;
+}
+
+/* length of the next record, 0 at the end of the log */
+uint8 qti_logger_read(struct QTI_LOGGER_CURSOR *cursor, const uint8 **data)
+{
+  const uint8 *page;
+  uint32 sequence;
+  uint16 length;
+
+  while(cursor->pages_left)
+  {
+    page = (const uint8*)hw_flash_map(page_address(cursor->page));
+    if(!cursor->offset)
+    {
+      if(page_sequence(cursor->page, &sequence) && sequence == _sequence - (cursor->pages_left - 1))
+        cursor->offset = PAGE_HEADER_SIZE;
+    }
+
+    if(cursor->offset && cursor->offset + 2 <= HW_FLASH_PAGE_SIZE)
+    {
+      memcpy(&length, page + cursor->offset, sizeof(length));
+      if(length && length <= QTI_LOGGER_RECORD_MAX && cursor->offset + RECORD_WORDS(length) * 2 <= HW_FLASH_PAGE_SIZE)
+      {
+        *data = page + cursor->offset + 2;
+        cursor->offset += RECORD_WORDS(length) * 2;
+        return (uint8)length;
+      }
+    }
+
+    cursor->page = (cursor->page + 1) % QTI_LOGGER_PAGES;
+    cursor->pages_left--;
+    cursor->offset = 0;
+  }
+  return 0;
+}
+
+/*
+  Pages from the first valid one on form a run of sequence numbers up to
+  the head and no further, older pages and erased ones follow it.
+*/
+void qti_logger_recover(void)
+{
+  const uint8 *page;
+  uint32 sequence;
+  uint16 offset, length;
+  uint8 reference, low, high, middle;
+
+  _stats.boot_reads = 0;
+  _record_done = 0;
+  for(reference = 0; reference < QTI_LOGGER_PAGES; reference++)
+  {
+    _stats.boot_reads++;
+    if(page_sequence(reference, &sequence))
+      break;
+  }
+  if(reference == QTI_LOGGER_PAGES)
+  {
+    /* blank, the first record erases page 0 */
+    _page = QTI_LOGGER_PAGES - 1;
+    _sequence = 0xffffffffUL;
+    _page_used = HW_FLASH_PAGE_SIZE;
+    return;
+  }
+
+  low = 0;
+  high = QTI_LOGGER_PAGES;
+  while(high - low > 1)
+  {
+    middle = (low + high) / 2;
+    if(in_run(reference, sequence, middle))
+      low = middle;
+    else
+      high = middle;
+  }
+  _page = (reference + low) % QTI_LOGGER_PAGES;
+  _sequence = sequence + low;
+
+  page = (const uint8*)hw_flash_map(page_address(_page));
+  for(offset = PAGE_HEADER_SIZE; offset + 2 <= HW_FLASH_PAGE_SIZE; offset += RECORD_WORDS(length) * 2)
+  {
+    memcpy(&length, page + offset, sizeof(length));
+    if(length == ERASED)
+      break;
+    if(!length || length > QTI_LOGGER_RECORD_MAX || offset + RECORD_WORDS(length) * 2 > HW_FLASH_PAGE_SIZE)
+    {
+      offset = HW_FLASH_PAGE_SIZE;
+      break;
+    }
+  }
+  _page_used = offset;
+
+  /* a record cut short leaves data behind the end, the page is done */
+  for(; offset + 2 <= HW_FLASH_PAGE_SIZE; offset += 2)
+  {
+    memcpy(&length, page + offset, sizeof(length));
+    if(length != ERASED)
+    {
+      _page_used = HW_FLASH_PAGE_SIZE;
+      break;
+    }
+  }
+}
+
+void qti_logger_get_stats(struct QTI_LOGGER_STATS *stats)
+{
+  qti_system_lock();
+  *stats = _stats;
+  qti_system_unlock();
+}
+
+void qti_logger_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  uint16 id;
+
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+  {
+    qti_logger_recover();
+    qti_system_lock();
+    _self = self->self;
+    qti_system_unlock();
+    kick();
+  }
+  else if(from == QTI_SYSTEM && sig == SYSTEM_RSP_TIMER)
+  {
+    id = *((uint16*)(p));
+    if(id == TIMER_FLUSH)
+    {
+      _timer_running = FALSE;
+      _flushing = TRUE;
+      kick();
+    }
+  }
+  else if(sig == LOGGER_LCL_KICK)
+  {
+    qti_system_lock();
+    _kick_pending = FALSE;
+    qti_system_unlock();
+    kick();
+  }
+  else if(sig == LOGGER_LCL_STEP)
+    step();
+}
+
+/* steps start on a full batch or a flush, the timer sees to the rest */
+static void kick(void)
+{
+  if(_busy)
+    return;
+  if(!_buffer_count)
+  {
+    _flushing = FALSE;
+    return;
+  }
+
+  if(_buffer_count * 2 >= QTI_LOGGER_BATCH || _flushing)
+  {
+    if(_timer_running)
+    {
+      qti_system_stop_timer(_self, TIMER_FLUSH);
+      _timer_running = FALSE;
+    }
+    _busy = TRUE;
+    tinyq_send_signal(_self, _self, LOGGER_LCL_STEP, 0, 0);
+  }
+  else if(!_timer_running)
+  {
+    qti_system_start_timer(_self, TIMER_FLUSH, QTI_LOGGER_FLUSH_TIME);
+    _timer_running = TRUE;
+  }
+}
+
+/* the data of the first record a chunk at a time, then its length, until RAM is empty */
+static void step(void)
+{
+  uint16 chunk[QTI_LOGGER_CHUNK];
+  uint16 length, words, count, index, i;
+  uint32 address;
+
+  if(!_buffer_count)
+  {
+    qti_system_lock();
+    _busy = FALSE;
+    _flushing = FALSE;
+    qti_system_unlock();
+    return;
+  }
+
+  length = _buffer[_buffer_head];
+  words = RECORD_WORDS(length);
+  if(!_record_done && _page_used + words * 2 > HW_FLASH_PAGE_SIZE)
+  {
+    advance_page();
+    tinyq_send_signal(_self, _self, LOGGER_LCL_STEP, 0, 0);
+    return;
+  }
+
+  address = page_address(_page) + _page_used;
+  if(_record_done < words - 1)
+  {
+    count = words - 1 - _record_done;
+    count = (count > QTI_LOGGER_CHUNK) ? QTI_LOGGER_CHUNK : count;
+    index = (_buffer_head + 1 + _record_done) % (QTI_LOGGER_BUFFER_SIZE / 2);
+    for(i = 0; i < count; i++)
+    {
+      chunk[i] = _buffer[index];
+      index = (index + 1 == QTI_LOGGER_BUFFER_SIZE / 2) ? 0 : index + 1;
+    }
+
+    if(hw_flash_program(address + 2 + _record_done * 2, chunk, count))
+      _record_done += count;
+    else
+    {
+      /* not erased, the record starts over on the next page */
+      _stats.errors++;
+      _page_used = HW_FLASH_PAGE_SIZE;
+      _record_done = 0;
+    }
+  }
+  else if(hw_flash_program(address, &length, 1))
+  {
+    _stats.records++;
+    _stats.bytes += length;
+    _page_used += words * 2;
+    _record_done = 0;
+
+    qti_system_lock();
+    _buffer_head = (_buffer_head + words) % (QTI_LOGGER_BUFFER_SIZE / 2);
+    _buffer_count -= words;
+    qti_system_unlock();
+  }
+  else
+  {
+    /* the record goes again on the next page */
+    _stats.errors++;
+    _page_used = HW_FLASH_PAGE_SIZE;
+    _record_done = 0;
+  }
+  tinyq_send_signal(_self, _self, LOGGER_LCL_STEP, 0, 0);
+}
+
+static void advance_page(void)
+{
+  uint16 header[3];
+
+  _page = (_page + 1) % QTI_LOGGER_PAGES;
+  _sequence++;
+  _page_used = PAGE_HEADER_SIZE;
+
+  header[0] = PAGE_MAGIC;
+  header[1] = (uint16)_sequence;
+  header[2] = (uint16)(_sequence >> 16);
+  _stats.erases++;
+  if(!hw_flash_erase_page(page_address(_page)) || !hw_flash_program(page_address(_page), header, 3))
+  {
+    _stats.errors++;
+    _page_used = HW_FLASH_PAGE_SIZE;
+  }
+}
+
+static boolean page_sequence(uint8 page, uint32 *sequence)
+{
+  uint16 header[4];
+
+  memcpy(header, hw_flash_map(page_address(page)), sizeof(header));
+  if(header[0] != PAGE_MAGIC || header[3] != ERASED)
+    return FALSE;
+
+  *sequence = header[1] | ((uint32)header[2] << 16);
+  return TRUE;
+}
+
+static boolean in_run(uint8 reference, uint32 sequence, uint8 distance)
+{
+  uint32 found;
+
+  _stats.boot_reads++;
+  return (page_sequence((reference + distance) % QTI_LOGGER_PAGES, &found) && found == sequence + distance) ? TRUE : FALSE;
+}
+
+static uint32 page_address(uint8 page)
+{
+  return QTI_LOGGER_BASE + (uint32)page * HW_FLASH_PAGE_SIZE;
+}
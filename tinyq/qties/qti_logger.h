@@ -0,0 +1,82 @@
+/****************************************************************************
+  qti_logger.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTI_LOGGER_H
+#define QTI_LOGGER_H
+
+/*
+  Append only log of records in a ring of flash pages, on the
+  hw_flash.h of the port. Records are batched in RAM and programmed once
+  QTI_LOGGER_BATCH bytes wait, QTI_LOGGER_FLUSH_TIME after the first, or
+  on qti_logger_flush(). Programming goes QTI_LOGGER_CHUNK half words per
+  signal to itself, other signals are dispatched in between. The log
+  moves on to the next page of the ring when a record does not fit, that
+  page is erased then and its records are lost, every page is erased as
+  often as the others.
+
+  A page starts with a header holding a sequence number one more than the
+  page before it. At start the head page is found by a binary search
+  over the headers and the end of its records by a walk. A record is
+  committed by programming its length last, one cut short by a reset is
+  left behind together with the rest of its page.
+
+  Page: 0x4c47 sequence(4) 0xffff record...
+  Record: length(2) data... padded to a half word
+*/
+
+#ifndef QTI_LOGGER_BASE
+#define QTI_LOGGER_BASE                     (0x0800e000UL)  /* last 8KB of 64KB */
+#endif
+
+#ifndef QTI_LOGGER_PAGES
+#define QTI_LOGGER_PAGES                    (8)
+#endif
+
+#ifndef QTI_LOGGER_BUFFER_SIZE
+#define QTI_LOGGER_BUFFER_SIZE              (256)           /* bytes of RAM for records not programmed yet */
+#endif
+
+#ifndef QTI_LOGGER_RECORD_MAX
+#define QTI_LOGGER_RECORD_MAX               (64)
+#endif
+
+#ifndef QTI_LOGGER_BATCH
+#define QTI_LOGGER_BATCH                    (128)           /* bytes */
+#endif
+
+#ifndef QTI_LOGGER_FLUSH_TIME
+#define QTI_LOGGER_FLUSH_TIME               (1000)          /* ms */
+#endif
+
+#ifndef QTI_LOGGER_CHUNK
+#define QTI_LOGGER_CHUNK                    (8)             /* half words a step, about 50us each */
+#endif
+
+struct QTI_LOGGER_CURSOR
+{
+  uint8  page;
+  uint8  pages_left;
+  uint16 offset;                            /* in the page, 0 before its header */
+};
+
+struct QTI_LOGGER_STATS
+{
+  uint32 records;                           /* programmed */
+  uint32 bytes;
+  uint32 erases;
+  uint32 dropped;                           /* no room in RAM */
+  uint32 errors;                            /* of flash operations */
+  uint16 boot_reads;                        /* page headers read at start */
+};
+
+extern boolean qti_logger_append(const void *data, uint8 size);
+extern void    qti_logger_flush(void);
+extern boolean qti_logger_idle(void);
+extern void    qti_logger_rewind(struct QTI_LOGGER_CURSOR *cursor);
+extern uint8   qti_logger_read(struct QTI_LOGGER_CURSOR *cursor, const uint8 **data);
+extern void    qti_logger_recover(void);
+extern void    qti_logger_get_stats(struct QTI_LOGGER_STATS *stats);
+extern void    qti_logger_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+#endif
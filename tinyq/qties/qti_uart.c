@@ -0,0 +1,236 @@
+/****************************************************************************
+  qti_uart.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#include <string.h>
+#include "tq_types.h"
+#include "tinyq.h"
+#include "qties.h"
+#include "hw_debug.h"
+#include "qti_system.h"
+#include "hw_uart.h"
+#include "qti_uart.h"
+
+#if QTI_UART_TX_BUFFERS < 1 || QTI_UART_TX_BUFFERS > 8
+#error "QTI_UART_TX_BUFFERS out of range"
+#endif
+
+static void rx_irq(void);
+static void rx_deliver(uint16 start, uint16 size);
+static void tx_irq(void);
+static uint8 tx_index(const uint8 *buffer);
+
+static uint8 _self;
+static uint8 _listener = 0;
+static boolean _open;
+static struct QTI_UART_STATS _stats;
+
+static uint8  _rx_ring[QTI_UART_RX_SIZE];
+static uint16 _rx_tail;                     /* next byte to deliver */
+static uint16 _rx_pending;                  /* delivered, not released */
+
+/* queued buffers go out from _tx_head on, _tx_free has a bit per buffer */
+static uint8  _tx_pool[QTI_UART_TX_BUFFERS][QTI_UART_TX_BUFFER_SIZE];
+static uint8  _tx_queue[QTI_UART_TX_BUFFERS];
+static uint16 _tx_sizes[QTI_UART_TX_BUFFERS];
+static uint8  _tx_head;
+static uint8  _tx_count;
+static uint8  _tx_free;
+static boolean _tx_starved;
+
+
+void qti_uart_set_listener(uint8 qti)
+{
+  _listener = qti;
+}
+
+void qti_uart_open(uint32 baud)
+{
+  TQ_ASSERT(!_open);
+
+  _rx_tail = 0;
+  _rx_pending = 0;
+  _tx_head = 0;
+  _tx_count = 0;
+  _tx_free = (uint8)((1 << QTI_UART_TX_BUFFERS) - 1);
+  _tx_starved = FALSE;
+  _open = TRUE;
+
+  qti_system_request_wait(_self);
+  hw_uart_open(baud, _rx_ring, QTI_UART_RX_SIZE, rx_irq, tx_irq);
+}
+
+/* buffers still queued are dropped */
+void qti_uart_close(void)
+{
+  if(!_open)
+    return;
+
+  hw_uart_close();
+  _open = FALSE;
+  qti_system_release_wait(_self);
+}
+
+void qti_uart_rx_release(uint16 size)
+{
+  qti_system_lock();
+  _rx_pending = (size > _rx_pending) ? 0 : _rx_pending - size;
+  qti_system_unlock();
+}
+
+uint8 *qti_uart_tx_alloc(void)
+{
+  uint8 *buffer = 0;
+  uint8 i;
+
+  qti_system_lock();
+  for(i = 0; i < QTI_UART_TX_BUFFERS; i++)
+  {
+    if(_tx_free & (1 << i))
+    {
+      _tx_free &= ~(1 << i);
+      buffer = _tx_pool[i];
+      break;
+    }
+  }
+  if(!buffer)
+    _tx_starved = TRUE;
+  qti_system_unlock();
+
+  return buffer;
+}
+
+/* the buffer belongs to the UART from here on, an empty one is freed */
+void qti_uart_tx_send(uint8 *buffer, uint16 size)
+{
+  uint8 index = tx_index(buffer);
+
+  TQ_ASSERT(_open && size <= QTI_UART_TX_BUFFER_SIZE);
+
+  qti_system_lock();
+  if(!size)
+    _tx_free |= (1 << index);
+  else
+  {
+    _tx_queue[(_tx_head + _tx_count) % QTI_UART_TX_BUFFERS] = index;
+    _tx_sizes[index] = size;
+    _tx_count++;
+    if(_tx_count == 1)
+      hw_uart_tx(buffer, size);
+  }
+  qti_system_unlock();
+}
+
+/* copies as much as there are free buffers for */
+uint16 qti_uart_write(const uint8 *data, uint16 size)
+{
+  uint16 written = 0, chunk;
+  uint8 *buffer;
+
+  while(written < size)
+  {
+    buffer = qti_uart_tx_alloc();
+    if(!buffer)
+      break;
+
+    chunk = (size - written > QTI_UART_TX_BUFFER_SIZE) ? QTI_UART_TX_BUFFER_SIZE : size - written;
+    memcpy(buffer, data + written, chunk);
+    qti_uart_tx_send(buffer, chunk);
+    written += chunk;
+  }
+  return written;
+}
+
+void qti_uart_get_stats(struct QTI_UART_STATS *stats)
+{
+  qti_system_lock();
+  *stats = _stats;
+  qti_system_unlock();
+}
+
+void qti_uart_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size)
+{
+  if(from == QTI_SYSTEM && sig == SYSTEM_NTF_START)
+    _self = self->self;
+}
+
+/* half and full transfer and idle line, all bytes up to the DMA position */
+static void rx_irq(void)
+{
+  uint16 position = hw_uart_rx_position();
+
+  if(position == _rx_tail)
+    return;
+
+  if(position > _rx_tail)
+    rx_deliver(_rx_tail, position - _rx_tail);
+  else
+  {
+    rx_deliver(_rx_tail, QTI_UART_RX_SIZE - _rx_tail);
+    if(position)
+      rx_deliver(0, position);
+  }
+  _rx_tail = position;
+}
+
+static void rx_deliver(uint16 start, uint16 size)
+{
+  struct QTI_UART_SPAN span;
+
+  /* the DMA has written them over bytes the listener still holds */
+  if(_rx_pending + size > QTI_UART_RX_SIZE)
+  {
+    _stats.rx_overruns += size;
+    return;
+  }
+
+  _rx_pending += size;
+  _stats.rx_bytes += size;
+  _stats.rx_spans++;
+
+  span.data = _rx_ring + start;
+  span.size = size;
+  tinyq_send_signal(_self, _listener, UART_NTF_RX, &span, sizeof(span));
+}
+
+/* the front buffer is out, the next one goes */
+static void tx_irq(void)
+{
+  uint8 index;
+
+  if(!_tx_count)
+    return;
+
+  index = _tx_queue[_tx_head];
+  _stats.tx_bytes += _tx_sizes[index];
+  _stats.tx_buffers++;
+  _tx_free |= (1 << index);
+  _tx_head = (_tx_head + 1) % QTI_UART_TX_BUFFERS;
+  _tx_count--;
+
+  if(_tx_count)
+  {
+    index = _tx_queue[_tx_head];
+    hw_uart_tx(_tx_pool[index], _tx_sizes[index]);
+  }
+  if(_tx_starved)
+  {
+    _tx_starved = FALSE;
+    tinyq_send_signal(_self, _listener, UART_NTF_TX_READY, 0, 0);
+  }
+}
+
+/* no divider on the M0, the pool is short */
+static uint8 tx_index(const uint8 *buffer)
+{
+  uint8 i;
+
+  for(i = 0; i < QTI_UART_TX_BUFFERS; i++)
+  {
+    if(buffer == _tx_pool[i])
+      return i;
+  }
+
+  TQ_ASSERT(FALSE);
+  return 0;
+}
@@ -0,0 +1,60 @@
+/****************************************************************************
+  qti_uart.h
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+****************************************************************************/
+#ifndef QTI_UART_H
+#define QTI_UART_H
+
+/*
+  UART with DMA both ways, on the hw_uart.h of the port. Reception runs
+  into a circular ring, at half and full transfer and on an idle line the
+  bytes received since are sent to the listener as a span of the ring,
+  two when they wrap. The listener reads them in place and hands them back
+  with qti_uart_rx_release(), in order. Bytes the ring has no room for
+  while spans are held are dropped as overrun, the listener never sees
+  more spans queued than fit the ring. Transmission takes buffers of a small pool,
+  filled by the caller and queued for the DMA as they are. The UART holds
+  a wait while open, the DMA stops in STOP mode.
+*/
+
+#ifndef QTI_UART_RX_SIZE
+#define QTI_UART_RX_SIZE                    (128)
+#endif
+
+#ifndef QTI_UART_TX_BUFFERS
+#define QTI_UART_TX_BUFFERS                 (4)             /* up to 8 */
+#endif
+
+#ifndef QTI_UART_TX_BUFFER_SIZE
+#define QTI_UART_TX_BUFFER_SIZE             (64)
+#endif
+
+#define UART_NTF_RX                         TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 1)   /* p: struct QTI_UART_SPAN */
+#define UART_NTF_TX_READY                   TQ_SIG_MAKE_NTF(TQ_DSP_NORMAL, 2)   /* a buffer is free after qti_uart_tx_alloc() failed */
+
+struct QTI_UART_SPAN
+{
+  const uint8 *data;
+  uint16 size;
+};
+
+struct QTI_UART_STATS
+{
+  uint32 rx_bytes;
+  uint32 rx_spans;
+  uint32 rx_overruns;                       /* bytes dropped, the listener held the ring */
+  uint32 tx_bytes;
+  uint32 tx_buffers;
+};
+
+extern void    qti_uart_set_listener(uint8 qti);
+extern void    qti_uart_open(uint32 baud);
+extern void    qti_uart_close(void);
+extern void    qti_uart_rx_release(uint16 size);
+extern uint8  *qti_uart_tx_alloc(void);                     /* QTI_UART_TX_BUFFER_SIZE bytes, 0 when all are queued */
+extern void    qti_uart_tx_send(uint8 *buffer, uint16 size);
+extern uint16  qti_uart_write(const uint8 *data, uint16 size);
+extern void    qti_uart_get_stats(struct QTI_UART_STATS *stats);
+extern void    qti_uart_signal_entry(const struct TQ_QTI *self, uint8 from, uint8 sig, const uint8 *p, uint8 size);
+
+#endif
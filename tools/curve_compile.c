@@ -0,0 +1,275 @@
+/****************************************************************************
+  curve_compile.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Builds the const slot table of a struct S_CURVE of tinyq/misc/curve.h.
+  The curve is resampled at every 1 << slot_bits of x, the value and the
+  slope to the next sample go into a slot. Points come as "x y" lines on
+  stdin, x rising, linear in between, or from the Beta equation of an NTC
+  thermistor to ground under a pull up, x the ADC code and y the degrees.
+
+    R=../tinyq
+    cc -I$R/core -I$R/misc -I$R/hw/posix -o curve_compile curve_compile.c $R/misc/curve.c -lm
+    curve_compile [-n name] [-b slot bits | -e max error] [-s y scale] < points > curve.h
+    curve_compile -ntc beta r25 pull_up [-adc bits] [-t t_min t_max] [-n name] ... > curve.h
+
+  Without -b the widest slots within -e of the curve are taken, y in its
+  units after -s. The NTC defaults to a 12 bit ADC, -40 to 125 degrees and
+  a scale of 100. A summary goes to stderr: slots, bytes, the largest error
+  of curve_value() over every x of the curve and where it is.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "tq_types.h"
+#include "curve.h"
+
+#define DEFAULT_NAME                        "_curve"
+#define DEFAULT_MAX_ERROR                   (1.0)
+#define DEFAULT_NTC_ADC_BITS                (12)
+#define DEFAULT_NTC_T_MIN                   (-40.0)
+#define DEFAULT_NTC_T_MAX                   (125.0)
+#define DEFAULT_NTC_SCALE                   (100.0)
+#define POINTS_MAX                          (4096)
+#define SLOT_BITS_MAX                       (10)
+#define KELVIN                              (273.15)
+
+static boolean read_points(void);
+static boolean ntc_range(void);
+static double curve_at(double x);
+static double ntc_at(double x);
+static boolean build(uint8 slot_bits);
+static double max_error(uint32 *at);
+static void emit(void);
+
+static const char *_name = DEFAULT_NAME;
+static double _scale = 1.0;
+static double _max_error = DEFAULT_MAX_ERROR;
+static int    _slot_bits = -1;
+
+static boolean _ntc;
+static double _ntc_beta;
+static double _ntc_r25;
+static double _ntc_pull_up;
+static uint8  _ntc_adc_bits = DEFAULT_NTC_ADC_BITS;
+static double _ntc_t_min = DEFAULT_NTC_T_MIN;
+static double _ntc_t_max = DEFAULT_NTC_T_MAX;
+
+static double _px[POINTS_MAX];
+static double _py[POINTS_MAX];
+static uint32 _point_count;
+
+static struct S_CURVE_SLOT _slots[65536];
+static struct S_CURVE _curve = {_slots, 0, 0, 0, 0};
+
+
+int main(int argc, char *argv[])
+{
+  boolean scaled = FALSE;
+  uint32 at;
+  double error;
+  int i, bits;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-n") && i + 1 < argc)
+      _name = argv[++i];
+    else if(!strcmp(argv[i], "-b") && i + 1 < argc)
+      _slot_bits = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-e") && i + 1 < argc)
+      _max_error = atof(argv[++i]);
+    else if(!strcmp(argv[i], "-s") && i + 1 < argc)
+    {
+      _scale = atof(argv[++i]);
+      scaled = TRUE;
+    }
+    else if(!strcmp(argv[i], "-ntc") && i + 3 < argc)
+    {
+      _ntc = TRUE;
+      _ntc_beta = atof(argv[++i]);
+      _ntc_r25 = atof(argv[++i]);
+      _ntc_pull_up = atof(argv[++i]);
+    }
+    else if(!strcmp(argv[i], "-adc") && i + 1 < argc)
+      _ntc_adc_bits = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-t") && i + 2 < argc)
+    {
+      _ntc_t_min = atof(argv[++i]);
+      _ntc_t_max = atof(argv[++i]);
+    }
+  }
+  if(_ntc && !scaled)
+    _scale = DEFAULT_NTC_SCALE;
+  if(_slot_bits > SLOT_BITS_MAX)
+  {
+    fprintf(stderr, "slots of at most %u bits\n", SLOT_BITS_MAX);
+    return 1;
+  }
+
+  if(_ntc ? !ntc_range() : !read_points())
+    return 1;
+
+  /* the widest slots within the error, or the ones asked for */
+  for(bits = (_slot_bits < 0) ? SLOT_BITS_MAX : _slot_bits; bits >= 0; bits--)
+  {
+    if(build(bits) && (_slot_bits >= 0 || max_error(&at) <= _max_error))
+      break;
+    if(_slot_bits >= 0)
+    {
+      fprintf(stderr, "the curve does not fit in slots of %d bits\n", bits);
+      return 1;
+    }
+  }
+  if(bits < 0)
+  {
+    fprintf(stderr, "no slots within %.2f\n", _max_error);
+    return 1;
+  }
+
+  error = max_error(&at);
+  fprintf(stderr, "x %u to %u, %u slots of %u, %u bytes, error %.3f at %u\n", _curve.x_min, _curve.x_max,
+          _curve.slot_count, 1U << _curve.slot_bits, (uint32)(_curve.slot_count * sizeof(struct S_CURVE_SLOT)), error, at);
+  emit();
+  return 0;
+}
+
+static boolean read_points(void)
+{
+  double x, y;
+
+  while(scanf("%lf %lf", &x, &y) == 2)
+  {
+    if(_point_count == POINTS_MAX || (_point_count && x <= _px[_point_count - 1]) || x < 0 || x > 65535)
+    {
+      fprintf(stderr, "at most %u points of x 0 to 65535, rising\n", POINTS_MAX);
+      return FALSE;
+    }
+    _px[_point_count] = x;
+    _py[_point_count++] = y * _scale;
+  }
+  if(_point_count < 2)
+  {
+    fprintf(stderr, "two points at least\n");
+    return FALSE;
+  }
+  _curve.x_min = (uint16)ceil(_px[0]);
+  _curve.x_max = (uint16)floor(_px[_point_count - 1]);
+  return TRUE;
+}
+
+/* ADC codes of t_max and t_min, the code rises as the NTC cools */
+static boolean ntc_range(void)
+{
+  double full = (1UL << _ntc_adc_bits) - 1, r;
+
+  if(_ntc_beta <= 0 || _ntc_r25 <= 0 || _ntc_pull_up <= 0 || _ntc_adc_bits > 16 || _ntc_t_min >= _ntc_t_max)
+  {
+    fprintf(stderr, "beta, r25 and the pull up above 0, an ADC of 16 bits at most\n");
+    return FALSE;
+  }
+  r = _ntc_r25 * exp(_ntc_beta * (1.0 / (_ntc_t_max + KELVIN) - 1.0 / (25.0 + KELVIN)));
+  _curve.x_min = (uint16)ceil(full * r / (r + _ntc_pull_up));
+  r = _ntc_r25 * exp(_ntc_beta * (1.0 / (_ntc_t_min + KELVIN) - 1.0 / (25.0 + KELVIN)));
+  _curve.x_max = (uint16)floor(full * r / (r + _ntc_pull_up));
+  return TRUE;
+}
+
+/* the last slot ends past x_max, the curve goes on there as it ends */
+static double curve_at(double x)
+{
+  uint32 lo = 0, hi = _point_count - 1, mid;
+
+  if(_ntc)
+    return ntc_at(x);
+
+  if(x >= _px[hi])
+    lo = hi - 1;
+  while(hi - lo > 1)
+  {
+    mid = (lo + hi) / 2;
+    if(_px[mid] <= x)
+      lo = mid;
+    else
+      hi = mid;
+  }
+  return _py[lo] + (_py[hi] - _py[lo]) * (x - _px[lo]) / (_px[hi] - _px[lo]);
+}
+
+static double ntc_at(double x)
+{
+  double full = (1UL << _ntc_adc_bits) - 1;
+  double r;
+
+  x = (x < full - 0.5) ? x : full - 0.5;
+  r = _ntc_pull_up * x / (full - x);
+
+  return (1.0 / (1.0 / (25.0 + KELVIN) + log(r / _ntc_r25) / _ntc_beta) - KELVIN) * _scale;
+}
+
+/* FALSE when a value or a slope is out of 16 bits */
+static boolean build(uint8 slot_bits)
+{
+  uint32 span = (uint32)_curve.x_max - _curve.x_min;
+  uint32 i;
+  double y, next;
+
+  _curve.slot_bits = slot_bits;
+  _curve.slot_count = (uint16)((span >> slot_bits) + 1);
+  for(i = 0; i < _curve.slot_count; i++)
+  {
+    y = floor(curve_at(_curve.x_min + ((double)i * (1UL << slot_bits))) + 0.5);
+    next = floor(curve_at(_curve.x_min + ((double)(i + 1) * (1UL << slot_bits))) + 0.5);
+    if(y < -32768 || y > 32767 || next - y < -32768 || next - y > 32767)
+      return FALSE;
+    _slots[i].y = (int16)y;
+    _slots[i].k = (int16)(next - y);
+  }
+  return TRUE;
+}
+
+/* of curve_value() itself */
+static double max_error(uint32 *at)
+{
+  double error, max = 0;
+  uint32 x;
+
+  *at = _curve.x_min;
+  for(x = _curve.x_min; x <= _curve.x_max; x++)
+  {
+    error = fabs(curve_value(&_curve, (uint16)x) - curve_at(x));
+    if(error > max)
+    {
+      max = error;
+      *at = x;
+    }
+  }
+  return max;
+}
+
+/* guarded by the name upper cased, _ntc_curve in NTC_CURVE_H */
+static void emit(void)
+{
+  char guard[64];
+  uint32 i, n = 0;
+
+  for(i = (_name[0] == '_'); _name[i] && n + 3 < sizeof(guard); i++)
+    guard[n++] = (_name[i] >= 'a' && _name[i] <= 'z') ? _name[i] - 'a' + 'A' : _name[i];
+  strcpy(&guard[n], "_H");
+
+  printf("/****************************************************************************\n");
+  printf("  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.\n\n");
+  printf("  %s, generated by tools/curve_compile.c, do not edit.\n", _name);
+  if(_ntc)
+    printf("  NTC beta %.0f, %.0f ohm at 25C, %.0f ohm pull up, %u bit ADC, y in 1/%.0f C.\n", _ntc_beta, _ntc_r25,
+           _ntc_pull_up, _ntc_adc_bits, _scale);
+  printf("****************************************************************************/\n");
+  printf("#ifndef %s\n#define %s\n\n", guard, guard);
+  printf("static const struct S_CURVE_SLOT %s_slots[] =\n{", _name);
+  for(i = 0; i < _curve.slot_count; i++)
+    printf("%s{%6d, %6d},", (i % 6) ? " " : "\n  ", _slots[i].y, _slots[i].k);
+  printf("\n};\n\n");
+  printf("static const struct S_CURVE %s =\n{\n  %s_slots, %u, %u, %u, %u,\n};\n", _name, _name, _curve.slot_count,
+         _curve.x_min, _curve.x_max, _curve.slot_bits);
+  printf("\n#endif\n");
+}
@@ -0,0 +1,273 @@
+/****************************************************************************
+  melody_compile.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Compiles the buzzer melodies of melodies.h into the DMA bursts of the
+  buzzer timer, TIM17 ARR, RCR and CCR1, the way buzzer_fill_buffer() of
+  qti_indication.c would produce them note by note. Runs of periods within
+  a tolerance become one burst repeated by RCR, silences become bursts with
+  CCR1 at 0. Melodies over the size budget stay with the interpreter.
+
+    R=../tinyq; Q=../sample/sample_stm32f030/qties
+    cc -I$Q -I$R/core -I$R/misc -I$R/hw/posix -o melody_compile melody_compile.c $R/misc/interpolator.c -lm
+    melody_compile [-c cents] [-b bytes] > $Q/melody_streams.h
+
+  Periods are exact here, no tone_period(). A summary per melody goes to
+  stderr: bursts as the interpreter fills them, bursts in the stream and
+  the bytes of flash it takes, the length of a pass either way.
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "tq_types.h"
+#include "interpolator.h"
+#include "melodies.h"
+
+/* of qti_indication.c */
+#define BUZZER_X_FACTOR                     (1000 / 64)
+#define BUZZER_CLK_FREQ                     (4 * 1000 * 1000UL)
+
+#define DEFAULT_CENTS                       (5.0)
+#define DEFAULT_BUDGET                      (4096)          /* bytes a melody */
+#define BURSTS_MAX                          (65535 / 3)     /* of a DMA transfer */
+#define SILENCE_PERIOD                      (400)           /* ticks, 100us */
+#define RUN_MAX                             (256)           /* periods a burst, RCR of 8 bits */
+
+struct BURST
+{
+  uint16 arr;
+  uint16 rcr;
+  uint16 ccr;
+};
+
+static void compile(const struct S_NOTE *melody, uint8 id);
+static void add_tone(const struct S_NOTE *note);
+static void add_silence(uint32 ticks);
+static void add_period(double period);
+static void close_run(void);
+static void emit(uint8 id);
+
+static double _cents = DEFAULT_CENTS;
+static uint32 _budget = DEFAULT_BUDGET;
+
+static struct BURST _bursts[BURSTS_MAX + 2];
+static uint32 _burst_count;
+static uint32 _periods;                     /* as the interpreter fills them */
+static double _fill_ticks;                  /* of those */
+static boolean _too_long;
+
+static double _run_sum;                     /* periods of the run not closed */
+static double _run_min;
+static double _run_max;
+static uint16 _run_count;
+
+static uint8 _repeat[sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0])];
+static boolean _compiled[sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0])];
+
+
+int main(int argc, char *argv[])
+{
+  uint8 id;
+  int i;
+
+  for(i = 1; i < argc; i++)
+  {
+    if(!strcmp(argv[i], "-c") && i + 1 < argc)
+      _cents = atof(argv[++i]);
+    else if(!strcmp(argv[i], "-b") && i + 1 < argc)
+      _budget = atoi(argv[++i]);
+  }
+
+  printf("/****************************************************************************\n");
+  printf("  melody_streams.h\n");
+  printf("  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.\n\n");
+  printf("  Generated by tools/melody_compile.c from melodies.h, do not edit.\n");
+  printf("  Bursts of TIM17 ARR, RCR, CCR1, periods held within %.1f cents.\n", _cents);
+  printf("****************************************************************************/\n");
+  printf("#ifndef MELODY_STREAMS_H\n#define MELODY_STREAMS_H\n\n");
+
+  fprintf(stderr, "%6s %10s %8s %8s %10s %10s %7s\n", "melody", "fills", "bursts", "bytes", "fill ms", "stream ms", "repeat");
+  for(id = 0; id < sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0]); id++)
+  {
+    compile(_buzzer_melody_table[id], id);
+    emit(id);
+  }
+
+  printf("static const struct S_MELODY_STREAM _buzzer_stream_table[] =\n{\n");
+  for(id = 0; id < sizeof(_buzzer_melody_table) / sizeof(_buzzer_melody_table[0]); id++)
+  {
+    if(_compiled[id])
+      printf("  {_buzzer_stream_%u, sizeof(_buzzer_stream_%u) / sizeof(_buzzer_stream_%u[0]) / 3, %u},\n",
+             id, id, id, _repeat[id]);
+    else
+      printf("  {0, 0, 0},\n");
+  }
+  printf("};\n\n#endif\n");
+  return 0;
+}
+
+/* a pass of the melody, up to CTRL_STOP or CTRL_REPT */
+static void compile(const struct S_NOTE *melody, uint8 id)
+{
+  const struct S_NOTE *note;
+  uint8 func;
+
+  _burst_count = 0;
+  _periods = 0;
+  _fill_ticks = 0;
+  _too_long = FALSE;
+  _run_count = 0;
+
+  for(note = melody; ; note++)
+  {
+    func = TEMPO_GET_FUNC(note->tempo);
+    if(func == CTRL_STOP || func == CTRL_REPT)
+      break;
+
+    if(func == WAVE_SLNT)
+    {
+      add_silence(TEMPO_GET_PERIOD(note->tempo) * 10 * (BUZZER_CLK_FREQ / 1000));
+      _fill_ticks += TEMPO_GET_PERIOD(note->tempo) * 10 * (BUZZER_CLK_FREQ / 1000);
+    }
+    else
+      add_tone(note);
+  }
+  close_run();
+
+  /* CTRL_REPT n plays n passes, 0 for ever, as melody_play_note() counts them */
+  _repeat[id] = (func == CTRL_REPT) ? (uint8)TEMPO_GET_PERIOD(note->tempo) : 1;
+  if(func == CTRL_REPT && TEMPO_GET_PERIOD(note->tempo) > 255)
+    _repeat[id] = 255;
+
+  /*
+    TC comes when the last burst is written, it takes over at the next
+    update, the two silent ones let the last sound burst play out
+  */
+  add_silence(SILENCE_PERIOD);
+  close_run();
+  add_silence(SILENCE_PERIOD);
+  close_run();
+}
+
+/* buzzer_fill_buffer() a burst at a time */
+static void add_tone(const struct S_NOTE *note)
+{
+  struct S_INTERPOLATOR itp;
+  uint32 cx = 0, last_cx = 0, counter;
+  double freq;
+  int16 base = note[1].tone - note[0].tone;
+  int16 last_step = 0;
+  uint8 func = TEMPO_GET_FUNC(note->tempo);
+
+  interpolator_init(&itp, TEMPO_GET_PERIOD(note->tempo) * 10 * BUZZER_X_FACTOR, base < 0 ? -base : base,
+                    _wave_table[func], WAVE_TABLE_SIZE);
+  while(interpolator_step(&itp, last_step))
+  {
+    freq = note->tone;
+    if(base < 0)
+      freq -= interpolator_get_value(&itp);
+    else
+      freq += interpolator_get_value(&itp);
+
+    counter = (uint32)(BUZZER_CLK_FREQ / freq + 0.5);
+    cx += counter;
+    last_step = (cx - last_cx) >> 8;
+    if(last_step)
+      last_cx = cx;
+
+    add_period(BUZZER_CLK_FREQ / freq);
+    _fill_ticks += BUZZER_CLK_FREQ / freq;
+    _periods++;
+  }
+}
+
+static void add_silence(uint32 ticks)
+{
+  struct BURST *burst;
+  uint32 periods;
+
+  close_run();
+  while(ticks)
+  {
+    periods = (ticks + 65535) / 65536;
+    periods = (periods > RUN_MAX) ? RUN_MAX : periods;
+    if(_burst_count == BURSTS_MAX + 2)
+    {
+      _too_long = TRUE;
+      return;
+    }
+    burst = &_bursts[_burst_count++];
+    burst->arr = (uint16)((ticks / periods < 65536 ? ticks / periods : 65536) - 1);
+    burst->rcr = (uint16)(periods - 1);
+    burst->ccr = 0;
+    ticks -= (burst->arr + 1) * periods;
+
+    /* an ARR of 0 holds the counter, a tick is dropped */
+    if(ticks < 2)
+      ticks = 0;
+  }
+}
+
+/* the run goes on while all of it is within the tolerance */
+static void add_period(double period)
+{
+  double min = (_run_count && _run_min < period) ? _run_min : period;
+  double max = (_run_count && _run_max > period) ? _run_max : period;
+
+  if(_run_count && (_run_count == RUN_MAX || 1200 * log2(max / min) > _cents))
+  {
+    close_run();
+    min = max = period;
+  }
+  if(!_run_count)
+    _run_sum = 0;
+  _run_sum += period;
+  _run_min = min;
+  _run_max = max;
+  _run_count++;
+}
+
+/* the mean period keeps the length of the run */
+static void close_run(void)
+{
+  struct BURST *burst;
+  uint32 period;
+
+  if(!_run_count)
+    return;
+  if(_burst_count == BURSTS_MAX + 2)
+  {
+    _too_long = TRUE;
+    _run_count = 0;
+    return;
+  }
+
+  period = (uint32)(_run_sum / _run_count + 0.5);
+  burst = &_bursts[_burst_count++];
+  burst->arr = (uint16)(period - 1);
+  burst->rcr = _run_count - 1;
+  burst->ccr = (uint16)(period / 2);
+  _run_count = 0;
+}
+
+static void emit(uint8 id)
+{
+  uint32 i, bytes = _burst_count * sizeof(struct BURST);
+  double ticks = 0;
+
+  /* the two closing bursts left out */
+  for(i = 0; i + 2 < _burst_count; i++)
+    ticks += (_bursts[i].arr + 1.0) * (_bursts[i].rcr + 1);
+
+  _compiled[id] = (!_too_long && bytes <= _budget) ? TRUE : FALSE;
+  fprintf(stderr, "%6u %10u %8u %8u %10.3f %10.3f %7u%s\n", id, _periods, _burst_count, bytes,
+          _fill_ticks * 1000 / BUZZER_CLK_FREQ, ticks * 1000 / BUZZER_CLK_FREQ, _repeat[id], _compiled[id] ? "" : ", interpreted");
+  if(!_compiled[id])
+    return;
+
+  printf("static const uint16 _buzzer_stream_%u[] =\n{", id);
+  for(i = 0; i < _burst_count; i++)
+    printf("%s0x%04x, 0x%04x, 0x%04x,", (i % 4) ? "  " : "\n  ", _bursts[i].arr, _bursts[i].rcr, _bursts[i].ccr);
+  printf("\n};\n\n");
+}
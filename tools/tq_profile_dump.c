@@ -0,0 +1,144 @@
+/****************************************************************************
+  tq_profile_dump.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Prints a struct TQ_PROFILE_TABLE saved from a target (memory dump of
+  tq_profile) or written by a host build.
+
+    cc -o tq_profile_dump tq_profile_dump.c
+    tq_profile_dump tq_profile.bin
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TQ_PROFILE_MAGIC          (0x46505154)
+#define TABLE_HEADER_SIZE         (16)
+#define ENTRY_HEADER_SIZE         (20)
+
+static unsigned long get_u32(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static unsigned get_u16(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8);
+}
+
+static double ticks_to_us(unsigned long ticks, unsigned long freq)
+{
+  return ticks * 1000000.0 / freq;
+}
+
+/* upper edge of the bucket holding the given fraction of the samples */
+static double percentile_us(const unsigned char *histogram, unsigned buckets, unsigned shift,
+                            unsigned long count, double fraction, unsigned long freq)
+{
+  unsigned i;
+  unsigned long sum = 0;
+
+  for(i = 0; i < buckets; i++)
+  {
+    sum += get_u16(&histogram[i * 2]);
+    if(sum >= count * fraction)
+      break;
+  }
+  if(i >= buckets - 1)
+    return -1;
+  return ticks_to_us(2UL << (i + shift), freq);
+}
+
+int main(int argc, char *argv[])
+{
+  FILE *file;
+  unsigned char *data;
+  long size;
+  unsigned long freq, count, total;
+  unsigned slots, buckets, shift, entry_size, i, j;
+  const unsigned char *entry;
+  double p50, p99;
+
+  if(argc < 2)
+  {
+    fprintf(stderr, "usage: %s <dump file>\n", argv[0]);
+    return 1;
+  }
+
+  file = fopen(argv[1], "rb");
+  if(!file)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data = malloc(size);
+  if(!data || fread(data, 1, size, file) != (size_t)size)
+  {
+    fprintf(stderr, "%s: read failed\n", argv[1]);
+    return 1;
+  }
+  fclose(file);
+
+  if(size < TABLE_HEADER_SIZE || get_u32(data) != TQ_PROFILE_MAGIC)
+  {
+    fprintf(stderr, "%s: not a tinyq profile dump\n", argv[1]);
+    return 1;
+  }
+
+  freq = get_u32(&data[4]);
+  slots = get_u16(&data[8]);
+  buckets = data[10];
+  shift = data[11];
+  entry_size = (ENTRY_HEADER_SIZE + buckets * 2 + 3) & ~3;
+  if(size < TABLE_HEADER_SIZE + (long)(slots * entry_size))
+  {
+    fprintf(stderr, "%s: truncated dump\n", argv[1]);
+    return 1;
+  }
+
+  printf("timestamp %lu Hz, %u slots, %lu dispatches dropped\n\n", freq, slots, get_u32(&data[12]));
+  printf(" qti  sig      count    avg us    max us    p50 us    p99 us  max queued us\n");
+
+  for(i = 0; i < slots; i++)
+  {
+    entry = &data[TABLE_HEADER_SIZE + i * entry_size];
+    count = get_u32(&entry[4]);
+    if(!count)
+      break;
+
+    total = get_u32(&entry[8]);
+    p50 = percentile_us(&entry[ENTRY_HEADER_SIZE], buckets, shift, count, 0.50, freq);
+    p99 = percentile_us(&entry[ENTRY_HEADER_SIZE], buckets, shift, count, 0.99, freq);
+
+    printf("%4u 0x%02x %10lu %9.1f %9.1f ", entry[0], entry[1], count,
+           ticks_to_us(total, freq) / count, ticks_to_us(get_u32(&entry[12]), freq));
+    if(p50 < 0) printf("%9s ", "-"); else printf("%9.1f ", p50);
+    if(p99 < 0) printf("%9s ", "-"); else printf("%9.1f ", p99);
+    printf("%14.1f\n", ticks_to_us(get_u32(&entry[16]), freq));
+  }
+
+  printf("\nhandler time histograms (bucket upper edge us: count)\n");
+  for(i = 0; i < slots; i++)
+  {
+    entry = &data[TABLE_HEADER_SIZE + i * entry_size];
+    if(!get_u32(&entry[4]))
+      break;
+
+    printf("%4u 0x%02x:", entry[0], entry[1]);
+    for(j = 0; j < buckets; j++)
+    {
+      if(!get_u16(&entry[ENTRY_HEADER_SIZE + j * 2]))
+        continue;
+      if(j == buckets - 1)
+        printf(" inf:%u", get_u16(&entry[ENTRY_HEADER_SIZE + j * 2]));
+      else
+        printf(" %.1f:%u", ticks_to_us(2UL << (j + shift), freq), get_u16(&entry[ENTRY_HEADER_SIZE + j * 2]));
+    }
+    printf("\n");
+  }
+
+  free(data);
+  return 0;
+}
@@ -0,0 +1,229 @@
+/****************************************************************************
+  tq_trace_json.c
+  Copyright (c) 2021, Xiaofu Yan.  All rights reserved.
+
+  Converts a dump of tq_trace_buffer (struct TQ_TRACE_BUFFER) into Chrome
+  trace event JSON, open it in chrome://tracing or ui.perfetto.dev.
+
+    cc -o tq_trace_json tq_trace_json.c
+    tq_trace_json tq_trace.bin > trace.json
+****************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TQ_TRACE_MAGIC                      (0x52545154)
+#define BUFFER_HEADER_SIZE                  (16)
+#define RECORD_SIZE                         (8)
+
+#define TQ_TRACE_EVT_ENQUEUE                (0x01)
+#define TQ_TRACE_EVT_DISPATCH_BEGIN         (0x02)
+#define TQ_TRACE_EVT_DISPATCH_END           (0x03)
+#define TQ_TRACE_EVT_TIMER_START            (0x04)
+#define TQ_TRACE_EVT_TIMER_STOP             (0x05)
+#define TQ_TRACE_EVT_TIMER_EXPIRE           (0x06)
+#define TQ_TRACE_EVT_SLEEP_ENTER            (0x07)
+#define TQ_TRACE_EVT_SLEEP_EXIT             (0x08)
+#define TQ_TRACE_EVT_WAIT_REQUEST           (0x09)
+#define TQ_TRACE_EVT_WAIT_RELEASE           (0x0a)
+#define TQ_TRACE_EVT_EXTI                   (0x0b)
+
+#define TQ_DSP_MASK                         (0x80)
+
+enum TRACKS
+{
+  TRACK_NORMAL = 1,
+  TRACK_HIGH,
+  TRACK_SLEEP,
+  TRACK_TIMER,
+  TRACK_EXTI,
+  TRACK_COUNT
+};
+
+static const char *_track_names[TRACK_COUNT] =
+{
+  "", "normal dispatch", "high priority dispatch", "sleep", "timers", "exti"
+};
+
+static const char *_sleep_names[] = { "sleep", "stop", "standby" };
+
+static int _first = 1;
+static int _depth[TRACK_COUNT];
+
+
+static unsigned long get_u32(const unsigned char *p)
+{
+  return p[0] | (p[1] << 8) | ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+static void begin_event(const char *ph, double ts, int track)
+{
+  printf("%s\n  {\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", _first ? "" : ",", ph, ts, track);
+  _first = 0;
+}
+
+static void duration_begin(double ts, int track, const char *name, const char *args)
+{
+  begin_event("B", ts, track);
+  printf(",\"name\":\"%s\"%s%s%s}", name, args ? ",\"args\":{" : "", args ? args : "", args ? "}" : "");
+  _depth[track]++;
+}
+
+static void duration_end(double ts, int track)
+{
+  /* the ring may have dropped the begin */
+  if(!_depth[track])
+    return;
+  begin_event("E", ts, track);
+  printf("}");
+  _depth[track]--;
+}
+
+static void instant(double ts, int track, const char *name)
+{
+  begin_event("i", ts, track);
+  printf(",\"s\":\"t\",\"name\":\"%s\"}", name);
+}
+
+static void counter(double ts, const char *name, unsigned value)
+{
+  begin_event("C", ts, 0);
+  printf(",\"name\":\"%s\",\"args\":{\"%s\":%u}}", name, name, value);
+}
+
+static int dispatch_track(unsigned sig)
+{
+  return (sig & TQ_DSP_MASK) ? TRACK_NORMAL : TRACK_HIGH;
+}
+
+int main(int argc, char *argv[])
+{
+  FILE *file;
+  unsigned char *data;
+  long size;
+  unsigned long freq, head, count, index, i;
+  unsigned long time, last_time = 0;
+  double elapsed = 0, ts;
+  unsigned slots, a, b, c, t;
+  const unsigned char *record;
+  char name[64], args[64];
+
+  if(argc < 2)
+  {
+    fprintf(stderr, "usage: %s <dump file>\n", argv[0]);
+    return 1;
+  }
+
+  file = fopen(argv[1], "rb");
+  if(!file)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+  fseek(file, 0, SEEK_END);
+  size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+  data = malloc(size);
+  if(!data || fread(data, 1, size, file) != (size_t)size)
+  {
+    fprintf(stderr, "%s: read failed\n", argv[1]);
+    return 1;
+  }
+  fclose(file);
+
+  if(size < BUFFER_HEADER_SIZE || get_u32(data) != TQ_TRACE_MAGIC)
+  {
+    fprintf(stderr, "%s: not a tinyq trace dump\n", argv[1]);
+    return 1;
+  }
+
+  freq = get_u32(&data[4]);
+  slots = data[8] | (data[9] << 8);
+  head = get_u32(&data[12]);
+  if(size < BUFFER_HEADER_SIZE + (long)slots * RECORD_SIZE)
+  {
+    fprintf(stderr, "%s: truncated dump\n", argv[1]);
+    return 1;
+  }
+
+  count = head < slots ? head : slots;
+  fprintf(stderr, "%lu records, %lu overwritten\n", count, head - count);
+
+  printf("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+  for(t = 1; t < TRACK_COUNT; t++)
+  {
+    begin_event("M", 0, t);
+    printf(",\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}", _track_names[t]);
+  }
+
+  for(i = 0; i < count; i++)
+  {
+    index = (head - count + i) & (slots - 1);
+    record = &data[BUFFER_HEADER_SIZE + index * RECORD_SIZE];
+    time = get_u32(record);
+    a = record[5];
+    b = record[6];
+    c = record[7];
+
+    /* unwrap the 32 bit timestamp, records are in time order */
+    if(i)
+      elapsed += (double)((time - last_time) & 0xffffffffUL);
+    last_time = time;
+    ts = elapsed * 1000000.0 / freq;
+
+    switch(record[4])
+    {
+      case TQ_TRACE_EVT_ENQUEUE:
+        sprintf(name, "send %u>%u 0x%02x", a, b, c);
+        instant(ts, dispatch_track(c), name);
+        break;
+
+      case TQ_TRACE_EVT_DISPATCH_BEGIN:
+        sprintf(name, "qti %u sig 0x%02x", a, b);
+        sprintf(args, "\"from\":%u", c);
+        duration_begin(ts, dispatch_track(b), name, args);
+        break;
+
+      case TQ_TRACE_EVT_DISPATCH_END:
+        duration_end(ts, dispatch_track(b));
+        break;
+
+      case TQ_TRACE_EVT_TIMER_START:
+      case TQ_TRACE_EVT_TIMER_STOP:
+      case TQ_TRACE_EVT_TIMER_EXPIRE:
+        sprintf(name, "%s qti %u id %u", record[4] == TQ_TRACE_EVT_TIMER_START ? "start" :
+                record[4] == TQ_TRACE_EVT_TIMER_STOP ? "stop" : "expire", a, b | (c << 8));
+        instant(ts, TRACK_TIMER, name);
+        break;
+
+      case TQ_TRACE_EVT_SLEEP_ENTER:
+        sprintf(args, "\"waits\":%u", b);
+        duration_begin(ts, TRACK_SLEEP, a < 3 ? _sleep_names[a] : "sleep", args);
+        break;
+
+      case TQ_TRACE_EVT_SLEEP_EXIT:
+        duration_end(ts, TRACK_SLEEP);
+        break;
+
+      case TQ_TRACE_EVT_WAIT_REQUEST:
+      case TQ_TRACE_EVT_WAIT_RELEASE:
+        sprintf(name, "%s qti %u", record[4] == TQ_TRACE_EVT_WAIT_REQUEST ? "wait" : "release", a);
+        instant(ts, TRACK_SLEEP, name);
+        counter(ts, "waits", b);
+        break;
+
+      case TQ_TRACE_EVT_EXTI:
+        sprintf(name, "exti %u", a);
+        instant(ts, TRACK_EXTI, name);
+        break;
+
+      default:
+        sprintf(name, "event 0x%02x %u %u %u", record[4], a, b, c);
+        instant(ts, TRACK_NORMAL, name);
+        break;
+    }
+  }
+  printf("\n]}\n");
+
+  free(data);
+  return 0;
+}